@@ -332,6 +332,34 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+/* Walks the list of free blocks : size of the largest one (the largest allocation
+that can succeed, plus xHeapStructSize) and number of blocks. */
+void vPortGetFreeBlockStats( size_t *pxLargestFreeBlock, size_t *pxNumberOfFreeBlocks )
+{
+ BlockLink_t *pxBlock;
+ size_t xLargest = 0, xNumberOfBlocks = 0;
+
+ vTaskSuspendAll();
+ {
+   if( pxEnd != NULL )
+   {
+     for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+     {
+       xNumberOfBlocks++;
+       if( pxBlock->xBlockSize > xLargest )
+       {
+         xLargest = pxBlock->xBlockSize;
+       }
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+
+ *pxLargestFreeBlock = xLargest;
+ *pxNumberOfFreeBlocks = xNumberOfBlocks;
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
  /* This just exists to keep the linker quiet. */
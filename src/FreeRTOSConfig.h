@@ -75,7 +75,7 @@
 #define configUSE_TIME_SLICING                  0
 #define configUSE_NEWLIB_REENTRANT              0
 #define configENABLE_BACKWARD_COMPATIBILITY     1
-#define configUSE_TASK_NOTIFICATIONS            0
+#define configUSE_TASK_NOTIFICATIONS            1
 
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK            0
@@ -84,9 +84,13 @@
 #define configUSE_MALLOC_FAILED_HOOK   1
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS        0
+#define configGENERATE_RUN_TIME_STATS        1
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
+/* The run time counter is RTC0 (32768Hz), started by NimBLE (see systemtask/TaskStatistics.h) */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
+#define traceTASK_SWITCHED_IN()          vTaskSwitchedIn(pxCurrentTCB->uxTCBNumber)
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
@@ -181,6 +185,17 @@ standard names - or at least those used in the unmodified vector table. */
     #error "This port requires __NVIC_PRIO_BITS to be defined"
   #endif
 
+  /* Run time statistics of the tasks, implemented in main.cpp */
+  #include <stdint.h>
+  #ifdef __cplusplus
+extern "C" {
+  #endif
+uint32_t ulGetRunTimeCounterValue(void);
+void vTaskSwitchedIn(uint32_t taskNumber);
+  #ifdef __cplusplus
+}
+  #endif
+
   /* Access to current system core clock is required only if we are ticking the system by systimer */
   #if (configTICK_SOURCE == FREERTOS_USE_SYSTICK)
     #include <stdint.h>
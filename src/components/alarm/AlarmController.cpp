@@ -165,11 +165,7 @@ void AlarmController::LoadSettingsFromFile() {
 }
 
 void AlarmController::SaveSettingsToFile() const {
-  lfs_dir systemDir;
-  if (fs.DirOpen("/.system", &systemDir) != LFS_ERR_OK) {
-    fs.DirCreate("/.system");
-  }
-  fs.DirClose(&systemDir);
+  fs.EnsureDirectory("/.system");
   lfs_file_t alarmFile;
   if (fs.FileOpen(&alarmFile, "/.system/alarm.dat", LFS_O_WRONLY | LFS_O_CREAT) != LFS_ERR_OK) {
     NRF_LOG_WARNING("[AlarmController] Failed to open alarm data file for saving");
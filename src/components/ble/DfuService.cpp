@@ -1,6 +1,8 @@
 #include "components/ble/DfuService.h"
+#include <algorithm>
 #include <cstring>
 #include "components/ble/BleController.h"
+#include "components/ble/LinkPolicy.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
 #include <nrf_log.h>
@@ -29,9 +31,11 @@ void TimeoutTimerCallback(TimerHandle_t xTimer) {
 
 DfuService::DfuService(Pinetime::System::SystemTask& systemTask,
                        Pinetime::Controllers::Ble& bleController,
-                       Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       Pinetime::Controllers::LinkPolicy& linkPolicy)
   : systemTask {systemTask},
     bleController {bleController},
+    linkPolicy {linkPolicy},
     dfuImage {spiNorFlash},
     characteristicDefinition {{
                                 .uuid = &packetCharacteristicUuid.u,
@@ -75,6 +79,10 @@ void DfuService::Init() {
 
   res = ble_gatts_add_svcs(serviceDefinition);
   ASSERT(res == 0);
+
+#ifdef DFU_BENCHMARK
+  dfuImage.RunBenchmark();
+#endif
 }
 
 int DfuService::OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
@@ -163,6 +171,7 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
 
     case States::Data: {
       nbPacketReceived++;
+      linkPolicy.OnTransferActivity(LinkPolicy::Transfers::Dfu, om->om_len);
       dfuImage.Append(om->om_data, om->om_len);
       bytesReceived += om->om_len;
       bleController.FirmwareUpdateCurrentBytes(bytesReceived);
@@ -352,36 +361,114 @@ void DfuService::NotificationManager::Reset() {
   xTimerStop(timer, 0);
 }
 
+namespace {
+  // CRC-16/CCITT (polynomial 0x1021), one entry per value of the byte xored with the high byte of the CRC
+  constexpr std::array<uint16_t, 256> GenerateCrcTable() {
+    std::array<uint16_t, 256> table {};
+    for (uint32_t i = 0; i < table.size(); i++) {
+      uint16_t crc = i << 8;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  constexpr std::array<uint16_t, 256> crcTable = GenerateCrcTable();
+}
+
+DfuService::DfuImage::DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
+  pageQueue = xQueueCreate(nbPages, sizeof(PageWrite));
+  freePages = xSemaphoreCreateCounting(nbPages, nbPages);
+  flushDone = xSemaphoreCreateBinary();
+}
+
 void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
   if (chunkSize != 20)
     return;
+  if (writerTask == nullptr) {
+    if (pdPASS != xTaskCreate(DfuImage::WriterProcess, "DfuWriter", 200, this, 1, &writerTask)) {
+      writerTask = nullptr;
+      return;
+    }
+  }
+  if (!fillPageHeld) {
+    xSemaphoreTake(freePages, portMAX_DELAY);
+    fillPageHeld = true;
+  }
   this->chunkSize = chunkSize;
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
   this->ready = true;
   totalWriteIndex = 0;
-  bufferWriteIndex = 0;
+  pageWriteIndex = 0;
+  crc = 0xFFFF;
+  programFailed = false;
 }
 
 void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
   if (!ready)
     return;
-  ASSERT(size <= 20);
-
-  std::memcpy(tempBuffer + bufferWriteIndex, data, size);
-  bufferWriteIndex += size;
+  size = std::min(size, totalSize - totalWriteIndex);
+  crc = ComputeCrc(data, size, crc);
+
+  while (size > 0) {
+    const size_t length = std::min(size, pageSize - pageWriteIndex);
+    std::memcpy(pages[fillPage].data() + pageWriteIndex, data, length);
+    pageWriteIndex += length;
+    totalWriteIndex += length;
+    data += length;
+    size -= length;
+
+    if (pageWriteIndex == pageSize || totalWriteIndex == totalSize) {
+      SubmitPage();
+    }
+  }
+}
 
-  if (bufferWriteIndex == bufferSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    bufferWriteIndex = 0;
+void DfuService::DfuImage::SubmitPage() {
+  PageWrite write {static_cast<uint32_t>(writeOffset + totalWriteIndex - pageWriteIndex), static_cast<uint16_t>(pageWriteIndex), fillPage};
+  xQueueSend(pageQueue, &write, portMAX_DELAY);
+  fillPageHeld = false;
+  fillPage = (fillPage + 1) % nbPages;
+  pageWriteIndex = 0;
+
+  // Blocks only if the flash memory is slower than the BLE link
+  if (totalWriteIndex < totalSize) {
+    xSemaphoreTake(freePages, portMAX_DELAY);
+    fillPageHeld = true;
   }
+}
+
+bool DfuService::DfuImage::Flush() {
+  PageWrite write {0, 0, 0};
+  xQueueSend(pageQueue, &write, portMAX_DELAY);
+  xSemaphoreTake(flushDone, portMAX_DELAY);
+  return !programFailed;
+}
+
+void DfuService::DfuImage::WriterProcess(void* instance) {
+  auto* app = static_cast<DfuImage*>(instance);
+  app->WriterLoop();
+}
+
+void DfuService::DfuImage::WriterLoop() {
+  PageWrite write;
+  while (true) {
+    xQueueReceive(pageQueue, &write, portMAX_DELAY);
+    if (write.size == 0) {
+      xSemaphoreGive(flushDone);
+      continue;
+    }
 
-  if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    if (totalSize < maxSize)
-      WriteMagicNumber();
+    spiNorFlash.StartPageProgram(write.address, pages[write.page].data(), write.size);
+    // The data is in the page buffer of the flash memory when StartPageProgram() returns
+    xSemaphoreGive(freePages);
+    spiNorFlash.WaitWhileBusy();
+    if (spiNorFlash.ProgramFailed()) {
+      programFailed = true;
+    }
   }
 }
 
@@ -399,43 +486,33 @@ void DfuService::DfuImage::WriteMagicNumber() {
 }
 
 void DfuService::DfuImage::Erase() {
+  // Pages of a previous transfer that did not complete
+  if (writerTask != nullptr) {
+    Flush();
+  }
   for (size_t erased = 0; erased < maxSize; erased += 0x1000) {
     spiNorFlash.SectorErase(writeOffset + erased);
   }
 }
 
+// The CRC of the image was computed as it was received, the image is not read back
 bool DfuService::DfuImage::Validate() {
-  uint32_t chunkSize = 200;
-  size_t currentOffset = 0;
-  uint16_t crc = 0;
-
-  bool first = true;
-  while (currentOffset < totalSize) {
-    uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
-
-    spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
-    if (first) {
-      crc = ComputeCrc(tempBuffer, readSize, NULL);
-      first = false;
-    } else
-      crc = ComputeCrc(tempBuffer, readSize, &crc);
-    currentOffset += readSize;
-  }
+  if (!ready || !IsComplete())
+    return false;
+  const bool programmed = Flush();
+  if (!programmed || crc != expectedCrc)
+    return false;
 
-  return (crc == expectedCrc);
+  // The bootloader installs the image when it finds the magic number, it is only written once the CRC matches
+  if (totalSize < maxSize)
+    WriteMagicNumber();
+  return true;
 }
 
-uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
-  uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
-
+uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t crc) {
   for (uint32_t i = 0; i < size; i++) {
-    crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
-    crc ^= p_data[i];
-    crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xFF) << 4) << 1;
+    crc = static_cast<uint16_t>(crc << 8) ^ crcTable[static_cast<uint8_t>(crc >> 8) ^ p_data[i]];
   }
-
   return crc;
 }
 
@@ -2,6 +2,9 @@
 
 #include <cstdint>
 #include <array>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
 
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
@@ -20,12 +23,14 @@ namespace Pinetime {
 
   namespace Controllers {
     class Ble;
+    class LinkPolicy;
 
     class DfuService {
     public:
       DfuService(Pinetime::System::SystemTask& systemTask,
                  Pinetime::Controllers::Ble& bleController,
-                 Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                 Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                 Pinetime::Controllers::LinkPolicy& linkPolicy);
       void Init();
       int OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnTimeout();
@@ -49,10 +54,13 @@ namespace Pinetime {
         void Reset();
       };
 
+      /**
+       * Writes the image to the SPI flash memory page by page : the BLE host fills a page buffer while the writer task
+       * programs the other one, and the CRC is computed as the data arrives.
+       */
       class DfuImage {
       public:
-        DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
-        }
+        DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash);
 
         void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
         void Erase();
@@ -60,21 +68,54 @@ namespace Pinetime {
         bool Validate();
         bool IsComplete();
 
+        // CRC-16/CCITT of the Nordic DFU, crc is 0xFFFF for the first block
+        static uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t crc);
+
+#ifdef DFU_BENCHMARK
+        void RunBenchmark();
+#endif
+
       private:
+        static constexpr size_t pageSize = 256;
+        static constexpr size_t nbPages = 2;
+
+        struct PageWrite {
+          uint32_t address;
+          uint16_t size;
+          uint8_t page;
+        };
+
+        static void WriterProcess(void* instance);
+        void WriterLoop();
+        void SubmitPage();
+        // Waits until the pages submitted so far are programmed, returns false if programming one of them failed
+        bool Flush();
+
         Pinetime::Drivers::SpiNorFlash& spiNorFlash;
-        static constexpr size_t bufferSize = 200;
         bool ready = false;
         size_t chunkSize = 0;
         size_t totalSize = 0;
         size_t maxSize = 475136;
-        size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
         static constexpr size_t writeOffset = 0x40000;
-        uint8_t tempBuffer[bufferSize];
         uint16_t expectedCrc = 0;
+        uint16_t crc = 0xFFFF;
+
+        // Owned by the BLE host
+        std::array<std::array<uint8_t, pageSize>, nbPages> pages;
+        uint8_t fillPage = 0;
+        size_t pageWriteIndex = 0;
+        bool fillPageHeld = false;
+
+        // The writer task is created by the first Init() and waits for the pages submitted in pageQueue.
+        // freePages counts the page buffers that are neither filled nor being sent to the flash memory.
+        TaskHandle_t writerTask = nullptr;
+        QueueHandle_t pageQueue;
+        SemaphoreHandle_t freePages;
+        SemaphoreHandle_t flushDone;
+        volatile bool programFailed = false;
 
         void WriteMagicNumber();
-        uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
       };
 
       static constexpr ble_uuid128_t serviceUuid {
@@ -84,6 +125,7 @@ namespace Pinetime {
     private:
       Pinetime::System::SystemTask& systemTask;
       Pinetime::Controllers::Ble& bleController;
+      Pinetime::Controllers::LinkPolicy& linkPolicy;
       DfuImage dfuImage;
       NotificationManager notificationManager;
 
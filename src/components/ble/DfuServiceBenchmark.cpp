@@ -0,0 +1,132 @@
+#include "components/ble/DfuService.h"
+#include "utility/CycleCounter.h"
+#include <algorithm>
+#include "drivers/SpiNorFlash.h"
+#include <nrf_log.h>
+
+#ifdef DFU_BENCHMARK
+using namespace Pinetime::Controllers;
+
+namespace {
+  // Previous implementation of the CRC, for comparison
+  uint16_t ComputeCrcBitwise(uint8_t const* p_data, uint32_t size, uint16_t crc) {
+    for (uint32_t i = 0; i < size; i++) {
+      crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
+      crc ^= p_data[i];
+      crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
+      crc ^= (crc << 8) << 4;
+      crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+  }
+
+  void FillImage(uint8_t* buffer, size_t offset, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      buffer[i] = static_cast<uint8_t>(((offset + i) * 7) + ((offset + i) >> 8));
+    }
+  }
+
+  uint32_t KBytesPerSecond(uint32_t bytes, uint32_t cycles) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(bytes) * SystemCoreClock) / (static_cast<uint64_t>(cycles) * 1024));
+  }
+
+  uint32_t TicksToMs(TickType_t ticks) {
+    return (ticks * 1000) / configTICK_RATE_HZ;
+  }
+}
+
+// Receives a synthetic image of imageSize bytes in packets of 20 bytes with the previous writer (synchronous writes of
+// 200 bytes, CRC of the image read back by Validate()) and with the current one. No magic number is written : the
+// bootloader does not install the image.
+void DfuService::DfuImage::RunBenchmark() {
+  static constexpr size_t imageSize = 64 * 1024;
+  static constexpr size_t packetSize = 20;
+  static constexpr size_t previousBufferSize = 200;
+  uint8_t buffer[previousBufferSize];
+
+  Utility::EnableCycleCounter();
+
+  // CRC of data in RAM
+  uint16_t bitwiseCrc = 0xFFFF;
+  uint16_t tableCrc = 0xFFFF;
+  uint32_t bitwiseCycles = 0;
+  uint32_t tableCycles = 0;
+  for (size_t offset = 0; offset < imageSize; offset += previousBufferSize) {
+    const size_t size = std::min(previousBufferSize, imageSize - offset);
+    FillImage(buffer, offset, size);
+    uint32_t start = DWT->CYCCNT;
+    bitwiseCrc = ComputeCrcBitwise(buffer, size, bitwiseCrc);
+    bitwiseCycles += DWT->CYCCNT - start;
+    start = DWT->CYCCNT;
+    tableCrc = ComputeCrc(buffer, size, tableCrc);
+    tableCycles += DWT->CYCCNT - start;
+  }
+  NRF_LOG_INFO("[DFU] CRC : bitwise %lu KB/s, table %lu KB/s, same CRC %d",
+               KBytesPerSecond(imageSize, bitwiseCycles),
+               KBytesPerSecond(imageSize, tableCycles),
+               bitwiseCrc == tableCrc);
+
+  // Previous writer
+  TickType_t start = xTaskGetTickCount();
+  Erase();
+  const TickType_t eraseTicks = xTaskGetTickCount() - start;
+  start = xTaskGetTickCount();
+  for (size_t offset = 0; offset < imageSize; offset += previousBufferSize) {
+    const size_t size = std::min(previousBufferSize, imageSize - offset);
+    FillImage(buffer, offset, size);
+    spiNorFlash.Write(writeOffset + offset, buffer, size);
+  }
+  const TickType_t previousWriteTicks = xTaskGetTickCount() - start;
+  start = xTaskGetTickCount();
+  uint16_t readBackCrc = 0xFFFF;
+  for (size_t offset = 0; offset < imageSize; offset += previousBufferSize) {
+    const size_t size = std::min(previousBufferSize, imageSize - offset);
+    spiNorFlash.Read(writeOffset + offset, buffer, size);
+    readBackCrc = ComputeCrcBitwise(buffer, size, readBackCrc);
+  }
+  const TickType_t previousValidateTicks = xTaskGetTickCount() - start;
+  NRF_LOG_INFO("[DFU] previous writer : erase %lu ms, write %lu ms, validate %lu ms, total %lu ms, CRC ok %d",
+               TicksToMs(eraseTicks),
+               TicksToMs(previousWriteTicks),
+               TicksToMs(previousValidateTicks),
+               TicksToMs(eraseTicks + previousWriteTicks + previousValidateTicks),
+               readBackCrc == tableCrc);
+
+  // Current writer, the time spent in Append() is the time the BLE host is busy with the packets
+  start = xTaskGetTickCount();
+  Erase();
+  const TickType_t currentEraseTicks = xTaskGetTickCount() - start;
+  Init(packetSize, imageSize, tableCrc);
+  uint32_t maxAppendCycles = 0;
+  start = xTaskGetTickCount();
+  for (size_t offset = 0; offset < imageSize; offset += packetSize) {
+    const size_t size = std::min(packetSize, imageSize - offset);
+    FillImage(buffer, offset, size);
+    const uint32_t appendStart = DWT->CYCCNT;
+    Append(buffer, size);
+    maxAppendCycles = std::max(maxAppendCycles, DWT->CYCCNT - appendStart);
+  }
+  const TickType_t appendTicks = xTaskGetTickCount() - start;
+  start = xTaskGetTickCount();
+  const bool programmed = Flush();
+  const TickType_t flushTicks = xTaskGetTickCount() - start;
+  NRF_LOG_INFO("[DFU] current writer : erase %lu ms, append %lu ms (max %lu us), flush %lu ms, CRC ok %d",
+               TicksToMs(currentEraseTicks),
+               TicksToMs(appendTicks),
+               maxAppendCycles / (SystemCoreClock / 1000000),
+               TicksToMs(flushTicks),
+               programmed && crc == expectedCrc);
+
+  // The data written to the flash memory must be the same
+  uint16_t currentReadBackCrc = 0xFFFF;
+  for (size_t offset = 0; offset < imageSize; offset += previousBufferSize) {
+    const size_t size = std::min(previousBufferSize, imageSize - offset);
+    spiNorFlash.Read(writeOffset + offset, buffer, size);
+    currentReadBackCrc = ComputeCrc(buffer, size, currentReadBackCrc);
+  }
+  NRF_LOG_INFO("[DFU] current writer : total %lu ms, read back CRC ok %d",
+               TicksToMs(currentEraseTicks + appendTicks + flushTicks),
+               currentReadBackCrc == tableCrc);
+  ready = false;
+}
+#endif
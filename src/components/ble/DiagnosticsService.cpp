@@ -0,0 +1,231 @@
+#include "components/ble/DiagnosticsService.h"
+#include <cstring>
+#include <task.h>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0007yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x07, 0x00}};
+  }
+
+  // 00070000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t diagnosticsServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t displayStatisticsCharUuid {CharUuid(0x01, 0x00)};
+  constexpr ble_uuid128_t linkStatisticsCharUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t memoryStatisticsCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t taskStatisticsCharUuid {CharUuid(0x04, 0x00)};
+
+  int DiagnosticsServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* diagnosticsService = static_cast<DiagnosticsService*>(arg);
+    return diagnosticsService->OnRead(attr_handle, ctxt);
+  }
+
+  uint8_t* Append(uint8_t* buffer, uint32_t value) {
+    std::memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+  }
+
+  uint8_t* Append(uint8_t* buffer, uint16_t value) {
+    std::memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+  }
+
+  uint8_t* Append(uint8_t* buffer, const DisplayStatistics::RollingValue& value) {
+    buffer = Append(buffer, value.Last());
+    buffer = Append(buffer, value.Average());
+    return Append(buffer, value.Max());
+  }
+}
+
+DiagnosticsService::DiagnosticsService(const DisplayStatistics& displayStatistics,
+                                       const Pinetime::System::TaskStatistics& taskStatistics,
+                                       const Pinetime::Components::LvglPool& lvglPool,
+                                       const LinkPolicy& linkPolicy)
+  : displayStatistics {displayStatistics},
+    taskStatistics {taskStatistics},
+    lvglPool {lvglPool},
+    linkPolicy {linkPolicy},
+    characteristicDefinition {{.uuid = &displayStatisticsCharUuid.u,
+                               .access_cb = DiagnosticsServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &displayStatisticsHandle},
+                              {.uuid = &linkStatisticsCharUuid.u,
+                               .access_cb = DiagnosticsServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &linkStatisticsHandle},
+                              {.uuid = &memoryStatisticsCharUuid.u,
+                               .access_cb = DiagnosticsServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &memoryStatisticsHandle},
+                              {.uuid = &taskStatisticsCharUuid.u,
+                               .access_cb = DiagnosticsServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &taskStatisticsHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &diagnosticsServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void DiagnosticsService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int DiagnosticsService::OnRead(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (context->op != BLE_GATT_ACCESS_OP_READ_CHR) {
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+
+  if (attributeHandle == displayStatisticsHandle) {
+    const TickType_t now = xTaskGetTickCount();
+    if (displayStatisticsSize == 0 || now - displayStatisticsTimestamp > snapshotLifetime) {
+      displayStatisticsSize = WriteDisplayStatistics();
+      displayStatisticsTimestamp = now;
+    }
+    int res = os_mbuf_append(context->om, displayStatisticsSnapshot.data(), displayStatisticsSize);
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  if (attributeHandle == linkStatisticsHandle) {
+    return ReadLinkStatistics(context);
+  }
+  if (attributeHandle == memoryStatisticsHandle) {
+    const TickType_t now = xTaskGetTickCount();
+    if (!memoryStatisticsValid || now - memoryStatisticsTimestamp > snapshotLifetime) {
+      WriteMemoryStatistics();
+      memoryStatisticsValid = true;
+      memoryStatisticsTimestamp = now;
+    }
+    int res = os_mbuf_append(context->om, memoryStatisticsSnapshot.data(), memoryStatisticsSnapshot.size());
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  if (attributeHandle == taskStatisticsHandle) {
+    const TickType_t now = xTaskGetTickCount();
+    if (taskStatisticsSize == 0 || now - taskStatisticsTimestamp > snapshotLifetime) {
+      taskStatisticsSize = WriteTaskStatistics();
+      taskStatisticsTimestamp = now;
+    }
+    int res = os_mbuf_append(context->om, taskStatisticsSnapshot.data(), taskStatisticsSize);
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  return 0;
+}
+
+int DiagnosticsService::ReadLinkStatistics(ble_gatt_access_ctxt* context) const {
+  const auto parameters = linkPolicy.GetParameters();
+  std::array<uint8_t, linkStatisticsSize> value;
+  value[0] = linkStatisticsVersion;
+  value[1] = static_cast<uint8_t>(parameters.mode);
+  value[2] = static_cast<uint8_t>(parameters.transfer);
+  value[3] = parameters.txPhy;
+  value[4] = parameters.rxPhy;
+  uint8_t* buffer = Append(value.data() + 5, parameters.connectionInterval);
+  buffer = Append(buffer, parameters.slaveLatency);
+  buffer = Append(buffer, parameters.supervisionTimeout);
+  buffer = Append(buffer, parameters.maxTxOctets);
+  buffer = Append(buffer, parameters.throughput);
+  buffer = Append(buffer, parameters.peakThroughput);
+  buffer = Append(buffer, parameters.transferBytes);
+  Append(buffer, parameters.fastRequests);
+
+  int res = os_mbuf_append(context->om, value.data(), value.size());
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+size_t DiagnosticsService::WriteDisplayStatistics() {
+  const auto summary = displayStatistics.GetSummary();
+  uint8_t* entries = displayStatisticsSnapshot.data() + displayStatisticsHeaderSize;
+  uint8_t nbEntries = 0;
+
+  auto appendScreen = [&entries, &nbEntries](uint8_t type, uint8_t id, uint32_t frames) {
+    if (frames == 0) {
+      return;
+    }
+    entries[0] = type;
+    entries[1] = id;
+    entries = Append(entries + 2, frames);
+    nbEntries++;
+  };
+  for (size_t i = 0; i < DisplayStatistics::nbApps; i++) {
+    appendScreen(0, i, displayStatistics.AppFrames(static_cast<Pinetime::Applications::Apps>(i)));
+  }
+  for (size_t i = 0; i < DisplayStatistics::maxWatchFaces; i++) {
+    appendScreen(1, i, displayStatistics.WatchFaceFrames(static_cast<Pinetime::Applications::WatchFace>(i)));
+  }
+
+  uint8_t* header = displayStatisticsSnapshot.data();
+  header[0] = displayStatisticsVersion;
+  header[1] = nbEntries;
+  header = Append(header + 2, summary.frames);
+  header = Append(header, summary.droppedAlwaysOnFrames);
+  header = Append(header, summary.kilobytesFlushed);
+  header = Append(header, summary.taskHandlerUs);
+  header = Append(header, summary.renderUs);
+  header = Append(header, summary.flushUs);
+  header = Append(header, summary.frameUs);
+  header = Append(header, summary.bytesPerFrame);
+  Append(header, summary.areasPerFrame);
+
+  return entries - displayStatisticsSnapshot.data();
+}
+
+void DiagnosticsService::WriteMemoryStatistics() {
+  const auto& statistics = lvglPool.GetStatistics();
+  const auto heap = Pinetime::Components::LvglPool::GetHeapStatistics();
+
+  uint8_t* buffer = memoryStatisticsSnapshot.data();
+  buffer[0] = memoryStatisticsVersion;
+  buffer[1] = statistics.classes.size();
+  buffer = Append(buffer + 2, static_cast<uint32_t>(heap.freeBytes));
+  buffer = Append(buffer, static_cast<uint32_t>(heap.minimumEverFreeBytes));
+  buffer = Append(buffer, static_cast<uint32_t>(heap.largestFreeBlock));
+  buffer = Append(buffer, static_cast<uint32_t>(heap.nbFreeBlocks));
+  buffer = Append(buffer, lvglPool.MallocFailures());
+  buffer = Append(buffer, statistics.heapAllocations);
+  buffer = Append(buffer, statistics.failures);
+  for (const auto& sizeClass : statistics.classes) {
+    buffer = Append(buffer, sizeClass.blockSize);
+    buffer = Append(buffer, sizeClass.nbBlocks);
+    buffer = Append(buffer, sizeClass.used);
+    buffer = Append(buffer, sizeClass.peakUsed);
+    buffer = Append(buffer, sizeClass.allocations);
+    buffer = Append(buffer, sizeClass.overflows);
+  }
+}
+
+size_t DiagnosticsService::WriteTaskStatistics() {
+  const auto summary = taskStatistics.GetSummary();
+
+  uint8_t* buffer = taskStatisticsSnapshot.data();
+  buffer[0] = taskStatisticsVersion;
+  buffer[1] = summary.nbTasks;
+  buffer = Append(buffer + 2, summary.windowMs);
+  buffer = Append(buffer, summary.windows);
+  buffer = Append(buffer, summary.idlePermille);
+  buffer = Append(buffer, summary.wakeupsPerSecond);
+  for (size_t i = 0; i < summary.nbTasks; i++) {
+    const auto& task = summary.tasks[i];
+    buffer[0] = task.number;
+    std::memcpy(buffer + 1, task.name, sizeof(task.name));
+    buffer = Append(buffer + 1 + sizeof(task.name), task.cpuPermille);
+    buffer = Append(buffer, task.wakeupsPerSecond);
+  }
+
+  return buffer - taskStatisticsSnapshot.data();
+}
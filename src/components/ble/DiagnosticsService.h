@@ -0,0 +1,79 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include "components/ble/LinkPolicy.h"
+#include "components/display/DisplayStatistics.h"
+#include "displayapp/LvglPool.h"
+#include "systemtask/TaskStatistics.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Read only characteristics that expose the performance counters of the firmware (see doc/DiagnosticsService.md).
+     */
+    class DiagnosticsService {
+    public:
+      DiagnosticsService(const DisplayStatistics& displayStatistics,
+                         const Pinetime::System::TaskStatistics& taskStatistics,
+                         const Pinetime::Components::LvglPool& lvglPool,
+                         const LinkPolicy& linkPolicy);
+      void Init();
+      int OnRead(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+
+    private:
+      size_t WriteDisplayStatistics();
+      void WriteMemoryStatistics();
+      size_t WriteTaskStatistics();
+      int ReadLinkStatistics(ble_gatt_access_ctxt* context) const;
+
+      const DisplayStatistics& displayStatistics;
+      const Pinetime::System::TaskStatistics& taskStatistics;
+      const Pinetime::Components::LvglPool& lvglPool;
+      const LinkPolicy& linkPolicy;
+
+      struct ble_gatt_chr_def characteristicDefinition[5];
+      struct ble_gatt_svc_def serviceDefinition[2];
+      uint16_t displayStatisticsHandle;
+      uint16_t linkStatisticsHandle;
+      uint16_t memoryStatisticsHandle;
+      uint16_t taskStatisticsHandle;
+
+      static constexpr uint8_t displayStatisticsVersion = 1;
+      static constexpr uint8_t linkStatisticsVersion = 1;
+      static constexpr uint8_t memoryStatisticsVersion = 1;
+      static constexpr uint8_t taskStatisticsVersion = 1;
+      static constexpr size_t linkStatisticsSize = 5 + 4 * sizeof(uint16_t) + 4 * sizeof(uint32_t);
+      static constexpr size_t displayStatisticsHeaderSize = 2 + 3 * sizeof(uint32_t) + 6 * 3 * sizeof(uint32_t);
+      static constexpr size_t screenEntrySize = 2 + sizeof(uint32_t);
+      static constexpr size_t maxDisplayStatisticsSize =
+        displayStatisticsHeaderSize + (DisplayStatistics::nbApps + DisplayStatistics::maxWatchFaces) * screenEntrySize;
+      static constexpr size_t memoryStatisticsHeaderSize = 2 + 7 * sizeof(uint32_t);
+      static constexpr size_t sizeClassEntrySize = 4 * sizeof(uint16_t) + 2 * sizeof(uint32_t);
+      static constexpr size_t memoryStatisticsSize =
+        memoryStatisticsHeaderSize + Pinetime::Components::LvglPool::nbClasses * sizeClassEntrySize;
+      static constexpr size_t taskStatisticsHeaderSize = 2 + 2 * sizeof(uint32_t) + 2 * sizeof(uint16_t);
+      static constexpr size_t taskEntrySize = 1 + configMAX_TASK_NAME_LEN + 2 * sizeof(uint16_t);
+      static constexpr size_t maxTaskStatisticsSize =
+        taskStatisticsHeaderSize + Pinetime::System::TaskStatistics::maxTasks * taskEntrySize;
+
+      // Values longer than the MTU are read in several requests : they all read the same snapshot
+      static constexpr TickType_t snapshotLifetime = pdMS_TO_TICKS(500);
+      std::array<uint8_t, maxDisplayStatisticsSize> displayStatisticsSnapshot;
+      size_t displayStatisticsSize = 0;
+      TickType_t displayStatisticsTimestamp = 0;
+      std::array<uint8_t, memoryStatisticsSize> memoryStatisticsSnapshot;
+      TickType_t memoryStatisticsTimestamp = 0;
+      bool memoryStatisticsValid = false;
+      std::array<uint8_t, maxTaskStatisticsSize> taskStatisticsSnapshot;
+      size_t taskStatisticsSize = 0;
+      TickType_t taskStatisticsTimestamp = 0;
+    };
+  }
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <nrf_log.h>
 #include "FSService.h"
 #include "components/ble/BleController.h"
@@ -14,9 +15,17 @@ int FSServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gat
   return fsService->OnFSServiceRequested(conn_handle, attr_handle, ctxt);
 }
 
-FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs)
+void SessionTimerCallback(TimerHandle_t xTimer) {
+  auto* fsService = static_cast<FSService*>(pvTimerGetTimerID(xTimer));
+  fsService->OnSessionTimerExpired();
+}
+
+FSService::FSService(Pinetime::System::SystemTask& systemTask,
+                     Pinetime::Controllers::FS& fs,
+                     Pinetime::Controllers::LinkPolicy& linkPolicy)
   : systemTask {systemTask},
     fs {fs},
+    linkPolicy {linkPolicy},
     characteristicDefinition {{.uuid = &fsVersionUuid.u,
                                .access_cb = FSServiceCallback,
                                .arg = this,
@@ -26,7 +35,7 @@ FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Control
                                 .uuid = &fsTransferUuid.u,
                                 .access_cb = FSServiceCallback,
                                 .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                 .val_handle = &transferCharacteristicHandle,
                               },
                               {0}},
@@ -37,6 +46,8 @@ FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Control
        .characteristics = characteristicDefinition},
       {0},
     } {
+  sessionTimer = xTimerCreate("fsSession", sessionTimeout, pdFALSE, this, SessionTimerCallback);
+  sessionMutex = xSemaphoreCreateMutex();
 }
 
 void FSService::Init() {
@@ -55,7 +66,10 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
     return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
   }
   if (attributeHandle == transferCharacteristicHandle) {
-    return FSCommandHandler(connectionHandle, context->om);
+    xSemaphoreTake(sessionMutex, portMAX_DELAY);
+    const int res = FSCommandHandler(connectionHandle, context->om);
+    xSemaphoreGive(sessionMutex);
+    return res;
   }
   return 0;
 }
@@ -63,81 +77,59 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
 int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   auto command = static_cast<commands>(om->om_data[0]);
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
-  // Just always make sure we are awake...
-  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
-  vTaskDelay(10);
-  while (systemTask.IsSleeping()) {
-    vTaskDelay(100); // 50ms
+  // The chunks of a transfer are handled without waking the system task again
+  const bool continuesTransfer =
+    (command == commands::READ_PACING && state == FSState::READ) || (command == commands::WRITE_DATA && state == FSState::WRITE);
+  if (!continuesTransfer) {
+    EndSession();
+    // Just always make sure we are awake...
+    systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+    wakeLockHeld = true;
+    vTaskDelay(10);
+    while (systemTask.IsSleeping()) {
+      vTaskDelay(100); // 50ms
+    }
   }
   lfs_dir_t dir = {0};
   lfs_info info = {0};
-  lfs_file f = {0};
   switch (command) {
     case commands::READ: {
       NRF_LOG_INFO("[FS_S] -> Read");
       auto* header = (ReadHeader*) om->om_data;
       uint16_t plen = header->pathlen;
       if (plen > maxpathlen) { //> counts for null term
+        EndSession();
         return -1;
       }
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
-      ReadResponse resp;
-      os_mbuf* om;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
+      int res = OpenSessionFile(FSState::READ);
+      if (res < 0) {
+        ReadResponse resp {};
+        resp.command = commands::READ_DATA;
         resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-        fs.FileClose(&f);
+        resp.chunkoff = header->chunkoff;
+        auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+        ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+        break;
       }
-
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      SendReadData(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::READ_PACING: {
       NRF_LOG_INFO("[FS_S] -> Readpacing");
-      auto* header = (ReadHeader*) om->om_data;
-      ReadResponse resp;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
+      auto* header = (ReadPacing*) om->om_data;
+      int res = fileOpen ? LFS_ERR_OK : OpenSessionFile(FSState::READ);
+      if (res < 0) {
+        ReadResponse resp {};
+        resp.command = commands::READ_DATA;
         resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-      }
-      os_mbuf* om;
-      if (resp.chunklen > 0) {
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-      } else {
-        resp.chunklen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+        resp.chunkoff = header->chunkoff;
+        auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+        ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+        break;
       }
-      fs.FileClose(&f);
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      SendReadData(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::WRITE: {
@@ -145,6 +137,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       auto* header = (WriteHeader*) om->om_data;
       uint16_t plen = header->pathlen;
       if (plen > maxpathlen) { //> counts for null term
+        EndSession();
         return -1;             // TODO make this actually return a BLE notif
       }
       memcpy(filepath, header->pathstr, plen);
@@ -155,12 +148,13 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.offset = header->offset;
       resp.modTime = 0;
 
-      int res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT);
-      if (res == 0) {
-        fs.FileClose(&f);
-        resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      linkPolicy.OnTransferActivity(LinkPolicy::Transfers::FileSystem, 0);
+      int res = OpenSessionFile(FSState::WRITE);
+      resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      if (res == 0 && header->offset >= static_cast<uint32_t>(fileSize)) {
+        EndSession();
       }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
+      resp.freespace = std::min<uint32_t>(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
@@ -170,19 +164,22 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       auto* header = (WritePacing*) om->om_data;
       WriteResponse resp;
       resp.command = commands::WRITE_PACING;
+      resp.status = 0x01;
       resp.offset = header->offset;
-      int res = 0;
-
-      if (!(res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT))) {
-        if ((res = fs.FileSeek(&f, header->offset)) >= 0) {
-          res = fs.FileWrite(&f, header->data, header->dataSize);
-        }
-        fs.FileClose(&f);
+      resp.modTime = 0;
+      int res = fileOpen ? LFS_ERR_OK : OpenSessionFile(FSState::WRITE);
+      if (res == 0) {
+        res = WriteData(om, header->offset, header->dataSize);
+        linkPolicy.OnTransferActivity(LinkPolicy::Transfers::FileSystem, header->dataSize);
       }
       if (res < 0) {
         resp.status = (int8_t) res;
       }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
+      // littlefs commits the file when it is closed
+      if (res < 0 || header->offset + header->dataSize >= static_cast<uint32_t>(fileSize)) {
+        EndSession();
+      }
+      resp.freespace = std::min<uint32_t>(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
@@ -302,29 +299,141 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       break;
   }
   NRF_LOG_INFO("[FS_S] -> done ");
-  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+  if (state == FSState::IDLE) {
+    EndSession();
+  } else {
+    xTimerReset(sessionTimer, 0);
+  }
   return 0;
 }
 
-// Loads resp with file data given a valid filepath header and resp
-void FSService::prepareReadDataResp(ReadHeader* header, ReadResponse* resp) {
-  // uint16_t plen = header->pathlen;
-  resp->command = commands::READ_DATA;
-  resp->chunkoff = header->chunkoff;
-  resp->status = 0x01;
-  struct lfs_info info = {};
-  int res = fs.Stat(filepath, &info);
-  if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-    resp->status = 0x03;
-    resp->chunklen = 0;
-    resp->totallen = 0;
-  } else {
-    lfs_file f;
-    resp->chunklen = std::min(header->chunksize, info.size);
-    resp->totallen = info.size;
-    fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-    fs.FileSeek(&f, header->chunkoff);
-    resp->chunklen = fs.FileRead(&f, resp->chunk, resp->chunklen);
-    fs.FileClose(&f);
+int FSService::OpenSessionFile(FSState newState) {
+  int res;
+  if (newState == FSState::READ) {
+    lfs_info info;
+    if ((res = fs.Stat(filepath, &info)) < 0) {
+      return res;
+    }
+    fileSize = info.size;
+  }
+  const int flags = (newState == FSState::WRITE) ? (LFS_O_RDWR | LFS_O_CREAT) : LFS_O_RDONLY;
+  if ((res = fs.FileOpen(&file, filepath, flags)) < 0) {
+    return res;
+  }
+  fileOpen = true;
+  state = newState;
+  return LFS_ERR_OK;
+}
+
+void FSService::EndSession() {
+  xTimerStop(sessionTimer, 0);
+  if (fileOpen) {
+    fs.FileClose(&file);
+    fileOpen = false;
+  }
+  state = FSState::IDLE;
+  if (wakeLockHeld) {
+    systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+    wakeLockHeld = false;
+  }
+}
+
+void FSService::OnDisconnect() {
+  xSemaphoreTake(sessionMutex, portMAX_DELAY);
+  EndSession();
+  xSemaphoreGive(sessionMutex);
+}
+
+// Closing the file commits it to littlefs, which needs more stack than the timer task has : the session is ended by the
+// system task.
+void FSService::OnSessionTimerExpired() {
+  systemTask.PushMessage(Pinetime::System::Messages::FileTransferSessionTimeout);
+}
+
+// The client stopped in the middle of a transfer : the file is closed and the system task may sleep again. If the BLE
+// host is handling a packet, the session is not idle and the timer was restarted.
+void FSService::OnSessionTimeout() {
+  if (xSemaphoreTake(sessionMutex, 0) == pdTRUE) {
+    if (xTimerIsTimerActive(sessionTimer) == pdFALSE) {
+      NRF_LOG_INFO("[FS_S] session timeout");
+      EndSession();
+    }
+    xSemaphoreGive(sessionMutex);
+  }
+}
+
+uint16_t FSService::Mtu(uint16_t connectionHandle) const {
+#ifdef FS_TRANSFER_BENCHMARK
+  if (connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    return benchmarkMtu;
   }
+#endif
+  return std::max<uint16_t>(ble_att_mtu(connectionHandle), BLE_ATT_MTU_DFLT);
+}
+
+// The chunk is read from littlefs straight into the notification, as large as the MTU allows
+void FSService::SendReadData(uint16_t connectionHandle, uint32_t offset, uint32_t size) {
+  // ATT notification header : 3 bytes
+  static constexpr uint32_t maxChunkSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3 - sizeof(ReadResponse);
+  const uint32_t totalSize = std::max(fileSize, 0);
+  const uint32_t remaining = (offset < totalSize) ? (totalSize - offset) : 0;
+
+  ReadResponse resp;
+  resp.command = commands::READ_DATA;
+  resp.status = 0x01;
+  resp.padding = 0;
+  resp.chunkoff = offset;
+  resp.totallen = totalSize;
+  resp.chunklen = std::min({size, remaining, Mtu(connectionHandle) - 3 - static_cast<uint32_t>(sizeof(ReadResponse)), maxChunkSize});
+
+  auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+  if (om == nullptr) {
+    return;
+  }
+  if (resp.chunklen > 0) {
+    auto* chunk = static_cast<uint8_t*>(os_mbuf_extend(om, resp.chunklen));
+    int res = -1;
+    if (chunk != nullptr && fs.FileSeek(&file, offset) >= 0) {
+      res = fs.FileRead(&file, chunk, resp.chunklen);
+    }
+    const uint32_t chunkSize = std::max(res, 0);
+    if (chunk == nullptr || res < 0) {
+      resp.status = (int8_t) res;
+    }
+    if (chunk != nullptr && chunkSize < resp.chunklen) {
+      os_mbuf_adj(om, -static_cast<int>(resp.chunklen - chunkSize));
+    }
+    resp.chunklen = chunkSize;
+    os_mbuf_copyinto(om, 0, &resp, sizeof(ReadResponse));
+  }
+  ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+  linkPolicy.OnTransferActivity(LinkPolicy::Transfers::FileSystem, resp.chunklen);
+
+  if (offset + resp.chunklen >= totalSize || resp.status != 0x01) {
+    EndSession();
+  }
+}
+
+// The data is written to littlefs straight from the buffers of the packet
+int FSService::WriteData(os_mbuf* om, uint32_t offset, uint32_t size) {
+  int res = fs.FileSeek(&file, offset);
+  if (res < 0) {
+    return res;
+  }
+  uint32_t skip = sizeof(WritePacing);
+  size = std::min<uint32_t>(size, std::max<int>(OS_MBUF_PKTLEN(om) - sizeof(WritePacing), 0));
+  for (os_mbuf* buffer = om; buffer != nullptr && size > 0; buffer = SLIST_NEXT(buffer, om_next)) {
+    if (skip >= buffer->om_len) {
+      skip -= buffer->om_len;
+      continue;
+    }
+    const uint32_t length = std::min<uint32_t>(buffer->om_len - skip, size);
+    res = fs.FileWrite(&file, buffer->om_data + skip, length);
+    if (res < 0) {
+      return res;
+    }
+    skip = 0;
+    size -= length;
+  }
+  return 0;
 }
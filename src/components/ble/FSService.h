@@ -4,8 +4,12 @@
 #include <host/ble_gap.h>
 #undef max
 #undef min
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <timers.h>
 
 #include "components/fs/FS.h"
+#include "components/ble/LinkPolicy.h"
 
 namespace Pinetime {
   namespace System {
@@ -17,19 +21,29 @@ namespace Pinetime {
 
     class FSService {
     public:
-      FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs);
+      FSService(Pinetime::System::SystemTask& systemTask,
+                Pinetime::Controllers::FS& fs,
+                Pinetime::Controllers::LinkPolicy& linkPolicy);
       void Init();
 
       int OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void NotifyFSRaw(uint16_t connectionHandle);
+      void OnDisconnect();
+      void OnSessionTimerExpired();
+      void OnSessionTimeout();
+
+#ifdef FS_TRANSFER_BENCHMARK
+      void RunTransferBenchmark();
+#endif
 
     private:
       Pinetime::System::SystemTask& systemTask;
       Pinetime::Controllers::FS& fs;
+      Pinetime::Controllers::LinkPolicy& linkPolicy;
       static constexpr uint16_t FSServiceId {0xFEBB};
       static constexpr uint16_t fsVersionId {0x0100};
       static constexpr uint16_t fsTransferId {0x0200};
-      uint16_t fsVersion = {0x0004};
+      uint16_t fsVersion = {0x0005};
       static constexpr uint16_t maxpathlen = 256;
       static constexpr ble_uuid16_t fsServiceUuid {
         .u {.type = BLE_UUID_TYPE_16},
@@ -70,9 +84,18 @@ namespace Pinetime {
         READ = 0x01,
         WRITE = 0x02,
       };
-      FSState state;
+      FSState state = FSState::IDLE;
       char filepath[maxpathlen]; // TODO ..ugh fixed filepath len
       int fileSize;
+      // The file stays open and the system task awake from READ / WRITE to the last chunk (see doc/BLEFS.md), or until
+      // no packet of the transfer was received for sessionTimeout
+      static constexpr TickType_t sessionTimeout = pdMS_TO_TICKS(10000);
+      lfs_file_t file;
+      bool fileOpen = false;
+      bool wakeLockHeld = false;
+      TimerHandle_t sessionTimer;
+      // Taken by the BLE host while it handles a command and by the system task when the session times out
+      SemaphoreHandle_t sessionMutex;
 
       using ReadHeader = struct __attribute__((packed)) {
         commands command;
@@ -191,7 +214,15 @@ namespace Pinetime {
       };
 
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
-      void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
+      void SendReadData(uint16_t connectionHandle, uint32_t offset, uint32_t size);
+      int WriteData(os_mbuf* om, uint32_t offset, uint32_t size);
+      int OpenSessionFile(FSState newState);
+      void EndSession();
+      uint16_t Mtu(uint16_t connectionHandle) const;
+
+#ifdef FS_TRANSFER_BENCHMARK
+      uint16_t benchmarkMtu = BLE_ATT_MTU_DFLT;
+#endif
     };
   }
 }
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstring>
+#include <nrf_log.h>
+#include "components/ble/FSService.h"
+#include "components/fs/FS.h"
+
+#ifdef FS_TRANSFER_BENCHMARK
+using namespace Pinetime::Controllers;
+
+// Loopback transfer of a file through FSCommandHandler, the radio is not included : this measures the time spent by the
+// watch to handle the packets of a transfer, which bounds the throughput the link can reach.
+void FSService::RunTransferBenchmark() {
+  static constexpr char path[] = "/bench.bin";
+  static constexpr uint32_t transferSize = 32 * 1024;
+  static constexpr uint16_t mtus[] = {BLE_ATT_MTU_DFLT, 247};
+  uint8_t packet[MYNEWT_VAL(BLE_ATT_PREFERRED_MTU)];
+
+  for (uint16_t mtu : mtus) {
+    benchmarkMtu = mtu;
+    const uint32_t chunkSize = mtu - 3 - sizeof(WritePacing);
+
+    TickType_t start = xTaskGetTickCount();
+    auto* writeHeader = reinterpret_cast<WriteHeader*>(packet);
+    *writeHeader = {};
+    writeHeader->command = commands::WRITE;
+    writeHeader->pathlen = sizeof(path) - 1;
+    writeHeader->totalSize = transferSize;
+    memcpy(writeHeader->pathstr, path, sizeof(path) - 1);
+    auto* om = ble_hs_mbuf_from_flat(packet, sizeof(WriteHeader) + sizeof(path) - 1);
+    FSCommandHandler(BLE_HS_CONN_HANDLE_NONE, om);
+    os_mbuf_free_chain(om);
+    for (uint32_t offset = 0; offset < transferSize; offset += chunkSize) {
+      auto* writePacing = reinterpret_cast<WritePacing*>(packet);
+      *writePacing = {};
+      writePacing->command = commands::WRITE_DATA;
+      writePacing->offset = offset;
+      writePacing->dataSize = std::min(chunkSize, transferSize - offset);
+      memset(writePacing->data, offset / chunkSize, writePacing->dataSize);
+      om = ble_hs_mbuf_from_flat(packet, sizeof(WritePacing) + writePacing->dataSize);
+      FSCommandHandler(BLE_HS_CONN_HANDLE_NONE, om);
+      os_mbuf_free_chain(om);
+    }
+    const TickType_t uploadTicks = std::max<TickType_t>(1, xTaskGetTickCount() - start);
+
+    start = xTaskGetTickCount();
+    auto* readHeader = reinterpret_cast<ReadHeader*>(packet);
+    *readHeader = {};
+    readHeader->command = commands::READ;
+    readHeader->pathlen = sizeof(path) - 1;
+    readHeader->chunksize = transferSize;
+    memcpy(readHeader->pathstr, path, sizeof(path) - 1);
+    om = ble_hs_mbuf_from_flat(packet, sizeof(ReadHeader) + sizeof(path) - 1);
+    FSCommandHandler(BLE_HS_CONN_HANDLE_NONE, om);
+    os_mbuf_free_chain(om);
+    const uint32_t readChunkSize = mtu - 3 - sizeof(ReadResponse);
+    for (uint32_t offset = readChunkSize; offset < transferSize; offset += readChunkSize) {
+      auto* readPacing = reinterpret_cast<ReadPacing*>(packet);
+      *readPacing = {};
+      readPacing->command = commands::READ_PACING;
+      readPacing->chunkoff = offset;
+      readPacing->chunksize = transferSize - offset;
+      om = ble_hs_mbuf_from_flat(packet, sizeof(ReadPacing));
+      FSCommandHandler(BLE_HS_CONN_HANDLE_NONE, om);
+      os_mbuf_free_chain(om);
+    }
+    const TickType_t downloadTicks = std::max<TickType_t>(1, xTaskGetTickCount() - start);
+
+    fs.FileDelete(path);
+    NRF_LOG_INFO("[FS_S] MTU %d : upload %lu KB/s, download %lu KB/s",
+                 mtu,
+                 (transferSize * configTICK_RATE_HZ) / (uploadTicks * 1024),
+                 (transferSize * configTICK_RATE_HZ) / (downloadTicks * 1024));
+  }
+  benchmarkMtu = BLE_ATT_MTU_DFLT;
+}
+#endif
@@ -0,0 +1,106 @@
+#include "components/ble/HeartRateHistoryService.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0008yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x08, 0x00}};
+  }
+
+  // 00080000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t heartRateHistoryServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t recordsCharUuid {CharUuid(0x01, 0x00)};
+  constexpr ble_uuid128_t infoCharUuid {CharUuid(0x02, 0x00)};
+
+  int HeartRateHistoryServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* heartRateHistoryService = static_cast<HeartRateHistoryService*>(arg);
+    return heartRateHistoryService->OnAccess(conn_handle, attr_handle, ctxt);
+  }
+
+  uint8_t* Append(uint8_t* buffer, uint32_t value) {
+    std::memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+  }
+}
+
+HeartRateHistoryService::HeartRateHistoryService(HeartRateHistory& heartRateHistory)
+  : heartRateHistory {heartRateHistory},
+    characteristicDefinition {{.uuid = &recordsCharUuid.u,
+                               .access_cb = HeartRateHistoryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &recordsHandle},
+                              {.uuid = &infoCharUuid.u,
+                               .access_cb = HeartRateHistoryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &infoHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &heartRateHistoryServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void HeartRateHistoryService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int HeartRateHistoryService::OnAccess(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle == recordsHandle) {
+    if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+      // Range to synchronize : begin and end (UTC, s)
+      uint8_t request[2 * sizeof(uint32_t)];
+      if (OS_MBUF_PKTLEN(context->om) != sizeof(request) || os_mbuf_copydata(context->om, 0, sizeof(request), request) != 0) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+      std::memcpy(&begin, request, sizeof(begin));
+      std::memcpy(&end, request + sizeof(begin), sizeof(end));
+      cursor = 0;
+      return 0;
+    }
+    if (context->op == BLE_GATT_ACCESS_OP_READ_CHR) {
+      return OnRecordsRead(connectionHandle, context);
+    }
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+
+  if (attributeHandle == infoHandle && context->op == BLE_GATT_ACCESS_OP_READ_CHR) {
+    uint8_t info[4 + sizeof(uint32_t)];
+    info[0] = infoVersion;
+    info[1] = HeartRateHistory::recordSize;
+    info[2] = HeartRateHistory::sampleInterval;
+    info[3] = maxRecordsPerRead;
+    Append(info + 4, heartRateHistory.NbRecords());
+    int res = os_mbuf_append(context->om, info, sizeof(info));
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  return BLE_ATT_ERR_UNLIKELY;
+}
+
+// Each read returns the next records of the range, an empty response (no records) ends the range
+int HeartRateHistoryService::OnRecordsRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context) {
+  const uint16_t mtu = std::max<uint16_t>(ble_att_mtu(connectionHandle), BLE_ATT_MTU_DFLT);
+  const size_t nbRecords = std::min<size_t>((mtu - 2) / HeartRateHistory::recordSize, maxRecordsPerRead);
+  if (nbRecords == 0) {
+    // A record would be split across several read requests, which would all advance the cursor
+    return BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+
+  response[0] = heartRateHistory.ReadRecords(begin, end, cursor, response.data() + 1, nbRecords * HeartRateHistory::recordSize);
+  int res = os_mbuf_append(context->om, response.data(), 1 + (response[0] * HeartRateHistory::recordSize));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "components/heartrate/HeartRateHistory.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Bulk synchronization of the heart rate history (see doc/HeartRateHistoryService.md).
+     */
+    class HeartRateHistoryService {
+    public:
+      explicit HeartRateHistoryService(HeartRateHistory& heartRateHistory);
+      void Init();
+      int OnAccess(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+
+    private:
+      int OnRecordsRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+
+      HeartRateHistory& heartRateHistory;
+
+      struct ble_gatt_chr_def characteristicDefinition[3];
+      struct ble_gatt_svc_def serviceDefinition[2];
+      uint16_t recordsHandle;
+      uint16_t infoHandle;
+
+      static constexpr uint8_t infoVersion = 1;
+      // Read response : ATT header (1 byte), number of records (1 byte), followed by the records
+      static constexpr size_t maxRecordsPerRead = (MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 2) / HeartRateHistory::recordSize;
+
+      // Requested range, the cursor is reset by each write
+      uint32_t begin = 0;
+      uint32_t end = UINT32_MAX;
+      uint32_t cursor = 0;
+      std::array<uint8_t, 1 + (maxRecordsPerRead * HeartRateHistory::recordSize)> response;
+    };
+  }
+}
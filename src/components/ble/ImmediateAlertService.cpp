@@ -1,4 +1,5 @@
 #include "components/ble/ImmediateAlertService.h"
+#include <algorithm>
 #include <cstring>
 #include "components/ble/NotificationManager.h"
 #include "systemtask/SystemTask.h"
@@ -63,7 +64,10 @@ int ImmediateAlertService::OnAlertLevelChanged(uint16_t attributeHandle, ble_gat
       auto* alertString = ToString(alertLevel);
 
       NotificationManager::Notification notif;
-      std::memcpy(notif.message.data(), alertString, strlen(alertString));
+      const size_t messageSize = std::min(strlen(alertString) + 1, NotificationManager::MaximumMessageSize());
+      std::memcpy(notif.message.data(), alertString, messageSize);
+      notif.message[messageSize - 1] = '\0';
+      notif.size = messageSize;
       notif.category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
       notificationManager.Push(std::move(notif));
 
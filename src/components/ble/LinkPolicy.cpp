@@ -0,0 +1,121 @@
+#include "components/ble/LinkPolicy.h"
+#include <nrf_log.h>
+
+using namespace Pinetime::Controllers;
+
+// Not exposed by the public API of the NimBLE host (ble_hs_hci_priv.h)
+extern "C" int ble_hs_hci_util_set_data_len(uint16_t conn_handle, uint16_t tx_octets, uint16_t tx_time);
+
+namespace {
+  void LinkPolicyTimerCallback(TimerHandle_t xTimer) {
+    auto* linkPolicy = static_cast<LinkPolicy*>(pvTimerGetTimerID(xTimer));
+    linkPolicy->OnTimer();
+  }
+}
+
+LinkPolicy::LinkPolicy() {
+  timer = xTimerCreate("linkPolicy", throughputPeriod, pdTRUE, this, LinkPolicyTimerCallback);
+}
+
+void LinkPolicy::OnConnect(uint16_t connectionHandle) {
+  this->connectionHandle = connectionHandle;
+  mode = Modes::Default;
+  throughput = 0;
+  peakThroughput = 0;
+  transferBytes = 0;
+  windowBytes = 0;
+  currentMaxTxOctets = 27;
+  txPhy = BLE_GAP_LE_PHY_1M;
+  rxPhy = BLE_GAP_LE_PHY_1M;
+  ble_gap_read_le_phy(connectionHandle, &txPhy, &rxPhy);
+  OnConnectionUpdated(connectionHandle);
+}
+
+void LinkPolicy::OnDisconnect() {
+  connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+  mode = Modes::Default;
+  throughput = 0;
+  xTimerStop(timer, 0);
+}
+
+void LinkPolicy::OnConnectionUpdated(uint16_t connectionHandle) {
+  ble_gap_conn_desc desc;
+  if (ble_gap_conn_find(connectionHandle, &desc) != 0) {
+    return;
+  }
+  connectionInterval = desc.conn_itvl;
+  slaveLatency = desc.conn_latency;
+  supervisionTimeout = desc.supervision_timeout;
+  NRF_LOG_INFO("[LinkPolicy] interval %d, latency %d, timeout %d", connectionInterval, slaveLatency, supervisionTimeout);
+}
+
+void LinkPolicy::OnPhyUpdated(uint8_t txPhy, uint8_t rxPhy) {
+  this->txPhy = txPhy;
+  this->rxPhy = rxPhy;
+  NRF_LOG_INFO("[LinkPolicy] PHY tx %d, rx %d", txPhy, rxPhy);
+}
+
+void LinkPolicy::OnTransferActivity(Transfers transfer, size_t bytes) {
+  lastActivity = xTaskGetTickCount();
+  windowBytes += bytes;
+  transferBytes += bytes;
+  if (mode != Modes::Fast && connectionHandle != BLE_HS_CONN_HANDLE_NONE) {
+    this->transfer = transfer;
+    NRF_LOG_INFO("[LinkPolicy] transfer %d started", static_cast<uint8_t>(transfer));
+    RequestFastLink();
+  }
+}
+
+void LinkPolicy::OnTimer() {
+  const uint32_t bytes = windowBytes.exchange(0);
+  throughput = (bytes * configTICK_RATE_HZ) / throughputPeriod;
+  if (throughput > peakThroughput) {
+    peakThroughput = throughput.load();
+  }
+
+  if (mode == Modes::Fast && xTaskGetTickCount() - lastActivity > idleTimeout) {
+    NRF_LOG_INFO("[LinkPolicy] transfer idle, peak %lu B/s", peakThroughput.load());
+    RequestLowPowerLink();
+  }
+}
+
+LinkPolicy::Parameters LinkPolicy::GetParameters() const {
+  return {.mode = mode,
+          .transfer = transfer,
+          .txPhy = txPhy,
+          .rxPhy = rxPhy,
+          .connectionInterval = connectionInterval,
+          .slaveLatency = slaveLatency,
+          .supervisionTimeout = supervisionTimeout,
+          .maxTxOctets = currentMaxTxOctets,
+          .throughput = throughput,
+          .peakThroughput = peakThroughput,
+          .transferBytes = transferBytes,
+          .fastRequests = fastRequests};
+}
+
+void LinkPolicy::RequestFastLink() {
+  mode = Modes::Fast;
+  fastRequests++;
+  xTimerStart(timer, 0);
+
+  // The requests are independent, the central may accept only some of them
+  if (ble_gap_set_prefered_le_phy(connectionHandle, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_CODED_ANY) != 0) {
+    NRF_LOG_INFO("[LinkPolicy] 2M PHY request failed");
+  }
+  if (ble_hs_hci_util_set_data_len(connectionHandle, maxTxOctets, maxTxTime) == 0) {
+    currentMaxTxOctets = maxTxOctets;
+  }
+  if (ble_gap_update_params(connectionHandle, &fastParameters) != 0) {
+    NRF_LOG_INFO("[LinkPolicy] fast connection parameters request failed");
+  }
+}
+
+void LinkPolicy::RequestLowPowerLink() {
+  mode = Modes::LowPower;
+  throughput = 0;
+  xTimerStop(timer, 0);
+  if (ble_gap_update_params(connectionHandle, &lowPowerParameters) != 0) {
+    NRF_LOG_INFO("[LinkPolicy] low power connection parameters request failed");
+  }
+}
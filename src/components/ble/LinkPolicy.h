@@ -0,0 +1,101 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <timers.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Tunes the link for the bulk transfers (DFU, file system, remote fonts) : the first packet of a transfer requests
+     * the 2M PHY, the largest data length and a short connection interval. Once no packet was received or sent for
+     * idleTimeout, a longer connection interval with slave latency is requested.
+     */
+    class LinkPolicy {
+    public:
+      enum class Transfers : uint8_t { Dfu, FileSystem, RemoteFont };
+      enum class Modes : uint8_t { Default, Fast, LowPower };
+
+      struct Parameters {
+        Modes mode;
+        // Last transfer that requested the fast link
+        Transfers transfer;
+        uint8_t txPhy;
+        uint8_t rxPhy;
+        // Units of 1.25ms
+        uint16_t connectionInterval;
+        uint16_t slaveLatency;
+        // Units of 10ms
+        uint16_t supervisionTimeout;
+        uint16_t maxTxOctets;
+        // Bytes per second during the last second of transfer, and the maximum since the connection
+        uint32_t throughput;
+        uint32_t peakThroughput;
+        uint32_t transferBytes;
+        uint32_t fastRequests;
+      };
+
+      LinkPolicy();
+
+      void OnConnect(uint16_t connectionHandle);
+      void OnDisconnect();
+      void OnConnectionUpdated(uint16_t connectionHandle);
+      void OnPhyUpdated(uint8_t txPhy, uint8_t rxPhy);
+
+      // Called by the services for each packet of a bulk transfer
+      void OnTransferActivity(Transfers transfer, size_t bytes);
+      void OnTimer();
+
+      Parameters GetParameters() const;
+
+    private:
+      void RequestFastLink();
+      void RequestLowPowerLink();
+
+      static constexpr TickType_t throughputPeriod = pdMS_TO_TICKS(1000);
+      static constexpr TickType_t idleTimeout = pdMS_TO_TICKS(3000);
+      // Data length extension : 251 bytes per packet (2120us at 1Mbps)
+      static constexpr uint16_t maxTxOctets = 251;
+      static constexpr uint16_t maxTxTime = 2120;
+
+      // Within the limits accepted by iOS and Android
+      static constexpr ble_gap_upd_params fastParameters {.itvl_min = 12,
+                                                          .itvl_max = 24,
+                                                          .latency = 0,
+                                                          .supervision_timeout = 400,
+                                                          .min_ce_len = 0,
+                                                          .max_ce_len = 0};
+      static constexpr ble_gap_upd_params lowPowerParameters {.itvl_min = 24,
+                                                              .itvl_max = 40,
+                                                              .latency = 4,
+                                                              .supervision_timeout = 500,
+                                                              .min_ce_len = 0,
+                                                              .max_ce_len = 0};
+
+      TimerHandle_t timer;
+      std::atomic<uint16_t> connectionHandle {BLE_HS_CONN_HANDLE_NONE};
+      std::atomic<Modes> mode {Modes::Default};
+      std::atomic<Transfers> transfer {Transfers::Dfu};
+      std::atomic<TickType_t> lastActivity {0};
+      std::atomic<uint32_t> windowBytes {0};
+
+      // Written by the BLE host and the timer task, read by the diagnostics service
+      std::atomic<uint32_t> throughput {0};
+      std::atomic<uint32_t> peakThroughput {0};
+      std::atomic<uint32_t> transferBytes {0};
+      std::atomic<uint32_t> fastRequests {0};
+      std::atomic<uint16_t> currentMaxTxOctets {27};
+      uint8_t txPhy = BLE_GAP_LE_PHY_1M;
+      uint8_t rxPhy = BLE_GAP_LE_PHY_1M;
+      uint16_t connectionInterval = 0;
+      uint16_t slaveLatency = 0;
+      uint16_t supervisionTimeout = 0;
+    };
+  }
+}
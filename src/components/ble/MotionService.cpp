@@ -1,6 +1,8 @@
 #include "components/ble/MotionService.h"
 #include "components/motion/MotionController.h"
 #include "components/ble/NimbleController.h"
+#include <algorithm>
+#include <cstring>
 #include <nrf_log.h>
 
 using namespace Pinetime::Controllers;
@@ -20,11 +22,31 @@ namespace {
   constexpr ble_uuid128_t motionServiceUuid {BaseUuid()};
   constexpr ble_uuid128_t stepCountCharUuid {CharUuid(0x01, 0x00)};
   constexpr ble_uuid128_t motionValuesCharUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t streamCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t streamControlCharUuid {CharUuid(0x04, 0x00)};
 
   int MotionServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto* motionService = static_cast<MotionService*>(arg);
     return motionService->OnStepCountRequested(attr_handle, ctxt);
   }
+
+  int StreamControlCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* motionService = static_cast<MotionService*>(arg);
+    return motionService->OnStreamControl(attr_handle, ctxt);
+  }
+
+  template <class T>
+  uint8_t* Append(uint8_t* buffer, T value) {
+    std::memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+  }
+
+  uint32_t TicksToMs(TickType_t ticks) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(ticks) * 1000) / configTICK_RATE_HZ);
+  }
+
+  constexpr uint16_t samplePeriodMs = 1000 / MotionController::samplingFrequency;
+  static_assert(1000 % MotionController::samplingFrequency == 0);
 }
 
 // TODO Refactoring - remove dependency to SystemTask
@@ -41,6 +63,16 @@ MotionService::MotionService(NimbleController& nimble, Controllers::MotionContro
                                .arg = this,
                                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                .val_handle = &motionValuesHandle},
+                              {.uuid = &streamCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_NOTIFY,
+                               .val_handle = &streamHandle},
+                              {.uuid = &streamControlCharUuid.u,
+                               .access_cb = StreamControlCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &streamControlHandle},
                               {0}},
     serviceDefinition {
       {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &motionServiceUuid.u, .characteristics = characteristicDefinition},
@@ -107,11 +139,139 @@ void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
   ble_gattc_notify_custom(connectionHandle, motionValuesHandle, om);
 }
 
+void MotionService::OnNewMotionSamples(const Pinetime::Drivers::Bma421::Sample* samples, size_t count, TickType_t lastSampleTime) {
+  if (!streamNotificationEnabled)
+    return;
+
+  if (streamRestart.exchange(false)) {
+    streamCount = 0;
+    decimationCounter = 0;
+  }
+
+  const uint8_t decimation = streamDecimation;
+  for (size_t i = 0; i < count; i++) {
+    if (decimationCounter != 0) {
+      decimationCounter = (decimationCounter + 1) % decimation;
+      continue;
+    }
+    decimationCounter = (decimation > 1) ? 1 : 0;
+
+    if (streamCount == 0) {
+      // The batch size is evaluated at the beginning of each packet, the MTU may have changed since the last one
+      const size_t maxBatch = MaxStreamBatch();
+      const size_t requested = streamBatch;
+      streamTarget = (requested == 0) ? maxBatch : std::min(requested, maxBatch);
+
+      const TickType_t sampleTime = lastSampleTime - (((count - 1 - i) * configTICK_RATE_HZ) / MotionController::samplingFrequency);
+      uint8_t* header = Append(streamPacket.data() + 2, static_cast<uint16_t>(samplePeriodMs * decimation));
+      Append(header, TicksToMs(sampleTime));
+    }
+
+    uint8_t* entry = streamPacket.data() + streamHeaderSize + (streamCount * streamSampleSize);
+    entry = Append(entry, samples[i].x);
+    entry = Append(entry, samples[i].y);
+    Append(entry, samples[i].z);
+    streamCount++;
+
+    if (streamCount >= streamTarget) {
+      SendStreamPacket();
+    }
+  }
+}
+
+void MotionService::SendStreamPacket() {
+  Append(streamPacket.data(), static_cast<uint16_t>(streamSequence));
+  streamPacket[streamHeaderSize - 1] = static_cast<uint8_t>(streamCount);
+  const size_t size = streamHeaderSize + (streamCount * streamSampleSize);
+  const size_t nbSamples = streamCount;
+  // The sequence number is incremented for the dropped packets too : the client detects the losses from the gaps
+  streamSequence++;
+  streamCount = 0;
+
+  uint16_t connectionHandle = nimble.connHandle();
+  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    streamPacketsDropped++;
+    return;
+  }
+
+  auto* om = ble_hs_mbuf_from_flat(streamPacket.data(), size);
+  if (om == nullptr || ble_gattc_notify_custom(connectionHandle, streamHandle, om) != 0) {
+    streamPacketsDropped++;
+    return;
+  }
+  streamPacketsSent++;
+  streamSamplesSent += nbSamples;
+}
+
+size_t MotionService::MaxStreamBatch() const {
+  uint16_t connectionHandle = nimble.connHandle();
+  uint16_t mtu = BLE_ATT_MTU_DFLT;
+  if (connectionHandle != 0 && connectionHandle != BLE_HS_CONN_HANDLE_NONE) {
+    mtu = std::max<uint16_t>(ble_att_mtu(connectionHandle), BLE_ATT_MTU_DFLT);
+  }
+  return std::clamp<size_t>((mtu - 3 - streamHeaderSize) / streamSampleSize, 1, maxStreamBatch);
+}
+
+int MotionService::OnStreamControl(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle != streamControlHandle) {
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    // Requested rate (Hz, 0 for the sampling frequency) and batch size (0 for as many samples as the MTU allows)
+    uint8_t request[2];
+    if (OS_MBUF_PKTLEN(context->om) != sizeof(request) || os_mbuf_copydata(context->om, 0, sizeof(request), request) != 0) {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    // The samples are decimated : the rate is rounded to a divisor of the sampling frequency
+    uint16_t decimation = 1;
+    if (request[0] != 0) {
+      decimation = (MotionController::samplingFrequency + (request[0] / 2)) / request[0];
+    }
+    streamDecimation = std::clamp<uint16_t>(decimation, 1, UINT8_MAX);
+    streamBatch = request[1];
+    streamRestart = true;
+    NRF_LOG_INFO("[Motion] stream : %d ms, batch %d", samplePeriodMs * streamDecimation, request[1]);
+    return 0;
+  }
+
+  if (context->op != BLE_GATT_ACCESS_OP_READ_CHR) {
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+
+  uint16_t connectionInterval = 0;
+  uint16_t connectionHandle = nimble.connHandle();
+  ble_gap_conn_desc desc;
+  if (connectionHandle != 0 && connectionHandle != BLE_HS_CONN_HANDLE_NONE && ble_gap_conn_find(connectionHandle, &desc) == 0) {
+    connectionInterval = desc.conn_itvl;
+  }
+
+  std::array<uint8_t, streamControlSize> buffer;
+  uint8_t* entry = buffer.data();
+  entry = Append(entry, streamControlVersion);
+  entry = Append(entry, static_cast<uint8_t>(MotionController::samplingFrequency));
+  entry = Append(entry, static_cast<uint16_t>(samplePeriodMs * streamDecimation));
+  entry = Append(entry, static_cast<uint8_t>(streamBatch));
+  entry = Append(entry, static_cast<uint8_t>(MaxStreamBatch()));
+  entry = Append(entry, connectionInterval);
+  entry = Append(entry, static_cast<uint16_t>(streamSequence));
+  entry = Append(entry, static_cast<uint32_t>(streamSamplesSent));
+  entry = Append(entry, static_cast<uint32_t>(streamPacketsSent));
+  Append(entry, static_cast<uint32_t>(streamPacketsDropped));
+
+  int res = os_mbuf_append(context->om, buffer.data(), buffer.size());
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
 void MotionService::SubscribeNotification(uint16_t attributeHandle) {
   if (attributeHandle == stepCountHandle)
     stepCountNoficationEnabled = true;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = true;
+  else if (attributeHandle == streamHandle) {
+    streamRestart = true;
+    streamNotificationEnabled = true;
+  }
 }
 
 void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
@@ -119,8 +279,10 @@ void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
     stepCountNoficationEnabled = false;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = false;
+  else if (attributeHandle == streamHandle)
+    streamNotificationEnabled = false;
 }
 
 bool MotionService::IsMotionNotificationSubscribed() const {
-  return motionValuesNoficationEnabled;
+  return motionValuesNoficationEnabled || streamNotificationEnabled;
 }
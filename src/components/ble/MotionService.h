@@ -6,6 +6,10 @@
 #undef max
 #undef min
 
+#include <array>
+#include <FreeRTOS.h>
+#include "drivers/Bma421.h"
+
 namespace Pinetime {
   namespace Controllers {
     class NimbleController;
@@ -18,22 +22,56 @@ namespace Pinetime {
       int OnStepCountRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnNewStepCountValue(uint32_t stepCount);
       void OnNewMotionValues(int16_t x, int16_t y, int16_t z);
+      // Samples acquired at MotionController::samplingFrequency, the last one at lastSampleTime
+      void OnNewMotionSamples(const Pinetime::Drivers::Bma421::Sample* samples, size_t count, TickType_t lastSampleTime);
+      int OnStreamControl(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
 
       void SubscribeNotification(uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t attributeHandle);
       bool IsMotionNotificationSubscribed() const;
 
     private:
+      // Stream packet : sequence number (2 bytes), sample period in ms (2 bytes), time of the first sample in ms (4 bytes),
+      // number of samples (1 byte), followed by the samples (X, Y, Z)
+      static constexpr size_t streamHeaderSize = 9;
+      static constexpr size_t streamSampleSize = 3 * sizeof(int16_t);
+      // ATT notification header : 3 bytes
+      static constexpr size_t maxStreamBatch = (MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3 - streamHeaderSize) / streamSampleSize;
+      static constexpr uint8_t streamControlVersion = 1;
+      static constexpr size_t streamControlSize = 22;
+
+      void SendStreamPacket();
+      size_t MaxStreamBatch() const;
+
       NimbleController& nimble;
       Controllers::MotionController& motionController;
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
+      struct ble_gatt_chr_def characteristicDefinition[5];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t stepCountHandle;
       uint16_t motionValuesHandle;
+      uint16_t streamHandle;
+      uint16_t streamControlHandle;
       std::atomic_bool stepCountNoficationEnabled {false};
       std::atomic_bool motionValuesNoficationEnabled {false};
+      std::atomic_bool streamNotificationEnabled {false};
+
+      // Written by the BLE host through the control characteristic, applied by the system task
+      std::atomic_uint8_t streamDecimation {1};
+      std::atomic_uint8_t streamBatch {0};
+      std::atomic_bool streamRestart {true};
+
+      // Owned by the system task
+      std::array<uint8_t, streamHeaderSize + (maxStreamBatch * streamSampleSize)> streamPacket;
+      size_t streamCount = 0;
+      size_t streamTarget = 0;
+      uint8_t decimationCounter = 0;
+
+      std::atomic_uint16_t streamSequence {0};
+      std::atomic_uint32_t streamSamplesSent {0};
+      std::atomic_uint32_t streamPacketsSent {0};
+      std::atomic_uint32_t streamPacketsDropped {0};
     };
   }
 }
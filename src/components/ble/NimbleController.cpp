@@ -30,17 +30,21 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
                                    Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                                    HeartRateController& heartRateController,
                                    MotionController& motionController,
-                                   FS& fs)
+                                   FS& fs,
+                                   const DisplayStatistics& displayStatistics,
+                                   const Pinetime::System::TaskStatistics& taskStatistics,
+                                   const Pinetime::Components::LvglPool& lvglPool,
+                                   HeartRateHistory& heartRateHistory)
   : systemTask {systemTask},
     bleController {bleController},
     dateTimeController {dateTimeController},
     spiNorFlash {spiNorFlash},
     fs {fs},
-    dfuService {systemTask, bleController, spiNorFlash},
+    dfuService {systemTask, bleController, spiNorFlash, linkPolicy},
 
     currentTimeClient {dateTimeController},
     anService {systemTask, notificationManager},
-    remoteFont {*this, fs},
+    remoteFont {systemTask, *this, fs, linkPolicy},
     alertNotificationClient {systemTask, notificationManager},
     currentTimeService {dateTimeController},
     musicService {*this},
@@ -49,7 +53,9 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
     immediateAlertService {systemTask, notificationManager},
     heartRateService {*this, heartRateController},
     motionService {*this, motionController},
-    fsService {systemTask, fs},
+    fsService {systemTask, fs, linkPolicy},
+    diagnosticsService {displayStatistics, taskStatistics, lvglPool, linkPolicy},
+    heartRateHistoryService {heartRateHistory},
     serviceDiscovery({&currentTimeClient, &alertNotificationClient}) {
 }
 
@@ -100,6 +106,11 @@ void NimbleController::Init() {
   heartRateService.Init();
   motionService.Init();
   fsService.Init();
+#ifdef FS_TRANSFER_BENCHMARK
+  fsService.RunTransferBenchmark();
+#endif
+  diagnosticsService.Init();
+  heartRateHistoryService.Init();
 
   int rc;
   rc = ble_hs_util_ensure_addr(0);
@@ -208,6 +219,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
         StartAdvertising();
       } else {
         connectionHandle = event->connect.conn_handle;
+        linkPolicy.OnConnect(connectionHandle);
         bleController.Connect();
         systemTask.PushMessage(Pinetime::System::Messages::BleConnected);
         // Service discovery is deferred via systemtask
@@ -225,6 +237,9 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
       currentTimeClient.Reset();
       alertNotificationClient.Reset();
+      remoteFont.OnDisconnect();
+      fsService.OnDisconnect();
+      linkPolicy.OnDisconnect();
       connectionHandle = BLE_HS_CONN_HANDLE_NONE;
       if (bleController.IsConnected()) {
         bleController.Disconnect();
@@ -237,6 +252,9 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
       /* The central has updated the connection parameters. */
       NRF_LOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE");
       NRF_LOG_INFO("update status=%0X ", event->conn_update.status);
+      if (event->conn_update.status == 0) {
+        linkPolicy.OnConnectionUpdated(event->conn_update.conn_handle);
+      }
       break;
 
     case BLE_GAP_EVENT_CONN_UPDATE_REQ:
@@ -249,6 +267,14 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
                    event->conn_update_req.peer_params->supervision_timeout);
       break;
 
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+      NRF_LOG_INFO("PHY event : BLE_GAP_EVENT_PHY_UPDATE_COMPLETE");
+      NRF_LOG_INFO("phy update status=%0X tx=%d rx=%d", event->phy_updated.status, event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+      if (event->phy_updated.status == 0) {
+        linkPolicy.OnPhyUpdated(event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+      }
+      break;
+
     case BLE_GAP_EVENT_ENC_CHANGE:
       /* Encryption has been enabled or disabled for this connection. */
       NRF_LOG_INFO("Security event : BLE_GAP_EVENT_ENC_CHANGE");
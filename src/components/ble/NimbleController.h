@@ -22,6 +22,9 @@
 #include "components/ble/NavigationService.h"
 #include "components/ble/ServiceDiscovery.h"
 #include "components/ble/MotionService.h"
+#include "components/ble/DiagnosticsService.h"
+#include "components/ble/HeartRateHistoryService.h"
+#include "components/ble/LinkPolicy.h"
 #include "components/ble/SimpleWeatherService.h"
 #include "components/fs/FS.h"
 
@@ -50,7 +53,11 @@ namespace Pinetime {
                        Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                        HeartRateController& heartRateController,
                        MotionController& motionController,
-                       FS& fs);
+                       FS& fs,
+                       const DisplayStatistics& displayStatistics,
+                       const Pinetime::System::TaskStatistics& taskStatistics,
+                       const Pinetime::Components::LvglPool& lvglPool,
+                       HeartRateHistory& heartRateHistory);
       void Init();
       void StartAdvertising();
       int OnGAPEvent(ble_gap_event* event);
@@ -72,6 +79,14 @@ namespace Pinetime {
         return weatherService;
       };
 
+      Pinetime::Controllers::RemoteFont& fonts() {
+        return remoteFont;
+      };
+
+      Pinetime::Controllers::FSService& fileTransfer() {
+        return fsService;
+      };
+
       uint16_t connHandle();
       void NotifyBatteryLevel(uint8_t level);
 
@@ -92,6 +107,7 @@ namespace Pinetime {
       DateTime& dateTimeController;
       Pinetime::Drivers::SpiNorFlash& spiNorFlash;
       FS& fs;
+      LinkPolicy linkPolicy;
       DfuService dfuService;
 
       DeviceInformationService deviceInformationService;
@@ -108,6 +124,8 @@ namespace Pinetime {
       HeartRateService heartRateService;
       MotionService motionService;
       FSService fsService;
+      DiagnosticsService diagnosticsService;
+      HeartRateHistoryService heartRateHistoryService;
       ServiceDiscovery serviceDiscovery;
 
       uint8_t addrType;
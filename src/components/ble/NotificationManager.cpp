@@ -1,123 +1,356 @@
 #include "components/ble/NotificationManager.h"
+#include "components/ble/RemoteFont.h"
+#include "components/fs/FS.h"
 #include <cstring>
 #include <algorithm>
-#include <cassert>
+#include <nrf_log.h>
 
 using namespace Pinetime::Controllers;
 
 constexpr uint8_t NotificationManager::MessageSize;
 
+namespace {
+  constexpr const char* storePath = "/.system/notifs.dat";
+}
+
+NotificationManager::NotificationManager(FS& fs) : fs {fs} {
+  mutex = xSemaphoreCreateRecursiveMutex();
+  pushMutex = xSemaphoreCreateMutex();
+}
+
+void NotificationManager::Init() {
+  fs.EnsureDirectory("/.system");
+
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  Reset();
+  xSemaphoreGiveRecursive(mutex);
+}
+
+void NotificationManager::Register(Pinetime::Controllers::RemoteFont* remoteFont) {
+  this->remoteFont = remoteFont;
+}
+
+void NotificationManager::Reset() {
+  fs.FileDelete(storePath);
+  oldestId = nextId;
+  firstArenaId = nextId;
+  size = 0;
+  arenaUsed = 0;
+  dismissed.fill(0);
+}
+
 void NotificationManager::Push(NotificationManager::Notification&& notif) {
-  notif.id = GetNextId();
-  notif.valid = true;
+  const uint16_t textSize = std::max<uint16_t>(1, std::min<uint16_t>(notif.size, MessageSize));
+  notif.message[textSize - 1] = '\0';
+  // Request the glyphs of the title and message now, so they are available when the notification is displayed
+  if (remoteFont != nullptr) {
+    remoteFont->Prefetch(notif.message.data(), textSize);
+  }
+
+  xSemaphoreTake(pushMutex, portMAX_DELAY);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  const Notification::Id id = nextId++;
+  if (static_cast<Notification::Id>(id - oldestId) >= TotalNbNotifications) {
+    // Overwrite the slot of the oldest notification
+    if (!IsDismissed(oldestId)) {
+      --size;
+    }
+    ++oldestId;
+  }
+  SetDismissed(id, false);
+
+  const size_t length = recordHeaderSize + textSize;
+  if (arenaUsed + length > arenaSize) {
+    MoveToSpillBuffer(arenaSize - spillMargin - length);
+  }
+  if (arenaUsed == 0) {
+    firstArenaId = id;
+  }
+  const RecordHeader header {id, textSize, notif.category, 0};
+  std::memcpy(arena.data() + arenaUsed, &header, recordHeaderSize);
+  std::memcpy(arena.data() + arenaUsed + recordHeaderSize, notif.message.data(), textSize);
+  arenaUsed += length;
+  ++size;
+  xSemaphoreGiveRecursive(mutex);
+
+  if (spillUsed > 0) {
+    SpillToFlash();
+  }
+  xSemaphoreGive(pushMutex);
+
   newNotification = true;
-  if (beginIdx > 0) {
-    --beginIdx;
-  } else {
-    beginIdx = notifications.size() - 1;
+}
+
+void NotificationManager::MoveToSpillBuffer(size_t targetUsed) {
+  size_t offset = 0;
+  while (arenaUsed - offset > targetUsed) {
+    offset += recordHeaderSize + ArenaHeader(offset).size;
+  }
+  std::memcpy(spillBuffer.data(), arena.data(), offset);
+  spillUsed = offset;
+
+  std::memmove(arena.data(), arena.data() + offset, arenaUsed - offset);
+  arenaUsed -= offset;
+  firstArenaId = (arenaUsed > 0) ? ArenaHeader(0).id : nextId;
+}
+
+// Called without the store locked : the spill buffer is only modified by Push(), and read by the other tasks
+void NotificationManager::SpillToFlash() {
+  lfs_file_t file;
+  const bool opened = fs.FileOpen(&file, storePath, LFS_O_WRONLY | LFS_O_CREAT) == LFS_ERR_OK;
+  for (size_t offset = 0; offset < spillUsed;) {
+    const RecordHeader header = Header(spillBuffer.data(), offset);
+    const size_t length = recordHeaderSize + header.size;
+    // Seeking after the end of the file extends it
+    if (!opened || fs.FileSeek(&file, (header.id % TotalNbNotifications) * slotSize) < 0 ||
+        fs.FileWrite(&file, spillBuffer.data() + offset, length) != static_cast<int>(length)) {
+      NRF_LOG_WARNING("[NotificationManager] Failed to store notification %d", header.id);
+      xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+      if (!IsDismissed(header.id)) {
+        SetDismissed(header.id, true);
+        --size;
+      }
+      xSemaphoreGiveRecursive(mutex);
+    }
+    offset += length;
   }
-  notifications[beginIdx] = std::move(notif);
-  if (size < notifications.size()) {
-    size++;
+  if (opened) {
+    fs.FileClose(&file);
   }
+
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  spillUsed = 0;
+  xSemaphoreGiveRecursive(mutex);
 }
 
-NotificationManager::Notification::Id NotificationManager::GetNextId() {
-  return nextId++;
+NotificationManager::RecordHeader NotificationManager::Header(const uint8_t* records, size_t offset) {
+  RecordHeader header {};
+  std::memcpy(&header, records + offset, recordHeaderSize);
+  return header;
 }
 
-NotificationManager::Notification NotificationManager::GetLastNotification() const {
-  if (this->IsEmpty()) {
-    return {};
+size_t NotificationManager::Find(const uint8_t* records, size_t used, Notification::Id id) {
+  size_t offset = 0;
+  while (offset < used) {
+    const RecordHeader header = Header(records, offset);
+    if (header.id == id) {
+      return offset;
+    }
+    offset += recordHeaderSize + header.size;
+  }
+  return used;
+}
+
+NotificationManager::RecordHeader NotificationManager::ArenaHeader(size_t offset) const {
+  return Header(arena.data(), offset);
+}
+
+size_t NotificationManager::FindInArena(Notification::Id id) const {
+  return Find(arena.data(), arenaUsed, id);
+}
+
+void NotificationManager::RemoveFromArena(size_t offset) {
+  const size_t length = recordHeaderSize + ArenaHeader(offset).size;
+  std::memmove(arena.data() + offset, arena.data() + offset + length, arenaUsed - offset - length);
+  arenaUsed -= length;
+  if (offset == 0) {
+    firstArenaId = (arenaUsed > 0) ? ArenaHeader(0).id : nextId;
   }
-  return this->At(0);
 }
 
-const NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
-  if (idx >= notifications.size()) {
-    assert(false);
-    return notifications.at(beginIdx); // this should not happen
+bool NotificationManager::IsStored(Notification::Id id) const {
+  return static_cast<Notification::Id>(id - oldestId) < static_cast<Notification::Id>(nextId - oldestId) && !IsDismissed(id);
+}
+
+bool NotificationManager::IsInArena(Notification::Id id) const {
+  return static_cast<Notification::Id>(id - oldestId) >= static_cast<Notification::Id>(firstArenaId - oldestId);
+}
+
+bool NotificationManager::IsDismissed(Notification::Id id) const {
+  const size_t slot = id % TotalNbNotifications;
+  return (dismissed[slot / 32] & (1UL << (slot % 32))) != 0;
+}
+
+void NotificationManager::SetDismissed(Notification::Id id, bool value) {
+  const size_t slot = id % TotalNbNotifications;
+  if (value) {
+    dismissed[slot / 32] |= (1UL << (slot % 32));
+  } else {
+    dismissed[slot / 32] &= ~(1UL << (slot % 32));
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
 }
 
-NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) {
-  if (idx >= notifications.size()) {
-    assert(false);
-    return notifications.at(beginIdx); // this should not happen
+bool NotificationManager::FindNewest(Notification::Id& id) const {
+  for (Notification::Id candidate = nextId; candidate != oldestId;) {
+    --candidate;
+    if (!IsDismissed(candidate)) {
+      id = candidate;
+      return true;
+    }
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  return false;
 }
 
-NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) const {
-  for (NotificationManager::Notification::Idx idx = 0; idx < this->size; idx++) {
-    const NotificationManager::Notification& notification = this->At(idx);
-    if (notification.id == id) {
-      return idx;
+bool NotificationManager::CopyFromRam(Notification::Id id, View& view) const {
+  const uint8_t* records;
+  size_t offset;
+  if (IsInArena(id)) {
+    records = arena.data();
+    offset = FindInArena(id);
+    if (offset == arenaUsed) {
+      return false;
+    }
+  } else {
+    records = spillBuffer.data();
+    offset = Find(records, spillUsed, id);
+    if (offset == spillUsed) {
+      return false;
     }
   }
-  return size;
+  const RecordHeader header = Header(records, offset);
+  std::memcpy(view.text.data(), records + offset + recordHeaderSize, header.size);
+  view.category = header.category;
+  view.size = header.size;
+  return true;
 }
 
-NotificationManager::Notification NotificationManager::Get(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+bool NotificationManager::ReadFromFlash(Notification::Id id, View& view) {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, storePath, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  RecordHeader header {};
+  int read = -1;
+  if (fs.FileSeek(&file, (id % TotalNbNotifications) * slotSize) >= 0 &&
+      fs.FileRead(&file, reinterpret_cast<uint8_t*>(&header), recordHeaderSize) == static_cast<int>(recordHeaderSize)) {
+    // The slot was reused if the notification was overwritten in the meantime
+    if (header.id == id && header.size > 0 && header.size <= MessageSize) {
+      read = fs.FileRead(&file, reinterpret_cast<uint8_t*>(view.text.data()), header.size);
+    }
+  }
+  fs.FileClose(&file);
+  if (read != static_cast<int>(header.size)) {
+    return false;
   }
-  return this->At(idx);
+  view.text[header.size - 1] = '\0';
+  view.category = header.category;
+  view.size = header.size;
+  return true;
 }
 
-NotificationManager::Notification NotificationManager::GetNext(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
+NotificationManager::View NotificationManager::Get(NotificationManager::Notification::Id id) {
+  View view;
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (!IsStored(id)) {
+    xSemaphoreGiveRecursive(mutex);
     return {};
   }
-  if (idx == 0 || idx > notifications.size()) {
+  const bool copied = CopyFromRam(id, view);
+  view.index = IndexOf(id);
+  view.count = size;
+  xSemaphoreGiveRecursive(mutex);
+
+  // The store is not locked while the flash memory is read
+  if (!copied && !ReadFromFlash(id, view)) {
     return {};
   }
-  return this->At(idx - 1);
+#ifdef NOTIFICATION_BENCHMARK
+  bytesCopied += view.size;
+#endif
+  view.valid = true;
+  view.id = id;
+  return view;
 }
 
-NotificationManager::Notification NotificationManager::GetPrevious(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
+NotificationManager::View NotificationManager::GetLastNotification() {
+  Notification::Id id;
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  const bool found = FindNewest(id);
+  xSemaphoreGiveRecursive(mutex);
+  if (!found) {
     return {};
   }
-  if (static_cast<size_t>(idx + 1) >= notifications.size()) {
+  return Get(id);
+}
+
+NotificationManager::View NotificationManager::GetNext(NotificationManager::Notification::Id id) {
+  Notification::Id nextNotificationId;
+  if (!FindNext(id, nextNotificationId)) {
     return {};
   }
-  return this->At(idx + 1);
+  return Get(nextNotificationId);
 }
 
-void NotificationManager::DismissIdx(NotificationManager::Notification::Idx idx) {
-  if (this->IsEmpty()) {
-    return;
+NotificationManager::View NotificationManager::GetPrevious(NotificationManager::Notification::Id id) {
+  Notification::Id previousId;
+  if (!FindPrevious(id, previousId)) {
+    return {};
   }
-  if (idx >= size) {
-    assert(false);
-    return; // this should not happen
+  return Get(previousId);
+}
+
+bool NotificationManager::FindNext(Notification::Id id, Notification::Id& nextNotificationId) {
+  bool found = false;
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (IsStored(id)) {
+    for (Notification::Id candidate = id + 1; candidate != nextId; ++candidate) {
+      if (!IsDismissed(candidate)) {
+        nextNotificationId = candidate;
+        found = true;
+        break;
+      }
+    }
   }
-  if (idx == 0) { // just remove the first element, don't need to change the other elements
-    notifications.at(beginIdx).valid = false;
-    beginIdx = (beginIdx + 1) % notifications.size();
-  } else {
-    // overwrite the specified entry by moving all later messages one index to the front
-    for (size_t i = idx; i < size - 1; ++i) {
-      this->At(i) = this->At(i + 1);
+  xSemaphoreGiveRecursive(mutex);
+  return found;
+}
+
+bool NotificationManager::FindPrevious(Notification::Id id, Notification::Id& previousId) {
+  bool found = false;
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (IsStored(id)) {
+    for (Notification::Id candidate = id; candidate != oldestId;) {
+      --candidate;
+      if (!IsDismissed(candidate)) {
+        previousId = candidate;
+        found = true;
+        break;
+      }
+    }
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return found;
+}
+
+NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  Notification::Idx idx = size;
+  if (IsStored(id)) {
+    idx = 0;
+    for (Notification::Id newer = id + 1; newer != nextId; ++newer) {
+      if (!IsDismissed(newer)) {
+        ++idx;
+      }
     }
-    this->At(size - 1).valid = false;
   }
-  --size;
+  xSemaphoreGiveRecursive(mutex);
+  return idx;
 }
 
 void NotificationManager::Dismiss(NotificationManager::Notification::Id id) {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return;
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (IsStored(id)) {
+    SetDismissed(id, true);
+    --size;
+    // The slot of a notification in flash is simply reused later
+    if (IsInArena(id)) {
+      const size_t offset = FindInArena(id);
+      if (offset != arenaUsed) {
+        RemoveFromArena(offset);
+      }
+    }
   }
-  this->DismissIdx(idx);
+  xSemaphoreGiveRecursive(mutex);
 }
 
 bool NotificationManager::AreNewNotificationsAvailable() const {
@@ -132,19 +365,24 @@ size_t NotificationManager::NbNotifications() const {
   return size;
 }
 
-const char* NotificationManager::Notification::Message() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
-    const char* ptr = (itField) + 1;
-    return ptr;
+const char* NotificationManager::View::Message() const {
+  if (size == 0) {
+    return "";
+  }
+  const char* itField = std::find(text.data(), text.data() + size - 1, '\0');
+  if (itField != text.data() + size - 1) {
+    return itField + 1;
   }
-  return const_cast<char*>(message.data());
+  return text.data();
 }
 
-const char* NotificationManager::Notification::Title() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
-    return message.data();
+const char* NotificationManager::View::Title() const {
+  if (size == 0) {
+    return {};
+  }
+  const char* itField = std::find(text.data(), text.data() + size - 1, '\0');
+  if (itField != text.data() + size - 1) {
+    return text.data();
   }
   return {};
 }
@@ -4,12 +4,29 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Controllers {
+    class RemoteFont;
+    class FS;
+
+    /**
+     * Store of the notifications received from the companion app.
+     *
+     * The most recent notifications are packed, oldest first, into a RAM arena of variable length records (recordHeaderSize
+     * bytes of header followed by the text). When a new notification does not fit, the oldest records are moved to a ring
+     * file of TotalNbNotifications slots of slotSize bytes (slot = id % TotalNbNotifications), a few at a time so that
+     * they are written together. The records are moved to a spill buffer with the store locked, and written to flash
+     * once it is unlocked. The notifications are read through a View, which holds a copy of the record.
+     *
+     * The store is emptied at boot. The RAM footprint does not depend on the number of notifications : only a bit per
+     * slot (dismissed notifications) is kept for the notifications in flash.
+     */
     class NotificationManager {
     public:
-      enum class Categories {
+      enum class Categories : uint8_t {
         Unknown,
         SimpleAlert,
         Email,
@@ -22,29 +39,56 @@ namespace Pinetime {
         HighProriotyAlert,
         InstantMessage
       };
-      static constexpr uint8_t MessageSize {100};
+      // Including the string terminator
+      static constexpr uint8_t MessageSize {250};
+      static constexpr uint16_t TotalNbNotifications = 512;
 
+      // Filled by the services that receive the notifications, and passed to Push()
       struct Notification {
-        using Id = uint8_t;
-        using Idx = uint8_t;
+        using Id = uint16_t;
+        using Idx = uint16_t;
 
+        // Title and message separated by '\0', or message only
         std::array<char, MessageSize + 1> message;
-        uint8_t size;
+        uint8_t size = 0;
         Categories category = Categories::Unknown;
-        Id id = 0;
-        bool valid = false;
+      };
 
+      // Copy of a stored notification : only the size of its text is copied, and the store is not locked once it is made
+      class View {
+      public:
         const char* Message() const;
         const char* Title() const;
+
+        bool valid = false;
+        Notification::Id id = 0;
+        Categories category = Categories::Unknown;
+        // Position from the newest notification (0), and number of notifications in the store
+        Notification::Idx index = 0;
+        size_t count = 0;
+
+      private:
+        friend class NotificationManager;
+
+        std::array<char, MessageSize> text;
+        uint16_t size = 0;
       };
 
+      explicit NotificationManager(FS& fs);
+
+      void Init();
+      void Register(Pinetime::Controllers::RemoteFont* remoteFont);
       void Push(Notification&& notif);
-      Notification GetLastNotification() const;
-      Notification Get(Notification::Id id) const;
-      Notification GetNext(Notification::Id id) const;
-      Notification GetPrevious(Notification::Id id) const;
+      View GetLastNotification();
+      View Get(Notification::Id id);
+      // Newer and older notifications
+      View GetNext(Notification::Id id);
+      View GetPrevious(Notification::Id id);
+      // Same as GetNext() and GetPrevious(), without reading the notification
+      bool FindNext(Notification::Id id, Notification::Id& nextId);
+      bool FindPrevious(Notification::Id id, Notification::Id& previousId);
       // Return the index of the notification with the specified id, if not found return NbNotifications()
-      Notification::Idx IndexOf(Notification::Id id) const;
+      Notification::Idx IndexOf(Notification::Id id);
       bool ClearNewNotificationFlag();
       bool AreNewNotificationsAvailable() const;
       void Dismiss(Notification::Id id);
@@ -59,19 +103,75 @@ namespace Pinetime {
 
       size_t NbNotifications() const;
 
+#ifdef NOTIFICATION_BENCHMARK
+      void RunBenchmark();
+#endif
+
     private:
+      struct RecordHeader {
+        Notification::Id id;
+        uint16_t size;
+        Categories category;
+        uint8_t reserved;
+      };
+
+      static constexpr size_t recordHeaderSize = sizeof(RecordHeader);
+      static constexpr size_t slotSize = 256;
+      static constexpr size_t arenaSize = 1024;
+      // Free space left in the arena after moving records to flash
+      static constexpr size_t spillMargin = arenaSize / 4;
+      static_assert(recordHeaderSize + MessageSize <= slotSize, "A record must fit in a slot");
+      static_assert(arenaSize - spillMargin >= slotSize, "A record must fit in the arena");
+      // Records are moved to flash while more than arenaSize - spillMargin - slotSize bytes are used : the last one starts
+      // before spillMargin + slotSize
+      static constexpr size_t spillBufferSize = spillMargin + 2 * slotSize;
+      // The oldest notification is always in flash when the store is full
+      static_assert(arenaSize / recordHeaderSize < TotalNbNotifications, "The arena holds too many records");
+      // The slot of an id does not change when the ids wrap around
+      static_assert((UINT16_MAX + 1) % TotalNbNotifications == 0, "TotalNbNotifications must divide the range of the ids");
+
+      void Reset();
+      bool IsStored(Notification::Id id) const;
+      bool IsInArena(Notification::Id id) const;
+      bool IsDismissed(Notification::Id id) const;
+      void SetDismissed(Notification::Id id, bool value);
+      static RecordHeader Header(const uint8_t* records, size_t offset);
+      // Offset of the record in records, used if not found
+      static size_t Find(const uint8_t* records, size_t used, Notification::Id id);
+      RecordHeader ArenaHeader(size_t offset) const;
+      size_t FindInArena(Notification::Id id) const;
+      void RemoveFromArena(size_t offset);
+      void MoveToSpillBuffer(size_t targetUsed);
+      void SpillToFlash();
+      bool FindNewest(Notification::Id& id) const;
+      bool CopyFromRam(Notification::Id id, View& view) const;
+      bool ReadFromFlash(Notification::Id id, View& view);
+
+      FS& fs;
+      // Protects the store. Push() holds pushMutex while it writes to the flash memory, without the store locked.
+      SemaphoreHandle_t mutex = nullptr;
+      SemaphoreHandle_t pushMutex = nullptr;
+
+      // Ids in [oldestId, nextId) are stored, in the arena from firstArenaId on, in flash before
       Notification::Id nextId {0};
-      Notification::Id GetNextId();
-      const Notification& At(Notification::Idx idx) const;
-      Notification& At(Notification::Idx idx);
-      void DismissIdx(Notification::Idx idx);
+      Notification::Id oldestId {0};
+      Notification::Id firstArenaId {0};
+      size_t size = 0; // number of stored notifications that are not dismissed
+
+      std::array<uint8_t, arenaSize> arena;
+      size_t arenaUsed = 0;
+      std::array<uint32_t, TotalNbNotifications / 32> dismissed {};
+      // Records moved out of the arena by Push(), readable until they are written to flash
+      std::array<uint8_t, spillBufferSize> spillBuffer;
+      size_t spillUsed = 0;
 
-      static constexpr uint8_t TotalNbNotifications = 5;
-      std::array<Notification, TotalNbNotifications> notifications;
-      size_t beginIdx = TotalNbNotifications - 1; // index of the newest notification
-      size_t size = 0;                            // number of valid notifications in buffer
+#ifdef NOTIFICATION_BENCHMARK
+      // Bytes copied to read the notifications
+      uint32_t bytesCopied = 0;
+#endif
 
       std::atomic<bool> newNotification {false};
+      Pinetime::Controllers::RemoteFont* remoteFont = nullptr;
     };
   }
 }
@@ -0,0 +1,99 @@
+#include "components/ble/NotificationManager.h"
+#include "utility/CycleCounter.h"
+#include <cstring>
+#include <algorithm>
+#include <nrf_log.h>
+
+#ifdef NOTIFICATION_BENCHMARK
+using namespace Pinetime::Controllers;
+
+namespace {
+  // Record of the previous store : 5 fixed size messages, returned by copy by Get(), GetNext() and GetPrevious()
+  struct LegacyNotification {
+    std::array<char, 101> message;
+    uint8_t size;
+    int category;
+    uint8_t id;
+    bool valid;
+  };
+}
+
+// Fills the store with 5, 50 and 500 notifications of random length, then browses them from the newest to the oldest as
+// Screens::Notifications does. The store is emptied at the end.
+void NotificationManager::RunBenchmark() {
+  static constexpr uint16_t counts[] = {5, 50, 500};
+  static constexpr size_t titleSize = 6;
+  static uint8_t lengths[TotalNbNotifications];
+
+  Utility::EnableCycleCounter();
+
+  for (const uint16_t count : counts) {
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    Reset();
+    xSemaphoreGiveRecursive(mutex);
+
+    uint32_t seed = 12345;
+    uint32_t pushCycles = 0;
+    for (uint16_t i = 0; i < count; i++) {
+      seed = seed * 1103515245 + 12345;
+      Notification notif;
+      notif.size = titleSize + 1 + ((seed >> 16) % (MessageSize - titleSize));
+      std::memset(notif.message.data(), 'a' + (i % 26), notif.size);
+      notif.message[titleSize - 1] = '\0';
+      notif.category = Categories::SimpleAlert;
+      lengths[i] = notif.size;
+
+      const uint32_t start = DWT->CYCCNT;
+      Push(std::move(notif));
+      pushCycles += DWT->CYCCNT - start;
+    }
+
+    size_t nbInArena = 0;
+    for (size_t offset = 0; offset < arenaUsed; offset += recordHeaderSize + ArenaHeader(offset).size) {
+      nbInArena++;
+    }
+
+    bytesCopied = 0;
+    uint32_t maxStepBytes = 0;
+    uint32_t browseCycles = 0;
+    uint32_t nbMismatches = 0;
+    uint16_t nbSteps = 0;
+    Notification::Id id = nextId - 1;
+    for (int i = count - 1; i >= 0; i--) {
+      const uint32_t stepBytes = bytesCopied;
+      const uint32_t start = DWT->CYCCNT;
+      {
+        View view = (i == count - 1) ? GetLastNotification() : GetPrevious(id);
+        browseCycles += DWT->CYCCNT - start;
+        if (!view.valid || view.size != lengths[i] || view.Title()[0] != 'a' + (i % 26) || view.index != count - 1 - i) {
+          nbMismatches++;
+        }
+        id = view.id;
+      }
+      maxStepBytes = std::max(maxStepBytes, bytesCopied - stepBytes);
+      nbSteps++;
+    }
+
+    NRF_LOG_INFO("[NotificationManager] %u notifications : %u in RAM (%u arena bytes), %u in flash, push %lu cycles",
+                 count,
+                 nbInArena,
+                 arenaUsed,
+                 count - nbInArena,
+                 pushCycles / count);
+    NRF_LOG_INFO("[NotificationManager] %lu bytes copied per step (max %lu, previous store %u), %lu cycles per step, %lu mismatches",
+                 bytesCopied / nbSteps,
+                 maxStepBytes,
+                 sizeof(LegacyNotification),
+                 browseCycles / nbSteps,
+                 nbMismatches);
+    NRF_LOG_INFO("[NotificationManager] RAM : %u bytes (%u bytes for an array of %u previous records)",
+                 sizeof(NotificationManager),
+                 count * sizeof(LegacyNotification),
+                 count);
+  }
+
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  Reset();
+  xSemaphoreGiveRecursive(mutex);
+}
+#endif
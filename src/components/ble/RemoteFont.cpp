@@ -2,7 +2,11 @@
 #include "components/ble/NimbleController.h"
 #include "RemoteFont.h"
 #include "components/fs/FS.h"
+#include "systemtask/SystemTask.h"
 #include <hal/nrf_rtc.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 using namespace Pinetime::Controllers;
 
@@ -21,27 +25,34 @@ namespace {
   constexpr ble_uuid128_t fontServiceUuid {BaseUuid()};
   constexpr ble_uuid128_t requestFontUuid {CharUuid(0x01, 0x00)};
   constexpr ble_uuid128_t downloadFontUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t downloadFontsUuid {CharUuid(0x03, 0x00)};
 
   int RemoteFontCallback(uint16_t /*conn_handle*/, uint16_t /*attr_handle*/, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto anService = static_cast<RemoteFont*>(arg);
-    return anService->OnDownloadFont(ctxt);
+    return anService->OnCommand(ctxt);
   }
 }
 
 namespace Pinetime {
   namespace Controllers {
-    RemoteFont::RemoteFont(NimbleController& nimble, FS& fs) : nimble {nimble}, fs {fs} {
+    RemoteFont::RemoteFont(Pinetime::System::SystemTask& systemTask, NimbleController& nimble, FS& fs, LinkPolicy& linkPolicy)
+      : systemTask {systemTask}, nimble {nimble}, fs {fs}, linkPolicy {linkPolicy}, cache {fs} {
       characteristicDefinition[0] = {.uuid = &requestFontUuid.u,
                                      .access_cb = RemoteFontCallback,
                                      .arg = this,
-                                     .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+                                     .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
                                      .val_handle = &eventHandle};
       characteristicDefinition[1] = {.uuid = &downloadFontUuid.u,
                                      .access_cb = RemoteFontCallback,
                                      .arg = this,
                                      .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
                                      .val_handle = nullptr};
-      characteristicDefinition[2] = {0};
+      characteristicDefinition[2] = {.uuid = &downloadFontsUuid.u,
+                                     .access_cb = RemoteFontCallback,
+                                     .arg = this,
+                                     .flags = BLE_GATT_CHR_F_WRITE,
+                                     .val_handle = nullptr};
+      characteristicDefinition[3] = {0};
 
       serviceDefinition[0] = {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &fontServiceUuid.u, .characteristics = characteristicDefinition};
       serviceDefinition[1] = {0};
@@ -54,321 +65,251 @@ namespace Pinetime {
       res = ble_gatts_add_svcs(serviceDefinition);
       ASSERT(res == 0);
       fs.DirCreate(FONT_DIR);
-      ClearAllFontCache();
+      RemoveLegacyFiles();
+      if (cache.Init() < 0) {
+        cache.Clear();
+      }
     }
 
-    int RemoteFont::GetFont(uint16_t codePoint, lfs_file_t* file) {
-      char file_name[6];
-      snprintf(file_name, sizeof(file_name), "%u", codePoint);
-      char fullPath[sizeof(FONT_DIR) + sizeof(file_name) + 1];
-      snprintf(fullPath, sizeof(fullPath), "%s/%s", FONT_DIR, file_name);
-      int result = fs.FileOpen(file, fullPath, LFS_O_RDONLY);
-      if (result < 0) {
-        return result;
-      }
-      CacheNodeMoveToTop(codePoint);
-      return result;
+    int RemoteFont::GetFont(uint16_t codePoint, uint8_t* buffer, size_t size) {
+      return cache.Read(codePoint, buffer, size);
     }
 
-    int RemoteFont::RequestFont(uint16_t codePoint) {
-      auto* om = ble_hs_mbuf_from_flat(&codePoint, 2);
+    int RemoteFont::GlyphSize(uint16_t codePoint) {
+      return cache.GlyphSize(codePoint);
+    }
 
+    int RemoteFont::RequestFont(uint16_t codePoint) {
       uint16_t connectionHandle = nimble.connHandle();
 
       if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
         return BLE_HS_ENOTCONN;
       }
 
+      auto* om = ble_hs_mbuf_from_flat(&codePoint, 2);
+      if (om == nullptr) {
+        return BLE_HS_ENOMEM;
+      }
       return ble_gattc_notify_custom(connectionHandle, eventHandle, om);
     }
 
-    int DeleteFonts(FS& fs, lfs_info& info) {
-      if (info.type == LFS_TYPE_REG) { // Ensure we only delete files
-        char fullPath[sizeof(RemoteFont::FONT_DIR) + sizeof(info.name) + 1];
-        snprintf(fullPath, sizeof(fullPath), "%s/%s", RemoteFont::FONT_DIR, info.name);
-        return fs.FileDelete(fullPath);
+    int RemoteFont::RequestFonts(const uint16_t* codePoints, size_t count) {
+      std::array<uint16_t, maxBatchRequest> missing;
+      size_t nbMissing = 0;
+      for (size_t i = 0; i < count && nbMissing < missing.size(); i++) {
+        if (cache.Contains(codePoints[i]) || std::find(missing.begin(), missing.begin() + nbMissing, codePoints[i]) != missing.begin() + nbMissing) {
+          continue;
+        }
+        missing[nbMissing++] = codePoints[i];
       }
-      return 0;
-    }
 
-    int RemoteFont::CacheNodeAppend(uint16_t codePoint) {
-      // open cache file and append codePoint in new line
-      int result;
-      uint16_t node = cacheStart;
-      uint16_t nextNode;
-      lfs_file_t cacheFile;
-      char cachePath[sizeof(FONT_DIR) + 6];
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, node);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      // read the first node
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&node), sizeof(node));
-      if (result < 0) {
-        // if file is empty, the next node is the end
-        nextNode = cacheEnd;
-      } else {
-        // read the next node
-        result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&nextNode), sizeof(nextNode));
-        if (result < 0) {
-          return result;
+      if (companionVersion < 2) {
+        for (size_t i = 0; i < nbMissing; i++) {
+          int result = RequestFont(missing[i]);
+          if (result != 0) {
+            return result;
+          }
         }
+        return 0;
       }
-      // update the start node
-      result = fs.FileSeek(&cacheFile, 0);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&codePoint), sizeof(codePoint));
-      if (result < 0) {
-        return result;
-      }
-      // create new node file, name is the codePoint, and write the start node and the next node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, codePoint);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&node), sizeof(node));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&nextNode), sizeof(nextNode));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileClose(&cacheFile);
-      if (result < 0) {
-        return result;
-      }
-      // update the next node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, nextNode);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
+
+      uint16_t connectionHandle = nimble.connHandle();
+      if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+        return BLE_HS_ENOTCONN;
       }
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&codePoint), sizeof(codePoint));
-      if (result < 0) {
-        return result;
+
+      // ATT notification header : 3 bytes, followed by the count
+      const uint16_t mtu = ble_att_mtu(connectionHandle);
+      const size_t perNotification = std::min<size_t>((std::max<uint16_t>(mtu, BLE_ATT_MTU_DFLT) - 3 - 1) / 2, maxBatchRequest);
+      std::array<uint8_t, 1 + 2 * maxBatchRequest> packet;
+      for (size_t first = 0; first < nbMissing; first += perNotification) {
+        const size_t n = std::min<size_t>(perNotification, nbMissing - first);
+        packet[0] = static_cast<uint8_t>(n);
+        for (size_t i = 0; i < n; i++) {
+          packet[1 + 2 * i] = static_cast<uint8_t>(missing[first + i] & 0xff);
+          packet[2 + 2 * i] = static_cast<uint8_t>(missing[first + i] >> 8);
+        }
+        auto* om = ble_hs_mbuf_from_flat(packet.data(), 1 + 2 * n);
+        if (om == nullptr) {
+          return BLE_HS_ENOMEM;
+        }
+        int result = ble_gattc_notify_custom(connectionHandle, eventHandle, om);
+        if (result != 0) {
+          return result;
+        }
       }
-      result = fs.FileClose(&cacheFile);
-      return result;
+      return 0;
     }
 
-    int RemoteFont::CacheNodeMoveToTop(uint16_t codePoint) {
-      uint16_t node;
-      lfs_file_t cacheFile;
-      char cachePath[sizeof(FONT_DIR) + 6];
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, codePoint);
-      int result = fs.FileOpen(&cacheFile, cachePath, LFS_O_RDONLY);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&node), sizeof(node));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileClose(&cacheFile);
-      if (result < 0) {
-        return result;
-      }
-      if (node == cacheStart) {
-        return 0;
+    void RemoteFont::Prefetch(const char* text, size_t size) {
+      std::array<uint16_t, maxBatchRequest> codePoints;
+      size_t count = 0;
+      size_t i = 0;
+      while (i < size && count < codePoints.size()) {
+        const auto lead = static_cast<uint8_t>(text[i]);
+        uint32_t codePoint;
+        size_t length;
+        if (lead < 0x80) {
+          codePoint = lead;
+          length = 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+          codePoint = lead & 0x1F;
+          length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+          codePoint = lead & 0x0F;
+          length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+          codePoint = lead & 0x07;
+          length = 4;
+        } else {
+          i++;
+          continue;
+        }
+        if (i + length > size) {
+          break;
+        }
+
+        bool valid = true;
+        for (size_t k = 1; k < length; k++) {
+          const auto continuation = static_cast<uint8_t>(text[i + k]);
+          if ((continuation & 0xC0) != 0x80) {
+            valid = false;
+            break;
+          }
+          codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+        i += valid ? length : 1;
+
+        if (!valid || codePoint > 0xFFFF || IsBuiltInGlyph(codePoint)) {
+          continue;
+        }
+        if (std::find(codePoints.begin(), codePoints.begin() + count, codePoint) == codePoints.begin() + count) {
+          codePoints[count++] = static_cast<uint16_t>(codePoint);
+        }
       }
-      result = CacheNodeDelete(codePoint);
-      if (result < 0) {
-        return result;
+
+      if (count > 0) {
+        RequestFonts(codePoints.data(), count);
       }
-      return CacheNodeAppend(codePoint);
     }
 
-    int RemoteFont::CacheNodeDelete(uint16_t node) {
-      lfs_file_t cacheFile;
-      char cachePath[sizeof(FONT_DIR) + 6];
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, node);
-      uint16_t lastNode;
-      uint16_t nextNode;
-      int result;
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_RDONLY);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&lastNode), sizeof(lastNode));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&nextNode), sizeof(nextNode));
-      if (result < 0) {
-        return result;
-      }
-      // delete the node file
-      result = fs.FileClose(&cacheFile);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileDelete(cachePath);
-      if (result < 0) {
-        return result;
-      }
-      // update the last node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, lastNode);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      // seek 2 bytes from the end
-      result = fs.FileSeek(&cacheFile, sizeof(lastNode));
-      if (result < 0) {
-        return result;
-      }
-      // write the next node to last node
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&nextNode), sizeof(nextNode));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileClose(&cacheFile);
-      // update the next node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, nextNode);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      // write the last node to next node
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&lastNode), sizeof(lastNode));
-      if (result < 0) {
-        return result;
-      }
-      return fs.FileClose(&cacheFile);
+    bool RemoteFont::IsBuiltInGlyph(uint16_t codePoint) {
+      // Ranges of jetbrains_mono_bold_20 (see displayapp/fonts/fonts.json), control characters are never drawn
+      return codePoint < 0x7F || codePoint == 0xB0 || (codePoint >= 0x410 && codePoint <= 0x44F) ||
+             (codePoint >= 0xF000 && codePoint <= 0xF8FF);
     }
 
-    int RemoteFont::CacheNodeRemoveOldest(uint16_t& oldestNode) {
-      uint16_t node = cacheEnd;
-      uint16_t lastNode;
-      uint16_t last2Node;
-      int result;
-      lfs_file_t cacheFile;
-      char cachePath[sizeof(FONT_DIR) + 6];
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, node);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&lastNode), sizeof(lastNode));
-      if (result < 0) {
-        return result;
-      }
-      oldestNode = lastNode;
-      result = fs.FileClose(&cacheFile);
-      if (result < 0) {
-        return result;
-      }
-      // open the last node file and read the next last node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, lastNode);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileRead(&cacheFile, reinterpret_cast<uint8_t*>(&last2Node), sizeof(last2Node));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileClose(&cacheFile);
-      // delete the last node file
-      result = fs.FileDelete(cachePath);
-      if (result < 0) {
-        return result;
-      }
-      // update the last2 node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, last2Node);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
-      }
-      // seek 2 bytes from the end
-      result = fs.FileSeek(&cacheFile, sizeof(last2Node));
-      if (result < 0) {
-        return result;
-      }
-      // write the end node to last2 node
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&cacheEnd), sizeof(cacheEnd));
-      if (result < 0) {
-        return result;
-      }
-      result = fs.FileClose(&cacheFile);
-      if (result < 0) {
-        return result;
+    void RemoteFont::OnDisconnect() {
+      cache.Checkpoint();
+      companionVersion = 1;
+    }
+
+    int DeleteLegacyFonts(FS& fs, lfs_info& info) {
+      // Glyphs used to be stored in one file per code point, only the pack and index files are kept now
+      if (info.type == LFS_TYPE_REG && strcmp(info.name, RemoteFontCache::packFileName) != 0 &&
+          strcmp(info.name, RemoteFontCache::indexFileName) != 0) {
+        char fullPath[sizeof(RemoteFont::FONT_DIR) + sizeof(info.name) + 1];
+        snprintf(fullPath, sizeof(fullPath), "%s/%s", RemoteFont::FONT_DIR, info.name);
+        return fs.FileDelete(fullPath);
       }
-      // update the end node
-      snprintf(cachePath, sizeof(cachePath), "%s/%u", FONT_DIR, cacheEnd);
-      result = fs.FileOpen(&cacheFile, cachePath, LFS_O_CREAT | LFS_O_RDWR);
-      if (result < 0) {
-        return result;
+      return 0;
+    }
+
+    int RemoteFont::RemoveLegacyFiles() {
+      return fs.DirList(FONT_DIR, DeleteLegacyFonts);
+    }
+
+    int RemoteFont::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
+      if (ble_uuid_cmp(ctxt->chr->uuid, &requestFontUuid.u) == 0) {
+        return OnProtocolVersion(ctxt);
       }
-      // write the last2 node to end node
-      result = fs.FileWrite(&cacheFile, reinterpret_cast<const uint8_t*>(&last2Node), sizeof(last2Node));
-      if (result < 0) {
-        return result;
+      linkPolicy.OnTransferActivity(LinkPolicy::Transfers::RemoteFont, OS_MBUF_PKTLEN(ctxt->om));
+      if (ble_uuid_cmp(ctxt->chr->uuid, &downloadFontsUuid.u) == 0) {
+        return OnDownloadFonts(ctxt);
       }
-      return fs.FileClose(&cacheFile);
+      return OnDownloadFont(ctxt);
     }
 
-    int RemoteFont::ClearAllFontCache() {
-      return fs.DirList(FONT_DIR, DeleteFonts);
+    int RemoteFont::OnProtocolVersion(struct ble_gatt_access_ctxt* ctxt) {
+      if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR) {
+        int res = os_mbuf_append(ctxt->om, &protocolVersion, sizeof(protocolVersion));
+        return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+      }
+      if (OS_MBUF_PKTLEN(ctxt->om) != 1) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+      uint8_t version;
+      os_mbuf_copydata(ctxt->om, 0, 1, &version);
+      companionVersion = std::clamp<uint8_t>(version, 1, protocolVersion);
+      return 0;
     }
 
     int RemoteFont::OnDownloadFont(struct ble_gatt_access_ctxt* ctxt) {
-      uint16_t codePoint = static_cast<uint16_t>(ctxt->om->om_data[0] << 8 | ctxt->om->om_data[1]);
-      char file_name[6];
-      snprintf(file_name, sizeof(file_name), "%u", codePoint);
-      char fullPath[sizeof(RemoteFont::FONT_DIR) + sizeof(file_name) + 1];
-      snprintf(fullPath, sizeof(fullPath), "%s/%s", FONT_DIR, file_name);
-      lfs_file_t file;
-      int result = fs.FileOpen(&file, fullPath, LFS_O_CREAT | LFS_O_RDWR | LFS_O_TRUNC);
-      if (result < 0) {
-        return result;
+      const uint16_t packetLength = OS_MBUF_PKTLEN(ctxt->om);
+      if (packetLength < 2) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
       }
+      uint8_t codePointBytes[2];
+      os_mbuf_copydata(ctxt->om, 0, 2, codePointBytes);
+      const uint16_t codePoint = RemoteFontProtocol::V1CodePoint(codePointBytes);
 
-      struct os_mbuf* om = ctxt->om;
-      uint8_t* data_ptr = om->om_data + 2;
-      uint16_t data_len = om->om_len - 2;
+      if (StoreGlyph(ctxt->om, 2, codePoint, packetLength - 2) < 0) {
+        return BLE_ATT_ERR_UNLIKELY;
+      }
+      systemTask.PushMessage(Pinetime::System::Messages::OnRemoteGlyphReceived);
+      return 0;
+    }
 
-      while (om != nullptr) {
-        int written = fs.FileWrite(&file, data_ptr, data_len);
-        if (written < 0) {
-          fs.FileClose(&file);
-          return written;
-        }
-        om = SLIST_NEXT(om, om_next);
-        if (om != nullptr) {
-          data_ptr = om->om_data;
-          data_len = om->om_len;
-        }
+    int RemoteFont::OnDownloadFonts(struct ble_gatt_access_ctxt* ctxt) {
+      uint16_t stored = 0;
+      int result = 0;
+
+      cache.BeginBatch();
+      const auto status = RemoteFontProtocol::ParseBatch(
+        OS_MBUF_PKTLEN(ctxt->om),
+        [ctxt](uint16_t offset, uint16_t size, uint8_t* buffer) {
+          os_mbuf_copydata(ctxt->om, offset, size, buffer);
+        },
+        [this, ctxt, &stored](const RemoteFontProtocol::BatchGlyph& glyph) {
+          if (StoreGlyph(ctxt->om, glyph.offset, glyph.codePoint, glyph.size) < 0) {
+            return false;
+          }
+          stored++;
+          return true;
+        });
+      if (status == RemoteFontProtocol::BatchStatus::Aborted) {
+        result = BLE_ATT_ERR_UNLIKELY;
+      } else if (status != RemoteFontProtocol::BatchStatus::Complete) {
+        result = BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+      if (cache.EndBatch() < 0 && result == 0) {
+        result = BLE_ATT_ERR_UNLIKELY;
       }
 
-      result = fs.FileClose(&file);
-      if (result < 0) {
-        return result;
+      if (stored > 0) {
+        systemTask.PushMessage(Pinetime::System::Messages::OnRemoteGlyphReceived);
       }
-      result = CacheNodeAppend(codePoint);
+      return result;
+    }
+
+    int RemoteFont::StoreGlyph(const struct os_mbuf* om, uint16_t offset, uint16_t codePoint, uint16_t size) {
+      int result = cache.InsertBegin(codePoint, size);
       if (result < 0) {
         return result;
       }
-      cacheSize++;
-      if (cacheSize > maxCacheSize) {
-        uint16_t oldestNode;
-        result = CacheNodeRemoveOldest(oldestNode);
-        if (result < 0) {
-          return result;
-        }
-        snprintf(fullPath, sizeof(fullPath), "%s/%u", FONT_DIR, oldestNode);
-        result = fs.FileDelete(fullPath);
+
+      uint8_t buffer[32];
+      uint16_t written = 0;
+      while (written < size) {
+        const uint16_t chunk = std::min<uint16_t>(sizeof(buffer), size - written);
+        os_mbuf_copydata(om, offset + written, chunk, buffer);
+        result = cache.InsertData(buffer, chunk);
         if (result < 0) {
           return result;
         }
-        cacheSize--;
+        written += chunk;
       }
-      return cacheSize;
+      return cache.InsertCommit();
     }
   }
-}
\ No newline at end of file
+}
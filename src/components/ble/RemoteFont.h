@@ -7,48 +7,74 @@
 
 #include <string>
 
+#include "components/ble/RemoteFontCache.h"
+#include "components/ble/RemoteFontProtocol.h"
 #include "components/fs/FS.h"
 
 namespace Pinetime {
+  namespace System {
+    class SystemTask;
+  }
+
   namespace Controllers {
     class NimbleController;
+    class LinkPolicy;
 
     class RemoteFont {
     public:
-      RemoteFont(NimbleController& nimble, FS& fs);
-      int OnDownloadFont(struct ble_gatt_access_ctxt* ctxt);
+      using GlyphHeader = RemoteFontProtocol::GlyphHeader;
+
+      /**
+       * Protocol versions, the companion selects the version it supports by writing it to the request characteristic.
+       *
+       * V1 : one glyph per request notification (code point, 2 bytes LE) and per write on the download characteristic
+       *      (code point, 2 bytes big endian, followed by the glyph payload). See RemoteFontProtocol for the byte order.
+       * V2 : request notifications carry a list of code points ([count][code point LE] * count), and the companion
+       *      can answer with several glyphs in a single write on the batch download characteristic
+       *      ([code point LE][payload size LE][payload] * n, see RemoteFontProtocol::ParseBatch()). A batch is stored in a
+       *      single file transaction.
+       */
+      static constexpr uint8_t protocolVersion = 2;
+
+      RemoteFont(Pinetime::System::SystemTask& systemTask, NimbleController& nimble, FS& fs, LinkPolicy& linkPolicy);
+      int OnCommand(struct ble_gatt_access_ctxt* ctxt);
 
       void Init();
-      int GetFont(uint16_t codePoint, lfs_file_t* file);
+      /// Copies the glyph of codePoint into buffer, returns the number of bytes copied or a negative LFS error
+      int GetFont(uint16_t codePoint, uint8_t* buffer, size_t size);
+      /// Returns the size of the glyph payload (GlyphHeader + bitmap), or a negative LFS error if it is not downloaded
+      int GlyphSize(uint16_t codePoint);
       int RequestFont(uint16_t codePoint);
+      /// Requests the glyphs that are not downloaded yet, in as few notifications as possible
+      int RequestFonts(const uint16_t* codePoints, size_t count);
+      /// Requests the glyphs needed to display text (UTF-8) that the built-in font does not provide
+      void Prefetch(const char* text, size_t size);
+      /// Writes the glyph index back to the flash memory and falls back to the V1 protocol
+      void OnDisconnect();
       // Font directory path
       static constexpr char const* const FONT_DIR = "/remote_fonts";
 
     private:
+      Pinetime::System::SystemTask& systemTask;
       NimbleController& nimble;
       FS& fs;
+      LinkPolicy& linkPolicy;
+      RemoteFontCache cache;
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
+      struct ble_gatt_chr_def characteristicDefinition[4];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t eventHandle;
+      uint8_t companionVersion = 1;
 
-      int CacheNodeAppend(uint16_t codePoint);
-      int CacheNodeMoveToTop(uint16_t codePoint);
-      int CacheNodeDelete(uint16_t node);
-      int CacheNodeRemoveOldest(uint16_t& oldestNode);
-      int ClearAllFontCache();
+      static constexpr size_t maxBatchRequest = 64;
 
-      // Attributes
-      static constexpr size_t maxCacheSize = 250;
-      // current cache size
-      size_t cacheSize = 0;
-      /**
-       * File containing the cache of code points
-       * Start -> Cache 1 <--> Cache 2 <--> Cache 3 <--> Cache 4 <--> Cache 5 <- End
-       */
-      static constexpr uint16_t const cacheStart = 0x0000;
-      static constexpr uint16_t const cacheEnd = 0xFFFF;
+      int OnProtocolVersion(struct ble_gatt_access_ctxt* ctxt);
+      int OnDownloadFont(struct ble_gatt_access_ctxt* ctxt);
+      int OnDownloadFonts(struct ble_gatt_access_ctxt* ctxt);
+      int StoreGlyph(const struct os_mbuf* om, uint16_t offset, uint16_t codePoint, uint16_t size);
+      int RemoveLegacyFiles();
+      static bool IsBuiltInGlyph(uint16_t codePoint);
     };
   }
 }
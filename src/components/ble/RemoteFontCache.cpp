@@ -0,0 +1,411 @@
+#include "components/ble/RemoteFontCache.h"
+#include <algorithm>
+#include <limits>
+
+using namespace Pinetime::Controllers;
+
+RemoteFontCache::RemoteFontCache(FS& fs) : fs {fs} {
+}
+
+int RemoteFontCache::Init() {
+  if (mutex == nullptr) {
+    mutex = xSemaphoreCreateRecursiveMutex();
+    ASSERT(mutex != nullptr);
+  }
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = Open();
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+bool RemoteFontCache::Contains(uint16_t codePoint) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  bool found = Find(codePoint) != nullptr;
+  xSemaphoreGiveRecursive(mutex);
+  return found;
+}
+
+int RemoteFontCache::GlyphSize(uint16_t codePoint) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  const Entry* entry = Find(codePoint);
+  int result = LFS_ERR_NOENT;
+  if (entry != nullptr) {
+    result = entry->size;
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int RemoteFontCache::Read(uint16_t codePoint, uint8_t* buffer, size_t bufferSize) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  Entry* entry = Find(codePoint);
+  if (entry == nullptr || !packOpened) {
+    xSemaphoreGiveRecursive(mutex);
+    return LFS_ERR_NOENT;
+  }
+
+  int result = fs.FileSeek(&packFile, entry->offset + sizeof(RecordHeader));
+  if (result >= 0) {
+    result = fs.FileRead(&packFile, buffer, std::min<size_t>(bufferSize, entry->size));
+  }
+  if (result >= 0) {
+    Touch(*entry);
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int RemoteFontCache::InsertBegin(uint16_t codePoint, uint16_t size) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (!packOpened) {
+    xSemaphoreGiveRecursive(mutex);
+    return LFS_ERR_BADF;
+  }
+
+  // The record is written after the last valid one; packSize is only updated on commit
+  RecordHeader header {codePoint, size};
+  int result = fs.FileSeek(&packFile, packSize);
+  if (result >= 0) {
+    result = fs.FileWrite(&packFile, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  }
+  if (result < 0) {
+    AbortInsert();
+    return result;
+  }
+
+  inserting = true;
+  pendingCodePoint = codePoint;
+  pendingSize = size;
+  pendingRemaining = size;
+  return 0;
+}
+
+int RemoteFontCache::InsertData(const uint8_t* data, size_t size) {
+  if (!inserting) {
+    return LFS_ERR_INVAL;
+  }
+  if (size > pendingRemaining) {
+    AbortInsert();
+    return LFS_ERR_INVAL;
+  }
+  int result = fs.FileWrite(&packFile, data, size);
+  if (result < 0) {
+    AbortInsert();
+    return result;
+  }
+  pendingRemaining -= size;
+  return result;
+}
+
+int RemoteFontCache::InsertCommit() {
+  if (!inserting) {
+    return LFS_ERR_INVAL;
+  }
+  if (pendingRemaining != 0) {
+    AbortInsert();
+    return LFS_ERR_INVAL;
+  }
+
+  Entry* previous = Find(pendingCodePoint);
+  if (previous != nullptr) {
+    Remove(previous);
+  }
+  Add(pendingCodePoint, pendingSize, packSize);
+  packSize += sizeof(RecordHeader) + pendingSize;
+  inserting = false;
+
+  int result = 0;
+  if (++insertsSinceCheckpoint >= checkpointInterval && batchDepth == 0) {
+    result = WriteBack();
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+void RemoteFontCache::BeginBatch() {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  batchDepth++;
+}
+
+int RemoteFontCache::EndBatch() {
+  batchDepth--;
+  int result = 0;
+  if (batchDepth == 0) {
+    result = WriteBack();
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int RemoteFontCache::Checkpoint() {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = WriteBack();
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int RemoteFontCache::Clear() {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  if (packOpened) {
+    fs.FileClose(&packFile);
+    packOpened = false;
+  }
+  fs.FileDelete(packPath);
+  fs.FileDelete(indexPath);
+  int result = Open();
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int RemoteFontCache::Open() {
+  entryCount = 0;
+  packSize = 0;
+  deadBytes = 0;
+  useClock = 0;
+  indexDirty = false;
+  compactNeeded = false;
+  insertsSinceCheckpoint = 0;
+
+  // The pack file only ever contains data that was synced by a checkpoint (or a previous compaction)
+  lfs_info info;
+  uint32_t fileSize = 0;
+  if (fs.Stat(packPath, &info) == LFS_ERR_OK) {
+    fileSize = info.size;
+  }
+
+  int result = fs.FileOpen(&packFile, packPath, LFS_O_CREAT | LFS_O_RDWR);
+  if (result < 0) {
+    return result;
+  }
+  packOpened = true;
+
+  // Records appended after the last index checkpoint are recovered by scanning the end of the pack file
+  int indexed = LoadIndex();
+  if (indexed < 0 || static_cast<uint32_t>(indexed) > fileSize) {
+    entryCount = 0;
+    deadBytes = 0;
+    useClock = 0;
+    indexed = 0;
+  }
+  packSize = indexed;
+  if (packSize < fileSize) {
+    ScanPack(packSize, fileSize);
+  }
+  return 0;
+}
+
+int RemoteFontCache::LoadIndex() {
+  lfs_file_t indexFile;
+  int result = fs.FileOpen(&indexFile, indexPath, LFS_O_RDONLY);
+  if (result < 0) {
+    return result;
+  }
+
+  IndexHeader header;
+  result = fs.FileRead(&indexFile, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+  if (result != sizeof(header) || header.magic != indexMagic || header.version != indexVersion || header.entryCount > maxEntries) {
+    fs.FileClose(&indexFile);
+    return LFS_ERR_CORRUPT;
+  }
+
+  const size_t entriesSize = header.entryCount * sizeof(Entry);
+  result = fs.FileRead(&indexFile, reinterpret_cast<uint8_t*>(entries.data()), entriesSize);
+  fs.FileClose(&indexFile);
+  if (result < 0 || static_cast<size_t>(result) != entriesSize) {
+    return LFS_ERR_CORRUPT;
+  }
+
+  entryCount = header.entryCount;
+  deadBytes = header.deadBytes;
+  useClock = header.useClock;
+  return static_cast<int>(header.packSize);
+}
+
+void RemoteFontCache::ScanPack(uint32_t from, uint32_t end) {
+  uint32_t offset = from;
+  RecordHeader header;
+  while (offset + sizeof(RecordHeader) <= end) {
+    if (fs.FileSeek(&packFile, offset) < 0) {
+      break;
+    }
+    if (fs.FileRead(&packFile, reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+      break;
+    }
+    // Truncated record : the glyph download was interrupted
+    if (offset + sizeof(RecordHeader) + header.size > end) {
+      break;
+    }
+
+    Entry* previous = Find(header.codePoint);
+    if (previous != nullptr) {
+      Remove(previous);
+    }
+    Add(header.codePoint, header.size, offset);
+    offset += sizeof(RecordHeader) + header.size;
+  }
+
+  packSize = offset;
+  indexDirty = true;
+  // Get rid of the garbage at the end of the file so that it is never mistaken for a record later on
+  if (offset != end) {
+    compactNeeded = true;
+  }
+}
+
+int RemoteFontCache::WriteBack() {
+  if (!packOpened) {
+    return LFS_ERR_BADF;
+  }
+  insertsSinceCheckpoint = 0;
+
+  const uint32_t liveBytes = packSize - deadBytes;
+  if (compactNeeded || (deadBytes > compactThreshold && deadBytes > liveBytes)) {
+    return Compact();
+  }
+  if (!indexDirty) {
+    return 0;
+  }
+
+  // The glyphs must be on the flash memory before the index refers to them
+  int result = fs.FileSync(&packFile);
+  if (result < 0) {
+    return result;
+  }
+  return WriteIndex();
+}
+
+int RemoteFontCache::Compact() {
+  lfs_file_t compactFile;
+  int result = fs.FileOpen(&compactFile, compactPath, LFS_O_CREAT | LFS_O_WRONLY | LFS_O_TRUNC);
+  if (result < 0) {
+    return result;
+  }
+
+  uint8_t buffer[64];
+  for (size_t i = 0; i < entryCount && result >= 0; i++) {
+    result = fs.FileSeek(&packFile, entries[i].offset);
+    size_t remaining = sizeof(RecordHeader) + entries[i].size;
+    while (remaining > 0 && result >= 0) {
+      const size_t chunk = std::min(remaining, sizeof(buffer));
+      result = fs.FileRead(&packFile, buffer, chunk);
+      if (result >= 0) {
+        result = fs.FileWrite(&compactFile, buffer, chunk);
+      }
+      remaining -= chunk;
+    }
+  }
+
+  if (result < 0) {
+    fs.FileClose(&compactFile);
+    fs.FileDelete(compactPath);
+    return result;
+  }
+
+  result = fs.FileClose(&compactFile);
+  if (result < 0) {
+    return result;
+  }
+  fs.FileClose(&packFile);
+  packOpened = false;
+  result = fs.Rename(compactPath, packPath);
+  if (result < 0) {
+    return result;
+  }
+  result = fs.FileOpen(&packFile, packPath, LFS_O_RDWR);
+  if (result < 0) {
+    return result;
+  }
+  packOpened = true;
+
+  uint32_t offset = 0;
+  for (size_t i = 0; i < entryCount; i++) {
+    entries[i].offset = offset;
+    offset += sizeof(RecordHeader) + entries[i].size;
+  }
+  packSize = offset;
+  deadBytes = 0;
+  compactNeeded = false;
+  return WriteIndex();
+}
+
+int RemoteFontCache::WriteIndex() {
+  lfs_file_t indexFile;
+  int result = fs.FileOpen(&indexFile, indexPath, LFS_O_CREAT | LFS_O_WRONLY | LFS_O_TRUNC);
+  if (result < 0) {
+    return result;
+  }
+
+  IndexHeader header {indexMagic, indexVersion, static_cast<uint16_t>(entryCount), packSize, deadBytes, useClock};
+  result = fs.FileWrite(&indexFile, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  if (result >= 0) {
+    result = fs.FileWrite(&indexFile, reinterpret_cast<const uint8_t*>(entries.data()), entryCount * sizeof(Entry));
+  }
+  if (result < 0) {
+    fs.FileClose(&indexFile);
+    return result;
+  }
+  result = fs.FileClose(&indexFile);
+  if (result >= 0) {
+    indexDirty = false;
+  }
+  return result;
+}
+
+void RemoteFontCache::AbortInsert() {
+  // Whatever was written after packSize is garbage now, make sure it won't survive the next checkpoint
+  inserting = false;
+  compactNeeded = true;
+  xSemaphoreGiveRecursive(mutex);
+}
+
+RemoteFontCache::Entry* RemoteFontCache::Find(uint16_t codePoint) {
+  Entry* end = entries.data() + entryCount;
+  Entry* it = std::lower_bound(entries.data(), end, codePoint, [](const Entry& entry, uint16_t value) {
+    return entry.codePoint < value;
+  });
+  if (it == end || it->codePoint != codePoint) {
+    return nullptr;
+  }
+  return it;
+}
+
+RemoteFontCache::Entry* RemoteFontCache::Add(uint16_t codePoint, uint16_t size, uint32_t offset) {
+  if (entryCount == maxEntries) {
+    Entry* oldest = std::min_element(entries.data(), entries.data() + entryCount, [](const Entry& a, const Entry& b) {
+      return a.lastUse < b.lastUse;
+    });
+    Remove(oldest);
+  }
+
+  Entry* end = entries.data() + entryCount;
+  Entry* it = std::lower_bound(entries.data(), end, codePoint, [](const Entry& entry, uint16_t value) {
+    return entry.codePoint < value;
+  });
+  std::move_backward(it, end, end + 1);
+  entryCount++;
+
+  it->codePoint = codePoint;
+  it->size = size;
+  it->offset = offset;
+  Touch(*it);
+  return it;
+}
+
+void RemoteFontCache::Remove(Entry* entry) {
+  deadBytes += sizeof(RecordHeader) + entry->size;
+  std::move(entry + 1, entries.data() + entryCount, entry);
+  entryCount--;
+  indexDirty = true;
+}
+
+void RemoteFontCache::Touch(Entry& entry) {
+  if (useClock == std::numeric_limits<uint16_t>::max()) {
+    // Halving every timestamp keeps the LRU order
+    for (size_t i = 0; i < entryCount; i++) {
+      entries[i].lastUse /= 2;
+    }
+    useClock /= 2;
+  }
+  entry.lastUse = ++useClock;
+  indexDirty = true;
+}
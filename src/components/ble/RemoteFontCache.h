@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+#include "components/fs/FS.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Glyph store used by RemoteFont.
+     *
+     * All the glyphs are appended to a single pack file. The index (code point -> offset/size) and the LRU
+     * information are kept in RAM and only written back to the index file by Checkpoint(). A cache hit is a
+     * seek + read in the (already opened) pack file and never writes to the flash memory.
+     *
+     * Pack file  : [Record header][glyph data] [Record header][glyph data] ...
+     * Index file : [Index header][Entry * entryCount]
+     *
+     * Glyphs that are evicted or downloaded again leave dead records in the pack file; they are reclaimed by
+     * rewriting the live records into a new pack file once the dead space grows larger than the live data.
+     */
+    class RemoteFontCache {
+    public:
+      explicit RemoteFontCache(FS& fs);
+      RemoteFontCache(const RemoteFontCache&) = delete;
+      RemoteFontCache& operator=(const RemoteFontCache&) = delete;
+      RemoteFontCache(RemoteFontCache&&) = delete;
+      RemoteFontCache& operator=(RemoteFontCache&&) = delete;
+
+      /// Opens the pack file and loads the index (rebuilding it from the pack file if needed).
+      int Init();
+
+      bool Contains(uint16_t codePoint);
+      /// Returns the size of the glyph, or a negative LFS error if it is not in the cache.
+      int GlyphSize(uint16_t codePoint);
+      /// Copies up to bufferSize bytes of the glyph into buffer and marks it as recently used.
+      /// Returns the number of bytes copied or a negative LFS error.
+      int Read(uint16_t codePoint, uint8_t* buffer, size_t bufferSize);
+
+      /// Appends a new glyph to the pack file, evicting the least recently used glyph if the cache is full.
+      /// The data is written by one or more calls to InsertData() and the glyph is visible once InsertCommit()
+      /// returns. The cache is locked from InsertBegin() to InsertCommit().
+      int InsertBegin(uint16_t codePoint, uint16_t size);
+      int InsertData(const uint8_t* data, size_t size);
+      int InsertCommit();
+
+      /// Groups several inserts in one transaction : the pack file is synced and the index written once, by EndBatch().
+      void BeginBatch();
+      int EndBatch();
+
+      /// Writes the index back to the flash memory if it changed since the last checkpoint.
+      int Checkpoint();
+      int Clear();
+
+      size_t Count() const {
+        return entryCount;
+      }
+
+      static constexpr size_t maxEntries = 250;
+      static constexpr const char* packFileName = "glyphs.pak";
+      static constexpr const char* indexFileName = "glyphs.idx";
+      static constexpr const char* packPath = "/remote_fonts/glyphs.pak";
+      static constexpr const char* indexPath = "/remote_fonts/glyphs.idx";
+      static constexpr const char* compactPath = "/remote_fonts/glyphs.tmp";
+
+    private:
+      struct RecordHeader {
+        uint16_t codePoint;
+        uint16_t size;
+      };
+
+      struct Entry {
+        uint32_t offset; // offset of the RecordHeader in the pack file
+        uint16_t codePoint;
+        uint16_t size;
+        uint16_t lastUse;
+      };
+
+      struct IndexHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entryCount;
+        uint32_t packSize;
+        uint32_t deadBytes;
+        uint16_t useClock;
+      };
+
+      static constexpr uint32_t indexMagic = 0x48504c47; // "GLPH"
+      static constexpr uint16_t indexVersion = 1;
+      // Compact the pack file when it contains more dead bytes than this and than live bytes
+      static constexpr uint32_t compactThreshold = 16 * 1024;
+      // Number of inserts after which the index is written back even if nobody calls Checkpoint()
+      static constexpr uint8_t checkpointInterval = 16;
+
+      int Open();
+      int LoadIndex();
+      void ScanPack(uint32_t from, uint32_t end);
+      int WriteBack();
+      int Compact();
+      int WriteIndex();
+      void AbortInsert();
+      Entry* Find(uint16_t codePoint);
+      Entry* Add(uint16_t codePoint, uint16_t size, uint32_t offset);
+      void Remove(Entry* entry);
+      void Touch(Entry& entry);
+
+      FS& fs;
+      SemaphoreHandle_t mutex = nullptr;
+      lfs_file_t packFile;
+      bool packOpened = false;
+
+      // Sorted by code point
+      std::array<Entry, maxEntries> entries;
+      size_t entryCount = 0;
+      uint32_t packSize = 0;
+      uint32_t deadBytes = 0;
+      uint16_t useClock = 0;
+      bool indexDirty = false;
+      uint8_t insertsSinceCheckpoint = 0;
+      uint8_t batchDepth = 0;
+
+      bool compactNeeded = false;
+
+      bool inserting = false;
+      uint16_t pendingCodePoint = 0;
+      uint16_t pendingSize = 0;
+      uint32_t pendingRemaining = 0;
+    };
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Data exchanged with the companion by RemoteFont, kept apart from the BLE service so the display and the host tests
+     * can use it.
+     *
+     * Byte order : the code point of a V1 download is big endian, as written by the companions that implemented the first
+     * version of the protocol, and cannot change without breaking them. Everything else is little endian like the rest
+     * of BLE, including the V1 request notification (a uint16_t sent as is) : the V2 messages follow the requests.
+     */
+    namespace RemoteFontProtocol {
+      /**
+       * Glyph payload written by the companion after the 2-byte code point :
+       * a GlyphHeader followed by the bitmap (boxWidth * boxHeight pixels, bpp bits per pixel, rows packed without padding)
+       */
+      struct __attribute__((packed)) GlyphHeader {
+        uint8_t advanceWidth;
+        uint8_t boxWidth;
+        uint8_t boxHeight;
+        int8_t offsetX;
+        int8_t offsetY;
+        uint8_t bpp;
+      };
+
+      /// Size of the bitmap described by header, in bytes
+      constexpr uint32_t BitmapSize(const GlyphHeader& header) {
+        return (static_cast<uint32_t>(header.boxWidth) * header.boxHeight * header.bpp + 7) / 8;
+      }
+
+      /// True if header describes a bitmap that LVGL can draw from a payload of payloadSize bytes
+      constexpr bool IsValid(const GlyphHeader& header, uint32_t payloadSize) {
+        const bool validBpp = header.bpp == 1 || header.bpp == 2 || header.bpp == 4 || header.bpp == 8;
+        return validBpp && sizeof(GlyphHeader) + BitmapSize(header) <= payloadSize;
+      }
+
+      /// Code point of a V1 download (big endian)
+      constexpr uint16_t V1CodePoint(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] << 8 | data[1]);
+      }
+
+      constexpr uint16_t ReadLittleEndian16(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] | data[1] << 8);
+      }
+
+      /// Glyph of a V2 batch : its payload is the size bytes at offset in the write
+      struct BatchGlyph {
+        uint16_t codePoint;
+        uint16_t offset;
+        uint16_t size;
+      };
+
+      enum class BatchStatus : uint8_t {
+        Complete,
+        // A glyph header or payload goes past the end of the write
+        Truncated,
+        // A payload is smaller than a GlyphHeader
+        InvalidGlyph,
+        // onGlyph() refused a glyph
+        Aborted,
+      };
+
+      // [code point LE][payload size LE] before each payload of a V2 batch
+      static constexpr size_t batchHeaderSize = 4;
+
+      /**
+       * Splits a V2 batch write of length bytes into glyphs. copyData(offset, size, buffer) copies bytes of the write,
+       * onGlyph(const BatchGlyph&) is called for each glyph in order and returns false to stop. The glyphs before the
+       * first malformed one are passed to onGlyph().
+       */
+      template <class CopyData, class OnGlyph>
+      BatchStatus ParseBatch(uint16_t length, CopyData&& copyData, OnGlyph&& onGlyph) {
+        uint16_t offset = 0;
+        while (offset < length) {
+          if (length - offset < static_cast<int>(batchHeaderSize)) {
+            return BatchStatus::Truncated;
+          }
+          uint8_t header[batchHeaderSize];
+          copyData(offset, batchHeaderSize, header);
+          const BatchGlyph glyph {ReadLittleEndian16(header),
+                                  static_cast<uint16_t>(offset + batchHeaderSize),
+                                  ReadLittleEndian16(header + 2)};
+          if (glyph.size > length - glyph.offset) {
+            return BatchStatus::Truncated;
+          }
+          if (glyph.size < sizeof(GlyphHeader)) {
+            return BatchStatus::InvalidGlyph;
+          }
+          if (!onGlyph(glyph)) {
+            return BatchStatus::Aborted;
+          }
+          offset = glyph.offset + glyph.size;
+        }
+        return BatchStatus::Complete;
+      }
+    }
+  }
+}
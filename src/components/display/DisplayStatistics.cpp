@@ -0,0 +1,92 @@
+#include "components/display/DisplayStatistics.h"
+#include <FreeRTOS.h>
+#include <task.h>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  uint32_t CyclesToUs(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000);
+  }
+}
+
+void DisplayStatistics::RollingValue::Add(uint32_t value) {
+  last = value;
+  if (!initialized) {
+    averageX16 = value * 16;
+    initialized = true;
+  } else {
+    averageX16 = averageX16 - (averageX16 / 16) + value;
+  }
+
+  if (value > currentMax) {
+    currentMax = value;
+  }
+  if (++count == window) {
+    previousMax = currentMax;
+    currentMax = 0;
+    count = 0;
+  }
+}
+
+void DisplayStatistics::OnTaskHandler(uint32_t cycles) {
+  taskENTER_CRITICAL();
+  summary.taskHandlerUs.Add(CyclesToUs(cycles));
+  taskEXIT_CRITICAL();
+}
+
+void DisplayStatistics::OnFrame(Pinetime::Applications::Apps app, Pinetime::Applications::WatchFace watchFace, const Frame& frame) {
+  taskENTER_CRITICAL();
+  summary.frames++;
+  summary.renderUs.Add(CyclesToUs(frame.renderCycles));
+  summary.flushUs.Add(CyclesToUs(frame.flushCycles));
+  summary.frameUs.Add(CyclesToUs(frame.frameCycles));
+  summary.bytesPerFrame.Add(frame.bytes);
+  summary.areasPerFrame.Add(frame.areas);
+
+  bytesFlushed += frame.bytes;
+  summary.kilobytesFlushed += bytesFlushed / 1024;
+  bytesFlushed %= 1024;
+
+  const auto appIndex = static_cast<size_t>(app);
+  if (appIndex < appFrames.size()) {
+    appFrames[appIndex]++;
+  }
+  const auto watchFaceIndex = static_cast<size_t>(watchFace);
+  if (app == Pinetime::Applications::Apps::Clock && watchFaceIndex < watchFaceFrames.size()) {
+    watchFaceFrames[watchFaceIndex]++;
+  }
+  taskEXIT_CRITICAL();
+}
+
+void DisplayStatistics::OnAlwaysOnFramesDropped(uint32_t count) {
+  taskENTER_CRITICAL();
+  summary.droppedAlwaysOnFrames += count;
+  taskEXIT_CRITICAL();
+}
+
+DisplayStatistics::Summary DisplayStatistics::GetSummary() const {
+  taskENTER_CRITICAL();
+  Summary copy = summary;
+  taskEXIT_CRITICAL();
+  return copy;
+}
+
+uint32_t DisplayStatistics::AppFrames(Pinetime::Applications::Apps app) const {
+  const auto appIndex = static_cast<size_t>(app);
+  return (appIndex < appFrames.size()) ? appFrames[appIndex] : 0;
+}
+
+uint32_t DisplayStatistics::WatchFaceFrames(Pinetime::Applications::WatchFace watchFace) const {
+  const auto watchFaceIndex = static_cast<size_t>(watchFace);
+  return (watchFaceIndex < watchFaceFrames.size()) ? watchFaceFrames[watchFaceIndex] : 0;
+}
+
+void DisplayStatistics::Reset() {
+  taskENTER_CRITICAL();
+  summary = {};
+  bytesFlushed = 0;
+  appFrames.fill(0);
+  watchFaceFrames.fill(0);
+  taskEXIT_CRITICAL();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "displayapp/apps/Apps.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Rolling statistics about the refreshes of the display, to compare the cost of the screens.
+     *
+     * DisplayApp reports the duration of each call to lv_task_handler() and the statistics of each frame measured
+     * by LittleVgl. They are read by SystemInfo and by the Diagnostics BLE service, from other tasks : the
+     * statistics are updated and copied in critical sections.
+     */
+    class DisplayStatistics {
+    public:
+      // Average over the last ~16 samples, maximum over the last 64 to 128 samples
+      class RollingValue {
+      public:
+        void Add(uint32_t value);
+
+        uint32_t Last() const {
+          return last;
+        }
+
+        uint32_t Average() const {
+          return averageX16 / 16;
+        }
+
+        uint32_t Max() const {
+          return (currentMax > previousMax) ? currentMax : previousMax;
+        }
+
+      private:
+        static constexpr uint8_t window = 64;
+        uint32_t last = 0;
+        uint32_t averageX16 = 0;
+        uint32_t currentMax = 0;
+        uint32_t previousMax = 0;
+        uint8_t count = 0;
+        bool initialized = false;
+      };
+
+      struct Summary {
+        uint32_t frames = 0;
+        uint32_t droppedAlwaysOnFrames = 0;
+        uint32_t kilobytesFlushed = 0;
+        RollingValue taskHandlerUs; // lv_task_handler(), with or without a frame
+        RollingValue renderUs;      // rendering, without the time spent waiting for the display
+        RollingValue flushUs;       // sending the frame to the display
+        RollingValue frameUs;       // from the beginning of the refresh to the end of the last flush
+        RollingValue bytesPerFrame;
+        RollingValue areasPerFrame;
+      };
+
+      struct Frame {
+        uint32_t renderCycles;
+        uint32_t flushCycles;
+        uint32_t frameCycles;
+        uint32_t bytes;
+        uint8_t areas;
+      };
+
+      static constexpr size_t nbApps = static_cast<size_t>(Pinetime::Applications::Apps::Error) + 1;
+      static constexpr size_t maxWatchFaces = 8;
+
+      void OnTaskHandler(uint32_t cycles);
+      // The frames drawn by the watch face (Apps::Clock) are also counted per watch face
+      void OnFrame(Pinetime::Applications::Apps app, Pinetime::Applications::WatchFace watchFace, const Frame& frame);
+      void OnAlwaysOnFramesDropped(uint32_t count);
+
+      Summary GetSummary() const;
+      uint32_t AppFrames(Pinetime::Applications::Apps app) const;
+      uint32_t WatchFaceFrames(Pinetime::Applications::WatchFace watchFace) const;
+      void Reset();
+
+    private:
+      Summary summary;
+      uint32_t bytesFlushed = 0; // less than 1 KB, the rest is in summary.kilobytesFlushed
+      std::array<uint32_t, nbApps> appFrames = {};
+      std::array<uint32_t, maxWatchFaces> watchFaceFrames = {};
+    };
+  }
+}
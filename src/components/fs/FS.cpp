@@ -1,7 +1,7 @@
 #include "components/fs/FS.h"
+#include <algorithm>
 #include <cstring>
 #include <littlefs/lfs.h>
-#include <lvgl/lvgl.h>
 
 using namespace Pinetime::Controllers;
 
@@ -20,8 +20,8 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .block_count = size / blockSize,
       .block_cycles = 1000u,
 
-      .cache_size = 16,
-      .lookahead_size = 16,
+      .cache_size = FS_LFS_CACHE_SIZE,
+      .lookahead_size = FS_LFS_LOOKAHEAD_SIZE,
 
       .name_max = 50,
       .attr_max = 50,
@@ -29,6 +29,11 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
 }
 
 void FS::Init() {
+  if (mutex == nullptr) {
+    mutex = xSemaphoreCreateRecursiveMutex();
+    ASSERT(mutex != nullptr);
+  }
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
   // try mount
   int err = lfs_mount(&lfs, &lfsConfig);
@@ -39,6 +44,7 @@ void FS::Init() {
     lfs_format(&lfs, &lfsConfig);
     err = lfs_mount(&lfs, &lfsConfig);
     if (err != LFS_ERR_OK) {
+      xSemaphoreGiveRecursive(mutex);
       return;
     }
   }
@@ -46,6 +52,7 @@ void FS::Init() {
 #ifndef PINETIME_IS_RECOVERY
   VerifyResource();
 #endif
+  xSemaphoreGiveRecursive(mutex);
 }
 
 void FS::VerifyResource() {
@@ -54,54 +61,118 @@ void FS::VerifyResource() {
 }
 
 int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
-  return lfs_file_open(&lfs, file_p, fileName, flags);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_open(&lfs, file_p, fileName, flags);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::FileClose(lfs_file_t* file_p) {
-  return lfs_file_close(&lfs, file_p);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_close(&lfs, file_p);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
-  return lfs_file_read(&lfs, file_p, buff, size);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_read(&lfs, file_p, buff, size);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size) {
-  return lfs_file_write(&lfs, file_p, buff, size);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_write(&lfs, file_p, buff, size);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::FileSeek(lfs_file_t* file_p, uint32_t pos) {
-  return lfs_file_seek(&lfs, file_p, pos, LFS_SEEK_SET);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_seek(&lfs, file_p, pos, LFS_SEEK_SET);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int FS::FileSync(lfs_file_t* file_p) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_file_sync(&lfs, file_p);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::FileDelete(const char* fileName) {
-  return lfs_remove(&lfs, fileName);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_remove(&lfs, fileName);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int32_t FS::FileSize(lfs_t* lfs, lfs_file_t* file) {
-  return lfs_file_size(lfs, file);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int32_t result = lfs_file_size(lfs, file);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirOpen(const char* path, lfs_dir_t* lfs_dir) {
-  return lfs_dir_open(&lfs, lfs_dir, path);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_dir_open(&lfs, lfs_dir, path);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirClose(lfs_dir_t* lfs_dir) {
-  return lfs_dir_close(&lfs, lfs_dir);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_dir_close(&lfs, lfs_dir);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirRead(lfs_dir_t* dir, lfs_info* info) {
-  return lfs_dir_read(&lfs, dir, info);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_dir_read(&lfs, dir, info);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirRewind(lfs_dir_t* dir) {
-  return lfs_dir_rewind(&lfs, dir);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_dir_rewind(&lfs, dir);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirCreate(const char* path) {
-  return lfs_mkdir(&lfs, path);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_mkdir(&lfs, path);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int FS::EnsureDirectory(const char* path) {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  lfs_dir_t dir;
+  int result;
+  if (lfs_dir_open(&lfs, &dir, path) == LFS_ERR_OK) {
+    result = lfs_dir_close(&lfs, &dir);
+  } else {
+    result = lfs_mkdir(&lfs, path);
+  }
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::DirList(const char* dir_path, DirListCallback callback) {
+  // The callback runs with the mutex held and may call the file system again
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = ListDirectory(dir_path, callback);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+int FS::ListDirectory(const char* dir_path, DirListCallback callback) {
   lfs_dir_t dir;
   int err = lfs_dir_open(&lfs, &dir, dir_path);
   if (err) {
@@ -134,15 +205,31 @@ int FS::DirList(const char* dir_path, DirListCallback callback) {
 }
 
 int FS::Rename(const char* oldPath, const char* newPath) {
-  return lfs_rename(&lfs, oldPath, newPath);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_rename(&lfs, oldPath, newPath);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 int FS::Stat(const char* path, lfs_info* info) {
-  return lfs_stat(&lfs, path, info);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int result = lfs_stat(&lfs, path, info);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 lfs_ssize_t FS::GetFSSize() {
-  return lfs_fs_size(&lfs);
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  lfs_ssize_t result = lfs_fs_size(&lfs);
+  xSemaphoreGiveRecursive(mutex);
+  return result;
+}
+
+FS::ReadCacheStatistics FS::GetReadCacheStatistics() {
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  ReadCacheStatistics result = readCacheStatistics;
+  xSemaphoreGiveRecursive(mutex);
+  return result;
 }
 
 /*
@@ -157,6 +244,7 @@ int FS::SectorSync(const struct lfs_config* /*c*/) {
 int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize);
+  lfs.InvalidateReadCache(block, 0, blockSize);
   lfs.flashDriver.SectorErase(address);
   return lfs.flashDriver.EraseFailed() ? -1 : 0;
 }
@@ -164,13 +252,63 @@ int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
 int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
+  lfs.InvalidateReadCache(block, off, size);
   lfs.flashDriver.Write(address, (uint8_t*) buffer, size);
   return lfs.flashDriver.ProgramFailed() ? -1 : 0;
 }
 
 int FS::SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
-  const size_t address = startAddress + (block * blockSize) + off;
-  lfs.flashDriver.Read(address, static_cast<uint8_t*>(buffer), size);
+  return lfs.CachedRead(block, off, static_cast<uint8_t*>(buffer), size);
+}
+
+int FS::CachedRead(lfs_block_t block, lfs_off_t off, uint8_t* buffer, lfs_size_t size) {
+  if (readCacheNbLines == 0 || !readCacheEnabled || size >= readCacheLineSize) {
+    readCacheStatistics.directReads++;
+    flashDriver.FastRead(startAddress + (block * blockSize) + off, buffer, size);
+    return 0;
+  }
+
+  while (size > 0) {
+    const lfs_off_t lineOffset = off & ~(readCacheLineSize - 1);
+    const lfs_off_t offsetInLine = off - lineOffset;
+    const lfs_size_t toCopy = std::min<lfs_size_t>(size, readCacheLineSize - offsetInLine);
+    const size_t line = LoadReadCacheLine(block, lineOffset);
+    std::memcpy(buffer, &readCacheData[line * readCacheLineSize + offsetInLine], toCopy);
+    buffer += toCopy;
+    off += toCopy;
+    size -= toCopy;
+  }
   return 0;
 }
+
+size_t FS::LoadReadCacheLine(lfs_block_t block, lfs_off_t lineOffset) {
+  readCacheClock++;
+  size_t victim = 0;
+  for (size_t i = 0; i < readCacheLines.size(); i++) {
+    auto& line = readCacheLines[i];
+    if (line.valid && line.block == block && line.offset == lineOffset) {
+      line.lastUse = readCacheClock;
+      readCacheStatistics.hits++;
+      return i;
+    }
+    // Free lines first, then the least recently used one
+    const auto& candidate = readCacheLines[victim];
+    if (candidate.valid && (!line.valid || line.lastUse < candidate.lastUse)) {
+      victim = i;
+    }
+  }
+
+  readCacheStatistics.misses++;
+  flashDriver.FastRead(startAddress + (block * blockSize) + lineOffset, &readCacheData[victim * readCacheLineSize], readCacheLineSize);
+  readCacheLines[victim] = {block, lineOffset, readCacheClock, true};
+  return victim;
+}
+
+void FS::InvalidateReadCache(lfs_block_t block, lfs_off_t off, lfs_size_t size) {
+  for (auto& line : readCacheLines) {
+    if (line.valid && line.block == block && line.offset < off + size && off < line.offset + readCacheLineSize) {
+      line.valid = false;
+    }
+  }
+}
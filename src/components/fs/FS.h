@@ -1,9 +1,38 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiNorFlash.h"
 #include <littlefs/lfs.h>
 
+/*
+ * littlefs cache profiles, selected with -DFS_CACHE_PROFILE=<profile> :
+ *  - MINIMAL    : smallest RAM usage (littlefs allocates a cache buffer per open file)
+ *  - BALANCED   : larger littlefs caches and read cache
+ *  - THROUGHPUT : a whole flash page per littlefs cache
+ *
+ * The RAM budget of the FS read cache can be overridden with -DFS_READ_CACHE_SIZE=<bytes> (0 disables it).
+ */
+#if defined(FS_CACHE_PROFILE_THROUGHPUT)
+  #define FS_LFS_CACHE_SIZE 256
+  #define FS_LFS_LOOKAHEAD_SIZE 64
+  #define FS_DEFAULT_READ_CACHE_SIZE 4096
+#elif defined(FS_CACHE_PROFILE_BALANCED)
+  #define FS_LFS_CACHE_SIZE 64
+  #define FS_LFS_LOOKAHEAD_SIZE 32
+  #define FS_DEFAULT_READ_CACHE_SIZE 2048
+#else
+  #define FS_LFS_CACHE_SIZE 16
+  #define FS_LFS_LOOKAHEAD_SIZE 16
+  #define FS_DEFAULT_READ_CACHE_SIZE 1024
+#endif
+
+#ifndef FS_READ_CACHE_SIZE
+  #define FS_READ_CACHE_SIZE FS_DEFAULT_READ_CACHE_SIZE
+#endif
+
 namespace Pinetime {
   namespace Controllers {
     class FS {
@@ -17,15 +46,18 @@ namespace Pinetime {
       int FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size);
       int FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size);
       int FileSeek(lfs_file_t* file_p, uint32_t pos);
+      int FileSync(lfs_file_t* file_p);
 
       int FileDelete(const char* fileName);
-      int32_t FS::FileSize(lfs_t* lfs, lfs_file_t* file);
+      int32_t FileSize(lfs_t* lfs, lfs_file_t* file);
 
       int DirOpen(const char* path, lfs_dir_t* lfs_dir);
       int DirClose(lfs_dir_t* lfs_dir);
       int DirRead(lfs_dir_t* dir, lfs_info* info);
       int DirRewind(lfs_dir_t* dir);
       int DirCreate(const char* path);
+      // Creates the directory if it does not exist yet
+      int EnsureDirectory(const char* path);
 
       typedef int DirListCallback(FS&, lfs_info&);
       int DirList(const char* dir_path, DirListCallback callback);
@@ -34,6 +66,17 @@ namespace Pinetime {
       int Rename(const char* oldPath, const char* newPath);
       int Stat(const char* path, lfs_info* info);
       void VerifyResource();
+#ifdef FS_READ_BENCHMARK
+      void RunReadBenchmark();
+#endif
+
+      struct ReadCacheStatistics {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t directReads = 0;
+      };
+
+      ReadCacheStatistics GetReadCacheStatistics();
 
       static size_t getSize() {
         return size;
@@ -77,6 +120,37 @@ namespace Pinetime {
 
       lfs_t lfs;
 
+      // littlefs and the read cache are used from several tasks. The mutex is recursive because the callback of DirList()
+      // can call the file system again.
+      SemaphoreHandle_t mutex = nullptr;
+
+      /*
+       * Read cache between littlefs and the flash memory.
+       * littlefs reads metadata and small files by pieces of read_size bytes: the cache loads whole lines of
+       * readCacheLineSize bytes in one transaction and keeps the most recently used ones. Larger reads go
+       * directly to the flash memory. Lines are dropped when their part of the block is programmed or erased.
+       */
+      struct ReadCacheLine {
+        lfs_block_t block;
+        lfs_off_t offset;
+        uint32_t lastUse;
+        bool valid;
+      };
+      static constexpr size_t readCacheLineSize = 256;
+      static constexpr size_t readCacheNbLines = FS_READ_CACHE_SIZE / readCacheLineSize;
+      static_assert(blockSize % readCacheLineSize == 0, "Cache lines must not cross blocks");
+
+      std::array<ReadCacheLine, readCacheNbLines> readCacheLines = {};
+      std::array<uint8_t, readCacheNbLines * readCacheLineSize> readCacheData;
+      uint32_t readCacheClock = 0;
+      bool readCacheEnabled = true;
+      ReadCacheStatistics readCacheStatistics;
+
+      int ListDirectory(const char* dir_path, DirListCallback callback);
+      int CachedRead(lfs_block_t block, lfs_off_t off, uint8_t* buffer, lfs_size_t size);
+      size_t LoadReadCacheLine(lfs_block_t block, lfs_off_t lineOffset);
+      void InvalidateReadCache(lfs_block_t block, lfs_off_t off, lfs_size_t size);
+
       static int SectorSync(const struct lfs_config* c);
       static int SectorErase(const struct lfs_config* c, lfs_block_t block);
       static int SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size);
@@ -0,0 +1,61 @@
+#include "components/fs/FS.h"
+#include <algorithm>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <libraries/log/nrf_log.h>
+
+#ifdef FS_READ_BENCHMARK
+using namespace Pinetime::Controllers;
+
+// Reads the resource files sequentially and at random offsets, with and without the read cache, and logs the throughput
+void FS::RunReadBenchmark() {
+  static constexpr const char* files[] = {"/fonts/bebas.bin", "/fonts/teko.bin", "/images/navigation0.bin"};
+  static constexpr uint32_t nbRandomReads = 256;
+  static constexpr uint32_t randomReadSize = 16;
+  uint8_t buffer[64];
+
+  // Other tasks wait for the end of the benchmark : it changes the read cache settings
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  for (bool cacheEnabled : {false, true}) {
+    readCacheEnabled = cacheEnabled;
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+      lfs_file_t file;
+      if (FileOpen(&file, files[i], LFS_O_RDONLY) != LFS_ERR_OK) {
+        continue;
+      }
+      const int32_t fileSize = FileSize(&lfs, &file);
+
+      TickType_t start = xTaskGetTickCount();
+      uint32_t sequentialBytes = 0;
+      int res;
+      while ((res = FileRead(&file, buffer, sizeof(buffer))) > 0) {
+        sequentialBytes += res;
+      }
+      const TickType_t sequentialTicks = std::max<TickType_t>(1, xTaskGetTickCount() - start);
+
+      // Linear congruential generator, the same offsets are read in both runs
+      uint32_t seed = 12345;
+      start = xTaskGetTickCount();
+      for (uint32_t j = 0; j < nbRandomReads && fileSize > static_cast<int32_t>(randomReadSize); j++) {
+        seed = seed * 1103515245 + 12345;
+        FileSeek(&file, (seed >> 8) % (fileSize - randomReadSize));
+        FileRead(&file, buffer, randomReadSize);
+      }
+      const TickType_t randomTicks = std::max<TickType_t>(1, xTaskGetTickCount() - start);
+      FileClose(&file);
+
+      NRF_LOG_INFO("[FS] file %d, cache %d : sequential %lu KB/s, random %lu KB/s",
+                   i,
+                   cacheEnabled,
+                   (sequentialBytes * configTICK_RATE_HZ) / (sequentialTicks * 1024),
+                   (nbRandomReads * randomReadSize * configTICK_RATE_HZ) / (randomTicks * 1024));
+    }
+  }
+  readCacheEnabled = true;
+  NRF_LOG_INFO("[FS] read cache : %lu hits, %lu misses, %lu direct reads",
+               readCacheStatistics.hits,
+               readCacheStatistics.misses,
+               readCacheStatistics.directReads);
+  xSemaphoreGiveRecursive(mutex);
+}
+#endif
@@ -0,0 +1,249 @@
+#include "components/heartrate/FixedPointFft.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#if defined(__ARM_FEATURE_DSP)
+  #include <nrf.h>
+#endif
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  constexpr size_t nbComplex = FixedPointFft::length / 2;
+  constexpr size_t nbStages = 5;
+  static_assert((1U << nbStages) == nbComplex);
+
+  struct Twiddle16 {
+    int16_t cos;
+    int16_t sin;
+  };
+
+  struct Twiddle32 {
+    int32_t cos;
+    int32_t sin;
+  };
+
+  // cos and sin of 2*pi*k/64, from python:
+  // python -c 'import math;print([(round(math.cos(2*math.pi*k/64)*32767),round(math.sin(2*math.pi*k/64)*32767)) for k in range(32)])'
+  // The twiddles of the stages of the 32 points FFT are the even entries.
+  constexpr Twiddle16 twiddlesQ15[nbComplex] {
+    {32767, 0},      {32609, 3212},   {32137, 6393},   {31356, 9512},   {30273, 12539},  {28898, 15446},  {27245, 18204},
+    {25329, 20787},  {23170, 23170},  {20787, 25329},  {18204, 27245},  {15446, 28898},  {12539, 30273},  {9512, 31356},
+    {6393, 32137},   {3212, 32609},   {0, 32767},      {-3212, 32609},  {-6393, 32137},  {-9512, 31356},  {-12539, 30273},
+    {-15446, 28898}, {-18204, 27245}, {-20787, 25329}, {-23170, 23170}, {-25329, 20787}, {-27245, 18204}, {-28898, 15446},
+    {-30273, 12539}, {-31356, 9512},  {-32137, 6393},  {-32609, 3212}};
+
+  // Same as twiddlesQ15, multiplied by 2147483647
+  constexpr Twiddle32 twiddlesQ31[nbComplex] {
+    {2147483647, 0},           {2137142926, 210490206},   {2106220351, 418953276},   {2055013722, 623381597},
+    {1984016188, 821806413},   {1893911493, 1012316784},  {1785567395, 1193077990},  {1660027308, 1362349204},
+    {1518500249, 1518500249},  {1362349204, 1660027308},  {1193077990, 1785567395},  {1012316784, 1893911493},
+    {821806413, 1984016188},   {623381597, 2055013722},   {418953276, 2106220351},   {210490206, 2137142926},
+    {0, 2147483647},           {-210490206, 2137142926},  {-418953276, 2106220351},  {-623381597, 2055013722},
+    {-821806413, 1984016188},  {-1012316784, 1893911493}, {-1193077990, 1785567395}, {-1362349204, 1660027308},
+    {-1518500249, 1518500249}, {-1660027308, 1362349204}, {-1785567395, 1193077990}, {-1893911493, 1012316784},
+    {-1984016188, 821806413},  {-2055013722, 623381597},  {-2106220351, 418953276},  {-2137142926, 210490206}};
+
+  constexpr std::array<uint8_t, nbComplex> BitReversal() {
+    std::array<uint8_t, nbComplex> indices {};
+    for (size_t i = 0; i < nbComplex; i++) {
+      size_t reversed = 0;
+      for (size_t bit = 0; bit < nbStages; bit++) {
+        reversed |= ((i >> bit) & 1U) << (nbStages - 1 - bit);
+      }
+      indices[i] = reversed;
+    }
+    return indices;
+  }
+
+  constexpr std::array<uint8_t, nbComplex> bitReversal = BitReversal();
+
+  // The products by a twiddle (|w| = 1) of the values scaled to fullScale cannot overflow. In a forward FFT, the
+  // twiddle is cos - j*sin : (a + jb) * (c - js) = (ac + bs) + j(bc - as).
+  struct Q15 {
+    // Real part in the low half word, imaginary part in the high half word
+    using Complex = uint32_t;
+    using Wide = int32_t;
+    static constexpr float fullScale = 16383.0f;
+    static constexpr int shift = 15;
+
+    static Complex Make(int32_t real, int32_t imag) {
+      return static_cast<uint16_t>(real) | (static_cast<uint32_t>(static_cast<uint16_t>(imag)) << 16);
+    }
+
+    static int32_t Real(Complex value) {
+      return static_cast<int16_t>(value & 0xffff);
+    }
+
+    static int32_t Imag(Complex value) {
+      return static_cast<int16_t>(value >> 16);
+    }
+
+    static Wide Cos(size_t k) {
+      return twiddlesQ15[k].cos;
+    }
+
+    static Wide Sin(size_t k) {
+      return twiddlesQ15[k].sin;
+    }
+
+    static Complex Multiply(Complex x, size_t k) {
+      uint32_t w;
+      std::memcpy(&w, &twiddlesQ15[k], sizeof(w));
+#if defined(__ARM_FEATURE_DSP)
+      const int32_t real = static_cast<int32_t>(__SMUAD(x, w)) >> shift;
+      const int32_t imag = static_cast<int32_t>(__SMUSDX(w, x)) >> shift;
+#else
+      const int32_t real = (Real(x) * Real(w) + Imag(x) * Imag(w)) >> shift;
+      const int32_t imag = (Imag(x) * Real(w) - Real(x) * Imag(w)) >> shift;
+#endif
+      return Make(real, imag);
+    }
+
+    static void Butterfly(Complex& p, Complex& q, Complex t) {
+#if defined(__ARM_FEATURE_DSP)
+      q = __SHSUB16(p, t);
+      p = __SHADD16(p, t);
+#else
+      q = Make((Real(p) - Real(t)) >> 1, (Imag(p) - Imag(t)) >> 1);
+      p = Make((Real(p) + Real(t)) >> 1, (Imag(p) + Imag(t)) >> 1);
+#endif
+    }
+  };
+
+  struct Q31 {
+    struct Complex {
+      int32_t real;
+      int32_t imag;
+    };
+
+    using Wide = int64_t;
+    // 2 bits of headroom, for the sums of the butterflies
+    static constexpr float fullScale = 536870911.0f;
+    static constexpr int shift = 31;
+
+    static Complex Make(int32_t real, int32_t imag) {
+      return {real, imag};
+    }
+
+    static int32_t Real(Complex value) {
+      return value.real;
+    }
+
+    static int32_t Imag(Complex value) {
+      return value.imag;
+    }
+
+    static Wide Cos(size_t k) {
+      return twiddlesQ31[k].cos;
+    }
+
+    static Wide Sin(size_t k) {
+      return twiddlesQ31[k].sin;
+    }
+
+    static Complex Multiply(Complex x, size_t k) {
+      const Wide c = Cos(k);
+      const Wide s = Sin(k);
+      return {static_cast<int32_t>((x.real * c + x.imag * s) >> shift), static_cast<int32_t>((x.imag * c - x.real * s) >> shift)};
+    }
+
+    static void Butterfly(Complex& p, Complex& q, Complex t) {
+      q = {(p.real - t.real) >> 1, (p.imag - t.imag) >> 1};
+      p = {(p.real + t.real) >> 1, (p.imag + t.imag) >> 1};
+    }
+  };
+
+  uint32_t SquareRoot(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) {
+      bit >>= 2;
+    }
+    while (bit != 0) {
+      if (value >= result + bit) {
+        value -= result + bit;
+        result = (result >> 1) + bit;
+      } else {
+        result >>= 1;
+      }
+      bit >>= 2;
+    }
+    return result;
+  }
+
+  // The values are normalized to 15 bits before they are squared : the precision is relative to the bin, not to the
+  // largest bin of the spectrum.
+  uint32_t Magnitude(int32_t real, int32_t imag) {
+    uint32_t a = (real < 0) ? -real : real;
+    uint32_t b = (imag < 0) ? -imag : imag;
+    const uint32_t max = (a > b) ? a : b;
+    if (max == 0) {
+      return 0;
+    }
+    const int bits = 32 - __builtin_clz(max);
+    const int normalization = (bits > 15) ? bits - 15 : 0;
+    a >>= normalization;
+    b >>= normalization;
+    return SquareRoot(a * a + b * b) << normalization;
+  }
+
+  template <class Format>
+  void ComputeMagnitude(const float* signal, float* magnitude) {
+    float maxAbs = 0.0f;
+    for (size_t i = 0; i < FixedPointFft::length; i++) {
+      const float value = (signal[i] < 0.0f) ? -signal[i] : signal[i];
+      if (value > maxAbs) {
+        maxAbs = value;
+      }
+    }
+    if (maxAbs == 0.0f) {
+      std::fill(magnitude, magnitude + FixedPointFft::spectrumLength, 0.0f);
+      return;
+    }
+
+    // The real signal is transformed as the complex signal z[n] = x[2n] + j*x[2n+1], in bit reversed order
+    const float scale = Format::fullScale / maxAbs;
+    std::array<typename Format::Complex, nbComplex> data;
+    for (size_t n = 0; n < nbComplex; n++) {
+      data[bitReversal[n]] = Format::Make(static_cast<int32_t>(signal[2 * n] * scale), static_cast<int32_t>(signal[2 * n + 1] * scale));
+    }
+
+    for (size_t size = 2; size <= nbComplex; size <<= 1) {
+      const size_t half = size >> 1;
+      const size_t stride = FixedPointFft::length / size;
+      for (size_t j = 0; j < half; j++) {
+        for (size_t i = j; i < nbComplex; i += size) {
+          const auto t = Format::Multiply(data[i + half], j * stride);
+          Format::Butterfly(data[i], data[i + half], t);
+        }
+      }
+    }
+
+    // Split : X[k] = E[k] - j * W64^k * O[k], with E[k] = (Z[k] + Z*[32-k]) / 2 and O[k] = (Z[k] - Z*[32-k]) / 2
+    using Wide = typename Format::Wide;
+    const float unscale = static_cast<float>(1U << nbStages) / scale;
+    for (size_t k = 0; k < FixedPointFft::spectrumLength; k++) {
+      const auto z = data[k];
+      const auto m = data[(nbComplex - k) % nbComplex];
+      const int32_t evenReal = (Format::Real(z) + Format::Real(m)) >> 1;
+      const int32_t evenImag = (Format::Imag(z) - Format::Imag(m)) >> 1;
+      const Wide oddReal = (Format::Real(z) - Format::Real(m)) >> 1;
+      const Wide oddImag = (Format::Imag(z) + Format::Imag(m)) >> 1;
+      const Wide c = Format::Cos(k);
+      const Wide s = Format::Sin(k);
+      const int32_t real = evenReal + static_cast<int32_t>((oddImag * c - oddReal * s) >> Format::shift);
+      const int32_t imag = evenImag - static_cast<int32_t>((oddImag * s + oddReal * c) >> Format::shift);
+      magnitude[k] = static_cast<float>(Magnitude(real, imag)) * unscale;
+    }
+  }
+}
+
+void FixedPointFft::MagnitudeQ15(const float* signal, float* magnitude) {
+  ComputeMagnitude<Q15>(signal, magnitude);
+}
+
+void FixedPointFft::MagnitudeQ31(const float* signal, float* magnitude) {
+  ComputeMagnitude<Q31>(signal, magnitude);
+}
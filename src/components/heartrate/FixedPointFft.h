@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * 64 points real FFT in fixed point, used by Ppg instead of ArduinoFFT when the firmware is built with
+     * -DPPG_FFT=Q15 or -DPPG_FFT=Q31.
+     *
+     * The signal is scaled to the range of the format, transformed by a 32 points complex FFT (radix 2, halved at
+     * each stage so that it cannot overflow) and a split step, and the magnitudes are computed with an integer
+     * square root. They are returned in the same unit as the ones computed by ArduinoFFT.
+     *  - Q15 : the complex values are packed in 32 bits words, the butterflies use the SIMD instructions of the M4
+     *  - Q31 : 16 more bits of precision, at the cost of 64 bits multiplications
+     */
+    class FixedPointFft {
+    public:
+      static constexpr size_t length = 64;
+      static constexpr size_t spectrumLength = length / 2;
+
+      // Computes the magnitude of the bins [0, spectrumLength[. signal and magnitude can be the same buffer.
+      static void MagnitudeQ15(const float* signal, float* magnitude);
+      static void MagnitudeQ31(const float* signal, float* magnitude);
+    };
+  }
+}
@@ -1,4 +1,5 @@
 #include "components/heartrate/HeartRateController.h"
+#include "components/heartrate/HeartRateHistory.h"
 #include <heartratetask/HeartRateTask.h>
 #include <systemtask/SystemTask.h>
 
@@ -10,6 +11,9 @@ void HeartRateController::Update(HeartRateController::States newState, uint8_t h
     this->heartRate = heartRate;
     service->OnNewHeartRateValue(heartRate);
   }
+  if (history != nullptr && newState == States::Running && heartRate != 0) {
+    history->AddReading(heartRate);
+  }
 }
 
 void HeartRateController::Start() {
@@ -33,3 +37,7 @@ void HeartRateController::SetHeartRateTask(Pinetime::Applications::HeartRateTask
 void HeartRateController::SetService(Pinetime::Controllers::HeartRateService* service) {
   this->service = service;
 }
+
+void HeartRateController::SetHistory(Pinetime::Controllers::HeartRateHistory* history) {
+  this->history = history;
+}
@@ -13,6 +13,8 @@ namespace Pinetime {
   }
 
   namespace Controllers {
+    class HeartRateHistory;
+
     class HeartRateController {
     public:
       enum class States { Stopped, NotEnoughData, NoTouch, Running };
@@ -33,12 +35,14 @@ namespace Pinetime {
       }
 
       void SetService(Pinetime::Controllers::HeartRateService* service);
+      void SetHistory(Pinetime::Controllers::HeartRateHistory* history);
 
     private:
       Applications::HeartRateTask* task = nullptr;
       States state = States::Stopped;
       uint8_t heartRate = 0;
       Pinetime::Controllers::HeartRateService* service = nullptr;
+      Pinetime::Controllers::HeartRateHistory* history = nullptr;
     };
   }
 }
\ No newline at end of file
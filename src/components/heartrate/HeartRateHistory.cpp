@@ -0,0 +1,352 @@
+#include "components/heartrate/HeartRateHistory.h"
+#include <cstring>
+#include <nrf_log.h>
+#include "components/datetime/DateTimeController.h"
+#include "components/fs/FS.h"
+#include "systemtask/SystemTask.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  constexpr const char* journalPath = "/.system/hrlog.dat";
+  constexpr const char* oldJournalPath = "/.system/hrlog.old";
+  // Record being filled when Flush() was last called
+  constexpr const char* tailPath = "/.system/hrlog.tmp";
+  constexpr uint8_t timeDeltaFlag = 0x80;
+
+  uint8_t ZigZag(int delta) {
+    return (delta >= 0) ? (delta * 2) : ((-delta * 2) - 1);
+  }
+
+  int UnZigZag(uint8_t value) {
+    return (value & 1) ? -((value + 1) / 2) : (value / 2);
+  }
+
+  size_t VarintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      size++;
+    }
+    return size;
+  }
+
+  uint32_t ReadUint32(const uint8_t* buffer) {
+    uint32_t value;
+    std::memcpy(&value, buffer, sizeof(value));
+    return value;
+  }
+
+  // Calls callback(time, heartRate) for each sample of the record, stops at the end of the record if it is corrupted
+  template <typename Callback>
+  void ForEachSample(const uint8_t* record, Callback callback) {
+    uint32_t time = ReadUint32(record);
+    uint8_t heartRate = record[4];
+    const uint8_t nbSamples = record[5];
+    uint32_t delta = HeartRateHistory::sampleInterval;
+    if (nbSamples == 0) {
+      return;
+    }
+    callback(time, heartRate);
+
+    size_t offset = HeartRateHistory::recordHeaderSize;
+    for (uint8_t i = 1; i < nbSamples && offset < HeartRateHistory::recordSize; i++) {
+      const uint8_t token = record[offset++];
+      if (token & timeDeltaFlag) {
+        delta = 0;
+        for (uint8_t shift = 0; offset < HeartRateHistory::recordSize && shift < 32; shift += 7) {
+          const uint8_t byte = record[offset++];
+          delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+          if ((byte & 0x80) == 0) {
+            break;
+          }
+        }
+      }
+      time += delta;
+      heartRate += UnZigZag(token & 0x7f);
+      callback(time, heartRate);
+    }
+  }
+}
+
+void HeartRateHistory::RecordWriter::Start(uint32_t time, uint8_t heartRate) {
+  data.fill(0);
+  std::memcpy(data.data(), &time, sizeof(time));
+  data[4] = heartRate;
+  data[5] = 1;
+  size = recordHeaderSize;
+  nbSamples = 1;
+  lastTime = time;
+  lastDelta = sampleInterval;
+  lastHeartRate = heartRate;
+}
+
+bool HeartRateHistory::RecordWriter::Append(uint32_t time, uint8_t heartRate) {
+  const int heartRateDelta = static_cast<int>(heartRate) - lastHeartRate;
+  if (nbSamples == UINT8_MAX || time < lastTime || heartRateDelta < -64 || heartRateDelta > 63) {
+    return false;
+  }
+  uint32_t delta = time - lastTime;
+  const bool deltaChanged = (delta != lastDelta);
+  const size_t tokenSize = 1 + (deltaChanged ? VarintSize(delta) : 0);
+  if (size + tokenSize > recordSize) {
+    return false;
+  }
+
+  data[size++] = ZigZag(heartRateDelta) | (deltaChanged ? timeDeltaFlag : 0);
+  if (deltaChanged) {
+    lastDelta = delta;
+    while (delta >= 0x80) {
+      data[size++] = (delta & 0x7f) | 0x80;
+      delta >>= 7;
+    }
+    data[size++] = delta;
+  }
+  data[5] = ++nbSamples;
+  lastTime = time;
+  lastHeartRate = heartRate;
+  return true;
+}
+
+size_t HeartRateHistory::Decode(const uint8_t* record, Sample* samples, size_t maxSamples) {
+  size_t nbSamples = 0;
+  ForEachSample(record, [samples, maxSamples, &nbSamples](uint32_t time, uint8_t heartRate) {
+    if (nbSamples < maxSamples) {
+      samples[nbSamples++] = {time, heartRate};
+    }
+  });
+  return nbSamples;
+}
+
+uint32_t HeartRateHistory::FirstTime(const uint8_t* record) {
+  return ReadUint32(record);
+}
+
+uint32_t HeartRateHistory::LastTime(const uint8_t* record) {
+  uint32_t lastTime = 0;
+  ForEachSample(record, [&lastTime](uint32_t time, uint8_t /*heartRate*/) {
+    lastTime = time;
+  });
+  return lastTime;
+}
+
+HeartRateHistory::HeartRateHistory(FS& fs, DateTime& dateTimeController) : fs {fs}, dateTimeController {dateTimeController} {
+}
+
+void HeartRateHistory::Init() {
+  mutex = xSemaphoreCreateMutex();
+
+  fs.EnsureDirectory("/.system");
+
+  lfs_info info;
+  if (fs.Stat(oldJournalPath, &info) == LFS_ERR_OK) {
+    nbOldRecords = info.size / recordSize;
+  }
+  if (fs.Stat(journalPath, &info) == LFS_ERR_OK) {
+    nbJournalRecords = info.size / recordSize;
+  }
+  LoadTail();
+
+  // The new samples are logged after the last one
+  std::array<uint8_t, recordSize> record;
+  const uint32_t nbRecords = nbOldRecords + nbJournalRecords;
+  if (nbRecords > 0 && ReadRecord(nbRecords - 1, record.data())) {
+    lastSampleTime = LastTime(record.data());
+  }
+  NRF_LOG_INFO("[HeartRateHistory] %lu records", nbRecords);
+}
+
+void HeartRateHistory::Register(System::SystemTask* systemTask) {
+  this->systemTask = systemTask;
+}
+
+// The record that was being filled before the reset is appended to the journal, it is not filled anymore
+void HeartRateHistory::LoadTail() {
+  lfs_file_t tail;
+  if (fs.FileOpen(&tail, tailPath, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return;
+  }
+  const int read = fs.FileRead(&tail, pending.data(), recordSize);
+  fs.FileClose(&tail);
+  if (read == static_cast<int>(recordSize) && pending[5] > 0) {
+    nbPending = 1;
+    WriteBlock();
+  }
+  fs.FileDelete(tailPath);
+}
+
+void HeartRateHistory::AddReading(uint8_t heartRate) {
+  const auto now = static_cast<uint32_t>(
+    std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.UTCDateTime().time_since_epoch()).count());
+
+  // The measurement was interrupted (or the time was changed) : drop the incomplete window
+  if (windowCount > 0 && now - windowStart >= 2 * sampleInterval) {
+    windowCount = 0;
+  }
+  if (windowCount == 0) {
+    windowStart = now;
+    windowSum = 0;
+  }
+  windowSum += heartRate;
+  windowCount++;
+
+  if (now - windowStart >= sampleInterval) {
+    AddSample(now, (windowSum + (windowCount / 2)) / windowCount);
+    windowCount = 0;
+  }
+}
+
+void HeartRateHistory::AddSample(uint32_t time, uint8_t heartRate) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (time < lastSampleTime) {
+    xSemaphoreGive(mutex);
+    return;
+  }
+  lastSampleTime = time;
+  if (writer.Empty()) {
+    writer.Start(time, heartRate);
+  } else if (!writer.Append(time, heartRate)) {
+    CompleteRecord();
+    writer.Start(time, heartRate);
+    nbTailSamples = 0;
+  }
+  xSemaphoreGive(mutex);
+}
+
+void HeartRateHistory::CompleteRecord() {
+  if (nbPending == maxPendingRecords) {
+    NRF_LOG_WARNING("[HeartRateHistory] The journal was not written, record lost");
+    return;
+  }
+  std::memcpy(pending.data() + (nbPending * recordSize), writer.Data(), recordSize);
+  nbPending++;
+  if (nbPending == recordsPerBlock && systemTask != nullptr) {
+    systemTask->PushMessage(System::Messages::OnHeartRateHistoryBlock);
+  }
+}
+
+void HeartRateHistory::Flush() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (nbPending > 0) {
+    WriteBlock();
+  }
+  if (writer.NbSamples() != nbTailSamples) {
+    WriteTail();
+  }
+  xSemaphoreGive(mutex);
+}
+
+void HeartRateHistory::WriteTail() {
+  lfs_file_t tail;
+  if (fs.FileOpen(&tail, tailPath, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+    return;
+  }
+  if (fs.FileWrite(&tail, writer.Data(), recordSize) == static_cast<int>(recordSize)) {
+    nbTailSamples = writer.NbSamples();
+  }
+  fs.FileClose(&tail);
+}
+
+void HeartRateHistory::WriteBlock() {
+  lfs_file_t journal;
+  if (fs.FileOpen(&journal, journalPath, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND) != LFS_ERR_OK) {
+    NRF_LOG_WARNING("[HeartRateHistory] Failed to open the journal, %d records lost", static_cast<int>(nbPending));
+    nbPending = 0;
+    return;
+  }
+  const int written = fs.FileWrite(&journal, pending.data(), nbPending * recordSize);
+  fs.FileClose(&journal);
+  if (written == static_cast<int>(nbPending * recordSize)) {
+    nbJournalRecords += nbPending;
+  }
+  nbPending = 0;
+
+  if (nbJournalRecords * recordSize >= maxJournalSize) {
+    fs.FileDelete(oldJournalPath);
+    fs.Rename(journalPath, oldJournalPath);
+    nbRotatedRecords += nbOldRecords;
+    nbOldRecords = nbJournalRecords;
+    nbJournalRecords = 0;
+  }
+}
+
+uint32_t HeartRateHistory::NbRecords() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint32_t nbRecords = NbRecordsLocked();
+  xSemaphoreGive(mutex);
+  return nbRecords;
+}
+
+uint32_t HeartRateHistory::NbRecordsLocked() const {
+  return nbOldRecords + nbJournalRecords + nbPending + (writer.Empty() ? 0 : 1);
+}
+
+// Records are indexed in chronological order : old journal, journal, pending records, incomplete record
+bool HeartRateHistory::ReadRecord(uint32_t index, uint8_t* record) {
+  const char* path = nullptr;
+  if (index < nbOldRecords) {
+    path = oldJournalPath;
+  } else if ((index -= nbOldRecords) < nbJournalRecords) {
+    path = journalPath;
+  } else if ((index -= nbJournalRecords) < nbPending) {
+    std::memcpy(record, pending.data() + (index * recordSize), recordSize);
+    return true;
+  } else if (index == nbPending && !writer.Empty()) {
+    std::memcpy(record, writer.Data(), recordSize);
+    return true;
+  } else {
+    return false;
+  }
+
+  lfs_file_t file;
+  if (fs.FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  fs.FileSeek(&file, index * recordSize);
+  const int res = fs.FileRead(&file, record, recordSize);
+  fs.FileClose(&file);
+  return res == static_cast<int>(recordSize);
+}
+
+size_t HeartRateHistory::ReadRecords(uint32_t begin, uint32_t end, uint32_t& cursor, uint8_t* buffer, size_t size) {
+  std::array<uint8_t, recordSize> record;
+  size_t nbRecords = 0;
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint32_t total = NbRecordsLocked();
+  // cursor - 1 is the index of the next record among all the records logged since Init(), rotated ones included
+  uint32_t index = 0;
+  if (cursor == 0) {
+    // Binary search of the last record that starts before begin
+    uint32_t low = 0;
+    uint32_t high = total;
+    while (low < high) {
+      const uint32_t middle = (low + high) / 2;
+      if (ReadRecord(middle, record.data()) && FirstTime(record.data()) <= begin) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    index = (low > 0) ? low - 1 : 0;
+  } else if (cursor - 1 > nbRotatedRecords) {
+    index = cursor - 1 - nbRotatedRecords;
+  }
+
+  for (; index < total && (nbRecords + 1) * recordSize <= size; index++) {
+    if (!ReadRecord(index, record.data())) {
+      continue;
+    }
+    if (FirstTime(record.data()) > end) {
+      index = total;
+      break;
+    }
+    if (LastTime(record.data()) >= begin) {
+      std::memcpy(buffer + (nbRecords * recordSize), record.data(), recordSize);
+      nbRecords++;
+    }
+  }
+  cursor = nbRotatedRecords + index + 1;
+  xSemaphoreGive(mutex);
+  return nbRecords;
+}
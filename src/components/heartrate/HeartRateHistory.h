@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+namespace Pinetime {
+  namespace System {
+    class SystemTask;
+  }
+
+  namespace Controllers {
+    class FS;
+    class DateTime;
+
+    /**
+     * Persistent log of the heart rate, synchronized by HeartRateHistoryService (see doc/HeartRateHistoryService.md).
+     *
+     * The readings are averaged over sampleInterval and delta encoded into records of recordSize bytes :
+     *  - time of the first sample (UTC, s, 4 bytes), heart rate of the first sample (1 byte), number of samples (1 byte)
+     *  - 1 token per following sample : bit 7 set if the time delta changed, bits 0..6 the zigzag encoded heart rate delta
+     *    (-64..63), followed by the new time delta in seconds (varint) if bit 7 is set.
+     * A new record is started when a delta does not fit. Samples older than the last one (the time was set back) are
+     * dropped : the records stay sorted by time, which ReadRecords() relies on.
+     *
+     * Complete records are buffered in RAM, and SystemTask appends them to the journal recordsPerBlock at a time (the
+     * tasks that measure the heart rate have no stack for littlefs). The journal is rotated when it reaches
+     * maxJournalSize. Flush() also writes the pending records and the record being filled (to a separate file, reloaded
+     * by Init()) before the watch goes to sleep or installs a firmware, so a reset loses the samples since then at most.
+     */
+    class HeartRateHistory {
+    public:
+      static constexpr size_t recordSize = 64;
+      static constexpr size_t recordHeaderSize = 6;
+      static constexpr uint32_t sampleInterval = 10;
+      static constexpr size_t recordsPerBlock = 4;
+      // Records that complete while SystemTask has not written the previous block yet are kept too
+      static constexpr size_t maxPendingRecords = 2 * recordsPerBlock;
+      static constexpr size_t maxJournalSize = 64 * 1024;
+
+      struct Sample {
+        uint32_t time;
+        uint8_t heartRate;
+      };
+
+      class RecordWriter {
+      public:
+        void Start(uint32_t time, uint8_t heartRate);
+        // Returns false if the sample does not fit in the record
+        bool Append(uint32_t time, uint8_t heartRate);
+
+        bool Empty() const {
+          return nbSamples == 0;
+        }
+
+        const uint8_t* Data() const {
+          return data.data();
+        }
+
+        size_t Size() const {
+          return size;
+        }
+
+        uint8_t NbSamples() const {
+          return nbSamples;
+        }
+
+      private:
+        std::array<uint8_t, recordSize> data {};
+        size_t size = 0;
+        uint8_t nbSamples = 0;
+        uint32_t lastTime = 0;
+        uint32_t lastDelta = sampleInterval;
+        uint8_t lastHeartRate = 0;
+      };
+
+      // Decodes at most maxSamples samples of a record, returns the number of samples decoded
+      static size_t Decode(const uint8_t* record, Sample* samples, size_t maxSamples);
+      static uint32_t FirstTime(const uint8_t* record);
+      static uint32_t LastTime(const uint8_t* record);
+
+      HeartRateHistory(FS& fs, DateTime& dateTimeController);
+
+      void Init();
+      void Register(System::SystemTask* systemTask);
+      // Valid heart rate reading, called by HeartRateController
+      void AddReading(uint8_t heartRate);
+      // Writes the pending records to the journal and saves the record being filled, called by SystemTask
+      void Flush();
+
+      // Copies the records overlapping [begin, end] (UTC, s) to buffer, at most size / recordSize of them.
+      // cursor identifies the next record to read and stays valid when the journal is rotated, 0 to start a new request.
+      // Returns the number of records copied.
+      size_t ReadRecords(uint32_t begin, uint32_t end, uint32_t& cursor, uint8_t* buffer, size_t size);
+
+      uint32_t NbRecords();
+
+#ifdef HR_HISTORY_BENCHMARK
+      static void RunBenchmark();
+#endif
+
+    private:
+      void AddSample(uint32_t time, uint8_t heartRate);
+      void CompleteRecord();
+      void WriteBlock();
+      void WriteTail();
+      void LoadTail();
+      bool ReadRecord(uint32_t index, uint8_t* record);
+      uint32_t NbRecordsLocked() const;
+
+      FS& fs;
+      DateTime& dateTimeController;
+      System::SystemTask* systemTask = nullptr;
+      SemaphoreHandle_t mutex = nullptr;
+
+      uint32_t windowStart = 0;
+      uint32_t windowSum = 0;
+      uint16_t windowCount = 0;
+
+      RecordWriter writer;
+      uint32_t lastSampleTime = 0;
+      // Samples of writer saved by the last Flush()
+      uint8_t nbTailSamples = 0;
+      std::array<uint8_t, maxPendingRecords * recordSize> pending;
+      size_t nbPending = 0;
+      uint32_t nbOldRecords = 0;
+      uint32_t nbJournalRecords = 0;
+      // Records deleted by the rotations of the journal since Init(), the cursors of ReadRecords() count them
+      uint32_t nbRotatedRecords = 0;
+    };
+  }
+}
@@ -0,0 +1,93 @@
+#include "components/heartrate/HeartRateHistory.h"
+#include "utility/CycleCounter.h"
+#include <algorithm>
+#include <nrf_log.h>
+
+#ifdef HR_HISTORY_BENCHMARK
+using namespace Pinetime::Controllers;
+
+// A day of synthetic heart rate : the watch is not worn during the night, measurements are interrupted from time to time
+void HeartRateHistory::RunBenchmark() {
+  static constexpr uint32_t startTime = 1700000000;
+  static constexpr uint32_t duration = 24 * 3600;
+  static Sample recordSamples[UINT8_MAX];
+  static Sample decoded[UINT8_MAX];
+  RecordWriter benchmarkWriter;
+  size_t nbRecordSamples = 0;
+  uint32_t nbSamples = 0;
+  uint32_t nbRecords = 0;
+  uint32_t nbMismatches = 0;
+  uint32_t loggedSeconds = 0;
+  uint32_t encodeCycles = 0;
+
+  auto checkRecord = [&]() {
+    nbRecords++;
+    if (Decode(benchmarkWriter.Data(), decoded, UINT8_MAX) != nbRecordSamples) {
+      nbMismatches++;
+      return;
+    }
+    for (size_t i = 0; i < nbRecordSamples; i++) {
+      if (decoded[i].time != recordSamples[i].time || decoded[i].heartRate != recordSamples[i].heartRate) {
+        nbMismatches++;
+        return;
+      }
+    }
+  };
+
+  Utility::EnableCycleCounter();
+
+  uint32_t seed = 12345;
+  int heartRate = 60;
+  for (uint32_t t = 0; t < duration; t += sampleInterval) {
+    const uint32_t hour = t / 3600;
+    seed = seed * 1103515245 + 12345;
+    // Not worn between 0h and 7h, no touch during 5 minutes every 2 hours
+    if (hour < 7 || (t % 7200) < 300) {
+      continue;
+    }
+    loggedSeconds += sampleInterval;
+
+    int target = 65;
+    if (hour == 8 || hour == 18) {
+      target = 100; // walking
+    } else if (hour == 12 && (t % 3600) < 1800) {
+      target = 150; // running
+    }
+    heartRate += (target - heartRate) / 8 + static_cast<int>((seed >> 16) % 7) - 3;
+    if (((seed >> 8) % 500) == 0) {
+      heartRate += 70; // glitch of the sensor
+    }
+    heartRate = std::max(40, std::min(heartRate, 220));
+
+    const uint32_t time = startTime + t;
+    const uint32_t start = DWT->CYCCNT;
+    bool appended = !benchmarkWriter.Empty() && benchmarkWriter.Append(time, heartRate);
+    encodeCycles += DWT->CYCCNT - start;
+    if (!appended) {
+      if (!benchmarkWriter.Empty()) {
+        checkRecord();
+      }
+      benchmarkWriter.Start(time, heartRate);
+      nbRecordSamples = 0;
+    }
+    recordSamples[nbRecordSamples++] = {time, static_cast<uint8_t>(heartRate)};
+    nbSamples++;
+  }
+  checkRecord();
+
+  // Raw samples : time (4 bytes) and heart rate (1 byte)
+  const uint32_t rawBytes = nbSamples * (sizeof(uint32_t) + 1);
+  const uint32_t encodedBytes = nbRecords * recordSize;
+  NRF_LOG_INFO("[HeartRateHistory] %lu samples, %lu records, %lu bytes (raw %lu bytes), ratio x%lu.%02lu",
+               nbSamples,
+               nbRecords,
+               encodedBytes,
+               rawBytes,
+               rawBytes / encodedBytes,
+               ((rawBytes % encodedBytes) * 100) / encodedBytes);
+  NRF_LOG_INFO("[HeartRateHistory] %lu flash bytes per hour, %lu cycles per sample, %lu mismatches",
+               (encodedBytes * 3600) / loggedSeconds,
+               encodeCycles / nbSamples,
+               nbMismatches);
+}
+#endif
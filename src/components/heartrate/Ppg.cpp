@@ -1,64 +1,35 @@
 #include "components/heartrate/Ppg.h"
+#include "components/heartrate/PpgWindow.h"
+#include "components/heartrate/SpectrumPeak.h"
 #include <nrf_log.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
+static_assert(Pinetime::Controllers::PpgWindow::length == Pinetime::Controllers::Ppg::dataLength,
+              "PpgWindow only preprocesses windows of Ppg::dataLength points");
+
+// The analysis of the whole window (detrend, filters, Hanning window and FFT) is only built when it is used
+#ifndef PPG_ANALYSIS_SLIDING
+  #define PPG_WINDOW_ANALYSIS
+#endif
+#if defined(PPG_WINDOW_ANALYSIS) && (defined(PPG_FFT_Q15) || defined(PPG_FFT_Q31))
+  #include "components/heartrate/FixedPointFft.h"
+static_assert(Pinetime::Controllers::FixedPointFft::length == Pinetime::Controllers::Ppg::dataLength,
+              "FixedPointFft only computes the FFT of Ppg::dataLength points");
+#endif
+#if defined(PPG_WINDOW_ANALYSIS) && !(defined(PPG_FFT_Q15) || defined(PPG_FFT_Q31))
+  // Note: Change internal define 'sqrt_internal sqrt' to
+  // 'sqrt_internal sqrtf' to save ~3KB of flash.
+  #define sqrt_internal sqrtf
+  #define FFT_SPEED_OVER_PRECISION
+  #include "libs/arduinoFFT/src/arduinoFFT.h"
+  #define PPG_FLOAT_FFT
+#endif
+
 using namespace Pinetime::Controllers;
 
 namespace {
-  float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX) {
-    if (pointX > xValues[length - 1]) {
-      return yValues[length - 1];
-    } else if (pointX <= xValues[0]) {
-      return yValues[0];
-    }
-    int index = 0;
-    while (pointX > xValues[index] && index < length - 1) {
-      index++;
-    }
-    float pointX0 = xValues[index - 1];
-    float pointX1 = xValues[index];
-    float pointY0 = yValues[index - 1];
-    float pointY1 = yValues[index];
-    float mu = (pointX - pointX0) / (pointX1 - pointX0);
-
-    return (pointY0 * (1 - mu) + pointY1 * mu);
-  }
-
-  float PeakSearch(float* xVals, float* yVals, float threshold, float& width, float start, float end, int length) {
-    int peaks = 0;
-    bool enabled = false;
-    float minBin = 0.0f;
-    float maxBin = 0.0f;
-    float peakCenter = 0.0f;
-    float prevValue = LinearInterpolation(xVals, yVals, length, start - 0.01f);
-    float currValue = LinearInterpolation(xVals, yVals, length, start);
-    float idx = start;
-    while (idx < end) {
-      float nextValue = LinearInterpolation(xVals, yVals, length, idx + 0.01f);
-      if (currValue < threshold) {
-        enabled = true;
-      }
-      if (currValue >= threshold and enabled) {
-        if (prevValue < threshold) {
-          minBin = idx;
-        } else if (nextValue <= threshold) {
-          maxBin = idx;
-          peaks++;
-          width = maxBin - minBin;
-          peakCenter = width / 2.0f + minBin;
-        }
-      }
-      prevValue = currValue;
-      currValue = nextValue;
-      idx += 0.01f;
-    }
-    if (peaks != 1) {
-      width = 0.0f;
-      peakCenter = 0.0f;
-    }
-    return peakCenter;
-  }
-
   float SpectrumMean(const std::array<float, Ppg::spectrumLength>& signal, int start, int end) {
     int total = 0;
     float mean = 0.0f;
@@ -77,32 +48,6 @@ namespace {
     return max / mean;
   }
 
-  // Simple bandpass filter using exponential moving average
-  void Filter30to240(std::array<float, Ppg::dataLength>& signal) {
-    // From:
-    // https://www.norwegiancreations.com/2016/03/arduino-tutorial-simple-high-pass-band-pass-and-band-stop-filtering/
-
-    int length = signal.size();
-    // 0.268 is ~0.5Hz and 0.816 is ~4Hz cutoff at 10Hz sampling
-    float expAlpha = 0.816f;
-    float expAvg = 0.0f;
-    for (int loop = 0; loop < 4; loop++) {
-      expAvg = signal.front();
-      for (int idx = 0; idx < length; idx++) {
-        expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
-        signal[idx] = expAvg;
-      }
-    }
-    expAlpha = 0.268f;
-    for (int loop = 0; loop < 4; loop++) {
-      expAvg = signal.front();
-      for (int idx = 0; idx < length; idx++) {
-        expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
-        signal[idx] -= expAvg;
-      }
-    }
-  }
-
   float SpectrumMax(const std::array<float, Ppg::spectrumLength>& data, int start, int end) {
     float max = 0.0f;
     for (int idx = start; idx < end; idx++) {
@@ -113,38 +58,59 @@ namespace {
     return max;
   }
 
-  void Detrend(std::array<float, Ppg::dataLength>& signal) {
-    int size = signal.size();
-    float offset = signal.front();
-    float slope = (signal.at(size - 1) - offset) / static_cast<float>(size - 1);
+#ifdef PPG_FLOAT_FFT
+  void FloatMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>& vImag) {
+    vImag.fill(0.0f);
+    ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), Ppg::dataLength, 1000.0f / Ppg::deltaTms);
+    FFT.compute(FFTDirection::Forward);
+    FFT.complexToMagnitude();
+    FFT.~ArduinoFFT();
+  }
+#endif
 
-    for (int idx = 0; idx < size; idx++) {
-      signal[idx] -= (slope * static_cast<float>(idx) + offset);
-    }
-    for (int idx = 0; idx < size - 1; idx++) {
-      signal[idx] = signal[idx + 1] - signal[idx];
-    }
+#ifdef PPG_WINDOW_ANALYSIS
+  // vImag is only used by ArduinoFFT
+  #if defined(PPG_FFT_Q15)
+  void FftMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>* /*vImag*/) {
+    FixedPointFft::MagnitudeQ15(vReal.data(), vReal.data());
+  }
+  #elif defined(PPG_FFT_Q31)
+  void FftMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>* /*vImag*/) {
+    FixedPointFft::MagnitudeQ31(vReal.data(), vReal.data());
+  }
+  #else
+  void FftMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>* vImag) {
+    FloatMagnitude(vReal, *vImag);
   }
+  #endif
 
-  // Hanning Coefficients from numpy: python -c 'import numpy;print(numpy.hanning(64))'
-  // Note: Harcoded and must be updated if constexpr dataLength is changed. Prevents the need to
-  // use cosf() which results in an extra ~5KB in storage.
-  // This data is symetrical so just using the first half (saves 128B when dataLength is 64).
-  static constexpr float hanning[Ppg::dataLength >> 1] {
-    0.0f,        0.00248461f, 0.00991376f, 0.0222136f,  0.03926189f, 0.06088921f, 0.08688061f, 0.11697778f,
-    0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
-    0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
-    0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
+  // Computes in place the magnitude of the spectrum of the whole window
+  void WindowMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>* vImag) {
+    PpgWindow::Detrend(vReal);
+    PpgWindow::Filter30to240(vReal);
+    PpgWindow::ApplyHanningWindow(vReal);
+    FftMagnitude(vReal, vImag);
+  }
+#endif
 }
 
 Ppg::Ppg() {
+#ifdef PPG_ANALYSIS_SLIDING
+  static_assert(SlidingSpectrum::length == dataLength);
+  static_assert(SlidingSpectrum::nbMagnitudes == hrROIend + 2, "The peak search reads the bin after the region of interest");
+#endif
   dataAverage.fill(0.0f);
   spectrum.fill(0.0f);
 }
 
 int8_t Ppg::Preprocess(uint16_t hrs, uint16_t als) {
   if (dataIndex < dataLength) {
+#ifdef PPG_ANALYSIS_SLIDING
+    slidingSpectrum.Push(hrs);
+    dataIndex++;
+#else
     dataHRS[dataIndex++] = hrs;
+#endif
   }
   alsValue = als;
   if (alsValue > alsThreshold) {
@@ -161,9 +127,11 @@ int Ppg::HeartRate() {
   hr = ProcessHeartRate(resetSpectralAvg);
   resetSpectralAvg = false;
   // Make room for overlapWindow number of new samples
+#ifndef PPG_ANALYSIS_SLIDING
   for (int idx = 0; idx < dataLength - overlapWindow; idx++) {
     dataHRS[idx] = dataHRS[idx + overlapWindow];
   }
+#endif
   dataIndex = dataLength - overlapWindow;
   return hr;
 }
@@ -171,6 +139,9 @@ int Ppg::HeartRate() {
 void Ppg::Reset(bool resetDaqBuffer) {
   if (resetDaqBuffer) {
     dataIndex = 0;
+#ifdef PPG_ANALYSIS_SLIDING
+    slidingSpectrum.Reset();
+#endif
   }
   avgIndex = 0;
   dataAverage.fill(0.0f);
@@ -184,26 +155,17 @@ void Ppg::Reset(bool resetDaqBuffer) {
 // Pass init == true to reset spectral averaging.
 // Returns -1 (Reset Acquisition), 0 (Unable to obtain HR) or HR (BPM).
 int Ppg::ProcessHeartRate(bool init) {
-  std::copy(dataHRS.begin(), dataHRS.end(), vReal.begin());
-  Detrend(vReal);
-  Filter30to240(vReal);
-  vImag.fill(0.0f);
-  // Apply Hanning Window
-  int hannIdx = 0;
-  for (int idx = 0; idx < dataLength; idx++) {
-    if (idx >= dataLength >> 1) {
-      hannIdx--;
-    }
-    vReal[idx] *= hanning[hannIdx];
-    if (idx < dataLength >> 1) {
-      hannIdx++;
-    }
-  }
   // Compute in place power spectrum
-  ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), dataLength, sampleFreq);
-  FFT.compute(FFTDirection::Forward);
-  FFT.complexToMagnitude();
-  FFT.~ArduinoFFT();
+#ifdef PPG_ANALYSIS_SLIDING
+  slidingSpectrum.Magnitude(vReal.data(), spectrumLength);
+#else
+  std::copy(dataHRS.begin(), dataHRS.end(), vReal.begin());
+  #if defined(PPG_FFT_Q15) || defined(PPG_FFT_Q31)
+  WindowMagnitude(vReal, nullptr);
+  #else
+  WindowMagnitude(vReal, &vImag);
+  #endif
+#endif
   SpectrumAverage(vReal.data(), spectrum.data(), spectrum.size(), init);
   peakLocation = 0.0f;
   float threshold = peakDetectionThreshold;
@@ -213,18 +175,9 @@ int Ppg::ProcessHeartRate(bool init) {
   float signalToNoiseRatio = SignalToNoise(spectrum, hrROIbegin, hrROIend, max);
   if (signalToNoiseRatio > signalToNoiseThreshold && spectrum.at(0) < dcThreshold) {
     threshold *= max;
-    // Reuse VImag for interpolation x values passed to PeakSearch
-    for (int idx = 0; idx < dataLength; idx++) {
-      vImag[idx] = idx;
-    }
-    peakLocation = PeakSearch(vImag.data(),
-                              spectrum.data(),
-                              threshold,
-                              peakWidth,
-                              static_cast<float>(hrROIbegin),
-                              static_cast<float>(hrROIend),
-                              specLen);
-    peakLocation *= freqResolution;
+    const SpectrumPeak peak = SpectrumPeak::Find(spectrum.data(), specLen, threshold, hrROIbegin, hrROIend);
+    peakWidth = peak.width;
+    peakLocation = peak.location * freqResolution;
   }
   // Peak too wide? (broad spectrum noise or large, rapid HR change)
   if (peakWidth > maxPeakWidth) {
@@ -3,11 +3,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-// Note: Change internal define 'sqrt_internal sqrt' to
-// 'sqrt_internal sqrtf' to save ~3KB of flash.
-#define sqrt_internal sqrtf
-#define FFT_SPEED_OVER_PRECISION
-#include "libs/arduinoFFT/src/arduinoFFT.h"
+#ifdef PPG_ANALYSIS_SLIDING
+  #include "components/heartrate/SlidingSpectrum.h"
+#endif
 
 namespace Pinetime {
   namespace Controllers {
@@ -17,6 +15,12 @@ namespace Pinetime {
       int8_t Preprocess(uint16_t hrs, uint16_t als);
       int HeartRate();
       void Reset(bool resetDaqBuffer);
+#ifdef PPG_FFT_BENCHMARK
+      static void RunFftBenchmark();
+#endif
+#ifdef PPG_ANALYSIS_BENCHMARK
+      static void RunAnalysisBenchmark();
+#endif
       static constexpr int deltaTms = 100;
       // Daq dataLength: Must be power of 2
       static constexpr uint16_t dataLength = 64;
@@ -52,12 +56,21 @@ namespace Pinetime {
       // ALS detection factor
       static constexpr float alsFactor = 2.0f;
 
+#ifdef PPG_ANALYSIS_SLIDING
+      // Spectrum of the last dataLength samples, updated by each new sample
+      SlidingSpectrum slidingSpectrum;
+      // Magnitudes read from slidingSpectrum
+      std::array<float, spectrumLength> vReal;
+#else
       // Raw ADC data
       std::array<uint16_t, dataLength> dataHRS;
       // Stores Real numbers from FFT
       std::array<float, dataLength> vReal;
-      // Stores Imaginary numbers from FFT
+  #if !defined(PPG_FFT_Q15) && !defined(PPG_FFT_Q31)
+      // Stores Imaginary numbers from FFT (ArduinoFFT only, FixedPointFft transforms vReal in place)
       std::array<float, dataLength> vImag;
+  #endif
+#endif
       // Stores power spectrum calculated from FFT real and imag values
       std::array<float, (spectrumLength)> spectrum;
       // Stores each new HR value (Hz). Non zero values are averaged for HR output
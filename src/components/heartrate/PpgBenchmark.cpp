@@ -0,0 +1,212 @@
+#include "components/heartrate/Ppg.h"
+#include "components/heartrate/FixedPointFft.h"
+#include "components/heartrate/PpgWindow.h"
+#include "components/heartrate/SlidingSpectrum.h"
+#include "components/heartrate/SpectrumPeak.h"
+#include "utility/CycleCounter.h"
+#include <algorithm>
+#include <cmath>
+#include <FreeRTOS.h>
+#include <nrf_log.h>
+
+#if defined(PPG_FFT_BENCHMARK) || defined(PPG_ANALYSIS_BENCHMARK)
+  // Same configuration of ArduinoFFT as Ppg.cpp
+  #define sqrt_internal sqrtf
+  #define FFT_SPEED_OVER_PRECISION
+  #include "libs/arduinoFFT/src/arduinoFFT.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // Pulse around the DC level of the HRS3300, with a drift and some noise. seed is the state of a linear congruential
+  // generator : the signals are the same in each run.
+  uint16_t SyntheticSample(int bpm, int idx, uint32_t& seed) {
+    const float omega = 2.0f * 3.14159265f * (static_cast<float>(bpm) / 60.0f) * (Ppg::deltaTms / 1000.0f);
+    seed = seed * 1103515245 + 12345;
+    const float noise = static_cast<float>((seed >> 16) % 64) - 32.0f;
+    return static_cast<uint16_t>(4000.0f + 2.0f * static_cast<float>(idx) + 100.0f * sinf(omega * static_cast<float>(idx)) + noise);
+  }
+
+  #if defined(PPG_FFT_BENCHMARK) || !(defined(PPG_FFT_Q15) || defined(PPG_FFT_Q31))
+  void FloatMagnitude(std::array<float, Ppg::dataLength>& vReal, std::array<float, Ppg::dataLength>& vImag) {
+    vImag.fill(0.0f);
+    ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), Ppg::dataLength, 1000.0f / Ppg::deltaTms);
+    FFT.compute(FFTDirection::Forward);
+    FFT.complexToMagnitude();
+    FFT.~ArduinoFFT();
+  }
+  #endif
+
+  #ifdef PPG_ANALYSIS_BENCHMARK
+  // Analysis of the whole window with the FFT of the build (PPG_FFT), as Ppg::ProcessHeartRate() without PPG_ANALYSIS_SLIDING
+  void WindowMagnitude(std::array<float, Ppg::dataLength>& vReal) {
+    PpgWindow::Detrend(vReal);
+    PpgWindow::Filter30to240(vReal);
+    PpgWindow::ApplyHanningWindow(vReal);
+    #if defined(PPG_FFT_Q15)
+    FixedPointFft::MagnitudeQ15(vReal.data(), vReal.data());
+    #elif defined(PPG_FFT_Q31)
+    FixedPointFft::MagnitudeQ31(vReal.data(), vReal.data());
+    #else
+    // Static to keep it out of the stack of the heart rate task
+    static std::array<float, Ppg::dataLength> vImag;
+    FloatMagnitude(vReal, vImag);
+    #endif
+  }
+  #endif
+}
+#endif
+
+#ifdef PPG_FFT_BENCHMARK
+// Computes the spectrum of synthetic PPG signals with ArduinoFFT and FixedPointFft, and logs the duration of each FFT
+// and the deviation of the fixed point spectra from the float one
+void Ppg::RunFftBenchmark() {
+  static constexpr int heartRates[] = {45, 72, 120, 180};
+  static constexpr const char* names[] = {"Q15", "Q31"};
+  static constexpr void (*backends[])(const float*, float*) = {FixedPointFft::MagnitudeQ15, FixedPointFft::MagnitudeQ31};
+  // Static to keep them out of the stack of the heart rate task
+  static std::array<float, dataLength> signal;
+  static std::array<float, dataLength> vReal;
+  static std::array<float, dataLength> vImag;
+  static std::array<float, spectrumLength> reference;
+
+  Utility::EnableCycleCounter();
+
+  auto peakBin = [](const float* data) {
+    int peak = hrROIbegin;
+    for (int idx = hrROIbegin; idx < hrROIend; idx++) {
+      if (data[idx] > data[peak]) {
+        peak = idx;
+      }
+    }
+    return peak;
+  };
+
+  uint32_t seed = 12345;
+  for (int bpm : heartRates) {
+    for (int idx = 0; idx < dataLength; idx++) {
+      signal[idx] = SyntheticSample(bpm, idx, seed);
+    }
+    PpgWindow::Detrend(signal);
+    PpgWindow::Filter30to240(signal);
+    PpgWindow::ApplyHanningWindow(signal);
+
+    vReal = signal;
+    uint32_t start = DWT->CYCCNT;
+    FloatMagnitude(vReal, vImag);
+    const uint32_t floatCycles = DWT->CYCCNT - start;
+    std::copy(vReal.begin(), vReal.begin() + spectrumLength, reference.begin());
+    const float referenceMax = *std::max_element(reference.begin(), reference.end());
+    NRF_LOG_INFO("[PPG] %d bpm, float : %lu cycles, %d bpm",
+                 bpm,
+                 floatCycles,
+                 static_cast<int>(static_cast<float>(peakBin(reference.data())) * freqResolution * 60.0f));
+
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+      start = DWT->CYCCNT;
+      backends[i](signal.data(), vReal.data());
+      const uint32_t cycles = DWT->CYCCNT - start;
+
+      float deviation = 0.0f;
+      for (int idx = 0; idx < spectrumLength; idx++) {
+        const float difference = vReal[idx] - reference[idx];
+        deviation = std::max(deviation, (difference < 0.0f) ? -difference : difference);
+      }
+      const int peak = peakBin(vReal.data());
+      NRF_LOG_INFO("[PPG] %d bpm, %s : %lu cycles, deviation %lu ppm of the peak, %d bpm",
+                   bpm,
+                   names[i],
+                   cycles,
+                   static_cast<uint32_t>(deviation * 1000000.0f / referenceMax),
+                   static_cast<int>(static_cast<float>(peak) * freqResolution * 60.0f));
+    }
+  }
+}
+#endif
+
+#ifdef PPG_ANALYSIS_BENCHMARK
+// Feeds the same synthetic PPG signals to the analysis of the whole window and to SlidingSpectrum, and logs the cycles
+// spent on each HR update and the error of the heart rate found by the peak search in each spectrum
+void Ppg::RunAnalysisBenchmark() {
+  static_assert(SlidingSpectrum::nbMagnitudes == hrROIend + 2, "The peak search reads the bin after the region of interest");
+  static constexpr int heartRates[] = {45, 72, 120, 180};
+  static constexpr int nbSamples = 600;
+  // Static to keep them out of the stack of the heart rate task
+  static std::array<uint16_t, dataLength> window;
+  static std::array<float, dataLength> vReal;
+  static std::array<float, spectrumLength> spectrum;
+  static SlidingSpectrum slidingSpectrum;
+
+  Utility::EnableCycleCounter();
+
+  // Same peak search as ProcessHeartRate(), returns the HR (bpm) or 0 if the peak is not found
+  auto peakBpm = []() {
+    const float threshold = peakDetectionThreshold * *std::max_element(spectrum.begin() + hrROIbegin, spectrum.begin() + hrROIend);
+    const SpectrumPeak peak = SpectrumPeak::Find(spectrum.data(), spectrumLength, threshold, hrROIbegin, hrROIend);
+    return peak.location * freqResolution * 60.0f;
+  };
+
+  uint32_t seed = 12345;
+  for (int bpm : heartRates) {
+    struct Result {
+      uint32_t cycles = 0;
+      float error = 0.0f;
+      uint32_t failures = 0;
+    } results[2];
+    auto addUpdate = [bpm](Result& result, uint32_t cycles, float hr) {
+      result.cycles += cycles;
+      if (hr == 0.0f) {
+        result.failures++;
+      } else {
+        result.error += (hr > bpm) ? hr - bpm : bpm - hr;
+      }
+    };
+
+    slidingSpectrum.Reset();
+    uint16_t windowIndex = 0;
+    uint32_t nbUpdates = 0;
+    for (int idx = 0; idx < nbSamples; idx++) {
+      const uint16_t sample = SyntheticSample(bpm, idx, seed);
+      uint32_t start = DWT->CYCCNT;
+      window[windowIndex++] = sample;
+      const uint32_t windowCycles = DWT->CYCCNT - start;
+      start = DWT->CYCCNT;
+      slidingSpectrum.Push(sample);
+      const uint32_t slidingCycles = DWT->CYCCNT - start;
+      results[0].cycles += windowCycles;
+      results[1].cycles += slidingCycles;
+      if (windowIndex < dataLength) {
+        continue;
+      }
+
+      start = DWT->CYCCNT;
+      std::copy(window.begin(), window.end(), vReal.begin());
+      WindowMagnitude(vReal);
+      std::copy(window.begin() + overlapWindow, window.end(), window.begin());
+      windowIndex = dataLength - overlapWindow;
+      const uint32_t windowUpdateCycles = DWT->CYCCNT - start;
+      std::copy(vReal.begin(), vReal.begin() + spectrumLength, spectrum.begin());
+      addUpdate(results[0], windowUpdateCycles, peakBpm());
+
+      start = DWT->CYCCNT;
+      slidingSpectrum.Magnitude(spectrum.data(), spectrumLength);
+      const uint32_t slidingUpdateCycles = DWT->CYCCNT - start;
+      addUpdate(results[1], slidingUpdateCycles, peakBpm());
+      nbUpdates++;
+    }
+
+    static constexpr const char* names[] = {"window", "sliding"};
+    for (size_t i = 0; i < 2; i++) {
+      const uint32_t nbFound = std::max<uint32_t>(1, nbUpdates - results[i].failures);
+      const auto errorX10 = static_cast<uint32_t>(results[i].error * 10.0f / static_cast<float>(nbFound));
+      NRF_LOG_INFO("[PPG] %d bpm, %s : %lu cycles per update, mean error %lu.%lu bpm, %lu failures",
+                   bpm,
+                   names[i],
+                   results[i].cycles / std::max<uint32_t>(1, nbUpdates),
+                   errorX10 / 10,
+                   errorX10 % 10,
+                   results[i].failures);
+    }
+  }
+}
+#endif
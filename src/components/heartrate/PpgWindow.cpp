@@ -0,0 +1,66 @@
+#include "components/heartrate/PpgWindow.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // Hanning Coefficients from numpy: python -c 'import numpy;print(numpy.hanning(64))'
+  // Note: Harcoded and must be updated if constexpr length is changed. Prevents the need to
+  // use cosf() which results in an extra ~5KB in storage.
+  // This data is symetrical so just using the first half (saves 128B when length is 64).
+  constexpr float hanning[PpgWindow::length >> 1] {
+    0.0f,        0.00248461f, 0.00991376f, 0.0222136f,  0.03926189f, 0.06088921f, 0.08688061f, 0.11697778f,
+    0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
+    0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
+    0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
+}
+
+void PpgWindow::Detrend(std::array<float, length>& signal) {
+  int size = signal.size();
+  float offset = signal.front();
+  float slope = (signal.at(size - 1) - offset) / static_cast<float>(size - 1);
+
+  for (int idx = 0; idx < size; idx++) {
+    signal[idx] -= (slope * static_cast<float>(idx) + offset);
+  }
+  for (int idx = 0; idx < size - 1; idx++) {
+    signal[idx] = signal[idx + 1] - signal[idx];
+  }
+}
+
+void PpgWindow::Filter30to240(std::array<float, length>& signal) {
+  // From:
+  // https://www.norwegiancreations.com/2016/03/arduino-tutorial-simple-high-pass-band-pass-and-band-stop-filtering/
+
+  int size = signal.size();
+  // 0.268 is ~0.5Hz and 0.816 is ~4Hz cutoff at 10Hz sampling
+  float expAlpha = 0.816f;
+  float expAvg = 0.0f;
+  for (int loop = 0; loop < 4; loop++) {
+    expAvg = signal.front();
+    for (int idx = 0; idx < size; idx++) {
+      expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
+      signal[idx] = expAvg;
+    }
+  }
+  expAlpha = 0.268f;
+  for (int loop = 0; loop < 4; loop++) {
+    expAvg = signal.front();
+    for (int idx = 0; idx < size; idx++) {
+      expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
+      signal[idx] -= expAvg;
+    }
+  }
+}
+
+void PpgWindow::ApplyHanningWindow(std::array<float, length>& signal) {
+  int hannIdx = 0;
+  for (size_t idx = 0; idx < length; idx++) {
+    if (idx >= length >> 1) {
+      hannIdx--;
+    }
+    signal[idx] *= hanning[hannIdx];
+    if (idx < length >> 1) {
+      hannIdx++;
+    }
+  }
+}
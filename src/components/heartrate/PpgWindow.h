@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Preprocessing of the window of 64 samples analysed by Ppg at each update (-DPPG_ANALYSIS=WINDOW) : the signal is
+     * detrended and differentiated, filtered by a cascade of exponential moving averages (0.5Hz to 4Hz at 10Hz sampling)
+     * and multiplied by a Hanning window before its FFT.
+     */
+    class PpgWindow {
+    public:
+      static constexpr size_t length = 64;
+
+      static void Detrend(std::array<float, length>& signal);
+      // Simple bandpass filter using exponential moving average
+      static void Filter30to240(std::array<float, length>& signal);
+      static void ApplyHanningWindow(std::array<float, length>& signal);
+    };
+  }
+}
@@ -0,0 +1,110 @@
+#include "components/heartrate/SlidingSpectrum.h"
+#include <cmath>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // cos(2*pi*k/64), from python: python -c 'import math;print([math.cos(2*math.pi*k/64) for k in range(64)])'
+  // Hardcoded to prevent the need to use cosf() which results in an extra ~5KB in storage.
+  constexpr float cosTable[SlidingSpectrum::length] {
+    1.0f,         0.99518473f,  0.98078528f,  0.95694034f,  0.92387953f,  0.88192126f,  0.83146961f,  0.77301045f,
+    0.70710678f,  0.63439328f,  0.55557023f,  0.47139674f,  0.38268343f,  0.29028468f,  0.19509032f,  0.09801714f,
+    0.0f,         -0.09801714f, -0.19509032f, -0.29028468f, -0.38268343f, -0.47139674f, -0.55557023f, -0.63439328f,
+    -0.70710678f, -0.77301045f, -0.83146961f, -0.88192126f, -0.92387953f, -0.95694034f, -0.98078528f, -0.99518473f,
+    -1.0f,        -0.99518473f, -0.98078528f, -0.95694034f, -0.92387953f, -0.88192126f, -0.83146961f, -0.77301045f,
+    -0.70710678f, -0.63439328f, -0.55557023f, -0.47139674f, -0.38268343f, -0.29028468f, -0.19509032f, -0.09801714f,
+    0.0f,         0.09801714f,  0.19509032f,  0.29028468f,  0.38268343f,  0.47139674f,  0.55557023f,  0.63439328f,
+    0.70710678f,  0.77301045f,  0.83146961f,  0.88192126f,  0.92387953f,  0.95694034f,  0.98078528f,  0.99518473f};
+
+  float Cos(size_t index) {
+    return cosTable[index % SlidingSpectrum::length];
+  }
+
+  // sin(2*pi*k/64) = cos(2*pi*(k-16)/64)
+  float Sin(size_t index) {
+    return cosTable[(index + (SlidingSpectrum::length * 3 / 4)) % SlidingSpectrum::length];
+  }
+
+  // Cutoff frequencies of PpgWindow::Filter30to240() : 0.816 is ~4Hz and 0.268 is ~0.5Hz at 10Hz sampling
+  constexpr float lowPassAlpha = 0.816f;
+  constexpr float highPassAlpha = 0.268f;
+}
+
+void SlidingSpectrum::Push(uint16_t sample) {
+  if (!initialized) {
+    Reset();
+    lastSample = sample;
+    initialized = true;
+  }
+
+  // The samples are differentiated like in PpgWindow::Detrend() : the linear trend becomes a constant, removed by the high pass
+  float value = static_cast<float>(sample) - static_cast<float>(lastSample);
+  lastSample = sample;
+  for (float& average : lowPass) {
+    average = (lowPassAlpha * value) + ((1 - lowPassAlpha) * average);
+    value = average;
+  }
+  for (float& average : highPass) {
+    average = (highPassAlpha * value) + ((1 - highPassAlpha) * average);
+    value -= average;
+  }
+
+  const float delta = value - samples[oldest];
+  samples[oldest] = value;
+  oldest = (oldest + 1) % length;
+
+  if (++samplesSinceResynchronization == length) {
+    Resynchronize();
+    return;
+  }
+
+  // X[k] = (X[k] - oldest sample + new sample) * e^(j*2*pi*k/N), the time origin stays on the oldest sample
+  for (size_t k = 0; k < nbBins; k++) {
+    const float c = Cos(k);
+    const float s = Sin(k);
+    const float real = bins[k].real + delta;
+    const float imag = bins[k].imag;
+    bins[k].real = (real * c) - (imag * s);
+    bins[k].imag = (real * s) + (imag * c);
+  }
+}
+
+void SlidingSpectrum::Reset() {
+  samples.fill(0.0f);
+  bins.fill({0.0f, 0.0f});
+  lowPass.fill(0.0f);
+  highPass.fill(0.0f);
+  lastSample = 0;
+  oldest = 0;
+  samplesSinceResynchronization = 0;
+  initialized = false;
+}
+
+void SlidingSpectrum::Resynchronize() {
+  for (size_t k = 0; k < nbBins; k++) {
+    float real = 0.0f;
+    float imag = 0.0f;
+    for (size_t m = 0; m < length; m++) {
+      const float value = samples[(oldest + m) % length];
+      real += value * Cos(k * m);
+      imag -= value * Sin(k * m);
+    }
+    bins[k] = {real, imag};
+  }
+  samplesSinceResynchronization = 0;
+}
+
+void SlidingSpectrum::Magnitude(float* magnitude, size_t size) const {
+  // Hanning window : W[k] = X[k] / 2 - (X[k-1] + X[k+1]) / 4, with X[-1] = conj(X[1]) for a real signal
+  for (size_t k = 0; k < size; k++) {
+    if (k >= nbMagnitudes) {
+      magnitude[k] = 0.0f;
+      continue;
+    }
+    const Bin previous = (k == 0) ? Bin {bins[1].real, -bins[1].imag} : bins[k - 1];
+    const Bin& next = bins[k + 1];
+    const float real = (0.5f * bins[k].real) - (0.25f * (previous.real + next.real));
+    const float imag = (0.5f * bins[k].imag) - (0.25f * (previous.imag + next.imag));
+    magnitude[k] = std::sqrt((real * real) + (imag * imag));
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Incremental spectrum of the last 64 samples of the heart rate sensor, used by Ppg when the firmware is built with
+     * -DPPG_ANALYSIS=SLIDING.
+     *
+     * Each new sample is differentiated and filtered by the same cascade of exponential moving averages as
+     * PpgWindow::Filter30to240(), whose states are kept between the samples. The filtered samples are kept in a ring
+     * buffer, and the bins [0, nbBins[ of their DFT are updated by a sliding DFT : the cost of a sample is proportional
+     * to the number of bins, not to the length of the window. The Hanning window is applied in the frequency domain,
+     * when the magnitudes are read.
+     *
+     * The bins are recomputed from the ring buffer once per window, so that the rounding errors of the recurrence
+     * cannot accumulate.
+     */
+    class SlidingSpectrum {
+    public:
+      static constexpr size_t length = 64;
+      // The heart rate region of interest of Ppg (bins 3 to 26), the bin after it and the one after it for the window
+      static constexpr size_t nbBins = 29;
+      static constexpr size_t nbMagnitudes = nbBins - 1;
+
+      void Push(uint16_t sample);
+      void Reset();
+
+      // Magnitudes of the bins [0, nbMagnitudes[ of the spectrum of the windowed signal, the following ones are set to 0
+      void Magnitude(float* magnitude, size_t size) const;
+
+    private:
+      struct Bin {
+        float real;
+        float imag;
+      };
+
+      void Resynchronize();
+
+      static constexpr uint8_t nbFilterStages = 4;
+
+      std::array<float, length> samples = {};
+      std::array<Bin, nbBins> bins = {};
+      std::array<float, nbFilterStages> lowPass = {};
+      std::array<float, nbFilterStages> highPass = {};
+      uint16_t lastSample = 0;
+      uint8_t oldest = 0;
+      uint8_t samplesSinceResynchronization = 0;
+      bool initialized = false;
+    };
+  }
+}
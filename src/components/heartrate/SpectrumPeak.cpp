@@ -0,0 +1,53 @@
+#include "components/heartrate/SpectrumPeak.h"
+#include <cmath>
+
+using namespace Pinetime::Controllers;
+
+float SpectrumPeak::Refine(const float* spectrum, float risingBin, float fallingBin) {
+  const int first = static_cast<int>(std::ceil(risingBin));
+  const int last = static_cast<int>(std::floor(fallingBin));
+  int highest = first;
+  for (int idx = first + 1; idx <= last; idx++) {
+    if (spectrum[idx] > spectrum[highest]) {
+      highest = idx;
+    }
+  }
+  const float previous = spectrum[highest - 1];
+  const float next = spectrum[highest + 1];
+  const float curvature = previous - 2.0f * spectrum[highest] + next;
+  if (curvature >= 0.0f) {
+    return static_cast<float>(highest);
+  }
+  return static_cast<float>(highest) + 0.5f * (previous - next) / curvature;
+}
+
+SpectrumPeak SpectrumPeak::Find(const float* spectrum, int length, float threshold, int start, int end) {
+  SpectrumPeak peak;
+  int peaks = 0;
+  bool above = spectrum[start] >= threshold;
+  bool rising = false;
+  float risingBin = 0.0f;
+  for (int idx = start; idx < end && idx + 1 < length; idx++) {
+    const float value = spectrum[idx];
+    const float nextValue = spectrum[idx + 1];
+    if (!above && nextValue >= threshold) {
+      above = true;
+      rising = true;
+      risingBin = static_cast<float>(idx) + (threshold - value) / (nextValue - value);
+    } else if (above && nextValue < threshold) {
+      above = false;
+      if (rising) {
+        const float fallingBin = static_cast<float>(idx) + (value - threshold) / (value - nextValue);
+        peaks++;
+        peak.width = fallingBin - risingBin;
+        peak.center = risingBin + peak.width / 2.0f;
+        peak.location = Refine(spectrum, risingBin, fallingBin);
+        rising = false;
+      }
+    }
+  }
+  if (peaks != 1) {
+    return {};
+  }
+  return peak;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Peak search of the heart rate algorithm (Ppg).
+     *
+     * The spectrum is linearly interpolated between its bins, and the crossings of the threshold are computed for each
+     * segment between two bins. A peak is only counted if it rises above the threshold inside the range, and no peak is
+     * returned if more than one is found.
+     */
+    struct SpectrumPeak {
+      // Middle of the threshold crossings and distance between them (bins)
+      float center = 0.0f;
+      float width = 0.0f;
+      // Parabolic interpolation around the highest bin between the threshold crossings (bins)
+      float location = 0.0f;
+
+      // Finds the single peak above threshold of spectrum in [start, end]. Returns a peak of center 0 if there is none.
+      static SpectrumPeak Find(const float* spectrum, int length, float threshold, int start, int end);
+
+      // Location of the maximum of the parabola through the highest bin in [risingBin, fallingBin] and its neighbours.
+      // The bins before and after the range must be readable.
+      static float Refine(const float* spectrum, float risingBin, float fallingBin);
+    };
+  }
+}
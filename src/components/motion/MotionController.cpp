@@ -1,5 +1,6 @@
 #include "components/motion/MotionController.h"
 
+#include <algorithm>
 #include <task.h>
 
 #include "utility/Math.h"
@@ -47,6 +48,11 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
   lastTime = time;
   time = xTaskGetTickCount();
 
+  if (service != nullptr) {
+    const Pinetime::Drivers::Bma421::Sample sample {x, y, z};
+    service->OnNewMotionSamples(&sample, 1, time);
+  }
+
   xHistory++;
   xHistory[0] = x;
   yHistory++;
@@ -63,23 +69,80 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
   this->nbSteps = nbSteps;
 }
 
+#ifdef MOTION_ACQUISITION_FIFO
+void MotionController::Update(const Pinetime::Drivers::Bma421::Sample* samples, size_t count, uint32_t nbSteps) {
+  peakSpeed = 0;
+  raiseGestureDetected = false;
+  lowerGestureDetected = false;
+  if (count == 0) {
+    return;
+  }
+
+  if (this->nbSteps != nbSteps && service != nullptr) {
+    service->OnNewStepCountValue(nbSteps);
+  }
+
+  const auto& last = samples[count - 1];
+  if (service != nullptr && (xHistory[0] != last.x || yHistory[0] != last.y || zHistory[0] != last.z)) {
+    service->OnNewMotionValues(last.x, last.y, last.z);
+  }
+
+  // The samples are evenly spaced : the shake speed is computed with the nominal period of 100ms
+  constexpr TickType_t pollingPeriod = (100 * configTICK_RATE_HZ) / 1000;
+  lastTime = time;
+  time = xTaskGetTickCount();
+
+  if (service != nullptr) {
+    service->OnNewMotionSamples(samples, count, time);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    xHistory++;
+    xHistory[0] = samples[i].x;
+    yHistory++;
+    yHistory[0] = samples[i].y;
+    zHistory++;
+    zHistory[0] = samples[i].z;
+
+    stats = GetAccelStats();
+    UpdateShakeSpeed(pollingPeriod);
+    peakSpeed = std::max(peakSpeed, accumulatedSpeed);
+    raiseGestureDetected = raiseGestureDetected || IsRaiseGesture();
+    lowerGestureDetected = lowerGestureDetected || IsLowerGesture();
+  }
+
+  int32_t deltaSteps = nbSteps - this->nbSteps;
+  if (deltaSteps > 0) {
+    currentTripSteps += deltaSteps;
+  }
+  this->nbSteps = nbSteps;
+}
+#endif
+
 MotionController::AccelStats MotionController::GetAccelStats() const {
   AccelStats stats;
 
+  // The sums are 32 bits wide : with oversampling, numHistory samples of 16 bits can overflow 16 bits
+  int32_t xSum = 0;
+  int32_t ySum = 0;
+  int32_t zSum = 0;
+  int32_t prevXSum = 0;
+  int32_t prevYSum = 0;
+  int32_t prevZSum = 0;
   for (uint8_t i = 0; i < AccelStats::numHistory; i++) {
-    stats.xMean += xHistory[histSize - i];
-    stats.yMean += yHistory[histSize - i];
-    stats.zMean += zHistory[histSize - i];
-    stats.prevXMean += xHistory[1 + i];
-    stats.prevYMean += yHistory[1 + i];
-    stats.prevZMean += zHistory[1 + i];
-  }
-  stats.xMean /= AccelStats::numHistory;
-  stats.yMean /= AccelStats::numHistory;
-  stats.zMean /= AccelStats::numHistory;
-  stats.prevXMean /= AccelStats::numHistory;
-  stats.prevYMean /= AccelStats::numHistory;
-  stats.prevZMean /= AccelStats::numHistory;
+    xSum += xHistory[histSize - i];
+    ySum += yHistory[histSize - i];
+    zSum += zHistory[histSize - i];
+    prevXSum += xHistory[1 + i];
+    prevYSum += yHistory[1 + i];
+    prevZSum += zHistory[1 + i];
+  }
+  stats.xMean = xSum / AccelStats::numHistory;
+  stats.yMean = ySum / AccelStats::numHistory;
+  stats.zMean = zSum / AccelStats::numHistory;
+  stats.prevXMean = prevXSum / AccelStats::numHistory;
+  stats.prevYMean = prevYSum / AccelStats::numHistory;
+  stats.prevZMean = prevZSum / AccelStats::numHistory;
 
   for (uint8_t i = 0; i < AccelStats::numHistory; i++) {
     stats.xVariance += (xHistory[histSize - i] - stats.xMean) * (xHistory[histSize - i] - stats.xMean);
@@ -94,6 +157,14 @@ MotionController::AccelStats MotionController::GetAccelStats() const {
 }
 
 bool MotionController::ShouldRaiseWake() const {
+#ifdef MOTION_ACQUISITION_FIFO
+  return raiseGestureDetected;
+#else
+  return IsRaiseGesture();
+#endif
+}
+
+bool MotionController::IsRaiseGesture() const {
   constexpr uint32_t varianceThresh = 56 * 56;
   constexpr int16_t xThresh = 384;
   constexpr int16_t yThresh = -64;
@@ -112,17 +183,38 @@ bool MotionController::ShouldRaiseWake() const {
 }
 
 bool MotionController::ShouldShakeWake(uint16_t thresh) {
-  /* Currently Polling at 10hz, If this ever goes faster scalar and EMA might need adjusting */
-  int32_t speed = std::abs(zHistory[0] - zHistory[histSize - 1] + (yHistory[0] - yHistory[histSize - 1]) / 2 +
-                           (xHistory[0] - xHistory[histSize - 1]) / 4) *
-                  100 / (time - lastTime);
-  // (.2 * speed) + ((1 - .2) * accumulatedSpeed);
-  accumulatedSpeed = speed / 5 + accumulatedSpeed * 4 / 5;
-
+#ifdef MOTION_ACQUISITION_FIFO
+  return peakSpeed > thresh;
+#else
+  UpdateShakeSpeed(time - lastTime);
   return accumulatedSpeed > thresh;
+#endif
+}
+
+void MotionController::UpdateShakeSpeed(TickType_t elapsed) {
+  // The scalar and the EMA were tuned for polling at 10hz : the speed is the difference with the sample of 100ms ago,
+  // and the EMA is applied once per 100ms
+  constexpr uint8_t previous = histSize - oversampling;
+  if (elapsed == 0) {
+    return;
+  }
+  int32_t speed = std::abs(zHistory[0] - zHistory[previous] + (yHistory[0] - yHistory[previous]) / 2 +
+                           (xHistory[0] - xHistory[previous]) / 4) *
+                  100 / elapsed;
+  // (.2 * speed) + ((1 - .2) * accumulatedSpeed);
+  constexpr int32_t emaDivider = 5 * oversampling;
+  accumulatedSpeed = speed / emaDivider + accumulatedSpeed * (emaDivider - 1) / emaDivider;
 }
 
 bool MotionController::ShouldLowerSleep() const {
+#ifdef MOTION_ACQUISITION_FIFO
+  return lowerGestureDetected;
+#else
+  return IsLowerGesture();
+#endif
+}
+
+bool MotionController::IsLowerGesture() const {
   if ((stats.xMean > 887 && DegreesRolled(stats.xMean, stats.zMean, stats.prevXMean, stats.prevZMean) > 30) ||
       (stats.xMean < -887 && DegreesRolled(stats.xMean, stats.zMean, stats.prevXMean, stats.prevZMean) < -30)) {
     return true;
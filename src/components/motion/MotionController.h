@@ -18,7 +18,22 @@ namespace Pinetime {
         BMA425,
       };
 
+#ifdef MOTION_ACQUISITION_FIFO
+      static constexpr uint16_t samplingFrequency = Pinetime::Drivers::Bma421::fifoRate;
+#else
+      // SystemTask polls the accelerometer every 100ms
+      static constexpr uint16_t samplingFrequency = 10;
+#endif
+
       void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps);
+#ifdef MOTION_ACQUISITION_FIFO
+      // Consumes a batch of samples read from the FIFO of the accelerometer. The gestures are evaluated after each
+      // sample, and ShouldRaiseWake(), ShouldShakeWake() and ShouldLowerSleep() report whether they were detected in the batch.
+      void Update(const Pinetime::Drivers::Bma421::Sample* samples, size_t count, uint32_t nbSteps);
+#endif
+#ifdef MOTION_REPLAY_BENCHMARK
+      static void RunReplayBenchmark();
+#endif
 
       int16_t X() const {
         return xHistory[0];
@@ -73,8 +88,16 @@ namespace Pinetime {
       TickType_t lastTime = 0;
       TickType_t time = 0;
 
+#ifdef MOTION_ACQUISITION_FIFO
+      // Number of samples per 100ms, the polling period the gesture thresholds were tuned for
+      static constexpr uint8_t oversampling = samplingFrequency / 10;
+      static_assert(samplingFrequency % 10 == 0, "The gestures need a whole number of samples per 100ms");
+#else
+      static constexpr uint8_t oversampling = 1;
+#endif
+
       struct AccelStats {
-        static constexpr uint8_t numHistory = 2;
+        static constexpr uint8_t numHistory = 2 * oversampling;
 
         int16_t xMean = 0;
         int16_t yMean = 0;
@@ -89,14 +112,22 @@ namespace Pinetime {
       };
 
       AccelStats GetAccelStats() const;
+      bool IsRaiseGesture() const;
+      bool IsLowerGesture() const;
+      void UpdateShakeSpeed(TickType_t elapsed);
 
       AccelStats stats = {};
 
-      static constexpr uint8_t histSize = 8;
+      static constexpr uint8_t histSize = 8 * oversampling;
       Utility::CircularBuffer<int16_t, histSize> xHistory = {};
       Utility::CircularBuffer<int16_t, histSize> yHistory = {};
       Utility::CircularBuffer<int16_t, histSize> zHistory = {};
       int32_t accumulatedSpeed = 0;
+#ifdef MOTION_ACQUISITION_FIFO
+      int32_t peakSpeed = 0;
+      bool raiseGestureDetected = false;
+      bool lowerGestureDetected = false;
+#endif
 
       DeviceTypes deviceType = DeviceTypes::Unknown;
       Pinetime::Controllers::MotionService* service = nullptr;
@@ -0,0 +1,72 @@
+#include "components/motion/MotionController.h"
+#include "utility/CycleCounter.h"
+
+#include <array>
+#include <nrf_log.h>
+
+#ifdef MOTION_REPLAY_BENCHMARK
+  #if !defined(MOTION_ACQUISITION_FIFO)
+    #error "MOTION_REPLAY_BENCHMARK needs MOTION_ACQUISITION=FIFO"
+  #endif
+  #include "components/motion/SyntheticMotion.h"
+
+using namespace Pinetime::Controllers;
+
+// Replays the synthetic gestures of SyntheticMotion, batch by batch like SystemTask::UpdateMotion(), and logs when each gesture
+// is detected and the duration of the processing of a batch
+void MotionController::RunReplayBenchmark() {
+  using Sample = Pinetime::Drivers::Bma421::Sample;
+  constexpr size_t batchSize = Pinetime::Drivers::Bma421::fifoWatermark;
+  constexpr size_t nbSamples = SyntheticMotion::durationMs * Pinetime::Drivers::Bma421::fifoRate / 1000;
+  constexpr uint16_t shakeThreshold = 150;
+  // Static to keep them out of the stack of the system task
+  static MotionController controller;
+  static std::array<Sample, batchSize> batch;
+
+  Utility::EnableCycleCounter();
+
+  for (const auto& scenario : SyntheticMotion::scenarios) {
+    controller.xHistory = {};
+    controller.yHistory = {};
+    controller.zHistory = {};
+    controller.accumulatedSpeed = 0;
+    int32_t raiseMs = -1;
+    int32_t shakeMs = -1;
+    int32_t lowerMs = -1;
+    uint32_t cycles = 0;
+    uint32_t nbBatches = 0;
+    for (size_t first = 0; first < nbSamples; first += batchSize) {
+      SyntheticMotion::EncodeFifoFrames(scenario, first, batch.data(), batchSize);
+
+      const uint32_t start = DWT->CYCCNT;
+      Pinetime::Drivers::Bma421::ConvertFifoFrames(batch.data(), batchSize, BMA4_ACCEL_RANGE_2G);
+      controller.Update(batch.data(), batchSize, 0);
+      const bool raise = controller.ShouldRaiseWake();
+      const bool shake = controller.ShouldShakeWake(shakeThreshold);
+      const bool lower = controller.ShouldLowerSleep();
+      cycles += DWT->CYCCNT - start;
+      nbBatches++;
+
+      const auto endMs = static_cast<int32_t>((first + batchSize) * 1000 / Pinetime::Drivers::Bma421::fifoRate);
+      if (endMs <= SyntheticMotion::warmUpMs) {
+        continue;
+      }
+      if (raise && raiseMs < 0) {
+        raiseMs = endMs - SyntheticMotion::warmUpMs;
+      }
+      if (shake && shakeMs < 0) {
+        shakeMs = endMs - SyntheticMotion::warmUpMs;
+      }
+      if (lower && lowerMs < 0) {
+        lowerMs = endMs - SyntheticMotion::warmUpMs;
+      }
+    }
+    NRF_LOG_INFO("[motion] %s : raise %d ms, shake %d ms, lower %d ms",
+                 scenario.name,
+                 static_cast<int>(raiseMs),
+                 static_cast<int>(shakeMs),
+                 static_cast<int>(lowerMs));
+    NRF_LOG_INFO("[motion] %s : %lu cycles per batch of %u samples", scenario.name, cycles / nbBatches, static_cast<unsigned>(batchSize));
+  }
+}
+#endif
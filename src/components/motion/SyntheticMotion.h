@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "drivers/Bma421.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    // Gestures of the wrist encoded as the frames of the FIFO of the BMA421, replayed by MOTION_REPLAY_BENCHMARK and by the host
+    // tests of MotionController. They are generated, not recorded : see MOTION_DUMP in doc/Benchmarks.md for the recordings.
+    namespace SyntheticMotion {
+      struct Scenario {
+        const char* name;
+        // Roll of the wrist (degrees) after t ms : the gravity is (0, sin(roll), cos(roll))
+        float (*roll)(float t);
+        float shakeAmplitude;
+      };
+
+      // The gestures start after 1s, the detections of the first second (history and shake speed settling from 0) are ignored
+      constexpr int32_t warmUpMs = 1000;
+      constexpr uint16_t durationMs = 3000;
+
+      inline constexpr Scenario scenarios[] = {
+        {"rest",
+         [](float) {
+           return 0.0f;
+         },
+         0.0f},
+        {"raise",
+         [](float t) {
+           return -85.0f + (75.0f * std::clamp((t - 1000.0f) / 400.0f, 0.0f, 1.0f));
+         },
+         0.0f},
+        {"lower",
+         [](float t) {
+           return 170.0f - (70.0f * std::clamp((t - 1000.0f) / 400.0f, 0.0f, 1.0f));
+         },
+         0.0f},
+        {"shake",
+         [](float) {
+           return 0.0f;
+         },
+         700.0f},
+      };
+
+      // Writes count frames of the scenario, from its sample first on, as they are read from the FIFO : 12 bits values left
+      // aligned, at 1024 LSB/g, with the X and Y axis swapped
+      inline void EncodeFifoFrames(const Scenario& scenario, size_t first, Pinetime::Drivers::Bma421::Sample* samples, size_t count) {
+        constexpr float pi = 3.14159265f;
+        auto* frames = reinterpret_cast<uint8_t*>(samples);
+        for (size_t i = 0; i < count; i++) {
+          const float t = static_cast<float>((first + i) * 1000) / Pinetime::Drivers::Bma421::fifoRate;
+          const float roll = scenario.roll(t) * pi / 180.0f;
+          const float shake = (t < warmUpMs) ? 0.0f : scenario.shakeAmplitude * std::sin(2.0f * pi * 5.0f * t / 1000.0f);
+          const int16_t axis[3] = {static_cast<int16_t>((1024.0f * std::sin(roll)) + shake), 0, static_cast<int16_t>(1024.0f * std::cos(roll))};
+          for (size_t a = 0; a < 3; a++) {
+            const auto raw = static_cast<uint16_t>(axis[a] * 0x10);
+            frames[(i * Pinetime::Drivers::Bma421::fifoFrameSize) + (2 * a)] = raw & 0xff;
+            frames[(i * Pinetime::Drivers::Bma421::fifoFrameSize) + (2 * a) + 1] = raw >> 8;
+          }
+        }
+      }
+    }
+  }
+}
@@ -8,6 +8,7 @@ RleDecoder::RleDecoder(const uint8_t* buffer, size_t size) : buffer {buffer}, si
 RleDecoder::RleDecoder(const uint8_t* buffer, size_t size, uint16_t foregroundColor, uint16_t backgroundColor) : RleDecoder {buffer, size} {
   this->foregroundColor = foregroundColor;
   this->backgroundColor = backgroundColor;
+  color = backgroundColor;
 }
 
 void RleDecoder::DecodeNext(uint8_t* output, size_t maxBytes) {
@@ -1,57 +1,23 @@
 #include "displayapp/DisplayApp.h"
+#include "utility/CycleCounter.h"
 #include <libraries/log/nrf_log.h>
-#include "displayapp/screens/HeartRate.h"
-#include "displayapp/screens/Motion.h"
-#include "displayapp/screens/Timer.h"
-#include "displayapp/screens/Alarm.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/motion/MotionController.h"
 #include "components/motor/MotorController.h"
-#include "displayapp/screens/ApplicationList.h"
-#include "displayapp/screens/FirmwareUpdate.h"
-#include "displayapp/screens/FirmwareValidation.h"
-#include "displayapp/screens/InfiniPaint.h"
-#include "displayapp/screens/Paddle.h"
-#include "displayapp/screens/StopWatch.h"
-#include "displayapp/screens/Metronome.h"
-#include "displayapp/screens/Music.h"
-#include "displayapp/screens/Navigation.h"
-#include "displayapp/screens/Notifications.h"
-#include "displayapp/screens/SystemInfo.h"
-#include "displayapp/screens/Tile.h"
-#include "displayapp/screens/Twos.h"
-#include "displayapp/screens/FlashLight.h"
-#include "displayapp/screens/BatteryInfo.h"
-#include "displayapp/screens/Steps.h"
-#include "displayapp/screens/Dice.h"
-#include "displayapp/screens/Weather.h"
-#include "displayapp/screens/PassKey.h"
-#include "displayapp/screens/Error.h"
 
 #include "drivers/Cst816s.h"
 #include "drivers/St7789.h"
 #include "drivers/Watchdog.h"
 #include "systemtask/SystemTask.h"
 #include "systemtask/Messages.h"
+#include "systemtask/EventTrace.h"
 
-#include "displayapp/screens/settings/QuickSettings.h"
-#include "displayapp/screens/settings/Settings.h"
-#include "displayapp/screens/settings/SettingWatchFace.h"
-#include "displayapp/screens/settings/SettingTimeFormat.h"
-#include "displayapp/screens/settings/SettingWeatherFormat.h"
-#include "displayapp/screens/settings/SettingWakeUp.h"
-#include "displayapp/screens/settings/SettingDisplay.h"
-#include "displayapp/screens/settings/SettingSteps.h"
-#include "displayapp/screens/settings/SettingSetDateTime.h"
-#include "displayapp/screens/settings/SettingChimes.h"
-#include "displayapp/screens/settings/SettingShakeThreshold.h"
-#include "displayapp/screens/settings/SettingBluetooth.h"
+#include "displayapp/StreamingFont.h"
 
 #include "libs/lv_conf.h"
-#include "UserApps.h"
 
 using namespace Pinetime::Applications;
 using namespace Pinetime::Applications::Display;
@@ -82,7 +48,9 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                        Pinetime::Controllers::BrightnessController& brightnessController,
                        Pinetime::Controllers::TouchHandler& touchHandler,
                        Pinetime::Controllers::FS& filesystem,
-                       Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                       const Pinetime::System::TaskStatistics& taskStatistics)
   : lcd {lcd},
     touchPanel {touchPanel},
     batteryController {batteryController},
@@ -99,6 +67,8 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     touchHandler {touchHandler},
     filesystem {filesystem},
     spiNorFlash {spiNorFlash},
+    displayStatistics {displayStatistics},
+    taskStatistics {taskStatistics},
     lvgl {lcd, filesystem},
     timer(this, TimerCallback),
     controllers {batteryController,
@@ -127,6 +97,7 @@ void DisplayApp::Start(System::BootErrors error) {
   bootError = error;
 
   lvgl.Init();
+  remoteGlyphFont.Init();
   motorController.Init();
 
   if (error == System::BootErrors::TouchController) {
@@ -144,6 +115,15 @@ void DisplayApp::Process(void* instance) {
   auto* app = static_cast<DisplayApp*>(instance);
   NRF_LOG_INFO("displayapp task started!");
   app->InitHw();
+#ifdef DISPLAY_FLUSH_BENCHMARK
+  app->RunFlushBenchmark();
+#endif
+#ifdef SCREEN_LOAD_BENCHMARK
+  app->RunScreenLoadBenchmark();
+#endif
+#ifdef FONT_LOAD_BENCHMARK
+  Components::StreamingFont::RunBenchmark(app->filesystem);
+#endif
 
   while (true) {
     app->Refresh();
@@ -186,6 +166,23 @@ TickType_t DisplayApp::CalculateSleepTime() {
   }
 }
 
+// Runs lv_task_handler() and reports its duration and the frame it drew (if any) to displayStatistics
+uint32_t DisplayApp::RunLvglTasks() {
+  const uint32_t start = DWT->CYCCNT;
+  const uint32_t timeTillNext = lv_task_handler();
+  displayStatistics.OnTaskHandler(DWT->CYCCNT - start);
+
+  // The last flush of a frame may end after lv_task_handler() returns : the frame is reported by the next call
+  const auto frame = lvgl.LastFrameStatistics();
+  if (frame.sequence != lastFrameSequence) {
+    lastFrameSequence = frame.sequence;
+    displayStatistics.OnFrame(currentApp,
+                              settingsController.GetWatchFace(),
+                              {frame.renderCycles, frame.flushCycles, frame.frameCycles, frame.bytes, frame.nbFlushes});
+  }
+  return timeTillNext;
+}
+
 void DisplayApp::Refresh() {
   auto LoadPreviousScreen = [this]() {
     FullRefreshDirections returnDirection;
@@ -232,12 +229,15 @@ void DisplayApp::Refresh() {
           // Only advance the tick count when LVGL is done
           // Otherwise keep running the task handler while it still has things to draw
           // Note: under high graphics load, LVGL will always have more work to do
-          if (lv_task_handler() > 0) {
+          if (RunLvglTasks() > 0) {
             // Drop frames that we've missed if drawing/event handling took way longer than expected
+            uint32_t nbFrames = 0;
             while (queueTimeout == 0) {
               alwaysOnTickCount += 1;
+              nbFrames++;
               queueTimeout = CalculateSleepTime();
             }
+            displayStatistics.OnAlwaysOnFramesDropped(nbFrames - 1);
           };
         }
       } else {
@@ -248,7 +248,8 @@ void DisplayApp::Refresh() {
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
-      queueTimeout = lv_task_handler();
+      queueTimeout = RunLvglTasks();
+      remoteGlyphFont.SendRequests();
 
       if (!systemTask->IsSleepDisabled() && IsPastDimTime()) {
         if (!isDimmed) {
@@ -345,7 +346,7 @@ void DisplayApp::Refresh() {
         }
         if (currentApp == Apps::Timer) {
           lv_disp_trig_activity(nullptr);
-          auto* timer = static_cast<Screens::Timer*>(currentScreen.get());
+          auto* timer = static_cast<Screens::Timer*>(currentScreen.Get());
           timer->Reset();
         } else {
           LoadNewScreen(Apps::Timer, DisplayApp::FullRefreshDirections::Up);
@@ -354,7 +355,7 @@ void DisplayApp::Refresh() {
         break;
       case Messages::AlarmTriggered:
         if (currentApp == Apps::Alarm) {
-          auto* alarm = static_cast<Screens::Alarm*>(currentScreen.get());
+          auto* alarm = static_cast<Screens::Alarm*>(currentScreen.Get());
           alarm->SetAlerting();
         } else {
           LoadNewScreen(Apps::Alarm, DisplayApp::FullRefreshDirections::None);
@@ -456,6 +457,9 @@ void DisplayApp::Refresh() {
       case Messages::OnChargingEvent:
         motorController.RunForDuration(15);
         break;
+      case Messages::RemoteGlyphReceived:
+        remoteGlyphFont.OnGlyphsReceived();
+        break;
     }
   }
 
@@ -490,7 +494,8 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   lv_disp_trig_activity(nullptr);
   motorController.StopRinging();
 
-  currentScreen.reset(nullptr);
+  currentScreen.Clear();
+  remoteGlyphFont.ResetRequests();
   SetFullRefresh(direction);
 
   switch (app) {
@@ -500,13 +505,13 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
       for (const auto& userApp : userApps) {
         apps[i++] = Screens::Tile::Applications {userApp.icon, userApp.app, true};
       }
-      currentScreen = std::make_unique<Screens::ApplicationList>(this,
-                                                                 settingsController,
-                                                                 batteryController,
-                                                                 bleController,
-                                                                 dateTimeController,
-                                                                 filesystem,
-                                                                 std::move(apps));
+      currentScreen.Emplace<Screens::ApplicationList>(this,
+                                                      settingsController,
+                                                      batteryController,
+                                                      bleController,
+                                                      dateTimeController,
+                                                      filesystem,
+                                                      std::move(apps));
     } break;
     case Apps::Clock: {
       const auto* watchFace =
@@ -514,54 +519,58 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
           return watchfaceDescription.watchFace == settingsController.GetWatchFace();
         });
       if (watchFace != userWatchFaces.end())
-        currentScreen.reset(watchFace->create(controllers));
+        currentScreen.EmplaceWith([this, watchFace](void* memory) {
+          return watchFace->create(controllers, memory);
+        });
       else {
-        currentScreen.reset(userWatchFaces[0].create(controllers));
+        currentScreen.EmplaceWith([this](void* memory) {
+          return userWatchFaces[0].create(controllers, memory);
+        });
       }
       settingsController.SetAppMenu(0);
     } break;
     case Apps::Error:
-      currentScreen = std::make_unique<Screens::Error>(bootError);
+      currentScreen.Emplace<Screens::Error>(bootError);
       break;
 
     case Apps::FirmwareValidation:
-      currentScreen = std::make_unique<Screens::FirmwareValidation>(validator);
+      currentScreen.Emplace<Screens::FirmwareValidation>(validator);
       break;
     case Apps::FirmwareUpdate:
-      currentScreen = std::make_unique<Screens::FirmwareUpdate>(bleController);
+      currentScreen.Emplace<Screens::FirmwareUpdate>(bleController);
       break;
 
     case Apps::PassKey:
-      currentScreen = std::make_unique<Screens::PassKey>(bleController.GetPairingKey());
+      currentScreen.Emplace<Screens::PassKey>(bleController.GetPairingKey());
       break;
 
     case Apps::Notifications:
-      currentScreen = std::make_unique<Screens::Notifications>(this,
-                                                               notificationManager,
-                                                               systemTask->nimble().alertService(),
-                                                               motorController,
-                                                               *systemTask,
-                                                               Screens::Notifications::Modes::Normal);
+      currentScreen.Emplace<Screens::Notifications>(this,
+                                                    notificationManager,
+                                                    systemTask->nimble().alertService(),
+                                                    motorController,
+                                                    *systemTask,
+                                                    Screens::Notifications::Modes::Normal);
       break;
     case Apps::NotificationsPreview:
-      currentScreen = std::make_unique<Screens::Notifications>(this,
-                                                               notificationManager,
-                                                               systemTask->nimble().alertService(),
-                                                               motorController,
-                                                               *systemTask,
-                                                               Screens::Notifications::Modes::Preview);
+      currentScreen.Emplace<Screens::Notifications>(this,
+                                                    notificationManager,
+                                                    systemTask->nimble().alertService(),
+                                                    motorController,
+                                                    *systemTask,
+                                                    Screens::Notifications::Modes::Preview);
       break;
     case Apps::QuickSettings:
-      currentScreen = std::make_unique<Screens::QuickSettings>(this,
-                                                               batteryController,
-                                                               dateTimeController,
-                                                               brightnessController,
-                                                               motorController,
-                                                               settingsController,
-                                                               bleController);
+      currentScreen.Emplace<Screens::QuickSettings>(this,
+                                                    batteryController,
+                                                    dateTimeController,
+                                                    brightnessController,
+                                                    motorController,
+                                                    settingsController,
+                                                    bleController);
       break;
     case Apps::Settings:
-      currentScreen = std::make_unique<Screens::Settings>(this, settingsController);
+      currentScreen.Emplace<Screens::Settings>(this, settingsController);
       break;
     case Apps::SettingWatchFace: {
       std::array<Screens::SettingWatchFace::Item, UserWatchFaceTypes::Count> items;
@@ -570,60 +579,66 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
         items[i++] =
           Screens::SettingWatchFace::Item {userWatchFace.name, userWatchFace.watchFace, userWatchFace.isAvailable(controllers.filesystem)};
       }
-      currentScreen = std::make_unique<Screens::SettingWatchFace>(this, std::move(items), settingsController, filesystem);
+      currentScreen.Emplace<Screens::SettingWatchFace>(this, std::move(items), settingsController, filesystem);
     } break;
     case Apps::SettingTimeFormat:
-      currentScreen = std::make_unique<Screens::SettingTimeFormat>(settingsController);
+      currentScreen.Emplace<Screens::SettingTimeFormat>(settingsController);
       break;
     case Apps::SettingWeatherFormat:
-      currentScreen = std::make_unique<Screens::SettingWeatherFormat>(settingsController);
+      currentScreen.Emplace<Screens::SettingWeatherFormat>(settingsController);
       break;
     case Apps::SettingWakeUp:
-      currentScreen = std::make_unique<Screens::SettingWakeUp>(settingsController);
+      currentScreen.Emplace<Screens::SettingWakeUp>(settingsController);
       break;
     case Apps::SettingDisplay:
-      currentScreen = std::make_unique<Screens::SettingDisplay>(settingsController);
+      currentScreen.Emplace<Screens::SettingDisplay>(settingsController);
       break;
     case Apps::SettingSteps:
-      currentScreen = std::make_unique<Screens::SettingSteps>(settingsController);
+      currentScreen.Emplace<Screens::SettingSteps>(settingsController);
       break;
     case Apps::SettingSetDateTime:
-      currentScreen = std::make_unique<Screens::SettingSetDateTime>(this, dateTimeController, settingsController);
+      currentScreen.Emplace<Screens::SettingSetDateTime>(this, dateTimeController, settingsController);
       break;
     case Apps::SettingChimes:
-      currentScreen = std::make_unique<Screens::SettingChimes>(settingsController);
+      currentScreen.Emplace<Screens::SettingChimes>(settingsController);
       break;
     case Apps::SettingShakeThreshold:
-      currentScreen = std::make_unique<Screens::SettingShakeThreshold>(settingsController, motionController, *systemTask);
+      currentScreen.Emplace<Screens::SettingShakeThreshold>(settingsController, motionController, *systemTask);
       break;
     case Apps::SettingBluetooth:
-      currentScreen = std::make_unique<Screens::SettingBluetooth>(this, settingsController);
+      currentScreen.Emplace<Screens::SettingBluetooth>(this, settingsController);
       break;
     case Apps::BatteryInfo:
-      currentScreen = std::make_unique<Screens::BatteryInfo>(batteryController);
+      currentScreen.Emplace<Screens::BatteryInfo>(batteryController);
       break;
     case Apps::SysInfo:
-      currentScreen = std::make_unique<Screens::SystemInfo>(this,
-                                                            dateTimeController,
-                                                            batteryController,
-                                                            brightnessController,
-                                                            bleController,
-                                                            watchdog,
-                                                            motionController,
-                                                            touchPanel,
-                                                            spiNorFlash);
+      currentScreen.Emplace<Screens::SystemInfo>(this,
+                                                 dateTimeController,
+                                                 batteryController,
+                                                 brightnessController,
+                                                 bleController,
+                                                 watchdog,
+                                                 motionController,
+                                                 touchPanel,
+                                                 spiNorFlash,
+                                                 displayStatistics,
+                                                 taskStatistics);
       break;
     case Apps::FlashLight:
-      currentScreen = std::make_unique<Screens::FlashLight>(*systemTask, brightnessController);
+      currentScreen.Emplace<Screens::FlashLight>(*systemTask, brightnessController);
       break;
     default: {
       const auto* d = std::find_if(userApps.begin(), userApps.end(), [app](const AppDescription& appDescription) {
         return appDescription.app == app;
       });
       if (d != userApps.end()) {
-        currentScreen.reset(d->create(controllers));
+        currentScreen.EmplaceWith([this, d](void* memory) {
+          return d->create(controllers, memory);
+        });
       } else {
-        currentScreen.reset(userWatchFaces[0].create(controllers));
+        currentScreen.EmplaceWith([this](void* memory) {
+          return userWatchFaces[0].create(controllers, memory);
+        });
       }
       break;
     }
@@ -632,6 +647,7 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
 }
 
 void DisplayApp::PushMessage(Messages msg) {
+  TRACE_EVENT(DisplayMessage, static_cast<uint32_t>(msg) | (in_isr() ? 0x100 : 0));
   if (in_isr()) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     xQueueSendFromISR(msgQueue, &msg, &xHigherPriorityTaskWoken);
@@ -641,7 +657,8 @@ void DisplayApp::PushMessage(Messages msg) {
     // Make xQueueSend() non-blocking if the message is a Notification message. We do this to avoid
     // deadlock between SystemTask and DisplayApp when their respective message queues are getting full
     // when a lot of notifications are received on a very short time span.
-    if (msg == Messages::NewNotification) {
+    // The same applies to glyphs, which are downloaded in bursts.
+    if (msg == Messages::NewNotification || msg == Messages::RemoteGlyphReceived) {
       timeout = static_cast<TickType_t>(0);
     }
 
@@ -674,6 +691,20 @@ void DisplayApp::SetFullRefresh(DisplayApp::FullRefreshDirections direction) {
   }
 }
 
+void Screens::SetScreenListRefresh(DisplayApp* app, TouchEvents event) {
+  switch (event) {
+    case TouchEvents::SwipeDown:
+      app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
+      break;
+    case TouchEvents::SwipeUp:
+      app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
+      break;
+    default:
+      app->SetFullRefresh(DisplayApp::FullRefreshDirections::None);
+      break;
+  }
+}
+
 void DisplayApp::PushMessageToSystemTask(Pinetime::System::Messages message) {
   if (systemTask != nullptr) {
     systemTask->PushMessage(message);
@@ -697,6 +728,10 @@ void DisplayApp::Register(Pinetime::Controllers::NavigationService* NavigationSe
   this->controllers.navigationService = NavigationService;
 }
 
+void DisplayApp::Register(Pinetime::Controllers::RemoteFont* remoteFont) {
+  remoteGlyphFont.Register(remoteFont);
+}
+
 void DisplayApp::ApplyBrightness() {
   auto brightness = settingsController.GetBrightness();
   if (brightness != Controllers::BrightnessController::Levels::Low && brightness != Controllers::BrightnessController::Levels::Medium &&
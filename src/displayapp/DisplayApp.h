@@ -2,10 +2,12 @@
 #include <FreeRTOS.h>
 #include <queue.h>
 #include <task.h>
+#include <algorithm>
 #include <memory>
 #include <systemtask/Messages.h>
 #include "displayapp/apps/Apps.h"
 #include "displayapp/LittleVgl.h"
+#include "displayapp/RemoteGlyphFont.h"
 #include "displayapp/TouchEvents.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/motor/MotorController.h"
@@ -14,6 +16,8 @@
 #include "displayapp/screens/Screen.h"
 #include "components/timer/Timer.h"
 #include "components/alarm/AlarmController.h"
+#include "components/display/DisplayStatistics.h"
+#include "systemtask/TaskStatistics.h"
 #include "touchhandler/TouchHandler.h"
 
 #include "displayapp/Messages.h"
@@ -21,6 +25,9 @@
 
 #include "utility/StaticStack.h"
 #include "displayapp/Controllers.h"
+#include "displayapp/ScreenArena.h"
+#include "displayapp/SystemScreens.h"
+#include "displayapp/UserApps.h"
 
 namespace Pinetime {
 
@@ -40,6 +47,7 @@ namespace Pinetime {
     class MotionController;
     class TouchHandler;
     class SimpleWeatherService;
+    class RemoteFont;
   }
 
   namespace System {
@@ -67,7 +75,9 @@ namespace Pinetime {
                  Pinetime::Controllers::BrightnessController& brightnessController,
                  Pinetime::Controllers::TouchHandler& touchHandler,
                  Pinetime::Controllers::FS& filesystem,
-                 Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                 Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                 Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                 const Pinetime::System::TaskStatistics& taskStatistics);
       void Start(System::BootErrors error);
       void PushMessage(Display::Messages msg);
 
@@ -79,6 +89,7 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::SimpleWeatherService* weatherService);
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
+      void Register(Pinetime::Controllers::RemoteFont* remoteFont);
 
     private:
       Pinetime::Drivers::St7789& lcd;
@@ -98,9 +109,12 @@ namespace Pinetime {
       Pinetime::Controllers::TouchHandler& touchHandler;
       Pinetime::Controllers::FS& filesystem;
       Pinetime::Drivers::SpiNorFlash& spiNorFlash;
+      Pinetime::Controllers::DisplayStatistics& displayStatistics;
+      const Pinetime::System::TaskStatistics& taskStatistics;
 
       Pinetime::Controllers::FirmwareValidator validator;
       Pinetime::Components::LittleVgl lvgl;
+      Pinetime::Components::RemoteGlyphFont remoteGlyphFont;
       Pinetime::Controllers::Timer timer;
 
       AppControllers controllers;
@@ -112,7 +126,11 @@ namespace Pinetime {
       static constexpr uint8_t queueSize = 10;
       static constexpr uint8_t itemSize = 1;
 
-      std::unique_ptr<Screens::Screen> currentScreen;
+      // The screen displayed is constructed in place in the arena, as large as the largest screen of the apps and watch faces
+      static constexpr size_t screenArenaSize = std::max({SystemScreens::size, UserAppScreens::size, UserWatchFaceScreens::size});
+      static constexpr size_t screenArenaAlignment =
+        std::max({SystemScreens::alignment, UserAppScreens::alignment, UserWatchFaceScreens::alignment});
+      ScreenArena<screenArenaSize, screenArenaAlignment> currentScreen;
 
       Apps currentApp = Apps::None;
       Apps returnToApp = Apps::None;
@@ -123,6 +141,13 @@ namespace Pinetime {
       static void Process(void* instance);
       void InitHw();
       void Refresh();
+      uint32_t RunLvglTasks();
+#ifdef DISPLAY_FLUSH_BENCHMARK
+      void RunFlushBenchmark();
+#endif
+#ifdef SCREEN_LOAD_BENCHMARK
+      void RunScreenLoadBenchmark();
+#endif
       void LoadNewScreen(Apps app, DisplayApp::FullRefreshDirections direction);
       void LoadScreen(Apps app, DisplayApp::FullRefreshDirections direction);
       void PushMessageToSystemTask(Pinetime::System::Messages message);
@@ -137,6 +162,7 @@ namespace Pinetime {
       Utility::StaticStack<FullRefreshDirections, returnAppStackSize> appStackDirections;
 
       bool isDimmed = false;
+      uint32_t lastFrameSequence = 0;
 
       TickType_t CalculateSleepTime();
       TickType_t alwaysOnTickCount;
@@ -0,0 +1,133 @@
+#include "displayapp/DisplayApp.h"
+#include "utility/CycleCounter.h"
+#include <libraries/log/nrf_log.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include "components/fs/FS.h"
+#include "displayapp/LvglPool.h"
+
+using namespace Pinetime::Applications;
+
+#ifdef DISPLAY_FLUSH_BENCHMARK
+namespace {
+  // Writes a file from a task of its own while the display task refreshes the screen : the flash memory and the display share the
+  // SPI bus, the flush stalls while the file is written
+  struct FlashWriter {
+    Pinetime::Controllers::FS& filesystem;
+    std::atomic<bool> done {false};
+  };
+
+  void WriteFlash(void* instance) {
+    static constexpr size_t fileSize = 64 * 1024;
+    static constexpr size_t chunkSize = 256;
+    auto* writer = static_cast<FlashWriter*>(instance);
+    uint8_t chunk[chunkSize];
+    std::fill(std::begin(chunk), std::end(chunk), 0x5a);
+    lfs_file_t file;
+    if (writer->filesystem.FileOpen(&file, "/.system/flushbench.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) == LFS_ERR_OK) {
+      for (size_t written = 0; written < fileSize; written += chunkSize) {
+        writer->filesystem.FileWrite(&file, chunk, chunkSize);
+      }
+      writer->filesystem.FileClose(&file);
+      writer->filesystem.FileDelete("/.system/flushbench.bin");
+    }
+    writer->done = true;
+    vTaskDelete(nullptr);
+  }
+
+  void LogFlushStalls(const char* phase, const Pinetime::Components::LittleVgl::FlushStallStatistics& stalls) {
+    // NRF_LOG_INFO() takes at most 6 arguments
+    NRF_LOG_INFO("[DisplayApp] Flush stalls (%s) : longest %lu us, histogram %lu %lu %lu",
+                 phase,
+                 stalls.longestUs,
+                 stalls.histogram[0],
+                 stalls.histogram[1],
+                 stalls.histogram[2]);
+    NRF_LOG_INFO("[DisplayApp] Flush stalls (%s) : histogram (continued) %lu %lu %lu %lu %lu",
+                 phase,
+                 stalls.histogram[3],
+                 stalls.histogram[4],
+                 stalls.histogram[5],
+                 stalls.histogram[6],
+                 stalls.histogram[7]);
+  }
+}
+
+// Redraws the whole screen with and without chained SPI transfers, and logs the cost of a frame. Then compares the flush
+// stalls of the idle bus with the ones of a bus shared with a 64KB write to the file system.
+void DisplayApp::RunFlushBenchmark() {
+  static constexpr uint32_t nbFrames = 20;
+  Utility::EnableCycleCounter();
+  lvgl.ResetFlushStallStatistics();
+  for (bool chained : {false, true}) {
+    lcd.SetChainedTransfers(chained);
+    const auto interruptsBefore = lcd.SpiStatistics().interrupts;
+    const uint32_t cyclesBefore = DWT->CYCCNT;
+    for (uint32_t i = 0; i < nbFrames; i++) {
+      lv_obj_invalidate(lv_scr_act());
+      lvgl.RefreshDisplay(lv_disp_get_default()->refr_task);
+    }
+    const uint32_t cycles = DWT->CYCCNT - cyclesBefore;
+    const uint32_t interrupts = lcd.SpiStatistics().interrupts - interruptsBefore;
+    const auto frame = lvgl.LastFrameStatistics();
+    NRF_LOG_INFO("[DisplayApp] Flush (chained = %d) : %lu cycles/frame, %lu SPI interrupts/frame",
+                 chained,
+                 cycles / nbFrames,
+                 interrupts / nbFrames);
+    NRF_LOG_INFO("[DisplayApp] Last frame : render %lu, flush %lu, total %lu cycles, overlap %d%%",
+                 frame.renderCycles,
+                 frame.flushCycles,
+                 frame.frameCycles,
+                 frame.overlapPercent);
+  }
+  LogFlushStalls("idle bus", lvgl.GetFlushStallStatistics());
+
+  // The writer has a higher priority than the display task, as SystemTask and the DFU writer that write to the flash memory
+  static FlashWriter writer {filesystem};
+  lvgl.ResetFlushStallStatistics();
+  uint32_t nbWriteFrames = 0;
+  if (xTaskCreate(WriteFlash, "FlushBench", 512, &writer, 1, nullptr) == pdPASS) {
+    while (!writer.done) {
+      lv_obj_invalidate(lv_scr_act());
+      lvgl.RefreshDisplay(lv_disp_get_default()->refr_task);
+      nbWriteFrames++;
+    }
+  }
+  NRF_LOG_INFO("[DisplayApp] %lu frames during the file write", nbWriteFrames);
+  LogFlushStalls("file write", lvgl.GetFlushStallStatistics());
+}
+#endif
+
+#ifdef SCREEN_LOAD_BENCHMARK
+extern Pinetime::Components::LvglPool lvglPool;
+
+// Switches to the same screens several times, and logs the time spent in LoadScreen() and the allocations of LVGL that
+// did not fit in the LVGL pool per switch. The screen itself is constructed in the screen arena, but the page shown by a
+// ScreenList (Settings, System Information) is still allocated from the heap.
+void DisplayApp::RunScreenLoadBenchmark() {
+  static constexpr uint32_t nbSwitches = 10;
+  static constexpr Apps apps[] = {Apps::Clock, Apps::Launcher, Apps::QuickSettings, Apps::Settings, Apps::Notifications, Apps::SysInfo};
+
+  NRF_LOG_INFO("[DisplayApp] Screen arena : %u bytes", currentScreen.size);
+  for (const Apps app : apps) {
+    const uint32_t heapAllocationsBefore = lvglPool.GetStatistics().heapAllocations;
+    uint32_t cycles = 0;
+    uint32_t maxCycles = 0;
+    for (uint32_t i = 0; i < nbSwitches; i++) {
+      const uint32_t start = DWT->CYCCNT;
+      LoadScreen(app, FullRefreshDirections::None);
+      const uint32_t switchCycles = DWT->CYCCNT - start;
+      cycles += switchCycles;
+      maxCycles = std::max(maxCycles, switchCycles);
+    }
+    NRF_LOG_INFO("[DisplayApp] Load screen %u : %lu cycles (max %lu), %lu LVGL heap allocations per switch, %u bytes of heap free",
+                 static_cast<uint8_t>(app),
+                 cycles / nbSwitches,
+                 maxCycles,
+                 (lvglPool.GetStatistics().heapAllocations - heapAllocationsBefore) / nbSwitches,
+                 xPortGetFreeHeapSize());
+  }
+  LoadScreen(Apps::Clock, FullRefreshDirections::None);
+}
+#endif
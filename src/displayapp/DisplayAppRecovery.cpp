@@ -25,7 +25,9 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                        Pinetime::Controllers::BrightnessController& /*brightnessController*/,
                        Pinetime::Controllers::TouchHandler& /*touchHandler*/,
                        Pinetime::Controllers::FS& /*filesystem*/,
-                       Pinetime::Drivers::SpiNorFlash& /*spiNorFlash*/)
+                       Pinetime::Drivers::SpiNorFlash& /*spiNorFlash*/,
+                       Pinetime::Controllers::DisplayStatistics& /*displayStatistics*/,
+                       const Pinetime::System::TaskStatistics& /*taskStatistics*/)
   : lcd {lcd}, bleController {bleController} {
 }
 
@@ -122,3 +124,6 @@ void DisplayApp::Register(Pinetime::Controllers::MusicService* /*musicService*/)
 
 void DisplayApp::Register(Pinetime::Controllers::NavigationService* /*NavigationService*/) {
 }
+
+void DisplayApp::Register(Pinetime::Controllers::RemoteFont* /*remoteFont*/) {
+}
@@ -37,10 +37,13 @@ namespace Pinetime {
     class SimpleWeatherService;
     class MusicService;
     class NavigationService;
+    class RemoteFont;
+    class DisplayStatistics;
   }
 
   namespace System {
     class SystemTask;
+    class TaskStatistics;
   };
 
   namespace Applications {
@@ -61,7 +64,9 @@ namespace Pinetime {
                  Pinetime::Controllers::BrightnessController& brightnessController,
                  Pinetime::Controllers::TouchHandler& touchHandler,
                  Pinetime::Controllers::FS& filesystem,
-                 Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                 Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                 Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                 const Pinetime::System::TaskStatistics& taskStatistics);
       void Start();
 
       void Start(Pinetime::System::BootErrors) {
@@ -73,6 +78,7 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::SimpleWeatherService* weatherService);
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
+      void Register(Pinetime::Controllers::RemoteFont* remoteFont);
 
     private:
       TaskHandle_t taskHandle;
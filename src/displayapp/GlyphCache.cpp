@@ -0,0 +1,143 @@
+#include "displayapp/GlyphCache.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace Pinetime::Components;
+using namespace Pinetime::Controllers;
+
+GlyphCache::GlyphCache(Source& source) : source {source} {
+  owners.fill(freeSlot);
+}
+
+const GlyphCache::GlyphHeader* GlyphCache::Metrics(uint16_t codePoint) {
+  if (codePoint == noCodePoint) {
+    return nullptr;
+  }
+
+  auto& set = metrics[codePoint % nbMetricsSets];
+  for (size_t way = 0; way < nbMetricsWays; way++) {
+    if (set[way].codePoint == codePoint) {
+      std::rotate(set.begin(), set.begin() + way, set.begin() + way + 1);
+      return &set[0].header;
+    }
+  }
+
+  // The header is at the beginning of the payload : it is already in RAM if the bitmap is cached
+  GlyphHeader header;
+  const GlyphHeader* cachedHeader = FindBitmapHeader(codePoint);
+  if (cachedHeader != nullptr) {
+    std::memcpy(&header, cachedHeader, sizeof(header));
+  } else {
+    const int size = source.GlyphSize(codePoint);
+    if (size < static_cast<int>(sizeof(header)) ||
+        source.Read(codePoint, reinterpret_cast<uint8_t*>(&header), sizeof(header)) != static_cast<int>(sizeof(header))) {
+      return nullptr;
+    }
+    // Reject glyphs whose header does not match the payload, LVGL would read past the bitmap otherwise
+    if (!RemoteFontProtocol::IsValid(header, size)) {
+      return nullptr;
+    }
+  }
+
+  // The least recently used way is replaced
+  std::rotate(set.begin(), set.end() - 1, set.end());
+  set[0].codePoint = codePoint;
+  std::memcpy(&set[0].header, &header, sizeof(header));
+  return &set[0].header;
+}
+
+const uint8_t* GlyphCache::Bitmap(uint16_t codePoint) {
+  if (codePoint == noCodePoint) {
+    return nullptr;
+  }
+  int first = FindBitmap(codePoint);
+  if (first < 0) {
+    first = LoadBitmap(codePoint);
+  }
+  if (first < 0) {
+    return nullptr;
+  }
+
+  if (++useCounter == 0) {
+    // The ages are relative to useCounter, they are only reset after 65535 bitmaps
+    for (auto& entry : bitmaps) {
+      entry.lastUse = 0;
+    }
+    useCounter = 1;
+  }
+  bitmaps[first].lastUse = useCounter;
+  return &bitmapPool[first * bitmapSlotSize + sizeof(GlyphHeader)];
+}
+
+const GlyphCache::GlyphHeader* GlyphCache::FindBitmapHeader(uint16_t codePoint) const {
+  const int first = FindBitmap(codePoint);
+  if (first < 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const GlyphHeader*>(&bitmapPool[first * bitmapSlotSize]);
+}
+
+int GlyphCache::FindBitmap(uint16_t codePoint) const {
+  for (size_t i = 0; i < nbBitmapSlots; i++) {
+    if (bitmaps[i].nbSlots > 0 && bitmaps[i].codePoint == codePoint) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int GlyphCache::LoadBitmap(uint16_t codePoint) {
+  const int size = source.GlyphSize(codePoint);
+  if (size < static_cast<int>(sizeof(GlyphHeader)) || size > static_cast<int>(bitmapBudget)) {
+    return -1;
+  }
+
+  const size_t nbSlots = (size + bitmapSlotSize - 1) / bitmapSlotSize;
+  const size_t first = SelectSlots(nbSlots);
+  for (size_t i = first; i < first + nbSlots; i++) {
+    if (owners[i] != freeSlot) {
+      FreeSlots(owners[i], bitmaps[owners[i]].nbSlots);
+    }
+  }
+
+  uint8_t* payload = &bitmapPool[first * bitmapSlotSize];
+  if (source.Read(codePoint, payload, size) != size) {
+    return -1;
+  }
+  GlyphHeader header;
+  std::memcpy(&header, payload, sizeof(header));
+  if (!RemoteFontProtocol::IsValid(header, size)) {
+    return -1;
+  }
+
+  bitmaps[first] = {codePoint, useCounter, static_cast<uint8_t>(nbSlots)};
+  std::fill(owners.begin() + first, owners.begin() + first + nbSlots, static_cast<uint8_t>(first));
+  return first;
+}
+
+// Returns the first of the nbSlots consecutive slots whose glyphs are evicted to load a new one : the range of slots
+// whose most recently used glyph is the oldest
+size_t GlyphCache::SelectSlots(size_t nbSlots) const {
+  size_t best = 0;
+  uint32_t bestAge = 0;
+  for (size_t first = 0; first + nbSlots <= nbBitmapSlots; first++) {
+    // Free slots are older than any glyph
+    uint32_t youngest = std::numeric_limits<uint16_t>::max() + 1;
+    for (size_t i = first; i < first + nbSlots; i++) {
+      if (owners[i] != freeSlot) {
+        youngest = std::min<uint32_t>(youngest, Age(bitmaps[owners[i]]));
+      }
+    }
+    if (first == 0 || youngest > bestAge) {
+      best = first;
+      bestAge = youngest;
+    }
+  }
+  return best;
+}
+
+void GlyphCache::FreeSlots(size_t first, size_t nbSlots) {
+  std::fill(owners.begin() + first, owners.begin() + first + nbSlots, freeSlot);
+  bitmaps[first] = {};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "components/ble/RemoteFontProtocol.h"
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * RAM cache of the glyphs that RemoteGlyphFont draws, in front of the glyphs stored in the flash memory.
+     *
+     * LVGL renders the screen in stripes of LVGL_DRAW_BUFFER_LINES lines. For each stripe, it looks up the metrics of
+     * every glyph of the lines above it (to break the text into lines), then the bitmaps of the glyphs of the lines
+     * that cross it. The two are cached separately, so that measuring the lines above a stripe does not evict the
+     * bitmaps it draws :
+     *  - the metrics (the 6-byte GlyphHeader) in a set-associative LRU cache that holds the glyphs of a screen;
+     *  - the bitmaps in fixed-size slots (a glyph uses as many consecutive slots as it needs), evicted in LRU order.
+     *    The lines are drawn from top to bottom and the cache holds the longest line of ideographs : each bitmap is
+     *    read once per frame instead of once per stripe that crosses its line.
+     */
+    class GlyphCache {
+    public:
+      using GlyphHeader = Pinetime::Controllers::RemoteFontProtocol::GlyphHeader;
+
+      /// Glyphs stored in the flash memory
+      class Source {
+      public:
+        /// Returns the size of the payload of the glyph (GlyphHeader + bitmap), or a negative value if it is not available
+        virtual int GlyphSize(uint16_t codePoint) = 0;
+        /// Copies the first size bytes of the payload into buffer, returns the number of bytes copied or a negative value
+        virtual int Read(uint16_t codePoint, uint8_t* buffer, size_t size) = 0;
+      };
+
+      // 10 lines of 13 glyphs fill the screen
+      static constexpr size_t nbMetricsSets = 16;
+      static constexpr size_t nbMetricsWays = 8;
+      // An ideograph rendered at 20px is 18x19 pixels at 4 bits per pixel (177 bytes with the header), 13 of them fill
+      // a line of the screen
+      static constexpr size_t bitmapSlotSize = 96;
+      static constexpr size_t maxIdeographsPerLine = 240 / 18;
+      static constexpr size_t nbBitmapSlots = maxIdeographsPerLine * 2;
+      static constexpr size_t bitmapBudget = bitmapSlotSize * nbBitmapSlots;
+
+      explicit GlyphCache(Source& source);
+      GlyphCache(const GlyphCache&) = delete;
+      GlyphCache& operator=(const GlyphCache&) = delete;
+      GlyphCache(GlyphCache&&) = delete;
+      GlyphCache& operator=(GlyphCache&&) = delete;
+
+      /// Returns the metrics of the glyph, valid until the next call of Metrics(), or nullptr if the source does not provide it
+      const GlyphHeader* Metrics(uint16_t codePoint);
+      /// Returns the bitmap of the glyph, valid until the next call of Bitmap(), or nullptr if the source does not provide it
+      const uint8_t* Bitmap(uint16_t codePoint);
+
+    private:
+      struct __attribute__((packed)) MetricsEntry {
+        uint16_t codePoint;
+        GlyphHeader header;
+      };
+
+      struct BitmapEntry {
+        uint16_t codePoint;
+        uint16_t lastUse;
+        // Number of slots of the glyph, 0 for the slots that are free or that continue the glyph of a previous slot
+        uint8_t nbSlots;
+      };
+
+      static constexpr uint16_t noCodePoint = 0;
+      static constexpr uint8_t freeSlot = 0xff;
+
+      const GlyphHeader* FindBitmapHeader(uint16_t codePoint) const;
+      int FindBitmap(uint16_t codePoint) const;
+      int LoadBitmap(uint16_t codePoint);
+      size_t SelectSlots(size_t nbSlots) const;
+      void FreeSlots(size_t first, size_t nbSlots);
+      uint16_t Age(const BitmapEntry& entry) const {
+        return useCounter - entry.lastUse;
+      }
+
+      Source& source;
+
+      // The ways of a set are sorted from the most recently used to the least recently used
+      std::array<std::array<MetricsEntry, nbMetricsWays>, nbMetricsSets> metrics = {};
+
+      std::array<uint8_t, bitmapBudget> bitmapPool;
+      // Entry of each slot of bitmapPool : a glyph is described by the entry of its first slot
+      std::array<BitmapEntry, nbBitmapSlots> bitmaps = {};
+      // First slot of the glyph stored in each slot, freeSlot if the slot is free
+      std::array<uint8_t, nbBitmapSlots> owners;
+      uint16_t useCounter = 0;
+    };
+  }
+}
@@ -1,11 +1,14 @@
 #include "displayapp/LittleVgl.h"
+#include "utility/CycleCounter.h"
 #include "displayapp/InfiniTimeTheme.h"
 
 #include <FreeRTOS.h>
 #include <task.h>
+#include <algorithm>
 #include "drivers/St7789.h"
 #include "littlefs/lfs.h"
 #include "components/fs/FS.h"
+#include "systemtask/EventTrace.h"
 
 using namespace Pinetime::Components;
 
@@ -58,6 +61,17 @@ static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_
   lvgl->FlushDisplay(area, color_p);
 }
 
+static void refresh_task(lv_task_t* task) {
+  auto* disp = static_cast<lv_disp_t*>(task->user_data);
+  auto* lvgl = static_cast<LittleVgl*>(disp->driver.user_data);
+  lvgl->RefreshDisplay(task);
+}
+
+static void wait_flush(lv_disp_drv_t* disp_drv) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->WaitFlush();
+}
+
 static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
   if (lvgl->GetFullRefresh()) {
@@ -77,6 +91,13 @@ LittleVgl::LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS&
 }
 
 void LittleVgl::Init() {
+  // Cycle counter used for the frame statistics
+  Utility::EnableCycleCounter();
+
+  if (flushDone == nullptr) {
+    flushDone = xSemaphoreCreateBinary();
+  }
+
   lv_init();
   InitTheme();
   InitDisplay();
@@ -85,8 +106,9 @@ void LittleVgl::Init() {
 }
 
 void LittleVgl::InitDisplay() {
-  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 4); /*Initialize the display buffer*/
-  lv_disp_drv_init(&disp_drv);                                       /*Basic initialization*/
+  lv_color_t* secondBuffer = (drawBufferCount == 2) ? drawBuffers.data() + drawBufferSize : nullptr;
+  lv_disp_buf_init(&disp_buf_2, drawBuffers.data(), secondBuffer, drawBufferSize); /*Initialize the display buffer*/
+  lv_disp_drv_init(&disp_drv);                                                       /*Basic initialization*/
 
   /*Set up the functions to access to your display*/
 
@@ -100,9 +122,13 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  /*Sleep until the SPI transfer of the previous area is done*/
+  disp_drv.wait_cb = wait_flush;
 
   /*Finally register the driver*/
-  lv_disp_drv_register(&disp_drv);
+  lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
+  /*Measure the refreshes*/
+  lv_task_set_cb(disp->refr_task, refresh_task);
 }
 
 void LittleVgl::InitTouchpad() {
@@ -210,6 +236,19 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     }
   }
 
+  const uint32_t flushCallStart = DWT->CYCCNT;
+  flushStartCycles = flushCallStart;
+  flushInProgress = true;
+  currentFrame.nbFlushes++;
+  currentFrame.bytes += width * height * 2;
+
+  // IMPORTANT!!!
+  // The graphics library is informed that the flushing is done (lv_disp_flush_ready()) by the SPI interrupt,
+  // it renders the next area into the other buffer in the meantime.
+  auto flushCompleted = [this]() {
+    OnFlushCompleted();
+  };
+
   if (y2 < y1) {
     height = totalNbLines - y1;
 
@@ -219,15 +258,106 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    lcd.DrawBuffer(area->x1,
+                   0,
+                   width,
+                   height,
+                   reinterpret_cast<const uint8_t*>(color_p + pixOffset),
+                   width * height * 2,
+                   flushCompleted);
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2, flushCompleted);
   }
 
-  // IMPORTANT!!!
-  // Inform the graphics library that you are ready with the flushing
+  const uint32_t stallUs = (DWT->CYCCNT - flushCallStart) / (SystemCoreClock / 1000000);
+  size_t bucket = 0;
+  while (bucket < flushStallBucketLimitUs.size() && stallUs >= flushStallBucketLimitUs[bucket]) {
+    bucket++;
+  }
+  flushStalls.histogram[bucket]++;
+  flushStalls.longestUs = std::max(flushStalls.longestUs, stallUs);
+}
+
+// Called from the SPI interrupt
+void LittleVgl::OnFlushCompleted() {
+  const uint32_t now = DWT->CYCCNT;
+  currentFrame.flushCycles += now - flushStartCycles;
+  currentFrame.flushEnd = now;
+  flushInProgress = false;
   lv_disp_flush_ready(&disp_drv);
+
+  if (currentFrame.closing) {
+    CloseFrame();
+  }
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(flushDone, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void LittleVgl::WaitFlush() {
+  const uint32_t waitStart = DWT->CYCCNT;
+  // LVGL checks the flushing flag again when this returns, the timeout only guards against a lost interrupt
+  xSemaphoreTake(flushDone, pdMS_TO_TICKS(20));
+  currentFrame.waitCycles += DWT->CYCCNT - waitStart;
+}
+
+LittleVgl::FrameStatistics LittleVgl::LastFrameStatistics() const {
+  taskENTER_CRITICAL();
+  const FrameStatistics frame = lastFrame;
+  taskEXIT_CRITICAL();
+  return frame;
+}
+
+void LittleVgl::RefreshDisplay(lv_task_t* task) {
+  taskENTER_CRITICAL();
+  const uint32_t now = DWT->CYCCNT;
+  if (currentFrame.closing) {
+    // The last flush of the previous frame is still running: the rest of it overlaps with this frame
+    currentFrame.flushCycles += now - flushStartCycles;
+    currentFrame.flushEnd = now;
+    flushStartCycles = now;
+    CloseFrame();
+  }
+  currentFrame = {};
+  currentFrame.begin = now;
+  taskEXIT_CRITICAL();
+
+  TRACE_EVENT(LvglRefreshBegin, 0);
+  _lv_disp_refr_task(task);
+  TRACE_EVENT(LvglRefreshEnd, currentFrame.nbFlushes);
+
+  if (currentFrame.nbFlushes == 0) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  currentFrame.renderEnd = DWT->CYCCNT;
+  if (flushInProgress) {
+    currentFrame.closing = true;
+  } else {
+    CloseFrame();
+  }
+  taskEXIT_CRITICAL();
+}
+
+void LittleVgl::CloseFrame() {
+  const uint32_t renderTime = currentFrame.renderEnd - currentFrame.begin;
+  const uint32_t flushTime = currentFrame.flushEnd - currentFrame.begin;
+
+  lastFrame.frameCycles = std::max(renderTime, flushTime);
+  lastFrame.renderCycles = renderTime - std::min(renderTime, currentFrame.waitCycles);
+  lastFrame.flushCycles = currentFrame.flushCycles;
+  lastFrame.nbFlushes = currentFrame.nbFlushes;
+  lastFrame.bytes = currentFrame.bytes;
+  lastFrame.sequence++;
+
+  // The CPU is either rendering or waiting for a flush, so the time during which both happen is what exceeds the frame time
+  const uint32_t busy = lastFrame.renderCycles + lastFrame.flushCycles;
+  const uint32_t overlap = (busy > lastFrame.frameCycles) ? busy - lastFrame.frameCycles : 0;
+  lastFrame.overlapPercent =
+    (lastFrame.flushCycles > 0) ? static_cast<uint8_t>(std::min<uint64_t>(100, uint64_t {overlap} * 100 / lastFrame.flushCycles)) : 0;
+  currentFrame.closing = false;
 }
 
 void LittleVgl::SetNewTouchPoint(int16_t x, int16_t y, bool contact) {
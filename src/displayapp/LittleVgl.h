@@ -1,8 +1,22 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
 
+// Height (in lines) of the buffers LVGL renders into
+#ifndef LVGL_DRAW_BUFFER_LINES
+  #define LVGL_DRAW_BUFFER_LINES 4
+#endif
+
+// With 2 buffers, LVGL renders the next area while the previous one is sent to the display
+#ifndef LVGL_DRAW_BUFFER_COUNT
+  #define LVGL_DRAW_BUFFER_COUNT 2
+#endif
+
 namespace Pinetime {
   namespace Drivers {
     class St7789;
@@ -12,6 +26,17 @@ namespace Pinetime {
     class LittleVgl {
     public:
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
+
+      // Timings of the last refresh that drew something, in CPU cycles
+      struct FrameStatistics {
+        uint32_t renderCycles = 0; // time spent rendering, without the time spent waiting for the display
+        uint32_t flushCycles = 0;  // time during which a buffer was being sent to the display
+        uint32_t frameCycles = 0;  // from the beginning of the refresh to the end of the last flush
+        uint32_t bytes = 0; // sent to the display
+        uint32_t sequence = 0; // incremented for each frame
+        uint8_t nbFlushes = 0;
+        uint8_t overlapPercent = 0; // share of flushCycles during which the CPU was rendering the next area
+      };
       LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS& filesystem);
 
       LittleVgl(const LittleVgl&) = delete;
@@ -22,6 +47,8 @@ namespace Pinetime {
       void Init();
 
       void FlushDisplay(const lv_area_t* area, lv_color_t* color_p);
+      void RefreshDisplay(lv_task_t* task);
+      void WaitFlush();
       bool GetTouchPadInfo(lv_indev_data_t* ptr);
       void SetFullRefresh(FullRefreshDirections direction);
       void SetNewTouchPoint(int16_t x, int16_t y, bool contact);
@@ -35,22 +62,70 @@ namespace Pinetime {
         return returnValue;
       }
 
+      // Copy of the last frame, taken in a critical section : the frame may be closed by the SPI interrupt
+      FrameStatistics LastFrameStatistics() const;
+
+      // Time during which FlushDisplay() blocks the rendering (waiting for the SPI bus, sending the commands),
+      // bucket i counts the flushes that took less than flushStallBucketLimitUs[i]; the last bucket counts the others.
+      static constexpr size_t nbFlushStallBuckets = 8;
+      static constexpr std::array<uint32_t, nbFlushStallBuckets - 1> flushStallBucketLimitUs = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+      struct FlushStallStatistics {
+        std::array<uint32_t, nbFlushStallBuckets> histogram = {};
+        uint32_t longestUs = 0;
+      };
+
+      const FlushStallStatistics& GetFlushStallStatistics() const {
+        return flushStalls;
+      }
+
+      void ResetFlushStallStatistics() {
+        flushStalls = {};
+      }
+
     private:
       void InitDisplay();
       void InitTouchpad();
       void InitFileSystem();
+      void OnFlushCompleted();
+      void CloseFrame();
 
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
 
+      static constexpr uint16_t drawBufferNbLines = LVGL_DRAW_BUFFER_LINES;
+      static constexpr uint8_t drawBufferCount = LVGL_DRAW_BUFFER_COUNT;
+      static constexpr size_t drawBufferSize = LV_HOR_RES_MAX * drawBufferNbLines;
+      static_assert(drawBufferCount == 1 || drawBufferCount == 2, "LVGL renders into 1 or 2 buffers");
+      static_assert(drawBufferNbLines > 0 && drawBufferNbLines <= LV_VER_RES_MAX, "Invalid draw buffer height");
+
       lv_disp_buf_t disp_buf_2;
-      lv_color_t buf2_1[LV_HOR_RES_MAX * 4];
-      lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
+      std::array<lv_color_t, drawBufferSize * drawBufferCount> drawBuffers;
 
       lv_disp_drv_t disp_drv;
 
+      // Given by the SPI interrupt when a flush is done, LVGL waits on it instead of spinning
+      SemaphoreHandle_t flushDone = nullptr;
+      volatile bool flushInProgress = false;
+      uint32_t flushStartCycles = 0;
+
+      struct Frame {
+        uint32_t begin = 0;
+        uint32_t renderEnd = 0;
+        uint32_t flushEnd = 0;
+        uint32_t waitCycles = 0;
+        uint32_t flushCycles = 0;
+        uint32_t bytes = 0;
+        uint8_t nbFlushes = 0;
+        // The refresh is done but the last flush is still in progress
+        bool closing = false;
+      };
+      Frame currentFrame;
+      FrameStatistics lastFrame;
+      FlushStallStatistics flushStalls;
+
       bool fullRefresh = false;
-      static constexpr uint8_t nbWriteLines = 4;
+      static constexpr uint8_t nbWriteLines = drawBufferNbLines;
       static constexpr uint16_t totalNbLines = 320;
       static constexpr uint16_t visibleNbLines = 240;
 
@@ -0,0 +1,107 @@
+#include "displayapp/LvglPool.h"
+#include "systemtask/EventTrace.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <algorithm>
+
+using namespace Pinetime::Components;
+
+extern "C" void vPortGetFreeBlockStats(size_t* pxLargestFreeBlock, size_t* pxNumberOfFreeBlocks);
+
+constexpr std::array<uint16_t, LvglPool::nbClasses> LvglPool::blockSizes;
+constexpr std::array<uint16_t, LvglPool::nbClasses> LvglPool::blockCounts;
+
+LvglPool::LvglPool() {
+  for (size_t i = 0; i < nbClasses; i++) {
+    statistics.classes[i].blockSize = blockSizes[i];
+    statistics.classes[i].nbBlocks = blockCounts[i];
+  }
+}
+
+void* LvglPool::AllocateFromClass(size_t index) {
+  SizeClass& sizeClass = classes[index];
+  void* block = nullptr;
+  if (sizeClass.freeList != nullptr) {
+    block = sizeClass.freeList;
+    sizeClass.freeList = sizeClass.freeList->next;
+  } else if (sizeClass.nextUnused < blockCounts[index]) {
+    block = sizeClass.begin + (sizeClass.nextUnused++ * blockSizes[index]);
+  } else {
+    return nullptr;
+  }
+
+  ClassStatistics& classStatistics = statistics.classes[index];
+  classStatistics.used++;
+  if (classStatistics.used > classStatistics.peakUsed) {
+    classStatistics.peakUsed = classStatistics.used;
+  }
+  return block;
+}
+
+void* LvglPool::Allocate(size_t size) {
+  size_t index = 0;
+  while (index < nbClasses && size > blockSizes[index]) {
+    index++;
+  }
+
+  void* block = nullptr;
+  vTaskSuspendAll();
+  if (pool == nullptr) {
+    pool = static_cast<uint8_t*>(pvPortMalloc(PoolSize()));
+    uint8_t* begin = pool;
+    for (size_t i = 0; i < nbClasses && pool != nullptr; i++) {
+      classes[i] = {begin, nullptr, 0};
+      begin += blockSizes[i] * blockCounts[i];
+    }
+  }
+  if (index < nbClasses && pool != nullptr) {
+    statistics.classes[index].allocations++;
+    for (size_t i = index; i < nbClasses && block == nullptr; i++) {
+      block = AllocateFromClass(i);
+    }
+    if (block == nullptr) {
+      statistics.classes[index].overflows++;
+    }
+  }
+  if (block == nullptr) {
+    statistics.heapAllocations++;
+  }
+  (void) xTaskResumeAll();
+
+  if (block == nullptr) {
+    block = pvPortMalloc(size);
+    if (block == nullptr) {
+      statistics.failures++;
+    }
+  }
+  TRACE_EVENT(LvglAlloc, (reinterpret_cast<uintptr_t>(block) << 16) | std::min<size_t>(size, UINT16_MAX));
+  return block;
+}
+
+void LvglPool::Free(void* ptr) {
+  TRACE_EVENT(LvglFree, reinterpret_cast<uintptr_t>(ptr) & UINT16_MAX);
+  auto* block = static_cast<uint8_t*>(ptr);
+  if (pool == nullptr || block < pool || block >= pool + PoolSize()) {
+    vPortFree(ptr);
+    return;
+  }
+
+  size_t index = 0;
+  while (index < nbClasses - 1 && block >= classes[index + 1].begin) {
+    index++;
+  }
+  vTaskSuspendAll();
+  auto* freeBlock = reinterpret_cast<FreeBlock*>(block);
+  freeBlock->next = classes[index].freeList;
+  classes[index].freeList = freeBlock;
+  statistics.classes[index].used--;
+  (void) xTaskResumeAll();
+}
+
+LvglPool::HeapStatistics LvglPool::GetHeapStatistics() {
+  HeapStatistics heapStatistics;
+  heapStatistics.freeBytes = xPortGetFreeHeapSize();
+  heapStatistics.minimumEverFreeBytes = xPortGetMinimumEverFreeHeapSize();
+  vPortGetFreeBlockStats(&heapStatistics.largestFreeBlock, &heapStatistics.nbFreeBlocks);
+  return heapStatistics;
+}
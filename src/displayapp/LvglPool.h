@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory functions of LVGL (LV_MEM_CUSTOM_ALLOC and LV_MEM_CUSTOM_FREE in lv_conf.h)
+void* lvgl_pool_alloc(size_t size);
+void lvgl_pool_free(void* ptr);
+
+#ifdef __cplusplus
+}
+
+#include <array>
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * Allocator of the LVGL objects, styles and texts : the small allocations are served by size classes of fixed size
+     * blocks (a free list and a bump index per class, O(1) allocation and release), so that they do not fragment the
+     * FreeRTOS heap. A class that is full borrows a block from the next larger class, the allocations larger than the
+     * largest class, or that do not fit in any class, go to the FreeRTOS heap.
+     *
+     * The blocks are taken from the FreeRTOS heap by the first allocation (when LVGL is initialized) and never released.
+     */
+    class LvglPool {
+    public:
+      static constexpr size_t nbClasses = 5;
+
+      struct ClassStatistics {
+        uint16_t blockSize;
+        uint16_t nbBlocks;
+        uint16_t used;
+        uint16_t peakUsed;
+        uint32_t allocations;
+        // Allocations of this size that did not find a free block in the class
+        uint32_t overflows;
+      };
+
+      struct Statistics {
+        std::array<ClassStatistics, nbClasses> classes;
+        // Allocations served by the FreeRTOS heap, and failed allocations
+        uint32_t heapAllocations;
+        uint32_t failures;
+      };
+
+      // Fragmentation of the FreeRTOS heap
+      struct HeapStatistics {
+        size_t freeBytes;
+        size_t minimumEverFreeBytes;
+        size_t largestFreeBlock;
+        size_t nbFreeBlocks;
+      };
+
+      LvglPool();
+
+      void* Allocate(size_t size);
+      void Free(void* ptr);
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
+
+      static HeapStatistics GetHeapStatistics();
+
+      // Called by vApplicationMallocFailedHook() : allocations of the FreeRTOS heap that failed, LVGL or not
+      void OnMallocFailed() {
+        mallocFailures++;
+      }
+
+      uint32_t MallocFailures() const {
+        return mallocFailures;
+      }
+
+#ifdef LVGL_POOL_BENCHMARK
+      void RunBenchmark();
+#endif
+
+    private:
+      struct FreeBlock {
+        FreeBlock* next;
+      };
+
+      struct SizeClass {
+        uint8_t* begin;
+        FreeBlock* freeList;
+        // Blocks after this index were never allocated
+        uint16_t nextUnused;
+      };
+
+      // Block sizes include the 4 byte header added by LVGL, and are multiples of 8 (alignment of the FreeRTOS heap)
+      static constexpr std::array<uint16_t, nbClasses> blockSizes {16, 32, 48, 64, 96};
+      // Twice the peak number of blocks of each class over the modeled screens of LvglPoolTraces.h (22, 11, 15, 1 and 13
+      // blocks, checked by the host test LvglPoolTest), 5.3KB. No trace recorded on the watch comes with the sources : the
+      // host benchmark LvglPoolBenchmark prints the peaks of a recorded one (see doc/Benchmarks.md).
+      static constexpr std::array<uint16_t, nbClasses> blockCounts {44, 22, 30, 2, 26};
+
+      static constexpr size_t PoolSize() {
+        size_t size = 0;
+        for (size_t i = 0; i < nbClasses; i++) {
+          size += blockSizes[i] * blockCounts[i];
+        }
+        return size;
+      }
+
+      void* AllocateFromClass(size_t index);
+
+      uint8_t* pool = nullptr;
+      std::array<SizeClass, nbClasses> classes;
+      Statistics statistics {};
+      uint32_t mallocFailures = 0;
+    };
+  }
+}
+#endif
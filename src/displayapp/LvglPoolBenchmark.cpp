@@ -0,0 +1,126 @@
+#include "displayapp/LvglPool.h"
+#include "displayapp/LvglPoolTraces.h"
+#include "utility/CycleCounter.h"
+#include <FreeRTOS.h>
+#include <nrf_log.h>
+#include <algorithm>
+
+#ifdef LVGL_POOL_BENCHMARK
+using namespace Pinetime::Components;
+
+namespace {
+  constexpr size_t nbScreenSwitches = 200;
+
+  struct Replay {
+    const char* name;
+    void* (*allocate)(size_t);
+    void (*release)(void*);
+    uint32_t cycles;
+    uint32_t operations;
+    uint32_t failures;
+    // Fragmentation of the heap while the screens are displayed
+    size_t minLargestFreeBlock;
+    size_t maxFreeBlocks;
+  };
+
+  template <size_t N>
+  void ReplayScreen(const int16_t (&trace)[N], Replay& replay) {
+    static void* allocations[N];
+    size_t nbAllocations = 0;
+    uint32_t start = DWT->CYCCNT;
+    for (const int16_t entry : trace) {
+      if (entry > 0) {
+        allocations[nbAllocations] = replay.allocate(entry);
+        if (allocations[nbAllocations] == nullptr) {
+          replay.failures++;
+        }
+        nbAllocations++;
+        replay.operations++;
+      } else if (static_cast<size_t>(-entry) <= nbAllocations) {
+        void*& allocation = allocations[nbAllocations + entry];
+        if (allocation != nullptr) {
+          replay.release(allocation);
+          allocation = nullptr;
+          replay.operations++;
+        }
+      }
+    }
+    replay.cycles += DWT->CYCCNT - start;
+
+    const auto heap = LvglPool::GetHeapStatistics();
+    replay.minLargestFreeBlock = std::min(replay.minLargestFreeBlock, heap.largestFreeBlock);
+    replay.maxFreeBlocks = std::max(replay.maxFreeBlocks, heap.nbFreeBlocks);
+
+    start = DWT->CYCCNT;
+    for (size_t i = 0; i < nbAllocations; i++) {
+      if (allocations[i] != nullptr) {
+        replay.release(allocations[i]);
+        replay.operations++;
+      }
+    }
+    replay.cycles += DWT->CYCCNT - start;
+  }
+
+  LvglPool* benchmarkPool = nullptr;
+}
+
+// Replays 200 screen switches with the FreeRTOS heap only, then with the pool, and logs the time per operation and the
+// worst fragmentation of the heap while the screens are displayed. Between two screens, an allocation of another size (a screen
+// object, a buffer...) is made from the heap and kept during 3 screens.
+void LvglPool::RunBenchmark() {
+  Utility::EnableCycleCounter();
+
+  benchmarkPool = this;
+  Replay replays[] = {{"heap", pvPortMalloc, vPortFree, 0, 0, 0, SIZE_MAX, 0},
+                      {"pool",
+                       [](size_t size) {
+                         return benchmarkPool->Allocate(size);
+                       },
+                       [](void* ptr) {
+                         benchmarkPool->Free(ptr);
+                       },
+                       0,
+                       0,
+                       0,
+                       SIZE_MAX,
+                       0}};
+
+  for (Replay& replay : replays) {
+    void* longLived[3] {};
+    for (size_t screen = 0; screen < nbScreenSwitches; screen++) {
+      switch (screen % 3) {
+        case 0:
+          ReplayScreen(LvglPoolTraces::watchFace, replay);
+          break;
+        case 1:
+          ReplayScreen(LvglPoolTraces::list, replay);
+          break;
+        default:
+          ReplayScreen(LvglPoolTraces::settings, replay);
+          break;
+      }
+      vPortFree(longLived[screen % 3]);
+      longLived[screen % 3] = pvPortMalloc(64 + (screen % 5) * 40);
+    }
+
+    NRF_LOG_INFO("[LvglPool] %s : %lu cycles per operation, %lu failures, largest free block >= %u B, free blocks <= %u",
+                 replay.name,
+                 replay.cycles / replay.operations,
+                 replay.failures,
+                 replay.minLargestFreeBlock,
+                 replay.maxFreeBlocks);
+    for (void* allocation : longLived) {
+      vPortFree(allocation);
+    }
+  }
+
+  for (const auto& classStatistics : statistics.classes) {
+    NRF_LOG_INFO("[LvglPool] %u B : peak %u/%u blocks, %lu allocations, %lu overflows",
+                 classStatistics.blockSize,
+                 classStatistics.peakUsed,
+                 classStatistics.nbBlocks,
+                 classStatistics.allocations,
+                 classStatistics.overflows);
+  }
+}
+#endif
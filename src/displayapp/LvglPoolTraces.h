@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * Synthetic traces of the lv_mem_alloc() calls made while a screen is built, displayed and deleted, modeled on the sizes
+     * of LVGL 7 (header included) : 80 bytes per object (lv_obj_t and its node in the list of children of its parent),
+     * 12 to 40 bytes for the extended attributes, the lists of styles and the texts, growing style maps.
+     * A positive value allocates that size, -k releases the k-th last allocation (-1 : the last one).
+     * The allocations that are still alive are released when the screen is deleted.
+     *
+     * Replayed by LVGL_POOL_BENCHMARK, and by the host tests to size the classes of LvglPool.
+     */
+    namespace LvglPoolTraces {
+      constexpr int16_t watchFace[] = {80, 12, 16, 28, 44, 80, 12, 40, 36, 20, 80, 12, 40, 36, 12, 80, 12, 40, 36, 24,
+                                       80, 12, 40, 36, 12, -3, 16, 80, 12, 40, 36, 16, 80, 12, 24, 28, 12, -4, 20, 80,
+                                       12, 40, 36, 8,  80, 12, 40, 36, 12, 16, 20, 24, 32, -7, 12, 80, 12, 40, 36, 28};
+      constexpr int16_t list[] = {80, 12, 16, 28, 80, 16, 24, 12, 80, 16, 24, 28, 44, 80, 12, 40, 36, 16, 80, 16, 24,
+                                  12, 80, 12, 40, 36, 20, 80, 16, 24, 12, 80, 12, 40, 36, 12, 80, 16, 24, 12, 80, 12,
+                                  40, 36, 16, 80, 16, 24, 12, 80, 12, 40, 36, 20, 96, 160, 12, 20, 44, 52};
+      constexpr int16_t settings[] = {80, 12, 16, 28, 80, 12, 40, 36, 20, 80, 20, 12, 80, 12, 40, 36, 12, 48, 80, 20,
+                                      12, 80, 12, 40, 36, 12, 48, 80, 20, 12, 80, 12, 40, 36, 16, -1, 20, -1, 16, -1,
+                                      24, 300, 80, 20, 12, 80, 12, 40, 36, 20, -1, 24, 64, 12, 12, 16, 28, 44, 32};
+    }
+  }
+}
@@ -0,0 +1,158 @@
+#include "displayapp/RemoteGlyphFont.h"
+#include "components/ble/RemoteFont.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace Pinetime::Components;
+
+extern lv_font_t jetbrains_mono_bold_20;
+lv_font_t remote_glyph_font;
+
+namespace {
+  bool IsLabelUsingRemoteFont(lv_obj_t* obj) {
+    lv_obj_type_t type;
+    lv_obj_get_type(obj, &type);
+    if (strcmp(type.type[0], "lv_label") != 0) {
+      return false;
+    }
+    return lv_obj_get_style_text_font(obj, LV_LABEL_PART_MAIN) == &remote_glyph_font;
+  }
+
+  bool TextContains(const char* text, const uint16_t* codePoints, size_t count) {
+    uint32_t i = 0;
+    while (text[i] != '\0') {
+      uint32_t letter = _lv_txt_encoded_next(text, &i);
+      if (std::find(codePoints, codePoints + count, letter) != codePoints + count) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+void RemoteGlyphFont::Init() {
+  // Same metrics as the built-in font, the glyphs sent by the companion are rendered for this line height
+  remote_glyph_font = jetbrains_mono_bold_20;
+  remote_glyph_font.get_glyph_dsc = GetGlyphDsc;
+  remote_glyph_font.get_glyph_bitmap = GetGlyphBitmap;
+  remote_glyph_font.dsc = this;
+}
+
+void RemoteGlyphFont::Register(Pinetime::Controllers::RemoteFont* remoteFont) {
+  this->remoteFont = remoteFont;
+}
+
+void RemoteGlyphFont::ResetRequests() {
+  pendingRequests.fill(noCodePoint);
+  unsentCount = 0;
+}
+
+void RemoteGlyphFont::OnGlyphsReceived() {
+  if (remoteFont == nullptr) {
+    return;
+  }
+
+  std::array<uint16_t, maxPendingRequests> received;
+  size_t count = 0;
+  for (auto& codePoint : pendingRequests) {
+    if (codePoint != noCodePoint && remoteFont->GlyphSize(codePoint) >= 0) {
+      received[count++] = codePoint;
+      codePoint = noCodePoint;
+    }
+  }
+
+  if (count > 0) {
+    RefreshLabels(lv_scr_act(), received.data(), count);
+  }
+}
+
+bool RemoteGlyphFont::GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letterNext) {
+  if (jetbrains_mono_bold_20.get_glyph_dsc(&jetbrains_mono_bold_20, dsc, letter, letterNext)) {
+    return true;
+  }
+  if (letter == noCodePoint || letter > std::numeric_limits<uint16_t>::max()) {
+    return false;
+  }
+
+  auto* self = static_cast<RemoteGlyphFont*>(font->dsc);
+  const auto codePoint = static_cast<uint16_t>(letter);
+  const GlyphCache::GlyphHeader* header = self->cache.Metrics(codePoint);
+  if (header == nullptr) {
+    self->Request(codePoint);
+    return false;
+  }
+
+  dsc->adv_w = header->advanceWidth;
+  dsc->box_w = header->boxWidth;
+  dsc->box_h = header->boxHeight;
+  dsc->ofs_x = header->offsetX;
+  dsc->ofs_y = header->offsetY;
+  dsc->bpp = header->bpp;
+  return true;
+}
+
+const uint8_t* RemoteGlyphFont::GetGlyphBitmap(const lv_font_t* font, uint32_t letter) {
+  const uint8_t* bitmap = jetbrains_mono_bold_20.get_glyph_bitmap(&jetbrains_mono_bold_20, letter);
+  if (bitmap != nullptr || letter > std::numeric_limits<uint16_t>::max()) {
+    return bitmap;
+  }
+
+  // LVGL draws the bitmap before it asks for the next one
+  auto* self = static_cast<RemoteGlyphFont*>(font->dsc);
+  return self->cache.Bitmap(static_cast<uint16_t>(letter));
+}
+
+int RemoteGlyphFont::GlyphSize(uint16_t codePoint) {
+  if (remoteFont == nullptr) {
+    return -1;
+  }
+  return remoteFont->GlyphSize(codePoint);
+}
+
+int RemoteGlyphFont::Read(uint16_t codePoint, uint8_t* buffer, size_t size) {
+  if (remoteFont == nullptr) {
+    return -1;
+  }
+  return remoteFont->GetFont(codePoint, buffer, size);
+}
+
+void RemoteGlyphFont::Request(uint16_t codePoint) {
+  if (remoteFont == nullptr) {
+    return;
+  }
+  if (std::find(pendingRequests.begin(), pendingRequests.end(), codePoint) != pendingRequests.end()) {
+    return;
+  }
+  // If too many requests are in flight, the glyph will be requested again the next time it is drawn
+  auto slot = std::find(pendingRequests.begin(), pendingRequests.end(), noCodePoint);
+  if (slot != pendingRequests.end()) {
+    *slot = codePoint;
+    unsentRequests[unsentCount++] = codePoint;
+  }
+}
+
+void RemoteGlyphFont::SendRequests() {
+  if (unsentCount == 0) {
+    return;
+  }
+  // All the glyphs missing from the last frame are sent in as few notifications as possible
+  if (remoteFont->RequestFonts(unsentRequests.data(), unsentCount) != 0) {
+    for (size_t i = 0; i < unsentCount; i++) {
+      std::replace(pendingRequests.begin(), pendingRequests.end(), unsentRequests[i], noCodePoint);
+    }
+  }
+  unsentCount = 0;
+}
+
+void RemoteGlyphFont::RefreshLabels(lv_obj_t* parent, const uint16_t* codePoints, size_t count) {
+  lv_obj_t* child = lv_obj_get_child(parent, nullptr);
+  while (child != nullptr) {
+    if (IsLabelUsingRemoteFont(child) && TextContains(lv_label_get_text(child), codePoints, count)) {
+      // The size of the label changes with the new glyphs
+      lv_label_refr_text(child);
+    }
+    RefreshLabels(child, codePoints, count);
+    child = lv_obj_get_child(parent, child);
+  }
+}
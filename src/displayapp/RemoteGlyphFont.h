@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+#include "displayapp/GlyphCache.h"
+
+// Font used by the labels that display text received from the companion app (notifications, music, ...).
+// Glyphs missing from jetbrains_mono_bold_20 are fetched from RemoteFont.
+extern lv_font_t remote_glyph_font;
+
+namespace Pinetime {
+  namespace Controllers {
+    class RemoteFont;
+  }
+
+  namespace Components {
+    /**
+     * Streams the glyphs downloaded by RemoteFont into LVGL.
+     *
+     * Code points that are not part of the built-in font are looked up in RemoteFont through a GlyphCache, so the
+     * glyphs of a screen are read from the flash memory once per frame instead of once per stripe.
+     * Glyphs that are not downloaded yet are requested from the companion, and the labels that use them are
+     * refreshed when they arrive (OnGlyphsReceived()).
+     */
+    class RemoteGlyphFont : private GlyphCache::Source {
+    public:
+      RemoteGlyphFont() = default;
+      RemoteGlyphFont(const RemoteGlyphFont&) = delete;
+      RemoteGlyphFont& operator=(const RemoteGlyphFont&) = delete;
+      RemoteGlyphFont(RemoteGlyphFont&&) = delete;
+      RemoteGlyphFont& operator=(RemoteGlyphFont&&) = delete;
+
+      void Init();
+      void Register(Pinetime::Controllers::RemoteFont* remoteFont);
+      /// Forgets the glyphs requested by the previous screen
+      void ResetRequests();
+      /// Sends the requests for the glyphs that were missing while drawing the last frame
+      void SendRequests();
+      void OnGlyphsReceived();
+
+    private:
+      static bool GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letterNext);
+      static const uint8_t* GetGlyphBitmap(const lv_font_t* font, uint32_t letter);
+
+      int GlyphSize(uint16_t codePoint) override;
+      int Read(uint16_t codePoint, uint8_t* buffer, size_t size) override;
+      void Request(uint16_t codePoint);
+      void RefreshLabels(lv_obj_t* parent, const uint16_t* codePoints, size_t count);
+
+      static constexpr size_t maxPendingRequests = 16;
+      static constexpr uint16_t noCodePoint = 0;
+
+      Pinetime::Controllers::RemoteFont* remoteFont = nullptr;
+
+      GlyphCache cache {*this};
+
+      // Code points requested from the companion that did not arrive yet
+      std::array<uint16_t, maxPendingRequests> pendingRequests = {};
+      // Subset of pendingRequests that is not sent yet
+      std::array<uint16_t, maxPendingRequests> unsentRequests;
+      uint8_t unsentCount = 0;
+    };
+  }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "displayapp/screens/Screen.h"
+
+namespace Pinetime {
+  namespace Applications {
+    // Size and alignment of the largest of the screens Ts
+    template <typename... Ts>
+    struct ScreenLayout {
+      static constexpr size_t size = std::max({sizeof(Ts)...});
+      static constexpr size_t alignment = std::max({alignof(Ts)...});
+    };
+
+    /**
+     * Memory of the screen displayed by DisplayApp : the screen is constructed in place in a buffer of Size bytes, so that
+     * switching screens does not allocate from the heap. The arena holds a single screen, constructing a screen destroys
+     * the previous one. Only the screens of DisplayApp are constructed here : the pages of a ScreenList (Settings, System
+     * Information...) are still allocated from the heap on each swipe.
+     */
+    template <size_t Size, size_t Alignment>
+    class ScreenArena {
+    public:
+      static constexpr size_t size = Size;
+
+      ScreenArena() = default;
+      ScreenArena(const ScreenArena&) = delete;
+      ScreenArena& operator=(const ScreenArena&) = delete;
+
+      ~ScreenArena() {
+        Clear();
+      }
+
+      template <typename T, typename... Args>
+      T* Emplace(Args&&... args) {
+        static_assert(sizeof(T) <= Size,
+                      "The screen does not fit in the screen arena, add it to SystemScreen (SystemScreens.h) or give it AppTraits");
+        static_assert(alignof(T) <= Alignment, "The screen is more aligned than the screen arena");
+        Clear();
+        T* t = new (storage) T(std::forward<Args>(args)...);
+        screen = t;
+        return t;
+      }
+
+      // Constructs the screen with create(memory), used for the create functions of the user apps and watch faces
+      template <typename Create>
+      Screens::Screen* EmplaceWith(Create create) {
+        Clear();
+        screen = create(static_cast<void*>(storage));
+        return screen;
+      }
+
+      void Clear() {
+        if (screen != nullptr) {
+          screen->~Screen();
+          screen = nullptr;
+        }
+      }
+
+      Screens::Screen* Get() const {
+        return screen;
+      }
+
+      Screens::Screen* operator->() const {
+        return screen;
+      }
+
+    private:
+      alignas(Alignment) uint8_t storage[Size];
+      Screens::Screen* screen = nullptr;
+    };
+  }
+}
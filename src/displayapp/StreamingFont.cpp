@@ -0,0 +1,547 @@
+#include "displayapp/StreamingFont.h"
+#include "components/fs/FS.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace Pinetime::Components;
+
+namespace {
+  // Layout of the binary fonts generated by lv_font_conv (see lv_font_loader.c in LVGL)
+  constexpr uint32_t sectionHeaderSize = 8; // [length][tag]
+
+  struct FontHeader {
+    uint32_t version;
+    uint16_t tablesCount;
+    uint16_t fontSize;
+    uint16_t ascent;
+    int16_t descent;
+    uint16_t typoAscent;
+    int16_t typoDescent;
+    uint16_t typoLineGap;
+    int16_t minY;
+    int16_t maxY;
+    uint16_t defaultAdvanceWidth;
+    uint16_t kerningScale;
+    uint8_t indexToLocFormat;
+    uint8_t glyphIdFormat;
+    uint8_t advanceWidthFormat;
+    uint8_t bitsPerPixel;
+    uint8_t xyBits;
+    uint8_t whBits;
+    uint8_t advanceWidthBits;
+    uint8_t compressionId;
+    uint8_t subpixelsMode;
+    uint8_t padding;
+  };
+  static_assert(sizeof(FontHeader) == 36, "FontHeader must match the file format");
+
+  struct CmapTable {
+    uint32_t dataOffset; // from the beginning of the cmap section
+    uint32_t rangeStart;
+    uint16_t rangeLength;
+    uint16_t glyphIdStart;
+    uint16_t dataEntriesCount;
+    uint8_t formatType;
+    uint8_t padding;
+  };
+  static_assert(sizeof(CmapTable) == 16, "CmapTable must match the file format");
+
+  enum class CmapFormat : uint8_t { Format0Full = 0, SparseFull = 1, Format0Tiny = 2, SparseTiny = 3 };
+
+  uint16_t ReadUint16(const uint8_t* data) {
+    uint16_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  uint32_t ReadUint32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  // Size of the data of a cmap subtable, or -1 if the format is unknown
+  int32_t CmapDataSize(const CmapTable& table) {
+    switch (static_cast<CmapFormat>(table.formatType)) {
+      case CmapFormat::Format0Full:
+        return table.rangeLength;
+      case CmapFormat::SparseFull:
+        return table.dataEntriesCount * 2 * sizeof(uint16_t);
+      case CmapFormat::Format0Tiny:
+        return 0;
+      case CmapFormat::SparseTiny:
+        return table.dataEntriesCount * sizeof(uint16_t);
+    }
+    return -1;
+  }
+
+  // The metrics of the glyphs are packed, MSB first
+  class BitReader {
+  public:
+    explicit BitReader(const uint8_t* data) : data {data} {
+    }
+
+    uint32_t Read(uint8_t nbBits) {
+      uint32_t value = 0;
+      for (uint8_t i = 0; i < nbBits; i++) {
+        value = (value << 1) | ((data[position / 8] >> (7 - position % 8)) & 0x01);
+        position++;
+      }
+      return value;
+    }
+
+    int32_t ReadSigned(uint8_t nbBits) {
+      uint32_t value = Read(nbBits);
+      if (nbBits > 0 && (value & (1U << (nbBits - 1))) != 0) {
+        value |= ~0U << nbBits;
+      }
+      return static_cast<int32_t>(value);
+    }
+
+  private:
+    const uint8_t* data;
+    uint32_t position = 0;
+  };
+}
+
+StreamingFont::StreamingFont(Pinetime::Controllers::FS& fs) : fs {fs} {
+}
+
+StreamingFont::~StreamingFont() {
+  if (fileOpened) {
+    fs.FileClose(&file);
+  }
+}
+
+lv_font_t* StreamingFont::Load(Pinetime::Controllers::FS& fs, const char* path, size_t bitmapCacheSize) {
+  auto* streamingFont = new (std::nothrow) StreamingFont(fs);
+  if (streamingFont == nullptr) {
+    return nullptr;
+  }
+  if (streamingFont->Open(path, bitmapCacheSize) != LFS_ERR_OK) {
+    delete streamingFont;
+    return nullptr;
+  }
+  return &streamingFont->font;
+}
+
+void StreamingFont::Free(lv_font_t* font) {
+  delete static_cast<StreamingFont*>(font->dsc);
+}
+
+int StreamingFont::Open(const char* path, size_t bitmapCacheSize) {
+  int result = fs.FileOpen(&file, path, LFS_O_RDONLY);
+  if (result != LFS_ERR_OK) {
+    return result;
+  }
+  fileOpened = true;
+
+  uint32_t headLength;
+  FontHeader fontHeader;
+  if ((result = ReadSection(0, "head", headLength)) != LFS_ERR_OK ||
+      (result = ReadAt(sectionHeaderSize, &fontHeader, sizeof(fontHeader))) != LFS_ERR_OK) {
+    return result;
+  }
+  // The fonts are generated with --no-compress, the bitmaps are read as is from the file
+  if (headLength < sectionHeaderSize + sizeof(fontHeader) || fontHeader.compressionId != 0 || fontHeader.bitsPerPixel == 0 ||
+      fontHeader.bitsPerPixel > 8 || fontHeader.xyBits > 8 || fontHeader.whBits > 8 || fontHeader.advanceWidthBits > 16) {
+    return LFS_ERR_CORRUPT;
+  }
+  header.defaultAdvanceWidth = fontHeader.defaultAdvanceWidth;
+  header.kerningScale = fontHeader.kerningScale;
+  header.indexToLocFormat = fontHeader.indexToLocFormat;
+  header.glyphIdFormat = fontHeader.glyphIdFormat;
+  header.advanceWidthFormat = fontHeader.advanceWidthFormat;
+  header.bpp = fontHeader.bitsPerPixel;
+  header.xyBits = fontHeader.xyBits;
+  header.whBits = fontHeader.whBits;
+  header.advanceWidthBits = fontHeader.advanceWidthBits;
+
+  const uint32_t cmapOffset = headLength;
+  uint32_t cmapLength;
+  if ((result = ReadSection(cmapOffset, "cmap", cmapLength)) != LFS_ERR_OK) {
+    return result;
+  }
+  const uint32_t locaOffset = cmapOffset + cmapLength;
+  uint32_t locaLength;
+  uint32_t locaCount;
+  if ((result = ReadSection(locaOffset, "loca", locaLength)) != LFS_ERR_OK ||
+      (result = ReadAt(locaOffset + sectionHeaderSize, &locaCount, sizeof(locaCount))) != LFS_ERR_OK) {
+    return result;
+  }
+  const uint32_t glyfOffset = locaOffset + locaLength;
+  uint32_t glyfLength;
+  if ((result = ReadSection(glyfOffset, "glyf", glyfLength)) != LFS_ERR_OK) {
+    return result;
+  }
+  const uint32_t kernOffset = glyfOffset + glyfLength;
+  uint32_t kernLength = sectionHeaderSize;
+  if (fontHeader.tablesCount == 4 && (result = ReadSection(kernOffset, "kern", kernLength)) != LFS_ERR_OK) {
+    return result;
+  }
+  if (cmapLength < sectionHeaderSize + sizeof(uint32_t) || locaCount == 0 || locaCount > UINT16_MAX) {
+    return LFS_ERR_CORRUPT;
+  }
+
+  glyphCount = locaCount;
+  cmapsSize = cmapLength - sectionHeaderSize;
+  kerningSize = kernLength - sectionHeaderSize;
+  const size_t glyphsSize = glyphCount * sizeof(Glyph);
+  index.reset(new (std::nothrow) uint8_t[glyphsSize + cmapsSize + kerningSize]);
+  if (index == nullptr) {
+    return LFS_ERR_NOMEM;
+  }
+  glyphs = reinterpret_cast<Glyph*>(index.get());
+  cmaps = index.get() + glyphsSize;
+  kerning = (kerningSize > 0) ? cmaps + cmapsSize : nullptr;
+
+  if ((result = ReadAt(cmapOffset + sectionHeaderSize, index.get() + glyphsSize, cmapsSize)) != LFS_ERR_OK) {
+    return result;
+  }
+  if (!ValidateCmaps()) {
+    return LFS_ERR_CORRUPT;
+  }
+  if (kerning != nullptr) {
+    if ((result = ReadAt(kernOffset + sectionHeaderSize, index.get() + glyphsSize + cmapsSize, kerningSize)) != LFS_ERR_OK) {
+      return result;
+    }
+    if (!ValidateKerning()) {
+      kerning = nullptr;
+    }
+  }
+
+  if ((result = LoadGlyphs(locaOffset, glyfOffset, glyfLength)) != LFS_ERR_OK) {
+    return result;
+  }
+
+  // The largest glyph must fit in the cache, or it could never be drawn
+  uint16_t largestBitmap = 0;
+  for (uint16_t i = 0; i < glyphCount; i++) {
+    largestBitmap = std::max(largestBitmap, glyphs[i].size);
+  }
+  bitmapPoolSize = std::min<size_t>(UINT16_MAX, std::max<size_t>(bitmapCacheSize, largestBitmap));
+  bitmapPool.reset(new (std::nothrow) uint8_t[bitmapPoolSize]);
+  if (bitmapPool == nullptr) {
+    return LFS_ERR_NOMEM;
+  }
+
+  font = {};
+  font.get_glyph_dsc = GetGlyphDsc;
+  font.get_glyph_bitmap = GetGlyphBitmap;
+  font.line_height = fontHeader.ascent - fontHeader.descent;
+  font.base_line = -fontHeader.descent;
+  font.subpx = fontHeader.subpixelsMode;
+  font.dsc = this;
+  return LFS_ERR_OK;
+}
+
+int StreamingFont::ReadAt(uint32_t offset, void* buffer, uint32_t size) {
+  int result = fs.FileSeek(&file, offset);
+  if (result < 0) {
+    return result;
+  }
+  result = fs.FileRead(&file, static_cast<uint8_t*>(buffer), size);
+  if (result < 0) {
+    return result;
+  }
+  return (static_cast<uint32_t>(result) == size) ? LFS_ERR_OK : LFS_ERR_CORRUPT;
+}
+
+int StreamingFont::ReadSection(uint32_t offset, const char* tag, uint32_t& length) {
+  uint8_t sectionHeader[sectionHeaderSize];
+  int result = ReadAt(offset, sectionHeader, sizeof(sectionHeader));
+  if (result != LFS_ERR_OK) {
+    return result;
+  }
+  length = ReadUint32(sectionHeader);
+  if (std::memcmp(&sectionHeader[4], tag, 4) != 0 || length < sectionHeaderSize) {
+    return LFS_ERR_CORRUPT;
+  }
+  return LFS_ERR_OK;
+}
+
+int StreamingFont::ReadLoca(uint32_t locaOffset, uint32_t glyph, uint32_t& offset) {
+  const uint32_t entriesOffset = locaOffset + sectionHeaderSize + sizeof(uint32_t);
+  if (header.indexToLocFormat == 0) {
+    uint16_t entry;
+    int result = ReadAt(entriesOffset + glyph * sizeof(entry), &entry, sizeof(entry));
+    offset = entry;
+    return result;
+  }
+  return ReadAt(entriesOffset + glyph * sizeof(offset), &offset, sizeof(offset));
+}
+
+int StreamingFont::LoadGlyphs(uint32_t locaOffset, uint32_t glyfOffset, uint32_t glyfLength) {
+  const uint32_t nbBits = header.advanceWidthBits + 2 * header.xyBits + 2 * header.whBits;
+  uint8_t metrics[(16 + 4 * 8 + 7) / 8];
+
+  uint32_t glyphStart;
+  int result = ReadLoca(locaOffset, 0, glyphStart);
+  for (uint16_t i = 0; i < glyphCount && result == LFS_ERR_OK; i++) {
+    uint32_t glyphEnd = glyfLength;
+    if (i + 1 < glyphCount && (result = ReadLoca(locaOffset, i + 1, glyphEnd)) != LFS_ERR_OK) {
+      break;
+    }
+
+    // Glyph 0 means "no glyph"
+    Glyph& glyph = glyphs[i];
+    glyph = {};
+    if (i == 0) {
+      glyphStart = glyphEnd;
+      continue;
+    }
+    if (glyphStart > glyphEnd || glyphEnd > glyfLength || glyphEnd - glyphStart < (nbBits + 7) / 8) {
+      return LFS_ERR_CORRUPT;
+    }
+    if ((result = ReadAt(glyfOffset + glyphStart, metrics, (nbBits + 7) / 8)) != LFS_ERR_OK) {
+      break;
+    }
+
+    BitReader reader(metrics);
+    uint32_t advanceWidth = (header.advanceWidthBits == 0) ? header.defaultAdvanceWidth : reader.Read(header.advanceWidthBits);
+    if (header.advanceWidthFormat == 0) {
+      advanceWidth *= 16;
+    }
+    glyph.advanceWidth = advanceWidth;
+    glyph.offsetX = reader.ReadSigned(header.xyBits);
+    glyph.offsetY = reader.ReadSigned(header.xyBits);
+    glyph.boxWidth = reader.Read(header.whBits);
+    glyph.boxHeight = reader.Read(header.whBits);
+
+    // The bitmap follows the metrics, without padding
+    const uint32_t bitmapBits = glyph.boxWidth * glyph.boxHeight * header.bpp;
+    if (bitmapBits > 0) {
+      glyph.offset = glyfOffset + glyphStart + nbBits / 8;
+      glyph.shift = nbBits % 8;
+      const uint32_t size = (glyph.shift + bitmapBits + 7) / 8;
+      if (size > glyphEnd - glyphStart - nbBits / 8 || size > UINT16_MAX) {
+        return LFS_ERR_CORRUPT;
+      }
+      glyph.size = size;
+    }
+    glyphStart = glyphEnd;
+  }
+  return result;
+}
+
+bool StreamingFont::ValidateCmaps() const {
+  const uint32_t count = ReadUint32(cmaps);
+  if (sizeof(uint32_t) + count * sizeof(CmapTable) > cmapsSize) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    CmapTable table;
+    std::memcpy(&table, cmaps + sizeof(uint32_t) + i * sizeof(CmapTable), sizeof(table));
+    const int32_t dataSize = CmapDataSize(table);
+    if (dataSize < 0) {
+      return false;
+    }
+    if (dataSize > 0 && (table.dataOffset < sectionHeaderSize || table.dataOffset - sectionHeaderSize + dataSize > cmapsSize)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool StreamingFont::ValidateKerning() const {
+  // [format][padding * 3][...]
+  if (kerningSize < 8) {
+    return false;
+  }
+  const uint8_t* data = kerning + 4;
+  if (kerning[0] == 0) {
+    const uint32_t idSize = (header.glyphIdFormat == 0) ? 1 : 2;
+    const uint32_t entries = ReadUint32(data);
+    return 8 + entries * (2 * idSize + 1) <= kerningSize;
+  }
+  if (kerning[0] == 3) {
+    const uint16_t mappingLength = ReadUint16(data);
+    const uint8_t rows = data[2];
+    const uint8_t columns = data[3];
+    return 8U + 2U * mappingLength + rows * columns <= kerningSize;
+  }
+  return false;
+}
+
+uint16_t StreamingFont::GlyphId(uint32_t letter) const {
+  const uint32_t count = ReadUint32(cmaps);
+  for (uint32_t i = 0; i < count; i++) {
+    CmapTable table;
+    std::memcpy(&table, cmaps + sizeof(uint32_t) + i * sizeof(CmapTable), sizeof(table));
+    if (letter < table.rangeStart || letter - table.rangeStart > table.rangeLength) {
+      continue;
+    }
+    const uint32_t offset = letter - table.rangeStart;
+    const uint8_t* data = cmaps + table.dataOffset - sectionHeaderSize;
+
+    uint32_t glyphId = 0;
+    switch (static_cast<CmapFormat>(table.formatType)) {
+      case CmapFormat::Format0Tiny:
+        glyphId = table.glyphIdStart + offset;
+        break;
+      case CmapFormat::Format0Full:
+        if (offset < table.rangeLength) {
+          glyphId = table.glyphIdStart + data[offset];
+        }
+        break;
+      case CmapFormat::SparseTiny:
+      case CmapFormat::SparseFull: {
+        // The code points are sorted, relative to rangeStart
+        uint32_t low = 0;
+        uint32_t high = table.dataEntriesCount;
+        while (low < high) {
+          const uint32_t middle = (low + high) / 2;
+          const uint16_t codePoint = ReadUint16(data + middle * sizeof(uint16_t));
+          if (codePoint == offset) {
+            glyphId = (static_cast<CmapFormat>(table.formatType) == CmapFormat::SparseTiny)
+                        ? table.glyphIdStart + middle
+                        : table.glyphIdStart + ReadUint16(data + (table.dataEntriesCount + middle) * sizeof(uint16_t));
+            break;
+          }
+          if (codePoint < offset) {
+            low = middle + 1;
+          } else {
+            high = middle;
+          }
+        }
+      } break;
+    }
+    if (glyphId != 0 && glyphId < glyphCount) {
+      return glyphId;
+    }
+  }
+  return 0;
+}
+
+int8_t StreamingFont::Kerning(uint16_t left, uint16_t right) const {
+  const uint8_t* data = kerning + 4;
+  if (kerning[0] == 0) {
+    // Pairs of glyph ids sorted by left then right glyph, followed by the values
+    const uint32_t idSize = (header.glyphIdFormat == 0) ? 1 : 2;
+    const uint32_t entries = ReadUint32(data);
+    const uint8_t* pairs = data + 4;
+    const uint8_t* values = pairs + entries * 2 * idSize;
+    auto pairId = [idSize](const uint8_t* id) -> uint16_t {
+      return (idSize == 1) ? *id : ReadUint16(id);
+    };
+    uint32_t low = 0;
+    uint32_t high = entries;
+    while (low < high) {
+      const uint32_t middle = (low + high) / 2;
+      const uint16_t pairLeft = pairId(pairs + middle * 2 * idSize);
+      const uint16_t pairRight = pairId(pairs + middle * 2 * idSize + idSize);
+      if (pairLeft == left && pairRight == right) {
+        return static_cast<int8_t>(values[middle]);
+      }
+      if (pairLeft < left || (pairLeft == left && pairRight < right)) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return 0;
+  }
+
+  // Class based kerning : [left classes][right classes][values, rows = left classes, columns = right classes]
+  const uint16_t mappingLength = ReadUint16(data);
+  const uint8_t columns = data[3];
+  const uint8_t* leftClasses = data + 4;
+  const uint8_t* rightClasses = leftClasses + mappingLength;
+  const uint8_t* values = rightClasses + mappingLength;
+  if (left >= mappingLength || right >= mappingLength) {
+    return 0;
+  }
+  const uint8_t leftClass = leftClasses[left];
+  const uint8_t rightClass = rightClasses[right];
+  if (leftClass == 0 || rightClass == 0) {
+    return 0;
+  }
+  return static_cast<int8_t>(values[(leftClass - 1) * columns + (rightClass - 1)]);
+}
+
+bool StreamingFont::GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letterNext) {
+  auto* self = static_cast<StreamingFont*>(font->dsc);
+  // Tabs are drawn as 2 spaces
+  const bool isTab = (letter == '\t');
+  const uint16_t glyphId = self->GlyphId(isTab ? ' ' : letter);
+  if (glyphId == 0) {
+    return false;
+  }
+
+  int32_t kerningValue = 0;
+  if (self->kerning != nullptr && letterNext != 0) {
+    const uint16_t nextGlyphId = self->GlyphId(letterNext);
+    if (nextGlyphId != 0) {
+      kerningValue = (self->Kerning(glyphId, nextGlyphId) * self->header.kerningScale) >> 4;
+    }
+  }
+
+  const Glyph& glyph = self->glyphs[glyphId];
+  int32_t advanceWidth = glyph.advanceWidth;
+  if (isTab) {
+    advanceWidth *= 2;
+  }
+  advanceWidth += kerningValue;
+  dsc->adv_w = (advanceWidth + (1 << 3)) >> 4;
+  dsc->box_w = glyph.boxWidth;
+  dsc->box_h = glyph.boxHeight;
+  dsc->ofs_x = glyph.offsetX;
+  dsc->ofs_y = glyph.offsetY;
+  dsc->bpp = self->header.bpp;
+  return true;
+}
+
+const uint8_t* StreamingFont::GetGlyphBitmap(const lv_font_t* font, uint32_t letter) {
+  auto* self = static_cast<StreamingFont*>(font->dsc);
+  const uint16_t glyphId = self->GlyphId((letter == '\t') ? ' ' : letter);
+  if (glyphId == 0) {
+    return nullptr;
+  }
+  return self->Bitmap(glyphId);
+}
+
+const uint8_t* StreamingFont::Bitmap(uint16_t glyphId) {
+  const Glyph& glyph = glyphs[glyphId];
+  if (glyph.size == 0) {
+    return nullptr;
+  }
+  for (const auto& cached : cachedBitmaps) {
+    if (cached.valid && cached.glyphId == glyphId) {
+      return &bitmapPool[cached.offset];
+    }
+  }
+
+  if (poolHead + glyph.size > bitmapPoolSize) {
+    poolHead = 0;
+  }
+  const uint16_t begin = poolHead;
+  const uint16_t end = poolHead + glyph.size;
+  for (auto& cached : cachedBitmaps) {
+    if (cached.valid && cached.offset < end && begin < cached.offset + cached.size) {
+      cached.valid = false;
+    }
+  }
+  CachedBitmap& slot = cachedBitmaps[nextSlot];
+  nextSlot = (nextSlot + 1) % maxCachedBitmaps;
+  slot.valid = false;
+
+  uint8_t* bitmap = &bitmapPool[begin];
+  if (ReadAt(glyph.offset, bitmap, glyph.size) != LFS_ERR_OK) {
+    return nullptr;
+  }
+  // Align the bitmap on a byte boundary, like lv_font_load() does
+  if (glyph.shift != 0) {
+    for (uint16_t i = 0; i < glyph.size; i++) {
+      const uint8_t next = (i + 1 < glyph.size) ? bitmap[i + 1] : 0;
+      bitmap[i] = (bitmap[i] << glyph.shift) | (next >> (8 - glyph.shift));
+    }
+  }
+
+  slot.glyphId = glyphId;
+  slot.offset = begin;
+  slot.size = glyph.size;
+  slot.valid = true;
+  poolHead = end;
+  return bitmap;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <lvgl/lvgl.h>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace Components {
+    /**
+     * Loads the fonts generated by lv_font_conv in the binary format (the fonts of src/resources/fonts.json).
+     *
+     * lv_font_load() copies the whole font, bitmaps included, into the heap. This loader only keeps the metrics of
+     * the glyphs, the character map and the kerning table in RAM, and keeps the font file opened : the bitmaps
+     * are read from the file system when LVGL draws them, and the most recent ones are kept in a small
+     * cache allocated like a ring buffer.
+     *
+     * The cache is at least as large as the largest bitmap of the font. The labels of the watch faces are drawn in
+     * several stripes (see LVGL_DRAW_BUFFER_LINES), so the cache should hold all the glyphs displayed at the same
+     * time in a label to avoid reading them again for every stripe.
+     */
+    class StreamingFont {
+    public:
+      /// Returns nullptr if the file does not exist, is not a valid font or if there is not enough memory.
+      static lv_font_t* Load(Pinetime::Controllers::FS& fs, const char* path, size_t bitmapCacheSize);
+      static void Free(lv_font_t* font);
+
+#ifdef FONT_LOAD_BENCHMARK
+      static void RunBenchmark(Pinetime::Controllers::FS& fs);
+#endif
+
+      StreamingFont(const StreamingFont&) = delete;
+      StreamingFont& operator=(const StreamingFont&) = delete;
+      StreamingFont(StreamingFont&&) = delete;
+      StreamingFont& operator=(StreamingFont&&) = delete;
+      ~StreamingFont();
+
+    private:
+      explicit StreamingFont(Pinetime::Controllers::FS& fs);
+
+      struct Glyph {
+        uint32_t offset;       // offset of the bitmap in the file
+        uint16_t size;         // number of bytes read from the file
+        uint16_t advanceWidth; // 1/16 px
+        uint8_t boxWidth;
+        uint8_t boxHeight;
+        int8_t offsetX;
+        int8_t offsetY;
+        uint8_t shift; // the bitmap does not start on a byte boundary in the file
+      };
+
+      struct CachedBitmap {
+        uint16_t glyphId;
+        uint16_t offset;
+        uint16_t size;
+        bool valid;
+      };
+
+      static bool GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letterNext);
+      static const uint8_t* GetGlyphBitmap(const lv_font_t* font, uint32_t letter);
+
+      int Open(const char* path, size_t bitmapCacheSize);
+      int ReadAt(uint32_t offset, void* buffer, uint32_t size);
+      int ReadSection(uint32_t offset, const char* tag, uint32_t& length);
+      int ReadLoca(uint32_t locaOffset, uint32_t glyph, uint32_t& offset);
+      int LoadGlyphs(uint32_t locaOffset, uint32_t glyfOffset, uint32_t glyfLength);
+      bool ValidateCmaps() const;
+      bool ValidateKerning() const;
+      uint16_t GlyphId(uint32_t letter) const;
+      int8_t Kerning(uint16_t left, uint16_t right) const;
+      const uint8_t* Bitmap(uint16_t glyphId);
+
+      static constexpr size_t maxCachedBitmaps = 16;
+
+      Pinetime::Controllers::FS& fs;
+      lfs_file_t file;
+      bool fileOpened = false;
+      lv_font_t font;
+
+      struct {
+        uint16_t defaultAdvanceWidth;
+        uint16_t kerningScale;
+        uint8_t indexToLocFormat;
+        uint8_t glyphIdFormat;
+        uint8_t advanceWidthFormat;
+        uint8_t bpp;
+        uint8_t xyBits;
+        uint8_t whBits;
+        uint8_t advanceWidthBits;
+      } header;
+
+      // [Glyph * glyphCount][cmap section][kern section]
+      std::unique_ptr<uint8_t[]> index;
+      Glyph* glyphs = nullptr;
+      uint16_t glyphCount = 0;
+      const uint8_t* cmaps = nullptr;
+      uint32_t cmapsSize = 0;
+      const uint8_t* kerning = nullptr;
+      uint32_t kerningSize = 0;
+
+      // Bitmaps are allocated in bitmapPool like in a ring buffer, the oldest ones are overwritten first
+      std::unique_ptr<uint8_t[]> bitmapPool;
+      uint16_t bitmapPoolSize = 0;
+      uint16_t poolHead = 0;
+      uint8_t nextSlot = 0;
+      std::array<CachedBitmap, maxCachedBitmaps> cachedBitmaps = {};
+    };
+  }
+}
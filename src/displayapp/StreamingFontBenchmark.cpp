@@ -0,0 +1,70 @@
+#include "displayapp/StreamingFont.h"
+#include "components/fs/FS.h"
+#include "utility/CycleCounter.h"
+#include <algorithm>
+#include <cstdio>
+#include <FreeRTOS.h>
+#include <libraries/log/nrf_log.h>
+
+#ifdef FONT_LOAD_BENCHMARK
+using namespace Pinetime::Components;
+
+// Loads the fonts of src/resources/fonts.json with lv_font_load() and StreamingFont, and logs the heap usage and the
+// time needed to fetch the bitmaps of the digits (cold = read from the file system, warm = from the cache)
+void StreamingFont::RunBenchmark(Pinetime::Controllers::FS& fs) {
+  static constexpr const char* fonts[] = {"/fonts/teko.bin",
+                                          "/fonts/bebas.bin",
+                                          "/fonts/lv_font_dots_40.bin",
+                                          "/fonts/7segments_40.bin",
+                                          "/fonts/7segments_115.bin"};
+  static constexpr const char* letters = "0123456789:";
+  static constexpr size_t bitmapCacheSize = 4096;
+  const uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+
+  for (size_t i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+    char lvglPath[40];
+    snprintf(lvglPath, sizeof(lvglPath), "F:%s", fonts[i]);
+    size_t freeBefore = xPortGetFreeHeapSize();
+    lv_font_t* font = lv_font_load(lvglPath);
+    if (font == nullptr) {
+      continue;
+    }
+    const size_t lvglHeap = freeBefore - xPortGetFreeHeapSize();
+    lv_font_free(font);
+
+    freeBefore = xPortGetFreeHeapSize();
+    font = Load(fs, fonts[i], bitmapCacheSize);
+    if (font == nullptr) {
+      continue;
+    }
+    const size_t streamingHeap = freeBefore - xPortGetFreeHeapSize();
+
+    uint32_t fetchCycles[2] = {};
+    uint32_t longestFetch = 0;
+    uint32_t nbFetches = 0;
+    for (uint32_t pass = 0; pass < 2; pass++) {
+      for (const char* letter = letters; *letter != '\0'; letter++) {
+        const uint32_t start = DWT->CYCCNT;
+        if (lv_font_get_glyph_bitmap(font, *letter) == nullptr) {
+          continue;
+        }
+        const uint32_t cycles = DWT->CYCCNT - start;
+        fetchCycles[pass] += cycles;
+        longestFetch = std::max(longestFetch, cycles);
+        nbFetches += (pass == 0) ? 1 : 0;
+      }
+    }
+    Free(font);
+
+    nbFetches = std::max<uint32_t>(1, nbFetches);
+    NRF_LOG_INFO("[StreamingFont] %s : heap %lu B (lv_font_load %lu B), fetch cold %lu us, warm %lu us, longest %lu us",
+                 fonts[i],
+                 streamingHeap,
+                 lvglHeap,
+                 fetchCycles[0] / (nbFetches * cyclesPerUs),
+                 fetchCycles[1] / (nbFetches * cyclesPerUs),
+                 longestFetch / cyclesPerUs);
+  }
+  NRF_LOG_INFO("[StreamingFont] minimum free heap since boot : %lu B", xPortGetMinimumEverFreeHeapSize());
+}
+#endif
@@ -0,0 +1,180 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "displayapp/apps/Apps.h"
+#include "displayapp/Controllers.h"
+#include "displayapp/ScreenArena.h"
+#include "displayapp/UserApps.h"
+
+#include "displayapp/screens/ApplicationList.h"
+#include "displayapp/screens/BatteryInfo.h"
+#include "displayapp/screens/Error.h"
+#include "displayapp/screens/FirmwareUpdate.h"
+#include "displayapp/screens/FirmwareValidation.h"
+#include "displayapp/screens/FlashLight.h"
+#include "displayapp/screens/Notifications.h"
+#include "displayapp/screens/PassKey.h"
+#include "displayapp/screens/SystemInfo.h"
+#include "displayapp/screens/settings/QuickSettings.h"
+#include "displayapp/screens/settings/Settings.h"
+#include "displayapp/screens/settings/SettingWatchFace.h"
+#include "displayapp/screens/settings/SettingTimeFormat.h"
+#include "displayapp/screens/settings/SettingWeatherFormat.h"
+#include "displayapp/screens/settings/SettingWakeUp.h"
+#include "displayapp/screens/settings/SettingDisplay.h"
+#include "displayapp/screens/settings/SettingSteps.h"
+#include "displayapp/screens/settings/SettingSetDateTime.h"
+#include "displayapp/screens/settings/SettingChimes.h"
+#include "displayapp/screens/settings/SettingShakeThreshold.h"
+#include "displayapp/screens/settings/SettingBluetooth.h"
+
+namespace Pinetime {
+  namespace Applications {
+    // Placeholder of the apps that are not system apps : the user apps (AppTraits), Clock (the watch faces) and None
+    struct NoSystemScreen {};
+
+    // Screen constructed by DisplayApp::LoadScreen() for each system app
+    template <Apps>
+    struct SystemScreen {
+      using Type = NoSystemScreen;
+    };
+
+    template <>
+    struct SystemScreen<Apps::Launcher> {
+      using Type = Screens::ApplicationList;
+    };
+
+    template <>
+    struct SystemScreen<Apps::Error> {
+      using Type = Screens::Error;
+    };
+
+    template <>
+    struct SystemScreen<Apps::FirmwareValidation> {
+      using Type = Screens::FirmwareValidation;
+    };
+
+    template <>
+    struct SystemScreen<Apps::FirmwareUpdate> {
+      using Type = Screens::FirmwareUpdate;
+    };
+
+    template <>
+    struct SystemScreen<Apps::PassKey> {
+      using Type = Screens::PassKey;
+    };
+
+    template <>
+    struct SystemScreen<Apps::Notifications> {
+      using Type = Screens::Notifications;
+    };
+
+    template <>
+    struct SystemScreen<Apps::NotificationsPreview> {
+      using Type = Screens::Notifications;
+    };
+
+    template <>
+    struct SystemScreen<Apps::QuickSettings> {
+      using Type = Screens::QuickSettings;
+    };
+
+    template <>
+    struct SystemScreen<Apps::Settings> {
+      using Type = Screens::Settings;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingWatchFace> {
+      using Type = Screens::SettingWatchFace;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingTimeFormat> {
+      using Type = Screens::SettingTimeFormat;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingWeatherFormat> {
+      using Type = Screens::SettingWeatherFormat;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingWakeUp> {
+      using Type = Screens::SettingWakeUp;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingDisplay> {
+      using Type = Screens::SettingDisplay;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingSteps> {
+      using Type = Screens::SettingSteps;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingSetDateTime> {
+      using Type = Screens::SettingSetDateTime;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingChimes> {
+      using Type = Screens::SettingChimes;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingShakeThreshold> {
+      using Type = Screens::SettingShakeThreshold;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SettingBluetooth> {
+      using Type = Screens::SettingBluetooth;
+    };
+
+    template <>
+    struct SystemScreen<Apps::BatteryInfo> {
+      using Type = Screens::BatteryInfo;
+    };
+
+    template <>
+    struct SystemScreen<Apps::SysInfo> {
+      using Type = Screens::SystemInfo;
+    };
+
+    template <>
+    struct SystemScreen<Apps::FlashLight> {
+      using Type = Screens::FlashLight;
+    };
+
+    template <Apps app>
+    consteval bool HasScreen() {
+      constexpr bool isSystemApp = !std::is_same_v<typename SystemScreen<app>::Type, NoSystemScreen>;
+      constexpr bool isUserApp = requires(AppControllers& controllers) { AppTraits<app>::Create(controllers, nullptr); };
+      static_assert(isSystemApp || isUserApp || app == Apps::None || app == Apps::Clock,
+                    "The app has no screen : give it AppTraits, or add its screen to SystemScreen");
+      return true;
+    }
+
+    template <size_t... is>
+    consteval bool HaveScreens(std::index_sequence<is...>) {
+      return (HasScreen<static_cast<Apps>(is)>() && ...);
+    }
+
+    template <size_t... is>
+    consteval ScreenLayout<typename SystemScreen<static_cast<Apps>(is)>::Type...> CreateSystemScreenLayout(std::index_sequence<is...>) {
+      return {};
+    }
+
+    // The apps of Apps.h.in, from None to Error (the last app)
+    using AllApps = std::make_index_sequence<static_cast<size_t>(Apps::Error) + 1>;
+    static_assert(HaveScreens(AllApps {}));
+
+    // Size and alignment of the largest screen of the system apps : the user apps and the watch faces are in
+    // UserAppScreens and UserWatchFaceScreens (UserApps.h)
+    using SystemScreens = decltype(CreateSystemScreenLayout(AllApps {}));
+  }
+}
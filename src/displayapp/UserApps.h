@@ -1,11 +1,24 @@
 #pragma once
+#include <type_traits>
+#include <utility>
 #include "displayapp/apps/Apps.h"
 #include "Controllers.h"
+#include "displayapp/ScreenArena.h"
 
 #include "displayapp/screens/Alarm.h"
 #include "displayapp/screens/Dice.h"
+#include "displayapp/screens/HeartRate.h"
+#include "displayapp/screens/InfiniPaint.h"
+#include "displayapp/screens/Metronome.h"
+#include "displayapp/screens/Motion.h"
+#include "displayapp/screens/Music.h"
+#include "displayapp/screens/Navigation.h"
+#include "displayapp/screens/Paddle.h"
+#include "displayapp/screens/Steps.h"
+#include "displayapp/screens/StopWatch.h"
 #include "displayapp/screens/Timer.h"
 #include "displayapp/screens/Twos.h"
+#include "displayapp/screens/Weather.h"
 #include "displayapp/screens/Tile.h"
 #include "displayapp/screens/ApplicationList.h"
 #include "displayapp/screens/WatchFaceDigital.h"
@@ -24,24 +37,42 @@ namespace Pinetime {
     struct AppDescription {
       Apps app;
       const char* icon;
-      Screens::Screen* (*create)(AppControllers& controllers);
+      // Constructs the screen in memory (see ScreenArena)
+      Screens::Screen* (*create)(AppControllers& controllers, void* memory);
     };
 
     struct WatchFaceDescription {
       WatchFace watchFace;
       const char* name;
-      Screens::Screen* (*create)(AppControllers& controllers);
+      Screens::Screen* (*create)(AppControllers& controllers, void* memory);
       bool (*isAvailable)(Controllers::FS& fileSystem);
     };
 
+    // Screen types of the apps and watch faces, returned by the Create() function of their traits
+    template <Apps t>
+    using AppScreen = std::remove_pointer_t<decltype(AppTraits<t>::Create(std::declval<AppControllers&>(), nullptr))>;
+
+    template <WatchFace t>
+    using WatchFaceScreen = std::remove_pointer_t<decltype(WatchFaceTraits<t>::Create(std::declval<AppControllers&>(), nullptr))>;
+
+    template <Apps t>
+    Screens::Screen* CreateApp(AppControllers& controllers, void* memory) {
+      return AppTraits<t>::Create(controllers, memory);
+    }
+
+    template <WatchFace t>
+    Screens::Screen* CreateWatchFace(AppControllers& controllers, void* memory) {
+      return WatchFaceTraits<t>::Create(controllers, memory);
+    }
+
     template <Apps t>
     consteval AppDescription CreateAppDescription() {
-      return {AppTraits<t>::app, AppTraits<t>::icon, &AppTraits<t>::Create};
+      return {AppTraits<t>::app, AppTraits<t>::icon, &CreateApp<t>};
     }
 
     template <WatchFace t>
     consteval WatchFaceDescription CreateWatchFaceDescription() {
-      return {WatchFaceTraits<t>::watchFace, WatchFaceTraits<t>::name, &WatchFaceTraits<t>::Create, &WatchFaceTraits<t>::IsAvailable};
+      return {WatchFaceTraits<t>::watchFace, WatchFaceTraits<t>::name, &CreateWatchFace<t>, &WatchFaceTraits<t>::IsAvailable};
     }
 
     template <template <Apps...> typename T, Apps... ts>
@@ -54,7 +85,19 @@ namespace Pinetime {
       return {CreateWatchFaceDescription<ts>()...};
     }
 
+    template <template <Apps...> typename T, Apps... ts>
+    consteval ScreenLayout<AppScreen<ts>...> CreateAppScreenLayout(T<ts...>) {
+      return {};
+    }
+
+    template <template <WatchFace...> typename T, WatchFace... ts>
+    consteval ScreenLayout<WatchFaceScreen<ts>...> CreateWatchFaceScreenLayout(T<ts...>) {
+      return {};
+    }
+
     constexpr auto userApps = CreateAppDescriptions(UserAppTypes {});
     constexpr auto userWatchFaces = CreateWatchFaceDescriptions(UserWatchFaceTypes {});
+    using UserAppScreens = decltype(CreateAppScreenLayout(UserAppTypes {}));
+    using UserWatchFaceScreens = decltype(CreateWatchFaceScreenLayout(UserWatchFaceTypes {}));
   }
 }
@@ -72,11 +72,11 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Alarm;
       static constexpr const char* icon = Screens::Symbols::bell;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Alarm(controllers.alarmController,
-                                  controllers.settingsController.GetClockType(),
-                                  *controllers.systemTask,
-                                  controllers.motorController);
+      static Screens::Alarm* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Alarm(controllers.alarmController,
+                                           controllers.settingsController.GetClockType(),
+                                           *controllers.systemTask,
+                                           controllers.motorController);
       };
     };
   }
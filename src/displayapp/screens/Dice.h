@@ -53,8 +53,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Dice;
       static constexpr const char* icon = Screens::Symbols::dice;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Dice(controllers.motionController, controllers.motorController, controllers.settingsController);
+      static Screens::Dice* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Dice(controllers.motionController, controllers.motorController, controllers.settingsController);
       };
     };
   }
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <chrono>
 #include "displayapp/screens/Screen.h"
+#include "displayapp/Controllers.h"
 #include "systemtask/SystemTask.h"
 #include "systemtask/WakeLock.h"
 #include "Symbols.h"
@@ -45,8 +46,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::HeartRate;
       static constexpr const char* icon = Screens::Symbols::heartBeat;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::HeartRate(controllers.heartRateController, *controllers.systemTask);
+      static Screens::HeartRate* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::HeartRate(controllers.heartRateController, *controllers.systemTask);
       };
     };
   }
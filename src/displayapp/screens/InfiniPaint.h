@@ -44,8 +44,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Paint;
       static constexpr const char* icon = Screens::Symbols::paintbrush;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::InfiniPaint(controllers.lvgl, controllers.motorController);
+      static Screens::InfiniPaint* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::InfiniPaint(controllers.lvgl, controllers.motorController);
       };
     };
   }
@@ -4,6 +4,7 @@
 #include "systemtask/WakeLock.h"
 #include "components/motor/MotorController.h"
 #include "displayapp/screens/Screen.h"
+#include "displayapp/Controllers.h"
 #include "Symbols.h"
 
 namespace Pinetime {
@@ -44,8 +45,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Metronome;
       static constexpr const char* icon = Screens::Symbols::drum;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Metronome(controllers.motorController, *controllers.systemTask);
+      static Screens::Metronome* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Metronome(controllers.motorController, *controllers.systemTask);
       };
     };
   }
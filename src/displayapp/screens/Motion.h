@@ -38,8 +38,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Motion;
       static constexpr const char* icon = "M";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Motion(controllers.motionController);
+      static Screens::Motion* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Motion(controllers.motionController);
       };
     };
   }
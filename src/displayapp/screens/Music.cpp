@@ -24,6 +24,8 @@
 #include "displayapp/icons/music/disc_f_1.c"
 #include "displayapp/icons/music/disc_f_2.c"
 
+extern lv_font_t remote_glyph_font;
+
 using namespace Pinetime::Applications::Screens;
 
 static void event_handler(lv_obj_t* obj, lv_event_t event) {
@@ -113,6 +115,7 @@ Music::Music(Pinetime::Controllers::MusicService& music) : musicService(music) {
   constexpr uint8_t LINE_PAD = 15;
   constexpr int8_t MIDDLE_OFFSET = -25;
   txtArtist = lv_label_create(lv_scr_act(), nullptr);
+  lv_obj_set_style_local_text_font(txtArtist, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &remote_glyph_font);
   lv_label_set_long_mode(txtArtist, LV_LABEL_LONG_SROLL_CIRC);
   lv_obj_align(txtArtist, nullptr, LV_ALIGN_IN_LEFT_MID, 12, MIDDLE_OFFSET + 1 * FONT_HEIGHT);
   lv_label_set_align(txtArtist, LV_ALIGN_IN_LEFT_MID);
@@ -120,6 +123,7 @@ Music::Music(Pinetime::Controllers::MusicService& music) : musicService(music) {
   lv_label_set_text_static(txtArtist, "Artist Name");
 
   txtTrack = lv_label_create(lv_scr_act(), nullptr);
+  lv_obj_set_style_local_text_font(txtTrack, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &remote_glyph_font);
   lv_label_set_long_mode(txtTrack, LV_LABEL_LONG_SROLL_CIRC);
   lv_obj_align(txtTrack, nullptr, LV_ALIGN_IN_LEFT_MID, 12, MIDDLE_OFFSET + 2 * FONT_HEIGHT + LINE_PAD);
 
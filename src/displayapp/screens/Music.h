@@ -91,8 +91,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Music;
       static constexpr const char* icon = Screens::Symbols::music;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Music(*controllers.musicService);
+      static Screens::Music* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Music(*controllers.musicService);
       };
     };
   }
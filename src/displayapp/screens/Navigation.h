@@ -64,8 +64,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Navigation;
       static constexpr const char* icon = Screens::Symbols::map;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Navigation(*controllers.navigationService);
+      static Screens::Navigation* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Navigation(*controllers.navigationService);
       };
     };
   }
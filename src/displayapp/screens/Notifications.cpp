@@ -9,6 +9,7 @@
 using namespace Pinetime::Applications::Screens;
 extern lv_font_t jetbrains_mono_extrabold_compressed;
 extern lv_font_t jetbrains_mono_bold_20;
+extern lv_font_t remote_glyph_font;
 
 Notifications::Notifications(DisplayApp* app,
                              Pinetime::Controllers::NotificationManager& notificationManager,
@@ -31,7 +32,7 @@ Notifications::Notifications(DisplayApp* app,
                                                      notification.Message(),
                                                      1,
                                                      notification.category,
-                                                     notificationManager.NbNotifications(),
+                                                     notification.count,
                                                      alertNotificationService,
                                                      motorController);
     validDisplay = true;
@@ -102,12 +103,11 @@ void Notifications::Refresh() {
     }
 
     if (validDisplay) {
-      Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
       currentItem = std::make_unique<NotificationItem>(notification.Title(),
                                                        notification.Message(),
-                                                       currentIdx + 1,
+                                                       notification.index + 1,
                                                        notification.category,
-                                                       notificationManager.NbNotifications(),
+                                                       notification.count,
                                                        alertNotificationService,
                                                        motorController);
     } else {
@@ -162,14 +162,16 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
   switch (event) {
     case Pinetime::Applications::TouchEvents::SwipeRight:
       if (validDisplay) {
-        auto previousMessage = notificationManager.GetPrevious(currentId);
-        auto nextMessage = notificationManager.GetNext(currentId);
-        afterDismissNextMessageFromAbove = previousMessage.valid;
+        Controllers::NotificationManager::Notification::Id previousId;
+        Controllers::NotificationManager::Notification::Id nextId;
+        const bool hasPrevious = notificationManager.FindPrevious(currentId, previousId);
+        const bool hasNext = notificationManager.FindNext(currentId, nextId);
+        afterDismissNextMessageFromAbove = hasPrevious;
         notificationManager.Dismiss(currentId);
-        if (previousMessage.valid) {
-          currentId = previousMessage.id;
-        } else if (nextMessage.valid) {
-          currentId = nextMessage.id;
+        if (hasPrevious) {
+          currentId = previousId;
+        } else if (hasNext) {
+          currentId = nextId;
         } else {
           // don't update id, notification manager will try to fetch
           // but not find it. Refresh will try to load latest message
@@ -180,7 +182,7 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       }
       return false;
     case Pinetime::Applications::TouchEvents::SwipeDown: {
-      Controllers::NotificationManager::Notification previousNotification;
+      Controllers::NotificationManager::View previousNotification;
       if (validDisplay) {
         previousNotification = notificationManager.GetPrevious(currentId);
       } else {
@@ -192,21 +194,20 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       }
 
       currentId = previousNotification.id;
-      Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
       currentItem = std::make_unique<NotificationItem>(previousNotification.Title(),
                                                        previousNotification.Message(),
-                                                       currentIdx + 1,
+                                                       previousNotification.index + 1,
                                                        previousNotification.category,
-                                                       notificationManager.NbNotifications(),
+                                                       previousNotification.count,
                                                        alertNotificationService,
                                                        motorController);
     }
       return true;
     case Pinetime::Applications::TouchEvents::SwipeUp: {
-      Controllers::NotificationManager::Notification nextNotification;
+      Controllers::NotificationManager::View nextNotification;
       if (validDisplay) {
         nextNotification = notificationManager.GetNext(currentId);
       } else {
@@ -219,15 +220,14 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       }
 
       currentId = nextNotification.id;
-      Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
       currentItem = std::make_unique<NotificationItem>(nextNotification.Title(),
                                                        nextNotification.Message(),
-                                                       currentIdx + 1,
+                                                       nextNotification.index + 1,
                                                        nextNotification.category,
-                                                       notificationManager.NbNotifications(),
+                                                       nextNotification.count,
                                                        alertNotificationService,
                                                        motorController);
     }
@@ -257,9 +257,9 @@ Notifications::NotificationItem::NotificationItem(Pinetime::Controllers::AlertNo
 
 Notifications::NotificationItem::NotificationItem(const char* title,
                                                   const char* msg,
-                                                  uint8_t notifNr,
+                                                  uint16_t notifNr,
                                                   Controllers::NotificationManager::Categories category,
-                                                  uint8_t notifNb,
+                                                  uint16_t notifNb,
                                                   Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                                                   Pinetime::Controllers::MotorController& motorController)
   : alertNotificationService {alertNotificationService}, motorController {motorController} {
@@ -287,6 +287,7 @@ Notifications::NotificationItem::NotificationItem(const char* title,
 
   lv_obj_t* alert_type = lv_label_create(container, nullptr);
   lv_obj_set_style_local_text_color(alert_type, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, Colors::orange);
+  lv_obj_set_style_local_text_font(alert_type, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &remote_glyph_font);
   if (title == nullptr) {
     lv_label_set_text_static(alert_type, "Notification");
   } else {
@@ -304,6 +305,7 @@ Notifications::NotificationItem::NotificationItem(const char* title,
   lv_obj_align(alert_type, nullptr, LV_ALIGN_IN_TOP_LEFT, 0, 16);
 
   lv_obj_t* alert_subject = lv_label_create(subject_container, nullptr);
+  lv_obj_set_style_local_text_font(alert_subject, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &remote_glyph_font);
   lv_label_set_long_mode(alert_subject, LV_LABEL_LONG_BREAK);
   lv_obj_set_width(alert_subject, LV_HOR_RES - 20);
 
@@ -316,6 +318,7 @@ Notifications::NotificationItem::NotificationItem(const char* title,
       lv_label_set_text_static(alert_subject, "Incoming call from");
 
       lv_obj_t* alert_caller = lv_label_create(subject_container, nullptr);
+      lv_obj_set_style_local_text_font(alert_caller, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &remote_glyph_font);
       lv_obj_align(alert_caller, alert_subject, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 0);
       lv_label_set_long_mode(alert_caller, LV_LABEL_LONG_BREAK);
       lv_obj_set_width(alert_caller, LV_HOR_RES - 20);
@@ -41,9 +41,9 @@ namespace Pinetime {
                            Pinetime::Controllers::MotorController& motorController);
           NotificationItem(const char* title,
                            const char* msg,
-                           uint8_t notifNr,
+                           uint16_t notifNr,
                            Controllers::NotificationManager::Categories,
-                           uint8_t notifNb,
+                           uint16_t notifNb,
                            Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                            Pinetime::Controllers::MotorController& motorController);
           ~NotificationItem();
@@ -54,8 +54,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Paddle;
       static constexpr const char* icon = Screens::Symbols::paddle;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Paddle(controllers.lvgl);
+      static Screens::Paddle* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Paddle(controllers.lvgl);
       };
     };
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <new>
 #include "displayapp/TouchEvents.h"
 #include <lvgl/lvgl.h>
 
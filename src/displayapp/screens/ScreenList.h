@@ -4,14 +4,23 @@
 #include <functional>
 #include <memory>
 #include "displayapp/screens/Screen.h"
-#include "displayapp/DisplayApp.h"
 
 namespace Pinetime {
   namespace Applications {
+    class DisplayApp;
+
     namespace Screens {
 
       enum class ScreenListModes { UpDown, RightLeft, LongPress };
 
+      // Sets the full refresh of app for the page shown after event (defined in DisplayApp.cpp). This header does not include
+      // DisplayApp.h, which includes the headers of the screens that hold a ScreenList (see SystemScreens.h).
+      void SetScreenListRefresh(DisplayApp* app, TouchEvents event);
+
+      /**
+       * Screen made of N pages, browsed with swipes or long taps. Unlike the screens of DisplayApp, which are constructed in
+       * its screen arena, each page is allocated from the heap when it is shown.
+       */
       template <size_t N>
       class ScreenList : public Screen {
       public:
@@ -43,7 +52,7 @@ namespace Pinetime {
               case TouchEvents::SwipeDown:
                 if (screenIndex > 0) {
                   current.reset(nullptr);
-                  app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
+                  SetScreenListRefresh(app, event);
                   screenIndex--;
                   current = screens[screenIndex]();
                   return true;
@@ -54,7 +63,7 @@ namespace Pinetime {
               case TouchEvents::SwipeUp:
                 if (screenIndex < screens.size() - 1) {
                   current.reset(nullptr);
-                  app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
+                  SetScreenListRefresh(app, event);
                   screenIndex++;
                   current = screens[screenIndex]();
                 }
@@ -67,7 +76,7 @@ namespace Pinetime {
               case TouchEvents::SwipeRight:
                 if (screenIndex > 0) {
                   current.reset(nullptr);
-                  app->SetFullRefresh(DisplayApp::FullRefreshDirections::None);
+                  SetScreenListRefresh(app, event);
                   screenIndex--;
                   current = screens[screenIndex]();
                   return true;
@@ -78,7 +87,7 @@ namespace Pinetime {
               case TouchEvents::SwipeLeft:
                 if (screenIndex < screens.size() - 1) {
                   current.reset(nullptr);
-                  app->SetFullRefresh(DisplayApp::FullRefreshDirections::None);
+                  SetScreenListRefresh(app, event);
                   screenIndex++;
                   current = screens[screenIndex]();
                 }
@@ -93,7 +102,7 @@ namespace Pinetime {
               screenIndex = 0;
             }
             current.reset(nullptr);
-            app->SetFullRefresh(DisplayApp::FullRefreshDirections::None);
+            SetScreenListRefresh(app, event);
             current = screens[screenIndex]();
             return true;
           }
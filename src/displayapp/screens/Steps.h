@@ -48,8 +48,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Steps;
       static constexpr const char* icon = Screens::Symbols::shoe;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Steps(controllers.motionController, controllers.settingsController);
+      static Screens::Steps* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Steps(controllers.motionController, controllers.settingsController);
       };
     };
   }
@@ -66,8 +66,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::StopWatch;
       static constexpr const char* icon = Screens::Symbols::stopWatch;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::StopWatch(*controllers.systemTask);
+      static Screens::StopWatch* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::StopWatch(*controllers.systemTask);
       };
     };
   }
@@ -12,6 +12,9 @@
 #include "components/brightness/BrightnessController.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/motion/MotionController.h"
+#include "components/display/DisplayStatistics.h"
+#include "displayapp/LvglPool.h"
+#include "systemtask/TaskStatistics.h"
 #include "drivers/Watchdog.h"
 #include "displayapp/InfiniTimeTheme.h"
 
@@ -39,7 +42,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
                        const Pinetime::Drivers::Watchdog& watchdog,
                        Pinetime::Controllers::MotionController& motionController,
                        const Pinetime::Drivers::Cst816S& touchPanel,
-                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       const Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                       const Pinetime::System::TaskStatistics& taskStatistics)
   : dateTimeController {dateTimeController},
     batteryController {batteryController},
     brightnessController {brightnessController},
@@ -48,6 +53,8 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
     motionController {motionController},
     touchPanel {touchPanel},
     spiNorFlash {spiNorFlash},
+    displayStatistics {displayStatistics},
+    taskStatistics {taskStatistics},
     screens {app,
              0,
              {[this]() -> std::unique_ptr<Screen> {
@@ -64,6 +71,15 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen7();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen8();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -96,7 +112,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         BootloaderVersion::VersionString());
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, label);
+  return std::make_unique<Screens::Label>(0, 8, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -175,10 +191,10 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, label);
+  return std::make_unique<Screens::Label>(1, 8, label);
 }
 
-extern int mallocFailedCount;
+extern Pinetime::Components::LvglPool lvglPool;
 extern int stackOverflowCount;
 std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
   lv_mem_monitor_t mon;
@@ -197,7 +213,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         "#808080 Memory heap#\n"
                         " #808080 Free# %d\n"
                         " #808080 Min free# %d\n"
-                        " #808080 Alloc err# %d\n"
+                        " #808080 Alloc err# %lu\n"
                         " #808080 Ovrfl err# %d\n",
                         bleAddr[5],
                         bleAddr[4],
@@ -210,17 +226,96 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         spiFlashId.density,
                         xPortGetFreeHeapSize(),
                         xPortGetMinimumEverFreeHeapSize(),
-                        mallocFailedCount,
+                        lvglPool.MallocFailures(),
                         stackOverflowCount);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, label);
+  return std::make_unique<Screens::Label>(2, 8, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+  const auto statistics = displayStatistics.GetSummary();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#FFFF00 Display# (avg/max)\n"
+                        "#808080 Frames# %lu\n"
+                        "#808080 Tasks# %lu/%luus\n"
+                        "#808080 Render# %lu/%luus\n"
+                        "#808080 Flush# %lu/%luus\n"
+                        "#808080 Frame# %lu/%luus\n"
+                        "#808080 Bytes# %lu/%lu\n"
+                        "#808080 Areas# %lu/%lu\n"
+                        "#808080 Total# %luKB\n"
+                        "#808080 AOD dropped# %lu",
+                        statistics.frames,
+                        statistics.taskHandlerUs.Average(),
+                        statistics.taskHandlerUs.Max(),
+                        statistics.renderUs.Average(),
+                        statistics.renderUs.Max(),
+                        statistics.flushUs.Average(),
+                        statistics.flushUs.Max(),
+                        statistics.frameUs.Average(),
+                        statistics.frameUs.Max(),
+                        statistics.bytesPerFrame.Average(),
+                        statistics.bytesPerFrame.Max(),
+                        statistics.areasPerFrame.Average(),
+                        statistics.areasPerFrame.Max(),
+                        statistics.kilobytesFlushed,
+                        statistics.droppedAlwaysOnFrames);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(3, 8, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+  static_assert(Pinetime::Components::LvglPool::nbClasses == 5, "The page displays 5 size classes");
+  const auto& statistics = lvglPool.GetStatistics();
+  const auto heap = Pinetime::Components::LvglPool::GetHeapStatistics();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#FFFF00 LVGL pool# (used/peak)\n"
+                        "#808080 %3uB# %u/%u of %u\n"
+                        "#808080 %3uB# %u/%u of %u\n"
+                        "#808080 %3uB# %u/%u of %u\n"
+                        "#808080 %3uB# %u/%u of %u\n"
+                        "#808080 %3uB# %u/%u of %u\n"
+                        "#808080 Heap allocs# %lu\n"
+                        "#808080 Largest free# %u\n"
+                        "#808080 Free blocks# %u",
+                        statistics.classes[0].blockSize,
+                        statistics.classes[0].used,
+                        statistics.classes[0].peakUsed,
+                        statistics.classes[0].nbBlocks,
+                        statistics.classes[1].blockSize,
+                        statistics.classes[1].used,
+                        statistics.classes[1].peakUsed,
+                        statistics.classes[1].nbBlocks,
+                        statistics.classes[2].blockSize,
+                        statistics.classes[2].used,
+                        statistics.classes[2].peakUsed,
+                        statistics.classes[2].nbBlocks,
+                        statistics.classes[3].blockSize,
+                        statistics.classes[3].used,
+                        statistics.classes[3].peakUsed,
+                        statistics.classes[3].nbBlocks,
+                        statistics.classes[4].blockSize,
+                        statistics.classes[4].used,
+                        statistics.classes[4].peakUsed,
+                        statistics.classes[4].nbBlocks,
+                        statistics.heapAllocations,
+                        heap.largestFreeBlock,
+                        heap.nbFreeBlocks);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(4, 8, label);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
   return lhs.xTaskNumber < rhs.xTaskNumber;
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
   static constexpr uint8_t maxTaskCount = 9;
   TaskStatus_t tasksStatus[maxTaskCount];
 
@@ -274,10 +369,41 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, infoTask);
+  return std::make_unique<Screens::Label>(5, 8, infoTask);
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen7() {
+  auto summary = taskStatistics.GetSummary();
+
+  lv_obj_t* infoTask = lv_table_create(lv_scr_act(), nullptr);
+  lv_table_set_col_cnt(infoTask, 3);
+  lv_table_set_row_cnt(infoTask, summary.nbTasks + 1);
+  lv_obj_set_style_local_pad_all(infoTask, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_border_color(infoTask, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, Colors::lightGray);
+
+  lv_table_set_cell_value(infoTask, 0, 0, "Task");
+  lv_table_set_col_width(infoTask, 0, 70);
+  lv_table_set_cell_value(infoTask, 0, 1, "CPU %");
+  lv_table_set_col_width(infoTask, 1, 80);
+  lv_table_set_cell_value(infoTask, 0, 2, "Wake/s");
+  lv_table_set_col_width(infoTask, 2, 90);
+
+  auto& tasks = summary.tasks;
+  std::sort(tasks.begin(), tasks.begin() + summary.nbTasks, [](const auto& lhs, const auto& rhs) {
+    return lhs.number < rhs.number;
+  });
+  for (uint8_t i = 0; i < summary.nbTasks; i++) {
+    char buffer[8] = {0};
+    lv_table_set_cell_value(infoTask, i + 1, 0, tasks[i].name);
+    snprintf(buffer, sizeof(buffer), "%u.%u", tasks[i].cpuPermille / 10, tasks[i].cpuPermille % 10);
+    lv_table_set_cell_value(infoTask, i + 1, 1, buffer);
+    snprintf(buffer, sizeof(buffer), "%u", tasks[i].wakeupsPerSecond);
+    lv_table_set_cell_value(infoTask, i + 1, 2, buffer);
+  }
+  return std::make_unique<Screens::Label>(6, 8, infoTask);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen8() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -291,5 +417,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, label);
+  return std::make_unique<Screens::Label>(7, 8, label);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "displayapp/screens/Screen.h"
+#include "displayapp/Controllers.h"
 #include "components/datetime/DateTimeController.h"
 #include "systemtask/SystemTask.h"
 #include "displayapp/LittleVgl.h"
@@ -54,8 +55,8 @@ namespace Pinetime::Applications {
     static constexpr Apps app = Apps::Timer;
     static constexpr const char* icon = Screens::Symbols::hourGlass;
 
-    static Screens::Screen* Create(AppControllers& controllers) {
-      return new Screens::Timer(controllers.timer);
+    static Screens::Timer* Create(AppControllers& controllers, void* memory) {
+      return new (memory) Screens::Timer(controllers.timer);
     };
   };
 }
@@ -42,8 +42,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Twos;
       static constexpr const char* icon = "2";
 
-      static Screens::Screen* Create(AppControllers& /*controllers*/) {
-        return new Screens::Twos();
+      static Screens::Twos* Create(AppControllers& /*controllers*/, void* memory) {
+        return new (memory) Screens::Twos();
       };
     };
   }
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <memory>
 #include "displayapp/screens/Screen.h"
+#include "displayapp/Controllers.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
@@ -93,12 +94,12 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::Analog;
       static constexpr const char* name = "Analog face";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFaceAnalog(controllers.dateTimeController,
-                                            controllers.batteryController,
-                                            controllers.bleController,
-                                            controllers.notificationManager,
-                                            controllers.settingsController);
+      static Screens::WatchFaceAnalog* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFaceAnalog(controllers.dateTimeController,
+                                                     controllers.batteryController,
+                                                     controllers.bleController,
+                                                     controllers.notificationManager,
+                                                     controllers.settingsController);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& /*filesystem*/) {
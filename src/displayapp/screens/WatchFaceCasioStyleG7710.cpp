@@ -6,6 +6,7 @@
 #include "displayapp/screens/BleIcon.h"
 #include "displayapp/screens/NotificationIcon.h"
 #include "displayapp/screens/Symbols.h"
+#include "displayapp/StreamingFont.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
@@ -32,21 +33,10 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
     heartRateController {heartRateController},
     motionController {motionController} {
 
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_dot40 = lv_font_load("F:/fonts/lv_font_dots_40.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/7segments_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment40 = lv_font_load("F:/fonts/7segments_40.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/7segments_115.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment115 = lv_font_load("F:/fonts/7segments_115.bin");
-  }
+  // The glyphs are read from the file system when they are drawn, the caches hold all the digits of the time
+  font_dot40 = Components::StreamingFont::Load(filesystem, "/fonts/lv_font_dots_40.bin", 1024);
+  font_segment40 = Components::StreamingFont::Load(filesystem, "/fonts/7segments_40.bin", 512);
+  font_segment115 = Components::StreamingFont::Load(filesystem, "/fonts/7segments_115.bin", 4096);
 
   label_battery_value = lv_label_create(lv_scr_act(), nullptr);
   lv_obj_align(label_battery_value, lv_scr_act(), LV_ALIGN_IN_TOP_RIGHT, 0, 0);
@@ -179,15 +169,15 @@ WatchFaceCasioStyleG7710::~WatchFaceCasioStyleG7710() {
   lv_style_reset(&style_border);
 
   if (font_dot40 != nullptr) {
-    lv_font_free(font_dot40);
+    Components::StreamingFont::Free(font_dot40);
   }
 
   if (font_segment40 != nullptr) {
-    lv_font_free(font_segment40);
+    Components::StreamingFont::Free(font_segment40);
   }
 
   if (font_segment115 != nullptr) {
-    lv_font_free(font_segment115);
+    Components::StreamingFont::Free(font_segment115);
   }
 
   lv_obj_clean(lv_scr_act());
@@ -107,15 +107,15 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::CasioStyleG7710;
       static constexpr const char* name = "Casio G7710";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFaceCasioStyleG7710(controllers.dateTimeController,
-                                                     controllers.batteryController,
-                                                     controllers.bleController,
-                                                     controllers.notificationManager,
-                                                     controllers.settingsController,
-                                                     controllers.heartRateController,
-                                                     controllers.motionController,
-                                                     controllers.filesystem);
+      static Screens::WatchFaceCasioStyleG7710* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFaceCasioStyleG7710(controllers.dateTimeController,
+                                                              controllers.batteryController,
+                                                              controllers.bleController,
+                                                              controllers.notificationManager,
+                                                              controllers.settingsController,
+                                                              controllers.heartRateController,
+                                                              controllers.motionController,
+                                                              controllers.filesystem);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
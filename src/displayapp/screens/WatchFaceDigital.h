@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <memory>
 #include "displayapp/screens/Screen.h"
+#include "displayapp/Controllers.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/ble/SimpleWeatherService.h"
 #include "components/ble/BleController.h"
@@ -80,15 +81,15 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::Digital;
       static constexpr const char* name = "Digital face";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFaceDigital(controllers.dateTimeController,
-                                             controllers.batteryController,
-                                             controllers.bleController,
-                                             controllers.notificationManager,
-                                             controllers.settingsController,
-                                             controllers.heartRateController,
-                                             controllers.motionController,
-                                             *controllers.weatherController);
+      static Screens::WatchFaceDigital* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFaceDigital(controllers.dateTimeController,
+                                                      controllers.batteryController,
+                                                      controllers.bleController,
+                                                      controllers.notificationManager,
+                                                      controllers.settingsController,
+                                                      controllers.heartRateController,
+                                                      controllers.motionController,
+                                                      *controllers.weatherController);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& /*filesystem*/) {
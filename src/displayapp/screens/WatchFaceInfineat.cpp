@@ -4,6 +4,7 @@
 #include <cstdio>
 #include "displayapp/screens/Symbols.h"
 #include "displayapp/screens/BleIcon.h"
+#include "displayapp/StreamingFont.h"
 #include "components/settings/Settings.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
@@ -133,16 +134,9 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
     notificationManager {notificationManager},
     settingsController {settingsController},
     motionController {motionController} {
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/teko.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_teko = lv_font_load("F:/fonts/teko.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/bebas.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_bebas = lv_font_load("F:/fonts/bebas.bin");
-  }
+  // The glyphs are read from the file system when they are drawn, the caches hold all the digits of the time
+  font_teko = Components::StreamingFont::Load(filesystem, "/fonts/teko.bin", 512);
+  font_bebas = Components::StreamingFont::Load(filesystem, "/fonts/bebas.bin", 2048);
 
   // Side Cover
   static constexpr lv_point_t linePoints[nLines][2] = {{{30, 25}, {68, -8}},
@@ -304,10 +298,10 @@ WatchFaceInfineat::~WatchFaceInfineat() {
   lv_task_del(taskRefresh);
 
   if (font_bebas != nullptr) {
-    lv_font_free(font_bebas);
+    Components::StreamingFont::Free(font_bebas);
   }
   if (font_teko != nullptr) {
-    lv_font_free(font_teko);
+    Components::StreamingFont::Free(font_teko);
   }
 
   lv_obj_clean(lv_scr_act());
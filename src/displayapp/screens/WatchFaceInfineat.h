@@ -105,14 +105,14 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::Infineat;
       static constexpr const char* name = "Infineat face";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFaceInfineat(controllers.dateTimeController,
-                                              controllers.batteryController,
-                                              controllers.bleController,
-                                              controllers.notificationManager,
-                                              controllers.settingsController,
-                                              controllers.motionController,
-                                              controllers.filesystem);
+      static Screens::WatchFaceInfineat* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFaceInfineat(controllers.dateTimeController,
+                                                       controllers.batteryController,
+                                                       controllers.bleController,
+                                                       controllers.notificationManager,
+                                                       controllers.settingsController,
+                                                       controllers.motionController,
+                                                       controllers.filesystem);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
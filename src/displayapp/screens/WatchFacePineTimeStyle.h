@@ -126,14 +126,14 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::PineTimeStyle;
       static constexpr const char* name = "PineTimeStyle";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFacePineTimeStyle(controllers.dateTimeController,
-                                                   controllers.batteryController,
-                                                   controllers.bleController,
-                                                   controllers.notificationManager,
-                                                   controllers.settingsController,
-                                                   controllers.motionController,
-                                                   *controllers.weatherController);
+      static Screens::WatchFacePineTimeStyle* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFacePineTimeStyle(controllers.dateTimeController,
+                                                            controllers.batteryController,
+                                                            controllers.bleController,
+                                                            controllers.notificationManager,
+                                                            controllers.settingsController,
+                                                            controllers.motionController,
+                                                            *controllers.weatherController);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& /*filesystem*/) {
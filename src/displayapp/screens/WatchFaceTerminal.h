@@ -74,14 +74,14 @@ namespace Pinetime {
       static constexpr WatchFace watchFace = WatchFace::Terminal;
       static constexpr const char* name = "Terminal";
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::WatchFaceTerminal(controllers.dateTimeController,
-                                              controllers.batteryController,
-                                              controllers.bleController,
-                                              controllers.notificationManager,
-                                              controllers.settingsController,
-                                              controllers.heartRateController,
-                                              controllers.motionController);
+      static Screens::WatchFaceTerminal* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::WatchFaceTerminal(controllers.dateTimeController,
+                                                       controllers.batteryController,
+                                                       controllers.bleController,
+                                                       controllers.notificationManager,
+                                                       controllers.settingsController,
+                                                       controllers.heartRateController,
+                                                       controllers.motionController);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& /*filesystem*/) {
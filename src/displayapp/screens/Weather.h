@@ -48,8 +48,8 @@ namespace Pinetime {
       static constexpr Apps app = Apps::Weather;
       static constexpr const char* icon = Screens::Symbols::cloudSunRain;
 
-      static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Weather(controllers.settingsController, *controllers.weatherController);
+      static Screens::Weather* Create(AppControllers& controllers, void* memory) {
+        return new (memory) Screens::Weather(controllers.settingsController, *controllers.weatherController);
       };
     };
   }
@@ -1,4 +1,5 @@
 #include "drivers/Bma421.h"
+#include <algorithm>
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/TwiMaster.h"
@@ -32,6 +33,22 @@ namespace {
     [BMA4_ACCEL_RANGE_8G] = 256,  // LSB/g +/- 8g range
     [BMA4_ACCEL_RANGE_16G] = 128  // LSB/g +/- 16g range
   };
+
+#ifdef MOTION_ACQUISITION_FIFO
+  // Command register value that clears the FIFO (see bma4_set_command_register())
+  constexpr uint8_t fifoFlushCommand = 0xB0;
+
+  constexpr uint8_t OutputDataRate(uint16_t rate) {
+    switch (rate) {
+      case 50:
+        return BMA4_OUTPUT_DATA_RATE_50HZ;
+      default:
+        return BMA4_OUTPUT_DATA_RATE_100HZ;
+    }
+  }
+
+  static_assert(Bma421::fifoRate == 50 || Bma421::fifoRate == 100, "MOTION_FIFO_RATE must be 50 or 100");
+#endif
 }
 
 Bma421::Bma421(TwiMaster& twiMaster, uint8_t twiAddress) : twiMaster {twiMaster}, deviceAddress {twiAddress} {
@@ -84,7 +101,11 @@ void Bma421::Init() {
   if (ret != BMA4_OK)
     return;
 
+#ifdef MOTION_ACQUISITION_FIFO
+  accel_conf.odr = OutputDataRate(fifoRate);
+#else
   accel_conf.odr = BMA4_OUTPUT_DATA_RATE_100HZ;
+#endif
   accel_conf.range = BMA4_ACCEL_RANGE_2G;
   accel_conf.bandwidth = BMA4_ACCEL_NORMAL_AVG4;
   accel_conf.perf_mode = BMA4_CIC_AVG_MODE;
@@ -92,6 +113,48 @@ void Bma421::Init() {
   if (ret != BMA4_OK)
     return;
 
+#ifdef MOTION_ACQUISITION_FIFO
+  // Headerless frames of accelerometer data only, the oldest frames are overwritten when the FIFO is full
+  ret = bma4_set_fifo_config(BMA4_FIFO_HEADER, BMA4_DISABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_ENABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_wm(fifoWatermark * fifoFrameSize, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  // The interrupt is latched : INT1 stays high until the interrupt status is read (see ReadFifo()), SystemTask checks its level
+  // in addition to its rising edge
+  ret = bma4_set_interrupt_mode(BMA4_LATCH_MODE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  const struct bma4_int_pin_config pinConfig = {
+    .edge_ctrl = BMA4_LEVEL_TRIGGER,
+    .lvl = BMA4_ACTIVE_HIGH,
+    .od = BMA4_PUSH_PULL,
+    .output_en = BMA4_OUTPUT_ENABLE,
+    .input_en = BMA4_INPUT_DISABLE,
+  };
+  ret = bma4_set_int_pin_config(&pinConfig, BMA4_INTR1_MAP, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_map_interrupt(BMA4_INTR1_MAP, BMA4_FIFO_WM_INT, BMA4_ENABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  FlushFifo();
+#endif
+
+#ifdef TWI_BENCHMARK
+  twiMaster.RunBenchmark(deviceAddress, BMA4_DATA_8_ADDR, BMA4_STEP_CNT_OUT_0_ADDR);
+#endif
+
   isOk = true;
 }
 
@@ -111,25 +174,107 @@ void Bma421::Write(uint8_t registerAddress, const uint8_t* data, size_t size) {
 Bma421::Values Bma421::Process() {
   if (not isOk)
     return {};
+  // Acceleration and step counter in a single batch of transactions (see bma4_read_accel_xyz() and
+  // bma423_step_counter_output())
+  uint8_t accelData[BMA4_ACCEL_DATA_LENGTH];
+  uint8_t stepData[sizeof(uint32_t)];
+  TwiMaster::Transaction transactions[] = {{deviceAddress, BMA4_DATA_8_ADDR, accelData, nullptr, sizeof(accelData)},
+                                           {deviceAddress, BMA4_STEP_CNT_OUT_0_ADDR, stepData, nullptr, sizeof(stepData)}};
+  if (twiMaster.Transfer(transactions, 2) != TwiMaster::ErrorCodes::NoError)
+    return {};
+
+  // 12 bits values, left aligned in little endian words
   struct bma4_accel rawData;
-  struct bma4_accel data;
-  bma4_read_accel_xyz(&rawData, &bma);
+  rawData.x = static_cast<int16_t>(accelData[0] | (accelData[1] << 8)) / 0x10;
+  rawData.y = static_cast<int16_t>(accelData[2] | (accelData[3] << 8)) / 0x10;
+  rawData.z = static_cast<int16_t>(accelData[4] | (accelData[5] << 8)) / 0x10;
 
   // Scale the measured ADC counts to units of 'binary milli-g'
   // where 1g = 1024 'binary milli-g' units.
   // See https://github.com/InfiniTimeOrg/InfiniTime/pull/1950 for
   // discussion of why we opted for scaling to 1024 rather than 1000.
+  struct bma4_accel data;
   data.x = 1024 * rawData.x / accelScaleFactors[accel_conf.range];
   data.y = 1024 * rawData.y / accelScaleFactors[accel_conf.range];
   data.z = 1024 * rawData.z / accelScaleFactors[accel_conf.range];
 
-  uint32_t steps = 0;
-  bma423_step_counter_output(&steps, &bma);
+  const uint32_t steps = stepData[0] | (stepData[1] << 8) | (stepData[2] << 16) | (static_cast<uint32_t>(stepData[3]) << 24);
 
   // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
   return {steps, data.y, data.x, data.z};
 }
 
+#ifdef MOTION_ACQUISITION_FIFO
+size_t Bma421::ReadFifo(Sample* samples, size_t size) {
+  if (not isOk)
+    return 0;
+
+  // The interrupt is cleared before the FIFO is drained : if the watermark is reached again meanwhile, INT1 rises again.
+  // Interrupt status and FIFO length in a single batch of transactions (see bma4_get_fifo_length()).
+  uint8_t interruptStatus[2];
+  uint8_t fifoLengthData[BMA4_FIFO_DATA_LENGTH];
+  TwiMaster::Transaction transactions[] = {
+    {deviceAddress, BMA4_INT_STAT_0_ADDR, interruptStatus, nullptr, sizeof(interruptStatus)},
+    {deviceAddress, BMA4_FIFO_LENGTH_0_ADDR, fifoLengthData, nullptr, sizeof(fifoLengthData)}};
+  if (twiMaster.Transfer(transactions, 2) != TwiMaster::ErrorCodes::NoError)
+    return 0;
+  const uint16_t fifoLength = ((fifoLengthData[1] & BMA4_FIFO_BYTE_COUNTER_MSB_MSK) << 8) | fifoLengthData[0];
+
+  const size_t nbFrames = std::min<size_t>(fifoLength / fifoFrameSize, size);
+  size_t count = 0;
+  while (count < nbFrames) {
+    // The FIFO data register is not auto-incremented : each burst pops the next frames
+    const size_t burst = std::min(nbFrames - count, maxFramesPerBurst);
+    Read(BMA4_FIFO_DATA_ADDR, reinterpret_cast<uint8_t*>(samples + count), burst * fifoFrameSize);
+    count += burst;
+  }
+  ConvertFifoFrames(samples, count, accel_conf.range);
+  return count;
+}
+
+void Bma421::FlushFifo() {
+  if (not isOk)
+    return;
+  uint16_t interruptStatus = 0;
+  bma4_read_int_status(&interruptStatus, &bma);
+  bma4_set_command_register(fifoFlushCommand, &bma);
+}
+
+void Bma421::SetFifoEnabled(bool enabled) {
+  if (not isOk)
+    return;
+  const uint8_t enable = enabled ? BMA4_ENABLE : BMA4_DISABLE;
+  bma4_set_fifo_config(BMA4_FIFO_ACCEL, enable, &bma);
+  bma4_map_interrupt(BMA4_INTR1_MAP, BMA4_FIFO_WM_INT, enable, &bma);
+  // Clears the latched interrupt, and the frames stored before the FIFO was stopped
+  FlushFifo();
+}
+
+uint32_t Bma421::StepCount() {
+  if (not isOk)
+    return 0;
+  uint32_t steps = 0;
+  bma423_step_counter_output(&steps, &bma);
+  return steps;
+}
+
+void Bma421::ConvertFifoFrames(Sample* samples, size_t count, uint8_t range) {
+  auto* frames = reinterpret_cast<const uint8_t*>(samples);
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t* frame = frames + (i * fifoFrameSize);
+    // 12 bits values, left aligned in little endian words. Divided like in bma4_read_accel_xyz().
+    const int16_t x = static_cast<int16_t>(frame[0] | (frame[1] << 8)) / 0x10;
+    const int16_t y = static_cast<int16_t>(frame[2] | (frame[3] << 8)) / 0x10;
+    const int16_t z = static_cast<int16_t>(frame[4] | (frame[5] << 8)) / 0x10;
+
+    // Same scaling and axis swap as Process()
+    samples[i] = {static_cast<int16_t>(1024 * y / accelScaleFactors[range]),
+                  static_cast<int16_t>(1024 * x / accelScaleFactors[range]),
+                  static_cast<int16_t>(1024 * z / accelScaleFactors[range])};
+  }
+}
+#endif
+
 bool Bma421::IsOk() const {
   return isOk;
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <drivers/Bma421_C/bma4_defs.h>
 
 namespace Pinetime {
@@ -16,6 +17,24 @@ namespace Pinetime {
         int16_t z;
       };
 
+      // Acceleration on the 3 axis, in the same units and orientation as Values
+      struct Sample {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+      };
+
+#ifdef MOTION_ACQUISITION_FIFO
+      // Headerless frames of the FIFO : 2 bytes per axis
+      static constexpr size_t fifoFrameSize = 6;
+      static_assert(sizeof(Sample) == fifoFrameSize);
+      static constexpr uint16_t fifoRate = MOTION_FIFO_RATE;
+      // The watermark interrupt is raised when the FIFO holds 250ms of samples
+      static constexpr size_t fifoWatermark = fifoRate / 4;
+      // The EasyDMA transfers of the TWI are limited to 255 bytes
+      static constexpr size_t maxFramesPerBurst = 255 / fifoFrameSize;
+#endif
+
       Bma421(TwiMaster& twiMaster, uint8_t twiAddress);
       Bma421(const Bma421&) = delete;
       Bma421& operator=(const Bma421&) = delete;
@@ -28,6 +47,18 @@ namespace Pinetime {
       void Init();
       Values Process();
       void ResetStepCounter();
+#ifdef MOTION_ACQUISITION_FIFO
+      /// Clears the watermark interrupt and drains the FIFO into samples, in bursts of maxFramesPerBurst frames.
+      /// Returns the number of samples read : if it is equal to size, the FIFO may hold more samples.
+      size_t ReadFifo(Sample* samples, size_t size);
+      /// Clears the watermark interrupt and drops the content of the FIFO
+      void FlushFifo();
+      /// Stops the FIFO and its watermark interrupt, or restarts them with an empty FIFO. The step counter keeps counting.
+      void SetFifoEnabled(bool enabled);
+      uint32_t StepCount();
+      /// Converts the raw frames stored at the beginning of samples in place
+      static void ConvertFifoFrames(Sample* samples, size_t count, uint8_t range);
+#endif
 
       void Read(uint8_t registerAddress, uint8_t* buffer, size_t size);
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
@@ -13,6 +13,13 @@ bool Spi::Write(const uint8_t* data, size_t size, const std::function<void()>& p
   return spiMaster.Write(pinCsn, data, size, preTransactionHook);
 }
 
+bool Spi::Write(const uint8_t* data,
+                size_t size,
+                const std::function<void()>& preTransactionHook,
+                const std::function<void()>& transferCompleted) {
+  return spiMaster.Write(pinCsn, data, size, preTransactionHook, transferCompleted);
+}
+
 bool Spi::Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
   return spiMaster.Read(pinCsn, cmd, cmdSize, data, dataSize);
 }
@@ -37,3 +44,11 @@ void Spi::Wakeup() {
   nrf_gpio_pin_set(pinCsn);
   NRF_LOG_INFO("[SPI] Wakeup")
 }
+
+void Spi::SetChainedTransfers(bool enabled) {
+  spiMaster.SetChainedTransfers(enabled);
+}
+
+const SpiMaster::Statistics& Spi::GetStatistics() const {
+  return spiMaster.GetStatistics();
+}
@@ -16,11 +16,18 @@ namespace Pinetime {
 
       bool Init();
       bool Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      bool Write(const uint8_t* data,
+                 size_t size,
+                 const std::function<void()>& preTransactionHook,
+                 const std::function<void()>& transferCompleted);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
       void Sleep();
       void Wakeup();
 
+      void SetChainedTransfers(bool enabled);
+      const SpiMaster::Statistics& GetStatistics() const;
+
     private:
       SpiMaster& spiMaster;
       uint8_t pinCsn;
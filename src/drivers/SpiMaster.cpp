@@ -3,9 +3,15 @@
 #include <hal/nrf_spim.h>
 #include <nrfx_log.h>
 #include <algorithm>
+#include "systemtask/EventTrace.h"
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  // Counts the chunks of a chained transfer (SPIM END events) and interrupts once the last one is sent
+  NRF_TIMER_Type* const chainTimer = NRF_TIMER1;
+}
+
 SpiMaster::SpiMaster(const SpiMaster::SpiModule spi, const SpiMaster::Parameters& params) : spi {spi}, params {params} {
 }
 
@@ -90,6 +96,12 @@ bool SpiMaster::Init() {
   NRFX_IRQ_PRIORITY_SET(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn, 2);
   NRFX_IRQ_ENABLE(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn);
 
+  chainTimer->MODE = TIMER_MODE_MODE_LowPowerCounter;
+  chainTimer->BITMODE = TIMER_BITMODE_BITMODE_16Bit;
+  chainTimer->INTENSET = TIMER_INTENSET_COMPARE1_Msk;
+  NRFX_IRQ_PRIORITY_SET(TIMER1_IRQn, 2);
+  NRFX_IRQ_ENABLE(TIMER1_IRQn);
+
   xSemaphoreGive(mutex);
   return true;
 }
@@ -136,28 +148,110 @@ void SpiMaster::DisableWorkaroundForErratum58() {
 }
 
 void SpiMaster::OnEndEvent() {
+  statistics.interrupts++;
   if (currentBufferAddr == 0) {
     return;
   }
 
   auto s = currentBufferSize;
   if (s > 0) {
-    auto currentSize = std::min((size_t) 255, s);
+    auto currentSize = std::min((size_t) maxChunkSize, s);
     PrepareTx(currentBufferAddr, currentSize);
     currentBufferAddr = currentBufferAddr + currentSize;
     currentBufferSize = currentBufferSize - currentSize;
 
     spiBaseAddress->TASKS_START = 1;
   } else {
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    EndTransfer();
   }
 }
 
 void SpiMaster::OnStartedEvent() {
+  statistics.interrupts++;
+}
+
+void SpiMaster::OnChainEndEvent() {
+  statistics.interrupts++;
+  StopChainedTx();
+
+  // The bytes that do not fill a whole chunk are sent like a regular transfer, OnEndEvent() ends it
+  if (currentBufferSize > 0) {
+    PrepareTx(currentBufferAddr, currentBufferSize);
+    currentBufferAddr = currentBufferAddr + currentBufferSize;
+    currentBufferSize = 0;
+    spiBaseAddress->TASKS_START = 1;
+  } else {
+    EndTransfer();
+  }
+}
+
+void SpiMaster::EndTransfer() {
+  nrf_gpio_pin_set(this->pinCsn);
+  TRACE_EVENT(SpiEnd, this->pinCsn);
+  currentBufferAddr = 0;
+
+  // The next transfer may overwrite transferCompleted as soon as the bus is released
+  auto callback = std::move(transferCompleted);
+  transferCompleted = nullptr;
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
+  if (callback != nullptr) {
+    callback();
+  }
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void SpiMaster::StartChainedTx(uint32_t bufferAddress, size_t nbChunks) {
+  // No interrupt per chunk: the SPIM is restarted by PPI and TXD.PTR is moved to the next chunk by the ArrayList
+  spiBaseAddress->INTENCLR = (1 << 6);
+  spiBaseAddress->INTENCLR = (1 << 19);
+
+  chainTimer->TASKS_STOP = 1;
+  chainTimer->TASKS_CLEAR = 1;
+  chainTimer->CC[0] = nbChunks - 1;
+  chainTimer->CC[1] = nbChunks;
+  chainTimer->EVENTS_COMPARE[0] = 0;
+  chainTimer->EVENTS_COMPARE[1] = 0;
+  chainTimer->TASKS_START = 1;
+
+  // END -> START restarts the transfer on the next chunk until the last chunk is started (COMPARE[0])
+  nrf_ppi_channel_endpoint_setup(chainRestartPpi,
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->EVENTS_END),
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->TASKS_START));
+  nrf_ppi_channel_endpoint_setup(chainCountPpi,
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->EVENTS_END),
+                                 reinterpret_cast<uint32_t>(&chainTimer->TASKS_COUNT));
+  nrf_ppi_channel_endpoint_setup(chainStopPpi,
+                                 reinterpret_cast<uint32_t>(&chainTimer->EVENTS_COMPARE[0]),
+                                 reinterpret_cast<uint32_t>(nrf_ppi_task_group_disable_address_get(chainGroup)));
+  nrf_ppi_channel_include_in_group(chainRestartPpi, chainGroup);
+  nrf_ppi_group_enable(chainGroup);
+  nrf_ppi_channel_enable(chainCountPpi);
+  nrf_ppi_channel_enable(chainStopPpi);
+
+  spiBaseAddress->TXD.PTR = bufferAddress;
+  spiBaseAddress->TXD.MAXCNT = maxChunkSize;
+  spiBaseAddress->TXD.LIST = SPIM_TXD_LIST_LIST_ArrayList;
+  spiBaseAddress->RXD.PTR = 0;
+  spiBaseAddress->RXD.MAXCNT = 0;
+  spiBaseAddress->RXD.LIST = 0;
+  spiBaseAddress->EVENTS_END = 0;
+  spiBaseAddress->TASKS_START = 1;
+}
+
+void SpiMaster::StopChainedTx() {
+  chainTimer->TASKS_STOP = 1;
+  nrf_ppi_group_disable(chainGroup);
+  nrf_ppi_channel_disable(chainCountPpi);
+  nrf_ppi_channel_disable(chainStopPpi);
+  nrf_ppi_channel_remove_from_group(chainRestartPpi, chainGroup);
+
+  spiBaseAddress->TXD.LIST = 0;
+  spiBaseAddress->EVENTS_END = 0;
+  spiBaseAddress->EVENTS_STARTED = 0;
+  spiBaseAddress->INTENSET = (1 << 6);
+  spiBaseAddress->INTENSET = (1 << 19);
 }
 
 void SpiMaster::PrepareTx(const uint32_t bufferAddress, const size_t size) {
@@ -181,12 +275,22 @@ void SpiMaster::PrepareRx(const uint32_t bufferAddress, const size_t size) {
 }
 
 bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
+  return Write(pinCsn, data, size, preTransactionHook, nullptr);
+}
+
+bool SpiMaster::Write(uint8_t pinCsn,
+                      const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& preTransactionHook,
+                      const std::function<void()>& transferCompleted) {
   if (data == nullptr)
     return false;
   auto ok = xSemaphoreTake(mutex, portMAX_DELAY);
   ASSERT(ok == true);
 
   this->pinCsn = pinCsn;
+  statistics.transfers++;
+  TRACE_EVENT(SpiBegin, (static_cast<uint32_t>(pinCsn) << 24) | size);
 
   if (size == 1) {
     SetupWorkaroundForErratum58();
@@ -202,21 +306,37 @@ bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const st
   currentBufferAddr = (uint32_t) data;
   currentBufferSize = size;
 
-  auto currentSize = std::min((size_t) 255, (size_t) currentBufferSize);
-  PrepareTx(currentBufferAddr, currentSize);
-  currentBufferSize = currentBufferSize - currentSize;
-  currentBufferAddr = currentBufferAddr + currentSize;
-  spiBaseAddress->TASKS_START = 1;
+  const size_t nbChunks = size / maxChunkSize;
+  if (size > 1) {
+    this->transferCompleted = transferCompleted;
+  }
+  if (chainedTransfersEnabled && nbChunks >= 2) {
+    statistics.chainedTransfers++;
+    currentBufferAddr = currentBufferAddr + nbChunks * maxChunkSize;
+    currentBufferSize = currentBufferSize - nbChunks * maxChunkSize;
+    StartChainedTx((uint32_t) data, nbChunks);
+  } else {
+    auto currentSize = std::min(maxChunkSize, (size_t) currentBufferSize);
+    PrepareTx(currentBufferAddr, currentSize);
+    currentBufferSize = currentBufferSize - currentSize;
+    currentBufferAddr = currentBufferAddr + currentSize;
+    spiBaseAddress->TASKS_START = 1;
+  }
 
   if (size == 1) {
     while (spiBaseAddress->EVENTS_END == 0)
       ;
     nrf_gpio_pin_set(this->pinCsn);
+    TRACE_EVENT(SpiEnd, this->pinCsn);
     currentBufferAddr = 0;
 
     DisableWorkaroundForErratum58();
 
     xSemaphoreGive(mutex);
+
+    if (transferCompleted != nullptr) {
+      transferCompleted();
+    }
   }
 
   return true;
@@ -226,6 +346,7 @@ bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data
   xSemaphoreTake(mutex, portMAX_DELAY);
 
   this->pinCsn = pinCsn;
+  TRACE_EVENT(SpiBegin, (static_cast<uint32_t>(pinCsn) << 24) | (cmdSize + dataSize));
   DisableWorkaroundForErratum58();
   spiBaseAddress->INTENCLR = (1 << 6);
   spiBaseAddress->INTENCLR = (1 << 1);
@@ -241,12 +362,20 @@ bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareRx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
+  // CS stays low between the EasyDMA transfers, the device keeps sending data on the next clock edges
+  size_t remaining = dataSize;
+  do {
+    const size_t currentSize = std::min(maxChunkSize, remaining);
+    PrepareRx((uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    remaining -= currentSize;
+  } while (remaining > 0);
   nrf_gpio_pin_set(this->pinCsn);
+  TRACE_EVENT(SpiEnd, this->pinCsn);
 
   xSemaphoreGive(mutex);
 
@@ -273,6 +402,7 @@ bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmd
   xSemaphoreTake(mutex, portMAX_DELAY);
 
   this->pinCsn = pinCsn;
+  TRACE_EVENT(SpiBegin, (static_cast<uint32_t>(pinCsn) << 24) | (cmdSize + dataSize));
   DisableWorkaroundForErratum58();
   spiBaseAddress->INTENCLR = (1 << 6);
   spiBaseAddress->INTENCLR = (1 << 1);
@@ -288,12 +418,19 @@ bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmd
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
+  size_t remaining = dataSize;
+  do {
+    const size_t currentSize = std::min(maxChunkSize, remaining);
+    PrepareTx((uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    remaining -= currentSize;
+  } while (remaining > 0);
   nrf_gpio_pin_set(this->pinCsn);
+  TRACE_EVENT(SpiEnd, this->pinCsn);
 
   xSemaphoreGive(mutex);
 
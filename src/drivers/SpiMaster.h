@@ -27,6 +27,12 @@ namespace Pinetime {
         uint8_t pinMISO;
       };
 
+      struct Statistics {
+        uint32_t interrupts = 0;
+        uint32_t transfers = 0;
+        uint32_t chainedTransfers = 0;
+      };
+
       SpiMaster(const SpiModule spi, const Parameters& params);
       SpiMaster(const SpiMaster&) = delete;
       SpiMaster& operator=(const SpiMaster&) = delete;
@@ -35,12 +41,28 @@ namespace Pinetime {
 
       bool Init();
       bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      /// Same as Write(), transferCompleted is called (from the ISR) once the whole buffer is sent and the bus is released
+      bool Write(uint8_t pinCsn,
+                 const uint8_t* data,
+                 size_t size,
+                 const std::function<void()>& preTransactionHook,
+                 const std::function<void()>& transferCompleted);
       bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
 
       bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
 
       void OnStartedEvent();
       void OnEndEvent();
+      void OnChainEndEvent();
+
+      /// Large writes are sent as a chain of DMA transfers restarted by PPI, without an interrupt per chunk
+      void SetChainedTransfers(bool enabled) {
+        chainedTransfersEnabled = enabled;
+      }
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
 
       void Sleep();
       void Wakeup();
@@ -50,6 +72,9 @@ namespace Pinetime {
       void DisableWorkaroundForErratum58();
       void PrepareTx(const volatile uint32_t bufferAddress, const volatile size_t size);
       void PrepareRx(const volatile uint32_t bufferAddress, const volatile size_t size);
+      void StartChainedTx(uint32_t bufferAddress, size_t nbChunks);
+      void StopChainedTx();
+      void EndTransfer();
 
       NRF_SPIM_Type* spiBaseAddress;
       uint8_t pinCsn;
@@ -62,6 +87,18 @@ namespace Pinetime {
       SemaphoreHandle_t mutex = nullptr;
       static constexpr nrf_ppi_channel_t workaroundPpi = NRF_PPI_CHANNEL0;
       bool workaroundActive = false;
+
+      // Maximum size of an EasyDMA transfer
+      static constexpr size_t maxChunkSize = 255;
+      // Channels 4, 5 and 17 to 31 are used by the BLE controller
+      static constexpr nrf_ppi_channel_t chainRestartPpi = NRF_PPI_CHANNEL6;
+      static constexpr nrf_ppi_channel_t chainCountPpi = NRF_PPI_CHANNEL7;
+      static constexpr nrf_ppi_channel_t chainStopPpi = NRF_PPI_CHANNEL8;
+      static constexpr nrf_ppi_channel_group_t chainGroup = NRF_PPI_CHANNEL_GROUP0;
+      bool chainedTransfersEnabled = true;
+
+      std::function<void()> transferCompleted;
+      Statistics statistics;
     };
   }
 }
@@ -3,6 +3,7 @@
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/Spi.h"
+#include <algorithm>
 
 using namespace Pinetime::Drivers;
 
@@ -10,6 +11,9 @@ SpiNorFlash::SpiNorFlash(Spi& spi) : spi {spi} {
 }
 
 void SpiNorFlash::Init() {
+  if (mutex == nullptr) {
+    mutex = xSemaphoreCreateMutex();
+  }
   device_id = ReadIdentification();
   NRF_LOG_INFO("[SpiNorFlash] Manufacturer : %d, Memory type : %d, memory density : %d",
                device_id.manufacturer,
@@ -21,6 +25,7 @@ void SpiNorFlash::Uninit() {
 }
 
 void SpiNorFlash::Sleep() {
+  WaitWhileBusy();
   auto cmd = static_cast<uint8_t>(Commands::DeepPowerDown);
   spi.Write(&cmd, sizeof(uint8_t), nullptr);
   NRF_LOG_INFO("[SpiNorFlash] Sleep")
@@ -76,7 +81,53 @@ void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
                           static_cast<uint8_t>(address >> 16U),
                           static_cast<uint8_t>(address >> 8U),
                           static_cast<uint8_t>(address)};
+  BeginRead();
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
+  EndRead();
+}
+
+void SpiNorFlash::FastRead(uint32_t address, uint8_t* buffer, size_t size) {
+  // The dummy byte gives the flash the time to fetch the first byte at high clock frequencies
+  static constexpr uint8_t cmdSize = 5;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::FastRead),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address),
+                          0x00};
+  BeginRead();
+  spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
+  EndRead();
+}
+
+// The flash memory does not answer to read commands while it is busy
+void SpiNorFlash::BeginRead() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (pendingOperation == Operations::None) {
+    return;
+  }
+
+  if (pendingOperation == Operations::Erase && eraseSuspendEnabled) {
+    auto cmd = static_cast<uint8_t>(Commands::ProgramEraseSuspend);
+    spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+    // The erase is suspended within a few tens of microseconds
+    while (WriteInProgress())
+      ;
+    eraseSuspended = true;
+    return;
+  }
+
+  while (WriteInProgress())
+    vTaskDelay(1);
+  pendingOperation = Operations::None;
+}
+
+void SpiNorFlash::EndRead() {
+  if (eraseSuspended) {
+    auto cmd = static_cast<uint8_t>(Commands::ProgramEraseResume);
+    spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+    eraseSuspended = false;
+  }
+  xSemaphoreGive(mutex);
 }
 
 void SpiNorFlash::WriteEnable() {
@@ -84,21 +135,89 @@ void SpiNorFlash::WriteEnable() {
   spi.Read(&cmd, sizeof(cmd), nullptr, 0);
 }
 
+// Takes the mutex once the pending operation is done, and sets the write enable latch : the operation is started before the
+// mutex is released, another task cannot start one in between
+void SpiNorFlash::BeginWrite() {
+  while (true) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (pendingOperation == Operations::None || !WriteInProgress()) {
+      pendingOperation = Operations::None;
+      break;
+    }
+    xSemaphoreGive(mutex);
+    WaitWhileBusy();
+  }
+
+  // The flash memory ignores the commands it receives while it is busy : send WREN again until it is taken into account
+  WriteEnable();
+  while (!WriteEnabled()) {
+    vTaskDelay(1);
+    WriteEnable();
+  }
+}
+
 void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  StartSectorErase(sectorAddress);
+  WaitWhileBusy();
+}
+
+void SpiNorFlash::StartSectorErase(uint32_t sectorAddress) {
   static constexpr uint8_t cmdSize = 4;
   uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::SectorErase),
                           static_cast<uint8_t>(sectorAddress >> 16U),
                           static_cast<uint8_t>(sectorAddress >> 8U),
                           static_cast<uint8_t>(sectorAddress)};
 
-  WriteEnable();
-  while (!WriteEnabled())
-    vTaskDelay(1);
-
+  BeginWrite();
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
+  pendingOperation = Operations::Erase;
+  operationStart = xTaskGetTickCount();
+  xSemaphoreGive(mutex);
+}
 
-  while (WriteInProgress())
-    vTaskDelay(1);
+void SpiNorFlash::StartPageProgram(uint32_t address, const uint8_t* buffer, size_t size) {
+  static constexpr uint8_t cmdSize = 4;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
+
+  BeginWrite();
+  spi.WriteCmdAndBuffer(cmd, cmdSize, buffer, size);
+  pendingOperation = Operations::Program;
+  operationStart = xTaskGetTickCount();
+  xSemaphoreGive(mutex);
+}
+
+void SpiNorFlash::WaitWhileBusy() {
+  if (pendingOperation == Operations::None) {
+    return;
+  }
+
+  // Don't poll the status before the operation is likely to be done
+  const bool erasing = (pendingOperation == Operations::Erase);
+  const TickType_t typicalTime = erasing ? sectorEraseTime : pageProgramTime;
+  const TickType_t elapsed = xTaskGetTickCount() - operationStart;
+  if (elapsed < typicalTime) {
+    vTaskDelay(typicalTime - elapsed);
+  }
+
+  const TickType_t maxPollPeriod = erasing ? maxErasePollPeriod : 1;
+  TickType_t pollPeriod = 1;
+  while (true) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const bool busy = (pendingOperation != Operations::None) && WriteInProgress();
+    if (!busy) {
+      pendingOperation = Operations::None;
+    }
+    xSemaphoreGive(mutex);
+    if (!busy) {
+      return;
+    }
+
+    vTaskDelay(pollPeriod);
+    pollPeriod = std::min<TickType_t>(pollPeriod * 2, maxPollPeriod);
+  }
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -117,8 +236,6 @@ bool SpiNorFlash::EraseFailed() {
 }
 
 void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
-
   size_t len = size;
   uint32_t addr = address;
   const uint8_t* b = buffer;
@@ -126,19 +243,8 @@ void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
     uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
     uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
 
-    uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
-                            static_cast<uint8_t>(addr >> 16U),
-                            static_cast<uint8_t>(addr >> 8U),
-                            static_cast<uint8_t>(addr)};
-
-    WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
-
-    spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
-
-    while (WriteInProgress())
-      vTaskDelay(1);
+    StartPageProgram(addr, b, toWrite);
+    WaitWhileBusy();
 
     addr += toWrite;
     b += toWrite;
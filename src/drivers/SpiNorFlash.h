@@ -2,6 +2,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <FreeRTOS.h>
+#include <semphr.h>
+
 namespace Pinetime {
   namespace Drivers {
     class Spi;
@@ -25,9 +28,23 @@ namespace Pinetime {
       bool WriteEnabled();
       uint8_t ReadConfigurationRegister();
       void Read(uint32_t address, uint8_t* buffer, size_t size);
+      /// Reads any number of bytes, across pages, in a single Fast Read transaction
+      void FastRead(uint32_t address, uint8_t* buffer, size_t size);
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
+
+      /// Starts erasing the sector and returns without waiting for the end of the erase
+      void StartSectorErase(uint32_t sectorAddress);
+      /// Starts programming size bytes (that must fit in a single page) and returns without waiting for the end of the program
+      void StartPageProgram(uint32_t address, const uint8_t* buffer, size_t size);
+      /// Sleeps until the pending erase/program is done. The status is polled with a growing period,
+      /// and the SPI bus is free between the polls.
+      void WaitWhileBusy();
+      /// Reads issued while a sector is being erased suspend the erase instead of waiting for its end
+      void SetEraseSuspend(bool enabled) {
+        eraseSuspendEnabled = enabled;
+      }
       uint8_t ReadSecurityRegister();
       bool ProgramFailed();
       bool EraseFailed();
@@ -42,10 +59,18 @@ namespace Pinetime {
 
     private:
       Identification ReadIdentification();
+      void BeginRead();
+      void EndRead();
+      void BeginWrite();
+
+      enum class Operations : uint8_t { None, Erase, Program };
 
       enum class Commands : uint8_t {
         PageProgram = 0x02,
+        ProgramEraseSuspend = 0x75,
+        ProgramEraseResume = 0x7A,
         Read = 0x03,
+        FastRead = 0x0B,
         ReadStatusRegister = 0x05,
         WriteEnable = 0x06,
         ReadConfigurationRegister = 0x15,
@@ -56,9 +81,20 @@ namespace Pinetime {
         DeepPowerDown = 0xB9
       };
       static constexpr uint16_t pageSize = 256;
+      // Typical duration of the operations, the status is not polled before
+      static constexpr TickType_t sectorEraseTime = pdMS_TO_TICKS(40);
+      static constexpr TickType_t pageProgramTime = 1;
+      static constexpr TickType_t maxErasePollPeriod = pdMS_TO_TICKS(8);
 
       Spi& spi;
       Identification device_id;
+
+      // Held while the state of the flash memory changes (operation started, status polled, erase suspended)
+      SemaphoreHandle_t mutex = nullptr;
+      Operations pendingOperation = Operations::None;
+      TickType_t operationStart = 0;
+      bool eraseSuspendEnabled = false;
+      bool eraseSuspended = false;
     };
   }
 }
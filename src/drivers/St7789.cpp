@@ -40,9 +40,17 @@ void St7789::WriteData(uint8_t data) {
 }
 
 void St7789::WriteData(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_set(pinDataCommand);
-  });
+  WriteData(data, size, nullptr);
+}
+
+void St7789::WriteData(const uint8_t* data, size_t size, const std::function<void()>& writeCompleted) {
+  WriteSpi(
+    data,
+    size,
+    [pinDataCommand = pinDataCommand]() {
+      nrf_gpio_pin_set(pinDataCommand);
+    },
+    writeCompleted);
 }
 
 void St7789::WriteCommand(uint8_t data) {
@@ -50,13 +58,20 @@ void St7789::WriteCommand(uint8_t data) {
 }
 
 void St7789::WriteCommand(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_clear(pinDataCommand);
-  });
+  WriteSpi(
+    data,
+    size,
+    [pinDataCommand = pinDataCommand]() {
+      nrf_gpio_pin_clear(pinDataCommand);
+    },
+    nullptr);
 }
 
-void St7789::WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  spi.Write(data, size, preTransactionHook);
+void St7789::WriteSpi(const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& preTransactionHook,
+                      const std::function<void()>& transferCompleted) {
+  spi.Write(data, size, preTransactionHook, transferCompleted);
 }
 
 void St7789::SoftwareReset() {
@@ -238,9 +253,9 @@ void St7789::SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
   WriteData(addrWindowArgs, sizeof(addrWindowArgs));
 }
 
-void St7789::WriteToRam(const uint8_t* data, size_t size) {
+void St7789::WriteToRam(const uint8_t* data, size_t size, const std::function<void()>& writeCompleted) {
   WriteCommand(static_cast<uint8_t>(Commands::WriteToRam));
-  WriteData(data, size);
+  WriteData(data, size, writeCompleted);
 }
 
 void St7789::SetVdv() {
@@ -269,8 +284,18 @@ void St7789::Uninit() {
 }
 
 void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
+  DrawBuffer(x, y, width, height, data, size, nullptr);
+}
+
+void St7789::DrawBuffer(uint16_t x,
+                        uint16_t y,
+                        uint16_t width,
+                        uint16_t height,
+                        const uint8_t* data,
+                        size_t size,
+                        const std::function<void()>& drawCompleted) {
   SetAddrWindow(x, y, x + width - 1, y + height - 1);
-  WriteToRam(data, size);
+  WriteToRam(data, size, drawCompleted);
 }
 
 void St7789::HardwareReset() {
@@ -309,3 +334,11 @@ void St7789::Wakeup() {
   DisplayOn();
   NRF_LOG_INFO("[LCD] Wakeup")
 }
+
+void St7789::SetChainedTransfers(bool enabled) {
+  spi.SetChainedTransfers(enabled);
+}
+
+const SpiMaster::Statistics& St7789::SpiStatistics() const {
+  return spi.GetStatistics();
+}
@@ -4,6 +4,7 @@
 #include <functional>
 
 #include <FreeRTOS.h>
+#include "drivers/SpiMaster.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -23,12 +24,23 @@ namespace Pinetime {
       void VerticalScrollStartAddress(uint16_t line);
 
       void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
+      /// Returns as soon as the transfer is started, drawCompleted is called from the SPI interrupt once data is sent
+      void DrawBuffer(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t height,
+                      const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& drawCompleted);
 
       void LowPowerOn();
       void LowPowerOff();
       void Sleep();
       void Wakeup();
 
+      void SetChainedTransfers(bool enabled);
+      const SpiMaster::Statistics& SpiStatistics() const;
+
     private:
       Spi& spi;
       uint8_t pinDataCommand;
@@ -47,7 +59,7 @@ namespace Pinetime {
       void MemoryDataAccessControl();
       void DisplayInversionOn();
       void NormalModeOn();
-      void WriteToRam(const uint8_t* data, size_t size);
+      void WriteToRam(const uint8_t* data, size_t size, const std::function<void()>& writeCompleted);
       void IdleModeOn();
       void IdleModeOff();
       void FrameRateNormalSet();
@@ -63,7 +75,10 @@ namespace Pinetime {
       void SetVdv();
       void WriteCommand(uint8_t cmd);
       void WriteCommand(const uint8_t* data, size_t size);
-      void WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      void WriteSpi(const uint8_t* data,
+                    size_t size,
+                    const std::function<void()>& preTransactionHook,
+                    const std::function<void()>& transferCompleted);
 
       enum class Commands : uint8_t {
         SoftwareReset = 0x01,
@@ -93,6 +108,7 @@ namespace Pinetime {
       };
       void WriteData(uint8_t data);
       void WriteData(const uint8_t* data, size_t size);
+      void WriteData(const uint8_t* data, size_t size, const std::function<void()>& writeCompleted);
 
       static constexpr uint16_t Width = 240;
       static constexpr uint16_t Height = 320;
@@ -1,13 +1,12 @@
 #include "drivers/TwiMaster.h"
+#include "utility/CycleCounter.h"
 #include <cstring>
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
+#include "systemtask/EventTrace.h"
 
 using namespace Pinetime::Drivers;
 
-// TODO use shortcut to automatically send STOP when receive LastTX, for example
-// TODO use DMA/IRQ
-
 TwiMaster::TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl)
   : module {module}, frequency {frequency}, pinSda {pinSda}, pinScl {pinScl} {
 }
@@ -22,14 +21,19 @@ void TwiMaster::ConfigurePins() const {
                               (GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos);
 }
 
+// The peripheral is enabled by Transfer() while batches are queued and disabled once they are done : Init() leaves it disabled,
+// which resets it, and does nothing while a batch is in flight
 void TwiMaster::Init() {
-  if (mutex == nullptr) {
-    mutex = xSemaphoreCreateBinary();
+  taskENTER_CRITICAL();
+  if (head != nullptr) {
+    taskEXIT_CRITICAL();
+    return;
   }
 
-  ConfigurePins();
-
   twiBaseAddress = module;
+  twiBaseAddress->ENABLE = (TWIM_ENABLE_ENABLE_Disabled << TWIM_ENABLE_ENABLE_Pos);
+
+  ConfigurePins();
 
   twiBaseAddress->FREQUENCY = frequency;
 
@@ -43,116 +47,182 @@ void TwiMaster::Init() {
   twiBaseAddress->EVENTS_SUSPENDED = 0;
   twiBaseAddress->EVENTS_TXSTARTED = 0;
 
-  twiBaseAddress->ENABLE = (TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos);
-
-  xSemaphoreGive(mutex);
+  // A transaction ends with STOPPED, even when it fails (the interrupt handler stops the bus on ERROR)
+  twiBaseAddress->INTENSET = TWIM_INTENSET_STOPPED_Msk | TWIM_INTENSET_ERROR_Msk;
+  NRFX_IRQ_PRIORITY_SET(nrfx_get_irq_number(twiBaseAddress), 2);
+  NRFX_IRQ_ENABLE(nrfx_get_irq_number(twiBaseAddress));
+  taskEXIT_CRITICAL();
 }
 
 TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* data, size_t size) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  auto ret = Write(deviceAddress, &registerAddress, 1, false);
-  ret = Read(deviceAddress, data, size, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction {deviceAddress, registerAddress, data, nullptr, size};
+  return Transfer(&transaction, 1);
 }
 
 TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size) {
-  ASSERT(size <= maxDataSize);
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  internalBuffer[0] = registerAddress;
-  std::memcpy(internalBuffer + 1, data, size);
-  auto ret = Write(deviceAddress, internalBuffer, size + 1, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction {deviceAddress, registerAddress, nullptr, data, size};
+  return Transfer(&transaction, 1);
 }
 
-TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->RXD.PTR = (uint32_t) buffer;
-  twiBaseAddress->RXD.MAXCNT = size;
-
-  twiBaseAddress->TASKS_STARTRX = 1;
-
-  while (!twiBaseAddress->EVENTS_RXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_RXSTARTED = 0x0UL;
-
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTRX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
+TwiMaster::ErrorCodes TwiMaster::Transfer(Transaction* transactions, size_t count) {
+  if (count == 0) {
+    return ErrorCodes::NoError;
+  }
+#ifdef TWI_BENCHMARK
+  const uint32_t cycles = DWT->CYCCNT;
+#endif
+  TRACE_EVENT(TwiBegin, (static_cast<uint32_t>(transactions[0].deviceAddress) << 8) | count);
+  Batch batch {transactions, count, 0, xTaskGetCurrentTaskHandle(), nullptr, false, ErrorCodes::NoError};
+
+  taskENTER_CRITICAL();
+  if (tail == nullptr) {
+    head = &batch;
+    tail = &batch;
+    Wakeup();
+    StartTransaction(transactions[0]);
+  } else {
+    tail->next = &batch;
+    tail = &batch;
+  }
+  statistics.batches++;
+  taskEXIT_CRITICAL();
+#ifdef TWI_BENCHMARK
+  statistics.cpuCycles += DWT->CYCCNT - cycles;
+#endif
+
+  const TickType_t start = xTaskGetTickCount();
+  while (!batch.done) {
+    const TickType_t elapsed = xTaskGetTickCount() - start;
+    if (elapsed < batchTimeout) {
+      ulTaskNotifyTake(pdTRUE, batchTimeout - elapsed);
+      continue;
+    }
+
+    taskENTER_CRITICAL();
+    if (!batch.done) {
+      AbortBatch(&batch);
     }
+    taskEXIT_CRITICAL();
+    break;
   }
-  twiBaseAddress->EVENTS_LASTRX = 0x0UL;
+  TRACE_EVENT(TwiEnd, static_cast<uint32_t>(batch.result));
+  return batch.result;
+}
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
+// Runs with the interrupt of the TWIM masked (critical section or interrupt handler)
+void TwiMaster::StartTransaction(const Transaction& transaction) {
+  twiBaseAddress->ADDRESS = transaction.deviceAddress;
+  if (transaction.writeData != nullptr) {
+    ASSERT(transaction.size <= maxDataSize);
+    internalBuffer[0] = transaction.registerAddress;
+    std::memcpy(internalBuffer + registerSize, transaction.writeData, transaction.size);
+    twiBaseAddress->TXD.PTR = reinterpret_cast<uint32_t>(internalBuffer);
+    twiBaseAddress->TXD.MAXCNT = transaction.size + registerSize;
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STOP_Msk;
   } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+    // Register address, repeated start and read
+    readRegister = transaction.registerAddress;
+    twiBaseAddress->TXD.PTR = reinterpret_cast<uint32_t>(&readRegister);
+    twiBaseAddress->TXD.MAXCNT = registerSize;
+    twiBaseAddress->RXD.PTR = reinterpret_cast<uint32_t>(transaction.readBuffer);
+    twiBaseAddress->RXD.MAXCNT = transaction.size;
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
   }
+  transactionFailed = false;
+  statistics.transactions++;
+  twiBaseAddress->TASKS_STARTTX = 1;
+}
 
+void TwiMaster::OnInterrupt() {
+#ifdef TWI_BENCHMARK
+  const uint32_t cycles = DWT->CYCCNT;
+#endif
+  statistics.interrupts++;
   if (twiBaseAddress->EVENTS_ERROR) {
     twiBaseAddress->EVENTS_ERROR = 0x0UL;
+    uint32_t error = twiBaseAddress->ERRORSRC;
+    twiBaseAddress->ERRORSRC = error;
+    transactionFailed = true;
+    twiBaseAddress->TASKS_STOP = 0x1UL;
   }
-  return ErrorCodes::NoError;
-}
-
-TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->TXD.PTR = (uint32_t) data;
-  twiBaseAddress->TXD.MAXCNT = size;
 
-  twiBaseAddress->TASKS_STARTTX = 1;
-
-  while (!twiBaseAddress->EVENTS_TXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_TXSTARTED = 0x0UL;
-
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTTX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
+  if (twiBaseAddress->EVENTS_STOPPED) {
+    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    Batch* batch = head;
+    if (batch != nullptr) {
+      if (transactionFailed) {
+        batch->result = ErrorCodes::TransactionFailed;
+        batch->index = batch->count;
+      } else {
+        batch->index++;
+      }
+
+      if (batch->index < batch->count) {
+        StartTransaction(batch->transactions[batch->index]);
+      } else {
+        CompleteBatch(&xHigherPriorityTaskWoken);
+      }
     }
+#ifdef TWI_BENCHMARK
+    statistics.cpuCycles += DWT->CYCCNT - cycles;
+#endif
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    return;
   }
-  twiBaseAddress->EVENTS_LASTTX = 0x0UL;
+#ifdef TWI_BENCHMARK
+  statistics.cpuCycles += DWT->CYCCNT - cycles;
+#endif
+}
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
+void TwiMaster::CompleteBatch(BaseType_t* higherPriorityTaskWoken) {
+  Batch* batch = head;
+  head = batch->next;
+  if (head == nullptr) {
+    tail = nullptr;
+  }
+
+  // The batch is on the stack of the caller, it must not be used once done is set
+  TaskHandle_t task = batch->task;
+  batch->done = true;
+  vTaskNotifyGiveFromISR(task, higherPriorityTaskWoken);
+
+  if (head != nullptr) {
+    StartTransaction(head->transactions[0]);
   } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+    Sleep();
   }
+}
 
-  if (twiBaseAddress->EVENTS_ERROR) {
+// Called in a critical section when a batch timed out
+void TwiMaster::AbortBatch(Batch* batch) {
+  statistics.timeouts++;
+  batch->result = ErrorCodes::TransactionFailed;
+
+  if (batch == head) {
+    FixHwFreezed();
+    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
     twiBaseAddress->EVENTS_ERROR = 0x0UL;
-    uint32_t error = twiBaseAddress->ERRORSRC;
-    twiBaseAddress->ERRORSRC = error;
+    head = batch->next;
+    if (head == nullptr) {
+      tail = nullptr;
+      Sleep();
+    } else {
+      StartTransaction(head->transactions[0]);
+    }
+    return;
   }
 
-  return ErrorCodes::NoError;
+  Batch* previous = head;
+  while (previous != nullptr && previous->next != batch) {
+    previous = previous->next;
+  }
+  if (previous != nullptr) {
+    previous->next = batch->next;
+    if (tail == batch) {
+      tail = previous;
+    }
+  }
 }
 
 void TwiMaster::Sleep() {
@@ -1,41 +1,98 @@
 #pragma once
 #include <FreeRTOS.h>
 #include <semphr.h>
+#include <task.h>
 #include <drivers/include/nrfx_twi.h> // NRF_TWIM_Type
+#include <cstddef>
 #include <cstdint>
 
 namespace Pinetime {
   namespace Drivers {
+    /**
+     * TWI (I2C) master driven by EasyDMA and interrupts. The transactions of the callers are queued and run back to back
+     * by the interrupt handler, the callers block on a task notification until their transactions are done.
+     */
     class TwiMaster {
     public:
       enum class ErrorCodes { NoError, TransactionFailed };
 
+      // Reads size bytes into readBuffer, or writes size bytes of writeData (at most 16), starting at registerAddress
+      struct Transaction {
+        uint8_t deviceAddress;
+        uint8_t registerAddress;
+        uint8_t* readBuffer;
+        const uint8_t* writeData;
+        size_t size;
+      };
+
+      struct Statistics {
+        uint32_t transactions = 0;
+        uint32_t batches = 0;
+        uint32_t interrupts = 0;
+        uint32_t timeouts = 0;
+#ifdef TWI_BENCHMARK
+        // CPU time spent in the driver (callers and interrupt handler)
+        uint32_t cpuCycles = 0;
+#endif
+      };
+
       TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl);
 
       void Init();
       ErrorCodes Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* buffer, size_t size);
       ErrorCodes Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size);
+      // Runs the transactions in order without other transactions in between, returns TransactionFailed if any failed
+      ErrorCodes Transfer(Transaction* transactions, size_t count);
+
+      void OnInterrupt();
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
 
       void Sleep();
       void Wakeup();
 
+#ifdef TWI_BENCHMARK
+      void RunBenchmark(uint8_t deviceAddress, uint8_t registerAddress, uint8_t registerAddress2);
+#endif
+
     private:
-      ErrorCodes Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop);
-      ErrorCodes Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop);
+      struct Batch {
+        Transaction* transactions;
+        size_t count;
+        size_t index;
+        TaskHandle_t task;
+        Batch* next;
+        volatile bool done;
+        ErrorCodes result;
+      };
+
+      void StartTransaction(const Transaction& transaction);
+      void CompleteBatch(BaseType_t* higherPriorityTaskWoken);
+      void AbortBatch(Batch* batch);
       void FixHwFreezed();
       void ConfigurePins() const;
 
       NRF_TWIM_Type* twiBaseAddress;
-      SemaphoreHandle_t mutex = nullptr;
       NRF_TWIM_Type* module;
       uint32_t frequency;
       uint8_t pinSda;
       uint8_t pinScl;
       static constexpr uint8_t maxDataSize {16};
       static constexpr uint8_t registerSize {1};
+      // Written by the interrupt handler only
       uint8_t internalBuffer[maxDataSize + registerSize];
-      uint32_t txStartedCycleCount = 0;
-      static constexpr uint32_t HwFreezedDelay {161000};
+      uint8_t readRegister;
+      bool transactionFailed = false;
+
+      // Queue of batches, the first one is running. Modified in critical sections.
+      Batch* head = nullptr;
+      Batch* tail = nullptr;
+
+      // The longest transaction (255 bytes) lasts about 7ms at 390KHz
+      static constexpr TickType_t batchTimeout = pdMS_TO_TICKS(50);
+      Statistics statistics;
     };
   }
 }
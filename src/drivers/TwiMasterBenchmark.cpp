@@ -0,0 +1,44 @@
+#include "drivers/TwiMaster.h"
+#include "utility/CycleCounter.h"
+#include <nrfx_log.h>
+
+#ifdef TWI_BENCHMARK
+using namespace Pinetime::Drivers;
+
+// Reads of 6 bytes at registerAddress, and of 6 bytes at registerAddress and 4 bytes at registerAddress2 (single reads or
+// batch). The previous driver busy-waited during the whole transaction : its CPU time was the elapsed time.
+void TwiMaster::RunBenchmark(uint8_t deviceAddress, uint8_t registerAddress, uint8_t registerAddress2) {
+  static constexpr uint32_t nbIterations = 200;
+  static constexpr uint32_t cyclesPerUs = 64;
+  uint8_t buffer[6];
+  uint8_t buffer2[4];
+  Transaction batch[] = {{deviceAddress, registerAddress, buffer, nullptr, sizeof(buffer)},
+                         {deviceAddress, registerAddress2, buffer2, nullptr, sizeof(buffer2)}};
+
+  Utility::EnableCycleCounter();
+
+  for (uint8_t scenario = 0; scenario < 3; scenario++) {
+    const uint32_t cpuCycles = statistics.cpuCycles;
+    const uint32_t interrupts = statistics.interrupts;
+    const uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < nbIterations; i++) {
+      if (scenario == 0) {
+        Read(deviceAddress, registerAddress, buffer, sizeof(buffer));
+      } else if (scenario == 1) {
+        Read(deviceAddress, batch[0].registerAddress, buffer, sizeof(buffer));
+        Read(deviceAddress, batch[1].registerAddress, buffer2, sizeof(buffer2));
+      } else {
+        Transfer(batch, 2);
+      }
+    }
+    const uint32_t elapsed = DWT->CYCCNT - start;
+    const uint32_t busy = statistics.cpuCycles - cpuCycles;
+    NRF_LOG_INFO("[TwiMaster] scenario %d : %lu us per operation, CPU %lu us (%lu permille), %lu interrupts",
+                 scenario,
+                 elapsed / (nbIterations * cyclesPerUs),
+                 busy / (nbIterations * cyclesPerUs),
+                 static_cast<uint32_t>((busy * 1000ULL) / elapsed),
+                 (statistics.interrupts - interrupts) / nbIterations);
+  }
+}
+#endif
@@ -24,6 +24,12 @@ void HeartRateTask::Process(void* instance) {
 }
 
 void HeartRateTask::Work() {
+#ifdef PPG_FFT_BENCHMARK
+  Controllers::Ppg::RunFftBenchmark();
+#endif
+#ifdef PPG_ANALYSIS_BENCHMARK
+  Controllers::Ppg::RunAnalysisBenchmark();
+#endif
   int lastBpm = 0;
   while (true) {
     Messages msg;
@@ -32,10 +32,13 @@
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/brightness/BrightnessController.h"
+#include "components/display/DisplayStatistics.h"
+#include "components/heartrate/HeartRateHistory.h"
 #include "components/motor/MotorController.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/heartrate/HeartRateController.h"
 #include "components/fs/FS.h"
+#include "displayapp/LvglPool.h"
 #include "drivers/Spi.h"
 #include "drivers/SpiMaster.h"
 #include "drivers/SpiNorFlash.h"
@@ -43,7 +46,9 @@
 #include "drivers/TwiMaster.h"
 #include "drivers/Cst816s.h"
 #include "drivers/PinMap.h"
+#include "systemtask/EventTrace.h"
 #include "systemtask/SystemTask.h"
+#include "systemtask/TaskStatistics.h"
 #include "touchhandler/TouchHandler.h"
 #include "buttonhandler/ButtonHandler.h"
 
@@ -102,12 +107,16 @@ Pinetime::Controllers::MotorController motorController {};
 
 Pinetime::Controllers::DateTime dateTimeController {settingsController};
 Pinetime::Drivers::Watchdog watchdog;
-Pinetime::Controllers::NotificationManager notificationManager;
+Pinetime::Controllers::NotificationManager notificationManager {fs};
 Pinetime::Controllers::MotionController motionController;
 Pinetime::Controllers::AlarmController alarmController {dateTimeController, fs};
 Pinetime::Controllers::TouchHandler touchHandler;
 Pinetime::Controllers::ButtonHandler buttonHandler;
 Pinetime::Controllers::BrightnessController brightnessController {};
+Pinetime::Controllers::DisplayStatistics displayStatistics;
+Pinetime::Components::LvglPool lvglPool;
+Pinetime::System::TaskStatistics taskStatistics;
+Pinetime::Controllers::HeartRateHistory heartRateHistory {fs, dateTimeController};
 
 Pinetime::Applications::DisplayApp displayApp(lcd,
                                               touchPanel,
@@ -124,7 +133,9 @@ Pinetime::Applications::DisplayApp displayApp(lcd,
                                               brightnessController,
                                               touchHandler,
                                               fs,
-                                              spiNorFlash);
+                                              spiNorFlash,
+                                              displayStatistics,
+                                              taskStatistics);
 
 Pinetime::System::SystemTask systemTask(spi,
                                         spiNorFlash,
@@ -145,17 +156,37 @@ Pinetime::System::SystemTask systemTask(spi,
                                         heartRateApp,
                                         fs,
                                         touchHandler,
-                                        buttonHandler);
-int mallocFailedCount = 0;
+                                        buttonHandler,
+                                        displayStatistics,
+                                        taskStatistics,
+                                        lvglPool,
+                                        heartRateHistory);
 int stackOverflowCount = 0;
 extern "C" {
 void vApplicationMallocFailedHook() {
-  mallocFailedCount++;
+  lvglPool.OnMallocFailed();
 }
 
 void vApplicationStackOverflowHook(TaskHandle_t /*xTask*/, char* /*pcTaskName*/) {
   stackOverflowCount++;
 }
+
+void* lvgl_pool_alloc(size_t size) {
+  return lvglPool.Allocate(size);
+}
+
+void lvgl_pool_free(void* ptr) {
+  lvglPool.Free(ptr);
+}
+
+uint32_t ulGetRunTimeCounterValue() {
+  return Pinetime::System::TaskStatistics::RunTimeCounter();
+}
+
+void vTaskSwitchedIn(uint32_t taskNumber) {
+  taskStatistics.OnTaskSwitchedIn(taskNumber);
+  TRACE_EVENT(TaskSwitchedIn, taskNumber);
+}
 }
 /* Variable Declarations for variables in noinit SRAM
    Increment NoInit_MagicValue upon adding variables to this area
@@ -172,6 +203,13 @@ void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action
     return;
   }
 
+#ifdef MOTION_ACQUISITION_FIFO
+  if (pin == Pinetime::PinMap::Bma421Irq) {
+    systemTask.PushMessage(Pinetime::System::Messages::OnMotionFifoWatermark);
+    return;
+  }
+#endif
+
   BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
   if (pin == Pinetime::PinMap::PowerPresent and action == NRF_GPIOTE_POLARITY_TOGGLE) {
@@ -208,6 +246,19 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
   }
 }
 
+extern "C" {
+void TIMER1_IRQHandler(void) {
+  if (NRF_TIMER1->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER1->EVENTS_COMPARE[1] = 0;
+    spi.OnChainEndEvent();
+  }
+}
+
+void SPIM1_SPIS1_TWIM1_TWIS1_SPI1_TWI1_IRQHandler(void) {
+  twiMaster.OnInterrupt();
+}
+}
+
 static void (*radio_isr_addr)();
 static void (*rng_isr_addr)();
 static void (*rtc0_isr_addr)();
@@ -312,6 +363,12 @@ void enable_dcdc_regulator() {
 int main() {
   enable_dcdc_regulator();
   logger.Init();
+#ifdef LVGL_POOL_BENCHMARK
+  lvglPool.RunBenchmark();
+#endif
+#ifdef EVENT_TRACE_BENCHMARK
+  Pinetime::System::EventTrace::RunBenchmark();
+#endif
 
   nrf_drv_clock_init();
   nrf_drv_clock_lfclk_request(nullptr);
@@ -7,5 +7,4 @@
 void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
 void DebounceTimerCallback(TimerHandle_t xTimer);
 
-extern int mallocFailedCount;
 extern int stackOverflowCount;
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include "recoveryImage.h"
 #include "drivers/PinMap.h"
+#include "systemtask/EventTrace.h"
 
 #include "displayapp/icons/infinitime/infinitime-nb.c"
 #include "components/rle/RleDecoder.h"
@@ -72,6 +73,13 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
 }
+
+void TIMER1_IRQHandler(void) {
+  if (NRF_TIMER1->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER1->EVENTS_COMPARE[1] = 0;
+    spi.OnChainEndEvent();
+  }
+}
 }
 
 void RefreshWatchdog() {
@@ -144,8 +152,22 @@ void vApplicationMallocFailedHook() {
 void vApplicationStackOverflowHook(TaskHandle_t /*xTask*/, char* /*pcTaskName*/) {
   stackOverflowCount++;
 }
+
+// No task statistics in the recovery loader
+uint32_t ulGetRunTimeCounterValue() {
+  return 0;
+}
+
+void vTaskSwitchedIn(uint32_t /*taskNumber*/) {
+}
 }
 
+#ifdef EVENT_TRACE
+// No event trace in the recovery loader
+void Pinetime::System::EventTrace::Record(Type /*type*/, uint32_t /*argument*/) {
+}
+#endif
+
 int main(void) {
   TaskHandle_t taskHandle;
   RefreshWatchdog();
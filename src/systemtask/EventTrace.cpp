@@ -0,0 +1,101 @@
+#include "systemtask/EventTrace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <nrf.h>
+#include <nrf_log.h>
+#include "components/fs/FS.h"
+#include "systemtask/TaskStatistics.h"
+
+using namespace Pinetime::System;
+
+namespace {
+  struct Event {
+    uint32_t header;
+    uint32_t argument;
+  };
+
+  static_assert((EventTrace::capacity & (EventTrace::capacity - 1)) == 0, "The capacity must be a power of 2 (the index wraps)");
+  static_assert(sizeof(Event) == EventTrace::eventSize, "Keep in sync with tools/trace2chrome.py");
+
+  // Header of the dump, followed by nbTasks names (number, then configMAX_TASK_NAME_LEN characters) and nbEvents events
+  struct __attribute__((packed)) DumpHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t nbTasks;
+    uint16_t eventSize;
+    uint32_t frequency;
+    uint32_t nbEvents;
+    // Events overwritten in the ring buffer since the previous dump
+    uint32_t lostEvents;
+  };
+
+  constexpr uint8_t dumpVersion = 1;
+  // RTC0 runs without prescaler for NimBLE
+  constexpr uint32_t timestampFrequency = 32768;
+
+  std::array<Event, EventTrace::capacity> events;
+  std::atomic<uint32_t> head {0};
+  std::atomic<bool> recording {true};
+  // Names of the tasks written by Dump(), kept out of the stack of SystemTask
+  std::array<TaskStatus_t, TaskStatistics::maxTasks> taskStatus;
+}
+
+void EventTrace::Record(Type type, uint32_t argument) {
+  if (!recording.load(std::memory_order_relaxed)) {
+    return;
+  }
+  const uint32_t index = head.fetch_add(1, std::memory_order_relaxed) % capacity;
+  events[index] = {(static_cast<uint32_t>(type) << 24) | (NRF_RTC0->COUNTER & 0x00FFFFFF), argument};
+}
+
+void EventTrace::Pause() {
+  recording.store(false);
+}
+
+void EventTrace::Clear() {
+  head.store(0);
+  recording.store(true);
+}
+
+void EventTrace::Dump(Controllers::FS& fs) {
+  Pause();
+  const uint32_t count = head.load();
+  const uint32_t nbEvents = std::min<uint32_t>(count, capacity);
+
+  const UBaseType_t nbTasks = uxTaskGetSystemState(taskStatus.data(), taskStatus.size(), nullptr);
+
+  fs.EnsureDirectory("/.system");
+  lfs_file_t file;
+  if (fs.FileOpen(&file, dumpPath, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+    NRF_LOG_WARNING("[EventTrace] Failed to open the trace file");
+    recording.store(true);
+    return;
+  }
+
+  const DumpHeader header {{'I', 'T', 'E', 'V'},
+                           dumpVersion,
+                           static_cast<uint8_t>(nbTasks),
+                           sizeof(Event),
+                           timestampFrequency,
+                           nbEvents,
+                           count - nbEvents};
+  fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  for (UBaseType_t i = 0; i < nbTasks; i++) {
+    uint8_t name[1 + configMAX_TASK_NAME_LEN] {static_cast<uint8_t>(taskStatus[i].xTaskNumber)};
+    std::strncpy(reinterpret_cast<char*>(name + 1), taskStatus[i].pcTaskName, configMAX_TASK_NAME_LEN);
+    fs.FileWrite(&file, name, sizeof(name));
+  }
+
+  // Oldest event first : the part of the ring after the oldest event, then the part before it
+  const uint32_t oldest = (count - nbEvents) % capacity;
+  const uint32_t firstPart = std::min<uint32_t>(nbEvents, capacity - oldest);
+  fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&events[oldest]), firstPart * sizeof(Event));
+  fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&events[0]), (nbEvents - firstPart) * sizeof(Event));
+  fs.FileClose(&file);
+  NRF_LOG_INFO("[EventTrace] %lu events written, %lu lost", nbEvents, count - nbEvents);
+  Clear();
+}
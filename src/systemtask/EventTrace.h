@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Records an event of type EventTrace::Type::type when the firmware is built with EVENT_TRACE, compiles to nothing otherwise
+#ifdef EVENT_TRACE
+  #define TRACE_EVENT(type, argument) Pinetime::System::EventTrace::Record(Pinetime::System::EventTrace::Type::type, (argument))
+#else
+  #define TRACE_EVENT(type, argument)
+#endif
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace System {
+    /**
+     * Binary trace of the scheduling, the messages, the bus transactions and the LVGL refreshes, enabled by EVENT_TRACE.
+     *
+     * Each event is 8 bytes : the type in the upper byte of the first word and the counter of RTC0 (32768Hz, 24 bits) in its
+     * lower bytes, then an argument that depends on the type. The events are written into a ring buffer of capacity events
+     * that keeps the most recent ones. Record() reserves its slot with an atomic increment (LDREX/STREX) : it is lock-free
+     * and can be called from the interrupts as well as from the tasks. An event that preempts the writer of another one
+     * may be stored before it with a later timestamp, the converter sorts the events by time.
+     *
+     * SystemTask writes the buffer to dumpPath when the display goes to sleep (see doc/EventTrace.md), the file is read through
+     * the FS BLE service and converted by tools/trace2chrome.py.
+     */
+    class EventTrace {
+    public:
+      // Keep in sync with tools/trace2chrome.py
+      enum class Type : uint8_t {
+        // Task number (uxTCBNumber) of the task switched in
+        TaskSwitchedIn = 1,
+        // System::Messages and Display::Messages sent : message in bits 0..7, bit 8 set if sent from an interrupt
+        SystemMessage,
+        DisplayMessage,
+        // Chip select pin in bits 24..31 and size in bits 0..23, the end of the transaction has the pin only
+        SpiBegin,
+        SpiEnd,
+        // Device address of the first transaction in bits 8..15 and number of transactions in bits 0..7, then the error code
+        TwiBegin,
+        TwiEnd,
+        // Refresh task of LVGL, the end has the number of flushes of the frame
+        LvglRefreshBegin,
+        LvglRefreshEnd,
+        // Allocations of LVGL (see LvglPool) : bits 0..15 of the address of the block in bits 16..31 (the RAM is 64KB) and
+        // the size in bits 0..15, the release has the bits 0..15 of the address only
+        LvglAlloc,
+        LvglFree,
+      };
+
+      static constexpr size_t capacity = 512;
+      static constexpr size_t eventSize = 8;
+      static constexpr const char* dumpPath = "/.system/trace.bin";
+
+      static void Record(Type type, uint32_t argument);
+      // Record() drops the events until Clear() is called
+      static void Pause();
+      // Discards the recorded events and resumes the recording
+      static void Clear();
+
+      // Writes the events to dumpPath (oldest first), recording is paused while the buffer is read
+      static void Dump(Controllers::FS& fs);
+
+#ifdef EVENT_TRACE_BENCHMARK
+      static void RunBenchmark();
+#endif
+    };
+  }
+}
@@ -0,0 +1,34 @@
+#include "systemtask/EventTrace.h"
+#include "utility/CycleCounter.h"
+#include <nrf.h>
+#include <nrf_log.h>
+
+#ifdef EVENT_TRACE_BENCHMARK
+using namespace Pinetime::System;
+
+// Logs the cost of Record() when recording and when paused, the events of the benchmark are discarded
+void EventTrace::RunBenchmark() {
+  constexpr uint32_t nbRecords = 1000;
+  Utility::EnableCycleCounter();
+
+  uint32_t start = DWT->CYCCNT;
+  for (uint32_t i = 0; i < nbRecords; i++) {
+    Record(Type::SystemMessage, i);
+  }
+  const uint32_t recordCycles = DWT->CYCCNT - start;
+
+  Pause();
+  start = DWT->CYCCNT;
+  for (uint32_t i = 0; i < nbRecords; i++) {
+    Record(Type::SystemMessage, i);
+  }
+  const uint32_t pausedCycles = DWT->CYCCNT - start;
+
+  Clear();
+  NRF_LOG_INFO("[EventTrace] %lu cycles per event (%lu ns), %lu cycles when paused, %u bytes of RAM",
+               recordCycles / nbRecords,
+               (recordCycles / nbRecords) * 1000 / (SystemCoreClock / 1000000),
+               pausedCycles / nbRecords,
+               capacity * eventSize);
+}
+#endif
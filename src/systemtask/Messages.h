@@ -29,7 +29,11 @@ namespace Pinetime {
       BatteryPercentageUpdated,
       StartFileTransfer,
       StopFileTransfer,
-      BleRadioEnableToggle
+      FileTransferSessionTimeout,
+      BleRadioEnableToggle,
+      OnRemoteGlyphReceived,
+      OnMotionFifoWatermark,
+      OnHeartRateHistoryBlock
     };
   }
 }
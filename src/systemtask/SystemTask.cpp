@@ -2,10 +2,16 @@
 #include <hal/nrf_rtc.h>
 #include <libraries/gpiote/app_gpiote.h>
 #include <libraries/log/nrf_log.h>
+#include <algorithm>
 #include "BootloaderVersion.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "displayapp/TouchEvents.h"
+#ifdef PINETIME_IS_RECOVERY
+  #include "displayapp/DisplayAppRecovery.h"
+#else
+  #include "displayapp/DisplayApp.h"
+#endif
 #include "drivers/Cst816s.h"
 #include "drivers/St7789.h"
 #include "drivers/InternalFlash.h"
@@ -14,6 +20,7 @@
 #include "drivers/TwiMaster.h"
 #include "drivers/Hrs3300.h"
 #include "drivers/PinMap.h"
+#include "systemtask/EventTrace.h"
 #include "main.h"
 #include "BootErrors.h"
 
@@ -25,6 +32,54 @@ namespace {
   inline bool in_isr() {
     return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
   }
+
+#ifdef MOTION_DUMP
+  #if !defined(MOTION_ACQUISITION_FIFO)
+    #error "MOTION_DUMP needs MOTION_ACQUISITION=FIFO"
+  #endif
+  // Records the samples of the accelerometer to /.system/motion.bin, from the boot until the file holds 64KB (see
+  // doc/Benchmarks.md). The file is synced after each batch : the recording survives a reset.
+  void DumpMotionSamples(Pinetime::Controllers::FS& fs, const Pinetime::Drivers::Bma421::Sample* samples, size_t count) {
+    static constexpr const char* dumpPath = "/.system/motion.bin";
+    static constexpr uint32_t maxDumpSize = 64 * 1024;
+    static lfs_file_t file;
+    static bool opened = false;
+    // The file could not be created : the dump is not tried again on each batch
+    static bool failed = false;
+    static uint32_t dumpSize = 0;
+
+    if (failed) {
+      return;
+    }
+    if (dumpSize == 0) {
+      fs.EnsureDirectory("/.system");
+      if (fs.FileOpen(&file, dumpPath, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+        NRF_LOG_WARNING("[SystemTask] Failed to create the motion dump");
+        failed = true;
+        return;
+      }
+      constexpr uint16_t rate = Pinetime::Drivers::Bma421::fifoRate;
+      const uint8_t header[] {'I', 'M', 'O', 'T', 1, 0, static_cast<uint8_t>(rate & 0xff), static_cast<uint8_t>(rate >> 8)};
+      fs.FileWrite(&file, header, sizeof(header));
+      dumpSize = sizeof(header);
+      opened = true;
+    }
+    if (!opened) {
+      return;
+    }
+
+    const uint32_t size = count * sizeof(Pinetime::Drivers::Bma421::Sample);
+    if (dumpSize + size > maxDumpSize) {
+      fs.FileClose(&file);
+      opened = false;
+      NRF_LOG_INFO("[SystemTask] Motion dump complete : %lu bytes", dumpSize);
+      return;
+    }
+    fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(samples), size);
+    fs.FileSync(&file);
+    dumpSize += size;
+  }
+#endif
 }
 
 void MeasureBatteryTimerCallback(TimerHandle_t xTimer) {
@@ -51,7 +106,11 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Pinetime::Applications::HeartRateTask& heartRateApp,
                        Pinetime::Controllers::FS& fs,
                        Pinetime::Controllers::TouchHandler& touchHandler,
-                       Pinetime::Controllers::ButtonHandler& buttonHandler)
+                       Pinetime::Controllers::ButtonHandler& buttonHandler,
+                       const Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                       TaskStatistics& taskStatistics,
+                       const Pinetime::Components::LvglPool& lvglPool,
+                       Pinetime::Controllers::HeartRateHistory& heartRateHistory)
   : spi {spi},
     spiNorFlash {spiNorFlash},
     twiMaster {twiMaster},
@@ -66,12 +125,14 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
     motionSensor {motionSensor},
     settingsController {settingsController},
     heartRateController {heartRateController},
+    heartRateHistory {heartRateHistory},
     motionController {motionController},
     displayApp {displayApp},
     heartRateApp(heartRateApp),
     fs {fs},
     touchHandler {touchHandler},
     buttonHandler {buttonHandler},
+    taskStatistics {taskStatistics},
     nimbleController(*this,
                      bleController,
                      dateTimeController,
@@ -80,7 +141,11 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
                      spiNorFlash,
                      heartRateController,
                      motionController,
-                     fs) {
+                     fs,
+                     displayStatistics,
+                     taskStatistics,
+                     lvglPool,
+                     heartRateHistory) {
 }
 
 void SystemTask::Start() {
@@ -111,6 +176,19 @@ void SystemTask::Work() {
   spiNorFlash.Wakeup();
 
   fs.Init();
+#ifdef FS_READ_BENCHMARK
+  fs.RunReadBenchmark();
+#endif
+  heartRateHistory.Init();
+  heartRateHistory.Register(this);
+  heartRateController.SetHistory(&heartRateHistory);
+#ifdef HR_HISTORY_BENCHMARK
+  Controllers::HeartRateHistory::RunBenchmark();
+#endif
+  notificationManager.Init();
+#ifdef NOTIFICATION_BENCHMARK
+  notificationManager.RunBenchmark();
+#endif
 
   nimbleController.Init();
 
@@ -130,17 +208,21 @@ void SystemTask::Work() {
   alarmController.Init(this);
 
   // Reset the TWI device because the motion sensor chip most probably crashed it...
-  twiMaster.Sleep();
   twiMaster.Init();
 
   motionSensor.Init();
   motionController.Init(motionSensor.DeviceType());
+#ifdef MOTION_REPLAY_BENCHMARK
+  Controllers::MotionController::RunReplayBenchmark();
+#endif
   settingsController.Init();
 
   displayApp.Register(this);
   displayApp.Register(&nimbleController.weather());
   displayApp.Register(&nimbleController.music());
   displayApp.Register(&nimbleController.navigation());
+  displayApp.Register(&nimbleController.fonts());
+  notificationManager.Register(&nimbleController.fonts());
   displayApp.Start(bootError);
 
   heartRateSensor.Init();
@@ -175,6 +257,20 @@ void SystemTask::Work() {
   nrfx_gpiote_in_init(PinMap::PowerPresent, &pinConfig, nrfx_gpiote_evt_handler);
   nrfx_gpiote_in_event_enable(PinMap::PowerPresent, true);
 
+#ifdef MOTION_ACQUISITION_FIFO
+  // Accelerometer FIFO watermark
+  pinConfig.sense = NRF_GPIOTE_POLARITY_LOTOHI;
+  pinConfig.pull = NRF_GPIO_PIN_NOPULL;
+  nrfx_gpiote_in_init(PinMap::Bma421Irq, &pinConfig, nrfx_gpiote_evt_handler);
+  nrfx_gpiote_in_event_enable(PinMap::Bma421Irq, true);
+
+  // The samples are delivered by the watermark interrupt, the timeout only paces the housekeeping of the loop
+  constexpr TickType_t queueTimeout = 1000;
+#else
+  // Polling period of the accelerometer
+  constexpr TickType_t queueTimeout = 100;
+#endif
+
   batteryController.MeasureVoltage();
 
   measureBatteryTimer = xTimerCreate("measureBattery", batteryMeasurementPeriod, pdTRUE, this, MeasureBatteryTimerCallback);
@@ -183,10 +279,31 @@ void SystemTask::Work() {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "EndlessLoop"
   while (true) {
+#ifdef MOTION_ACQUISITION_FIFO
+    // Without a consumer of the samples, the FIFO and its watermark interrupt are stopped while the watch sleeps : they
+    // are restarted when it wakes up, or at the latest 1 queue timeout after a client subscribes to the motion service
+    if (IsMotionNeeded() != motionFifoEnabled) {
+      motionFifoEnabled = !motionFifoEnabled;
+      motionSensor.SetFifoEnabled(motionFifoEnabled);
+    }
+    // INT1 is latched until the FIFO is read : the level is checked so that an edge missed before the setup of the
+    // interrupt cannot stall the acquisition
+    if (motionFifoEnabled && nrf_gpio_pin_read(PinMap::Bma421Irq) != 0) {
+      UpdateMotion();
+    }
+#else
     UpdateMotion();
+#endif
+
+    // The loop runs again when the discovery is due, whatever the acquisition of the accelerometer
+    TickType_t timeout = queueTimeout;
+    if (isBleDiscoveryTimerRunning) {
+      const TickType_t elapsed = xTaskGetTickCount() - bleDiscoveryStart;
+      timeout = (elapsed < bleDiscoveryDelay) ? std::min(timeout, bleDiscoveryDelay - elapsed) : 0;
+    }
 
     Messages msg;
-    if (xQueueReceive(systemTasksMsgQueue, &msg, 100) == pdTRUE) {
+    if (xQueueReceive(systemTasksMsgQueue, &msg, timeout) == pdTRUE) {
       switch (msg) {
         case Messages::EnableSleeping:
           wakeLocksHeld--;
@@ -235,15 +352,18 @@ void SystemTask::Work() {
         case Messages::BleConnected:
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::NotifyDeviceActivity);
           isBleDiscoveryTimerRunning = true;
-          bleDiscoveryTimer = 5;
+          bleDiscoveryStart = xTaskGetTickCount();
           break;
         case Messages::BleFirmwareUpdateStarted:
           GoToRunning();
           wakeLocksHeld++;
+          // The watch resets at the end of the update
+          heartRateHistory.Flush();
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::BleFirmwareUpdateStarted);
           break;
         case Messages::BleFirmwareUpdateFinished:
           if (bleController.State() == Pinetime::Controllers::Ble::FirmwareUpdateStates::Validated) {
+            heartRateHistory.Flush();
             NVIC_SystemReset();
           }
           wakeLocksHeld--;
@@ -259,6 +379,9 @@ void SystemTask::Work() {
           wakeLocksHeld--;
           // TODO add intent of fs access icon or something
           break;
+        case Messages::FileTransferSessionTimeout:
+          nimbleController.fileTransfer().OnSessionTimeout();
+          break;
         case Messages::OnTouchEvent:
           if (touchHandler.ProcessTouchInfo(touchPanel.GetTouchInfo())) {
             displayApp.PushMessage(Pinetime::Applications::Display::Messages::TouchEvent);
@@ -291,6 +414,11 @@ void SystemTask::Work() {
           if (state != SystemTaskState::GoingToSleep) {
             break;
           }
+#ifdef EVENT_TRACE
+          // The display is off and the SPI flash still awake : the trace of the period that ends is written now
+          EventTrace::Dump(fs);
+#endif
+          heartRateHistory.Flush();
           if (BootloaderVersion::IsValid()) {
             // First versions of the bootloader do not expose their version and cannot initialize the SPI NOR FLASH
             // if it's in sleep mode. Avoid bricked device by disabling sleep mode on these versions.
@@ -352,23 +480,32 @@ void SystemTask::Work() {
             nimbleController.DisableRadio();
           }
           break;
+        case Messages::OnRemoteGlyphReceived:
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::RemoteGlyphReceived);
+          break;
+        case Messages::OnMotionFifoWatermark:
+          // The FIFO is drained at the beginning of the next iteration
+          break;
+        case Messages::OnHeartRateHistoryBlock:
+          // The SPI flash sleeps with the display, the records are written before it goes to sleep
+          if (state != SystemTaskState::Sleeping) {
+            heartRateHistory.Flush();
+          }
+          break;
         default:
           break;
       }
     }
 
-    if (isBleDiscoveryTimerRunning) {
-      if (bleDiscoveryTimer == 0) {
-        isBleDiscoveryTimerRunning = false;
-        // Services discovery is deferred from 3 seconds to avoid the conflicts between the host communicating with the
-        // target and vice-versa. I'm not sure if this is the right way to handle this...
-        nimbleController.StartDiscovery();
-      } else {
-        bleDiscoveryTimer--;
-      }
+    if (isBleDiscoveryTimerRunning && xTaskGetTickCount() - bleDiscoveryStart >= bleDiscoveryDelay) {
+      isBleDiscoveryTimerRunning = false;
+      // Services discovery is deferred to avoid the conflicts between the host communicating with the
+      // target and vice-versa. I'm not sure if this is the right way to handle this...
+      nimbleController.StartDiscovery();
     }
 
     monitor.Process();
+    taskStatistics.Update();
     NoInit_BackUpTime = dateTimeController.CurrentDateTime();
     if (nrf_gpio_pin_read(PinMap::Button) == 0) {
       watchdog.Reload();
@@ -417,10 +554,14 @@ void SystemTask::GoToSleep() {
   state = SystemTaskState::GoingToSleep;
 };
 
+bool SystemTask::IsMotionNeeded() {
+  return !IsSleeping() || settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
+         settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) ||
+         motionController.GetService()->IsMotionNotificationSubscribed();
+}
+
 void SystemTask::UpdateMotion() {
-  if (IsSleeping() && !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
-                        settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) ||
-                        motionController.GetService()->IsMotionNotificationSubscribed())) {
+  if (!IsMotionNeeded()) {
     return;
   }
 
@@ -429,10 +570,26 @@ void SystemTask::UpdateMotion() {
     stepCounterMustBeReset = false;
   }
 
+#ifdef MOTION_ACQUISITION_FIFO
+  const uint32_t nbSteps = motionSensor.StepCount();
+  size_t count = 0;
+  do {
+    count = motionSensor.ReadFifo(motionSamples.data(), motionSamples.size());
+#ifdef MOTION_DUMP
+    DumpMotionSamples(fs, motionSamples.data(), count);
+#endif
+    motionController.Update(motionSamples.data(), count, nbSteps);
+    HandleMotionGestures();
+  } while (count == motionSamples.size());
+#else
   auto motionValues = motionSensor.Process();
 
   motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
+  HandleMotionGestures();
+#endif
+}
 
+void SystemTask::HandleMotionGestures() {
   if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
     if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
          motionController.ShouldRaiseWake()) ||
@@ -491,6 +648,7 @@ void SystemTask::OnTouchEvent() {
 }
 
 void SystemTask::PushMessage(System::Messages msg) {
+  TRACE_EVENT(SystemMessage, static_cast<uint32_t>(msg) | (in_isr() ? 0x100 : 0));
   if (in_isr()) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     xQueueSendFromISR(systemTasksMsgQueue, &msg, &xHigherPriorityTaskWoken);
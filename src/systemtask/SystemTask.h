@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 
 #include <FreeRTOS.h>
@@ -13,6 +14,8 @@
 #include <components/motion/MotionController.h>
 
 #include "systemtask/SystemMonitor.h"
+#include "systemtask/TaskStatistics.h"
+#include "displayapp/LvglPool.h"
 #include "components/ble/NimbleController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/alarm/AlarmController.h"
@@ -25,7 +28,6 @@
   #include "displayapp/DisplayAppRecovery.h"
 #else
   #include "components/settings/Settings.h"
-  #include "displayapp/DisplayApp.h"
 #endif
 
 #include "drivers/Watchdog.h"
@@ -43,6 +45,10 @@ namespace Pinetime {
     class Hrs3300;
   }
 
+  namespace Applications {
+    class DisplayApp;
+  }
+
   namespace Controllers {
     class Battery;
     class TouchHandler;
@@ -72,7 +78,11 @@ namespace Pinetime {
                  Pinetime::Applications::HeartRateTask& heartRateApp,
                  Pinetime::Controllers::FS& fs,
                  Pinetime::Controllers::TouchHandler& touchHandler,
-                 Pinetime::Controllers::ButtonHandler& buttonHandler);
+                 Pinetime::Controllers::ButtonHandler& buttonHandler,
+                 const Pinetime::Controllers::DisplayStatistics& displayStatistics,
+                 TaskStatistics& taskStatistics,
+                 const Pinetime::Components::LvglPool& lvglPool,
+                 Pinetime::Controllers::HeartRateHistory& heartRateHistory);
 
       void Start();
       void PushMessage(Messages msg);
@@ -110,6 +120,7 @@ namespace Pinetime {
       Pinetime::Drivers::Bma421& motionSensor;
       Pinetime::Controllers::Settings& settingsController;
       Pinetime::Controllers::HeartRateController& heartRateController;
+      Pinetime::Controllers::HeartRateHistory& heartRateHistory;
       Pinetime::Controllers::MotionController& motionController;
 
       Pinetime::Applications::DisplayApp& displayApp;
@@ -117,12 +128,15 @@ namespace Pinetime {
       Pinetime::Controllers::FS& fs;
       Pinetime::Controllers::TouchHandler& touchHandler;
       Pinetime::Controllers::ButtonHandler& buttonHandler;
+      TaskStatistics& taskStatistics;
       Pinetime::Controllers::NimbleController nimbleController;
 
       static void Process(void* instance);
       void Work();
       bool isBleDiscoveryTimerRunning = false;
-      uint8_t bleDiscoveryTimer = 0;
+      TickType_t bleDiscoveryStart = 0;
+      // Delay between the connection and the discovery of the services, 5 iterations of the loop when it polled the accelerometer
+      static constexpr TickType_t bleDiscoveryDelay = pdMS_TO_TICKS(500);
       TimerHandle_t measureBatteryTimer;
       uint8_t wakeLocksHeld = 0;
       SystemTaskState state = SystemTaskState::Running;
@@ -132,8 +146,17 @@ namespace Pinetime {
 
       void GoToRunning();
       void GoToSleep();
+      // The samples of the accelerometer are used while the watch runs, or by a wake mode or a client of the motion service
+      bool IsMotionNeeded();
       void UpdateMotion();
+      void HandleMotionGestures();
       bool stepCounterMustBeReset = false;
+#ifdef MOTION_ACQUISITION_FIFO
+      // Twice the watermark : the FIFO is usually drained by a single read
+      std::array<Drivers::Bma421::Sample, Drivers::Bma421::fifoWatermark * 2> motionSamples;
+      // Bma421::Init() starts the FIFO
+      bool motionFifoEnabled = true;
+#endif
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
 
       SystemMonitor monitor;
@@ -0,0 +1,88 @@
+#include "systemtask/TaskStatistics.h"
+#include <algorithm>
+#include <cstring>
+#include <nrf.h>
+
+using namespace Pinetime::System;
+
+namespace {
+  uint16_t Permille(uint32_t value, uint32_t total) {
+    if (total == 0) {
+      return 0;
+    }
+    return static_cast<uint16_t>((static_cast<uint64_t>(value) * 1000) / total);
+  }
+
+  uint16_t PerSecond(uint32_t count, uint32_t durationMs) {
+    if (durationMs == 0) {
+      return 0;
+    }
+    return static_cast<uint16_t>(std::min<uint32_t>((static_cast<uint64_t>(count) * 1000) / durationMs, UINT16_MAX));
+  }
+}
+
+uint32_t TaskStatistics::RunTimeCounter() {
+  static uint32_t overflows = 0;
+  static uint32_t lastCounter = 0;
+  const uint32_t counter = NRF_RTC0->COUNTER;
+  if (counter < lastCounter) {
+    overflows += 1UL << 24;
+  }
+  lastCounter = counter;
+  return overflows | counter;
+}
+
+void TaskStatistics::Update() {
+  const TickType_t now = xTaskGetTickCount();
+  if (now - windowStart < windowDuration) {
+    return;
+  }
+
+  uint32_t totalRunTime = 0;
+  const UBaseType_t nbTasks = uxTaskGetSystemState(status.data(), status.size(), &totalRunTime);
+  taskENTER_CRITICAL();
+  currentSwitchIns = switchIns;
+  taskEXIT_CRITICAL();
+
+  next = {};
+  next.windowMs = (now - windowStart) * 1000 / configTICK_RATE_HZ;
+  next.windows = summary.windows + 1;
+  const uint32_t windowRunTime = totalRunTime - previousTotalRunTime;
+  const TaskHandle_t idleTask = xTaskGetIdleTaskHandle();
+  for (UBaseType_t i = 0; i < nbTasks; i++) {
+    const size_t slot = status[i].xTaskNumber % maxTaskNumbers;
+    // The previous task at this slot was deleted : count from its creation
+    if (previousNumbers[slot] != static_cast<uint8_t>(status[i].xTaskNumber)) {
+      previousNumbers[slot] = status[i].xTaskNumber;
+      previousRunTimes[slot] = 0;
+      previousSwitchIns[slot] = 0;
+    }
+
+    Task& task = next.tasks[next.nbTasks++];
+    std::memcpy(task.name, status[i].pcTaskName, sizeof(task.name));
+    task.name[sizeof(task.name) - 1] = '\0';
+    task.number = status[i].xTaskNumber;
+    task.cpuPermille = Permille(status[i].ulRunTimeCounter - previousRunTimes[slot], windowRunTime);
+    task.wakeupsPerSecond = PerSecond(currentSwitchIns[slot] - previousSwitchIns[slot], next.windowMs);
+    if (status[i].xHandle == idleTask) {
+      next.idlePermille = task.cpuPermille;
+      next.wakeupsPerSecond = task.wakeupsPerSecond;
+    }
+
+    previousRunTimes[slot] = status[i].ulRunTimeCounter;
+    previousSwitchIns[slot] = currentSwitchIns[slot];
+  }
+  previousTotalRunTime = totalRunTime;
+  windowStart = now;
+
+  taskENTER_CRITICAL();
+  summary = next;
+  taskEXIT_CRITICAL();
+}
+
+TaskStatistics::Summary TaskStatistics::GetSummary() const {
+  taskENTER_CRITICAL();
+  Summary copy = summary;
+  taskEXIT_CRITICAL();
+  return copy;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <task.h>
+
+namespace Pinetime {
+  namespace System {
+    /**
+     * Rolling CPU usage and wakeups of the FreeRTOS tasks.
+     *
+     * FreeRTOS accumulates the run time of each task (configGENERATE_RUN_TIME_STATS) with RunTimeCounter() : the counter of
+     * RTC0, which runs at 32768Hz for NimBLE, extended to 32 bits. The context switches are counted per task by
+     * OnTaskSwitchedIn() (traceTASK_SWITCHED_IN). SystemTask calls Update(), which computes the CPU usage and the
+     * wakeups of each task over the last window. The idle task includes the time the CPU sleeps (tickless idle), each
+     * time it is switched in the CPU goes back to sleep : its switches count the wakeups of the CPU.
+     *
+     * The summary is read by SystemInfo and by the Diagnostics BLE service, from other tasks : it is copied in critical
+     * sections.
+     */
+    class TaskStatistics {
+    public:
+      static constexpr TickType_t windowDuration = pdMS_TO_TICKS(10000);
+      static constexpr size_t maxTasks = 10;
+
+      struct Task {
+        char name[configMAX_TASK_NAME_LEN];
+        uint8_t number;
+        // CPU time over the last window, in permille
+        uint16_t cpuPermille;
+        // Number of times the task was switched in, per second
+        uint16_t wakeupsPerSecond;
+      };
+
+      struct Summary {
+        std::array<Task, maxTasks> tasks;
+        uint8_t nbTasks = 0;
+        // Time spent in the idle task (sleep included) in permille, and wakeups of the CPU per second
+        uint16_t idlePermille = 0;
+        uint16_t wakeupsPerSecond = 0;
+        uint32_t windowMs = 0;
+        // Number of windows since the boot, 0 until the first window ends
+        uint32_t windows = 0;
+      };
+
+      void Update();
+      Summary GetSummary() const;
+
+      // Called by FreeRTOS at each context switch, with the interrupts masked
+      void OnTaskSwitchedIn(uint32_t taskNumber) {
+        switchIns[taskNumber % maxTaskNumbers]++;
+      }
+
+      // portGET_RUN_TIME_COUNTER_VALUE() : called at each context switch (SystemTask wakes up at least every second, no
+      // overflow of the 24 bits counter is missed), or with the scheduler suspended
+      static uint32_t RunTimeCounter();
+
+    private:
+      // The statistics of a task are kept at its number modulo maxTaskNumbers
+      static constexpr size_t maxTaskNumbers = 16;
+
+      std::array<uint32_t, maxTaskNumbers> switchIns {};
+      // Counters at the beginning of the window
+      std::array<uint8_t, maxTaskNumbers> previousNumbers {};
+      std::array<uint32_t, maxTaskNumbers> previousRunTimes {};
+      std::array<uint32_t, maxTaskNumbers> previousSwitchIns {};
+      uint32_t previousTotalRunTime = 0;
+      TickType_t windowStart = 0;
+
+      // Buffers of Update() (about 500 bytes), kept out of the stack of SystemTask
+      std::array<TaskStatus_t, maxTasks> status;
+      std::array<uint32_t, maxTaskNumbers> currentSwitchIns;
+      Summary next;
+
+      Summary summary;
+    };
+  }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <nrf.h>
+
+namespace Pinetime {
+  namespace Utility {
+    // Starts the cycle counter of the DWT (DWT->CYCCNT), which times the benchmarks and the frame statistics
+    inline void EnableCycleCounter() {
+      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "displayapp/ScreenArena.h"
+#include "displayapp/screens/Screen.h"
+
+// Screens of different sizes standing for the screens of DisplayApp, for the tests of ScreenArena : the screens of the
+// firmware create their objects of LVGL, which is not built for the computer
+namespace HostTests {
+  // Screens constructed and not destroyed yet
+  inline int liveScreens = 0;
+
+  template <size_t Size>
+  class SizedScreen : public Pinetime::Applications::Screens::Screen {
+  public:
+    explicit SizedScreen(uint8_t value) {
+      data.fill(value);
+      liveScreens++;
+    }
+
+    ~SizedScreen() override {
+      liveScreens--;
+    }
+
+    uint8_t Value() const {
+      return data[Size - 1];
+    }
+
+  private:
+    std::array<uint8_t, Size> data;
+  };
+
+  using SmallScreen = SizedScreen<16>;
+  using MediumScreen = SizedScreen<200>;
+  using LargeScreen = SizedScreen<1000>;
+
+  using ArenaScreens = Pinetime::Applications::ScreenLayout<SmallScreen, MediumScreen, LargeScreen>;
+  using Arena = Pinetime::Applications::ScreenArena<ArenaScreens::size, ArenaScreens::alignment>;
+
+  // Switch number i of a round of the 3 screens, as DisplayApp::LoadScreen() does it
+  inline Pinetime::Applications::Screens::Screen* SwitchScreen(Arena& arena, size_t i) {
+    switch (i % 3) {
+      case 0:
+        return arena.Emplace<SmallScreen>(static_cast<uint8_t>(i));
+      case 1:
+        return arena.Emplace<MediumScreen>(static_cast<uint8_t>(i));
+      default:
+        return arena.Emplace<LargeScreen>(static_cast<uint8_t>(i));
+    }
+  }
+
+  // The same switch with the screen allocated from the heap, as DisplayApp did it before the screen arena
+  inline Pinetime::Applications::Screens::Screen* SwitchScreen(std::unique_ptr<Pinetime::Applications::Screens::Screen>& screen,
+                                                               size_t i) {
+    screen.reset();
+    switch (i % 3) {
+      case 0:
+        screen = std::make_unique<SmallScreen>(static_cast<uint8_t>(i));
+        break;
+      case 1:
+        screen = std::make_unique<MediumScreen>(static_cast<uint8_t>(i));
+        break;
+      default:
+        screen = std::make_unique<LargeScreen>(static_cast<uint8_t>(i));
+        break;
+    }
+    return screen.get();
+  }
+}
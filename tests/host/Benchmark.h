@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <FreeRTOS.h>
+#include <gtest/gtest.h>
+
+namespace HostTests {
+  // Mean cost of a call measured by MeasurePerCall()
+  struct PerCall {
+    double nanoseconds;
+    // Allocations from the heap : pvPortMalloc() and operator new (see HeapAllocations.cpp)
+    double allocations;
+  };
+
+  // Cost of one of the nbOperations a call makes
+  inline PerCall operator/(const PerCall& perCall, double nbOperations) {
+    return {perCall.nanoseconds / nbOperations, perCall.allocations / nbOperations};
+  }
+
+  // Calls function nbCalls times and returns the mean duration and number of allocations of a call. The timings of the
+  // computer only show the relative cost of the implementations: the PineTime runs at 64MHz, without data cache.
+  template <class Function>
+  PerCall MeasurePerCall(size_t nbCalls, Function&& function) {
+    const uint64_t allocations = HostStubs::heapAllocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nbCalls; i++) {
+      function(i);
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return {duration.count() / static_cast<double>(nbCalls), static_cast<double>(HostStubs::heapAllocations - allocations) / nbCalls};
+  }
+
+  // Prints a result of a benchmark and adds it to the XML report of gtest (--gtest_output=xml)
+  inline void Report(const std::string& name, double value, const std::string& unit) {
+    std::cout << "[ RESULT   ] " << name << " : " << value << " " << unit << std::endl;
+    ::testing::Test::RecordProperty(name, std::to_string(value));
+  }
+
+  // Prints the cost of a call, in ns/op and allocations/op
+  inline void Report(const std::string& name, const PerCall& perCall) {
+    std::cout << "[ RESULT   ] " << name << " : " << perCall.nanoseconds << " ns/op, " << perCall.allocations << " allocations/op"
+              << std::endl;
+    ::testing::Test::RecordProperty(name + " ns/op", std::to_string(perCall.nanoseconds));
+    ::testing::Test::RecordProperty(name + " allocations/op", std::to_string(perCall.allocations));
+  }
+}
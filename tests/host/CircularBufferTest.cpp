@@ -0,0 +1,27 @@
+#include "utility/CircularBuffer.h"
+#include <gtest/gtest.h>
+
+using Pinetime::Utility::CircularBuffer;
+
+TEST(CircularBuffer, IndexesFromTheCurrentPosition) {
+  CircularBuffer<int, 4> buffer {};
+  for (int i = 0; i < 4; i++) {
+    buffer[i] = i;
+  }
+  buffer++;
+  EXPECT_EQ(buffer.Idx(), 1U);
+  EXPECT_EQ(buffer[0], 1);
+  EXPECT_EQ(buffer[3], 0);
+}
+
+TEST(CircularBuffer, WrapsInBothDirections) {
+  CircularBuffer<int, 3> buffer {};
+  buffer--;
+  EXPECT_EQ(buffer.Idx(), 2U);
+  buffer++;
+  EXPECT_EQ(buffer.Idx(), 0U);
+  for (int i = 0; i < 7; i++) {
+    buffer++;
+  }
+  EXPECT_EQ(buffer.Idx(), 1U);
+}
@@ -0,0 +1,157 @@
+#include "components/ble/DfuService.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "drivers/SpiNorFlash.h"
+
+using DfuImage = Pinetime::Controllers::DfuService::DfuImage;
+using Pinetime::Drivers::SpiNorFlash;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+  constexpr size_t writeOffset = 0x40000;
+  constexpr size_t packetSize = 20;
+
+  // CRC of DfuImage before the table : 5 shifts and xors per byte
+  uint16_t ComputeCrcBitwise(const uint8_t* data, uint32_t size, uint16_t crc) {
+    for (uint32_t i = 0; i < size; i++) {
+      crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
+      crc ^= data[i];
+      crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
+      crc ^= (crc << 8) << 4;
+      crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+  }
+
+  // DfuImage before the page writer : the packets are collected in a buffer of 200 bytes that is written synchronously
+  // by the BLE host, and Validate() reads the image back to compute its CRC
+  class PreviousDfuImage {
+  public:
+    explicit PreviousDfuImage(SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
+    }
+
+    void Init(size_t totalSize, uint16_t expectedCrc) {
+      this->totalSize = totalSize;
+      this->expectedCrc = expectedCrc;
+      totalWriteIndex = 0;
+      bufferWriteIndex = 0;
+    }
+
+    void Append(const uint8_t* data, size_t size) {
+      std::memcpy(buffer + bufferWriteIndex, data, size);
+      bufferWriteIndex += size;
+      if (bufferWriteIndex == bufferSize || totalWriteIndex + bufferWriteIndex == totalSize) {
+        spiNorFlash.Write(writeOffset + totalWriteIndex, buffer, bufferWriteIndex);
+        totalWriteIndex += bufferWriteIndex;
+        bufferWriteIndex = 0;
+      }
+    }
+
+    bool Validate() {
+      uint16_t crc = 0xFFFF;
+      for (size_t offset = 0; offset < totalSize; offset += bufferSize) {
+        const size_t size = std::min(bufferSize, totalSize - offset);
+        spiNorFlash.Read(writeOffset + offset, buffer, size);
+        crc = ComputeCrcBitwise(buffer, size, crc);
+      }
+      return crc == expectedCrc;
+    }
+
+  private:
+    static constexpr size_t bufferSize = 200;
+    SpiNorFlash& spiNorFlash;
+    uint8_t buffer[bufferSize];
+    size_t totalSize = 0;
+    size_t totalWriteIndex = 0;
+    size_t bufferWriteIndex = 0;
+    uint16_t expectedCrc = 0;
+  };
+
+  std::vector<uint8_t> Image(size_t size) {
+    std::vector<uint8_t> image(size);
+    for (size_t i = 0; i < size; i++) {
+      image[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+    return image;
+  }
+
+  double Milliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  }
+
+  // Link of the Nordic DFU : packets of 20 bytes, 6 per connection event of 7.5ms (16KB/s). The packets are handed to
+  // the image as they arrive, the controller keeps the packets that arrive while the BLE host is busy.
+  constexpr auto connectionInterval = std::chrono::microseconds(7500);
+  constexpr size_t packetsPerEvent = 6;
+
+  // Receives the image through the link, then validates it. The sectors are erased beforehand, the erase is the same for
+  // both writers. The flash memory takes the time it takes on the watch.
+  template <class Image>
+  void ReceiveImage(const std::string& name, SpiNorFlash& flash, Image& dfuImage, std::vector<uint8_t>& image) {
+    flash.timings = SpiNorFlash::watchTimings;
+    Clock::duration busy {};
+    Clock::duration maxBusy {};
+    const Clock::time_point start = Clock::now();
+    for (size_t offset = 0, packet = 0; offset < image.size(); offset += packetSize, packet++) {
+      std::this_thread::sleep_until(start + connectionInterval * (packet / packetsPerEvent));
+      const Clock::time_point appendStart = Clock::now();
+      dfuImage.Append(image.data() + offset, std::min(packetSize, image.size() - offset));
+      const Clock::duration appendDuration = Clock::now() - appendStart;
+      busy += appendDuration;
+      maxBusy = std::max(maxBusy, appendDuration);
+    }
+    const Clock::time_point validateStart = Clock::now();
+    EXPECT_TRUE(dfuImage.Validate());
+    const Clock::time_point end = Clock::now();
+    flash.timings = SpiNorFlash::instantTimings;
+
+    const double linkTime = Milliseconds(connectionInterval * ((image.size() / packetSize - 1) / packetsPerEvent));
+    HostTests::Report(name + " transfer",
+                      Milliseconds(end - start),
+                      "ms (link alone " + std::to_string(static_cast<int>(linkTime)) + " ms)");
+    HostTests::Report(name + " validate", Milliseconds(end - validateStart), "ms");
+    HostTests::Report(name + " BLE host busy", Milliseconds(busy), "ms");
+    HostTests::Report(name + " longest packet", Milliseconds(maxBusy), "ms");
+  }
+}
+
+TEST(DfuImageBenchmark, Crc) {
+  const std::vector<uint8_t> image = Image(464 * 1024);
+  uint16_t bitwiseCrc = 0;
+  uint16_t tableCrc = 0;
+  constexpr size_t nbRuns = 5;
+  const HostTests::PerCall bitwise = HostTests::MeasurePerCall(nbRuns, [&](size_t) {
+    bitwiseCrc = ComputeCrcBitwise(image.data(), image.size(), 0xFFFF);
+  });
+  const HostTests::PerCall table = HostTests::MeasurePerCall(nbRuns, [&](size_t) {
+    tableCrc = DfuImage::ComputeCrc(image.data(), image.size(), 0xFFFF);
+  });
+  EXPECT_EQ(bitwiseCrc, tableCrc);
+  HostTests::Report("bitwise CRC", image.size() / bitwise.nanoseconds * 1e9 / (1024 * 1024), "MB/s");
+  HostTests::Report("table CRC", image.size() / table.nanoseconds * 1e9 / (1024 * 1024), "MB/s");
+  HostTests::Report("bitwise CRC of the image", bitwise);
+  HostTests::Report("table CRC of the image", table);
+}
+
+// 32KB : the transfer lasts 2s with each writer
+TEST(DfuImageBenchmark, Transfer) {
+  std::vector<uint8_t> image = Image(32 * 1024);
+  const uint16_t crc = DfuImage::ComputeCrc(image.data(), image.size(), 0xFFFF);
+  // As on the watch, the image and its writer task live until the end of the program
+  static auto* flash = new SpiNorFlash;
+
+  PreviousDfuImage previous {*flash};
+  previous.Init(image.size(), crc);
+  ReceiveImage("previous writer", *flash, previous, image);
+
+  static auto* current = new DfuImage {*flash};
+  current->Erase();
+  current->Init(packetSize, image.size(), crc);
+  ReceiveImage("page writer", *flash, *current, image);
+}
@@ -0,0 +1,123 @@
+#include "components/ble/DfuService.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include "drivers/SpiNorFlash.h"
+
+using DfuImage = Pinetime::Controllers::DfuService::DfuImage;
+using Pinetime::Drivers::SpiNorFlash;
+
+namespace {
+  // DfuImage::writeOffset and DfuImage::maxSize
+  constexpr size_t writeOffset = 0x40000;
+  constexpr size_t maxSize = 475136;
+  constexpr size_t packetSize = 20;
+
+  std::vector<uint8_t> Image(size_t size) {
+    std::vector<uint8_t> image(size);
+    for (size_t i = 0; i < size; i++) {
+      image[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+    return image;
+  }
+
+  uint16_t Crc(const std::vector<uint8_t>& data) {
+    return DfuImage::ComputeCrc(data.data(), data.size(), 0xFFFF);
+  }
+
+  // Receives the image in packets of 20 bytes as DfuService does, returns the result of Validate()
+  bool Receive(DfuImage& dfuImage, std::vector<uint8_t> image, uint16_t expectedCrc) {
+    dfuImage.Erase();
+    dfuImage.Init(packetSize, image.size(), expectedCrc);
+    for (size_t offset = 0; offset < image.size(); offset += packetSize) {
+      dfuImage.Append(image.data() + offset, std::min(packetSize, image.size() - offset));
+    }
+    EXPECT_TRUE(dfuImage.IsComplete());
+    return dfuImage.Validate();
+  }
+
+  // As on the watch, the image and its writer task live until the end of the program : the tests share them
+  struct Device {
+    SpiNorFlash flash;
+    DfuImage dfuImage {flash};
+  };
+
+  Device& TheDevice() {
+    static auto* device = new Device;
+    return *device;
+  }
+
+  bool HasMagicNumber(const SpiNorFlash& flash) {
+    constexpr std::array<uint32_t, 4> magic {0xf395c277, 0x7fefd260, 0x0f505235, 0x8079b62c};
+    return std::equal(reinterpret_cast<const uint8_t*>(magic.data()),
+                      reinterpret_cast<const uint8_t*>(magic.data() + magic.size()),
+                      flash.memory.begin() + writeOffset + maxSize - sizeof(magic));
+  }
+
+  class DfuImageTest : public ::testing::Test {
+  protected:
+    // The writer task is idle between the tests : each of them ends with Validate()
+    void SetUp() override {
+      std::fill(flash.memory.begin(), flash.memory.end(), 0xff);
+      flash.statistics = {};
+    }
+
+    SpiNorFlash& flash = TheDevice().flash;
+    DfuImage& dfuImage = TheDevice().dfuImage;
+  };
+}
+
+TEST_F(DfuImageTest, CrcIsTheCrc16OfTheNordicDfu) {
+  // Check value of CRC-16/CCITT-FALSE
+  const std::vector<uint8_t> check {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(Crc(check), 0x29B1);
+
+  // Computed as the packets arrive
+  const std::vector<uint8_t> image = Image(1000);
+  uint16_t crc = 0xFFFF;
+  for (size_t offset = 0; offset < image.size(); offset += packetSize) {
+    crc = DfuImage::ComputeCrc(image.data() + offset, packetSize, crc);
+  }
+  EXPECT_EQ(crc, Crc(image));
+}
+
+TEST_F(DfuImageTest, ImageIsWrittenAtTheDfuOffset) {
+  for (const size_t size : {size_t {1000}, size_t {4096}, size_t {64 * 1024 + 20}}) {
+    const std::vector<uint8_t> image = Image(size);
+    ASSERT_TRUE(Receive(dfuImage, image, Crc(image))) << size;
+    EXPECT_TRUE(std::equal(image.begin(), image.end(), flash.memory.begin() + writeOffset)) << size;
+    EXPECT_EQ(flash.memory[writeOffset + size], 0xff) << size;
+    EXPECT_TRUE(HasMagicNumber(flash)) << size;
+  }
+}
+
+TEST_F(DfuImageTest, ImageIsProgrammedPageByPage) {
+  const std::vector<uint8_t> image = Image(10 * 256 + 100);
+  ASSERT_TRUE(Receive(dfuImage, image, Crc(image)));
+  // 11 pages of the image and the magic number, the image is not read back
+  EXPECT_EQ(flash.statistics.pagePrograms, 12U);
+  EXPECT_EQ(flash.statistics.bytesRead, 0U);
+}
+
+TEST_F(DfuImageTest, WrongCrcIsRejectedWithoutMagicNumber) {
+  const std::vector<uint8_t> image = Image(5000);
+  EXPECT_FALSE(Receive(dfuImage, image, Crc(image) ^ 1));
+  EXPECT_FALSE(HasMagicNumber(flash));
+
+  // The next transfer starts from a clean state
+  EXPECT_TRUE(Receive(dfuImage, image, Crc(image)));
+  EXPECT_TRUE(HasMagicNumber(flash));
+}
+
+TEST_F(DfuImageTest, IncompleteImageIsNotValid) {
+  std::vector<uint8_t> image = Image(5000);
+  dfuImage.Erase();
+  dfuImage.Init(packetSize, image.size(), Crc(image));
+  dfuImage.Append(image.data(), packetSize);
+  EXPECT_FALSE(dfuImage.IsComplete());
+  EXPECT_FALSE(dfuImage.Validate());
+
+  // Erase() waits for the pages of the transfer that did not complete
+  EXPECT_TRUE(Receive(dfuImage, image, Crc(image)));
+}
@@ -0,0 +1,41 @@
+#include "components/fs/FS.h"
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "drivers/SpiNorFlash.h"
+
+using Pinetime::Controllers::FS;
+using Pinetime::Drivers::SpiNorFlash;
+
+// Cost of the reads of a resource file by pieces, as the fonts and images of the resources are read, with the FS of the
+// firmware and littlefs on the flash memory in RAM of stubs/drivers/SpiNorFlash.h (without the timings of the watch)
+TEST(FSBenchmark, Read) {
+  SpiNorFlash flash;
+  FS fs {flash};
+  fs.Init();
+
+  std::vector<uint8_t> data(16 * 1024);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  lfs_file_t file {};
+  ASSERT_EQ(fs.FileOpen(&file, "/resource.bin", LFS_O_WRONLY | LFS_O_CREAT), LFS_ERR_OK);
+  ASSERT_EQ(fs.FileWrite(&file, data.data(), data.size()), static_cast<int>(data.size()));
+  ASSERT_EQ(fs.FileClose(&file), LFS_ERR_OK);
+
+  for (size_t pieceSize : {16, 64, 512}) {
+    std::vector<uint8_t> piece(pieceSize);
+    ASSERT_EQ(fs.FileOpen(&file, "/resource.bin", LFS_O_RDONLY), LFS_ERR_OK);
+    const size_t nbReads = data.size() / pieceSize;
+    const uint32_t bytesRead = flash.statistics.bytesRead;
+    const HostTests::PerCall read = HostTests::MeasurePerCall(nbReads, [&](size_t) {
+      fs.FileRead(&file, piece.data(), piece.size());
+    });
+    fs.FileClose(&file);
+    HostTests::Report("read of " + std::to_string(pieceSize) + " bytes", read);
+    HostTests::Report("read of " + std::to_string(pieceSize) + " bytes, flash",
+                      static_cast<double>(flash.statistics.bytesRead - bytesRead) / nbReads,
+                      "bytes per read");
+  }
+}
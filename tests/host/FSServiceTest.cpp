@@ -0,0 +1,294 @@
+#include "components/ble/FSService.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "components/ble/LinkPolicy.h"
+#include "components/fs/FS.h"
+#include "systemtask/SystemTask.h"
+
+using Pinetime::Controllers::FS;
+using Pinetime::Controllers::FSService;
+using Pinetime::Controllers::LinkPolicy;
+using Pinetime::System::Messages;
+using Pinetime::System::SystemTask;
+
+namespace {
+  constexpr uint16_t connectionHandle = 1;
+  // FSService::sessionTimeout
+  constexpr TickType_t sessionTimeout = pdMS_TO_TICKS(10000);
+  // Size of the headers of the READ_DATA response and of the WRITE_DATA packet
+  constexpr uint16_t readResponseSize = 16;
+  constexpr uint16_t writeDataSize = 12;
+
+  // Little endian fields of a packet of the protocol (see doc/BLEFS.md)
+  class Packet {
+  public:
+    template <class T>
+    Packet& Add(T value) {
+      const size_t offset = bytes.size();
+      bytes.resize(offset + sizeof(value));
+      std::memcpy(&bytes[offset], &value, sizeof(value));
+      return *this;
+    }
+
+    Packet& Add(const std::vector<uint8_t>& data) {
+      bytes.insert(bytes.end(), data.begin(), data.end());
+      return *this;
+    }
+
+    Packet& Add(const char* text) {
+      bytes.insert(bytes.end(), text, text + std::strlen(text));
+      return *this;
+    }
+
+    std::vector<uint8_t> bytes;
+  };
+
+  template <class T>
+  T Field(const std::vector<uint8_t>& data, size_t offset) {
+    T value {};
+    if (offset + sizeof(value) <= data.size()) {
+      std::memcpy(&value, data.data() + offset, sizeof(value));
+    }
+    return value;
+  }
+
+  std::vector<uint8_t> FileContent(size_t size) {
+    std::vector<uint8_t> content(size);
+    for (size_t i = 0; i < size; i++) {
+      content[i] = static_cast<uint8_t>(i * 7 + i / 256);
+    }
+    return content;
+  }
+
+  // The transfer characteristic of the service, accessed as the BLE host does
+  class FSServiceTest : public ::testing::Test {
+  protected:
+    FS fs;
+    SystemTask systemTask;
+    LinkPolicy linkPolicy;
+    std::unique_ptr<FSService> service;
+    uint16_t transferHandle;
+
+    void SetUp() override {
+      HostStubs::notifications.clear();
+      HostStubs::attMtu = 247;
+      const uint16_t firstHandle = HostStubs::nextAttributeHandle;
+      service = std::make_unique<FSService>(systemTask, fs, linkPolicy);
+      service->Init();
+      // Version characteristic, then transfer characteristic
+      transferHandle = firstHandle + 2;
+    }
+
+    void TearDown() override {
+      service.reset();
+      HostStubs::DeleteTimers();
+      EXPECT_EQ(HostStubs::mbufsInUse, 0);
+    }
+
+    // Writes the packet to the transfer characteristic in chunks of segmentSize bytes, returns the notifications sent
+    std::vector<HostStubs::Notification> Write(const Packet& packet, uint16_t segmentSize = 64) {
+      HostStubs::notifications.clear();
+      os_mbuf* om = HostStubs::MbufFromFlat(packet.bytes.data(), packet.bytes.size(), segmentSize);
+      ble_gatt_access_ctxt context {BLE_GATT_ACCESS_OP_WRITE_CHR, om};
+      EXPECT_EQ(service->OnFSServiceRequested(connectionHandle, transferHandle, &context), 0);
+      os_mbuf_free_chain(context.om);
+      for (const auto& notification : HostStubs::notifications) {
+        EXPECT_EQ(notification.attributeHandle, transferHandle);
+      }
+      return HostStubs::notifications;
+    }
+
+    std::vector<HostStubs::Notification> WriteHeader(const char* path, uint32_t totalSize) {
+      return Write(Packet {}
+                     .Add<uint8_t>(0x20)
+                     .Add<uint8_t>(0)
+                     .Add<uint16_t>(std::strlen(path))
+                     .Add<uint32_t>(0)
+                     .Add<uint64_t>(0)
+                     .Add<uint32_t>(totalSize)
+                     .Add(path));
+    }
+
+    std::vector<HostStubs::Notification> WriteData(uint32_t offset, const std::vector<uint8_t>& data) {
+      return Write(
+        Packet {}.Add<uint8_t>(0x22).Add<uint8_t>(0x01).Add<uint16_t>(0).Add<uint32_t>(offset).Add<uint32_t>(data.size()).Add(data));
+    }
+
+    // Uploads content in packets as large as the MTU allows, returns the number of packets
+    size_t Upload(const char* path, const std::vector<uint8_t>& content) {
+      const auto header = WriteHeader(path, content.size());
+      EXPECT_EQ(header.size(), 1U);
+      EXPECT_EQ(header.front().data.at(1), 0x01);
+      const size_t chunkSize = HostStubs::attMtu - 3 - writeDataSize;
+      size_t nbPackets = 0;
+      for (size_t offset = 0; offset < content.size(); offset += chunkSize, nbPackets++) {
+        const size_t size = std::min(chunkSize, content.size() - offset);
+        const auto responses = WriteData(offset, std::vector<uint8_t>(content.begin() + offset, content.begin() + offset + size));
+        EXPECT_EQ(responses.size(), 1U);
+        EXPECT_EQ(responses.front().data.at(0), 0x21);
+        EXPECT_EQ(responses.front().data.at(1), 0x01);
+        EXPECT_EQ(Field<uint32_t>(responses.front().data, 4), offset);
+      }
+      return nbPackets;
+    }
+
+    std::vector<HostStubs::Notification> Read(uint8_t command, const char* path, uint32_t offset, uint32_t size) {
+      Packet packet;
+      if (command == 0x10) {
+        packet.Add<uint8_t>(command).Add<uint8_t>(0).Add<uint16_t>(std::strlen(path)).Add<uint32_t>(offset).Add<uint32_t>(size).Add(path);
+      } else {
+        packet.Add<uint8_t>(command).Add<uint8_t>(0x01).Add<uint16_t>(0).Add<uint32_t>(offset).Add<uint32_t>(size);
+      }
+      return Write(packet);
+    }
+
+    // Downloads the file chunk by chunk, as large as the client asks
+    std::vector<uint8_t> Download(const char* path, uint32_t chunkRequest = 4096) {
+      std::vector<uint8_t> content;
+      uint32_t totalSize = 1;
+      while (content.size() < totalSize) {
+        const auto responses = Read(content.empty() ? 0x10 : 0x12, path, content.size(), chunkRequest);
+        EXPECT_EQ(responses.size(), 1U);
+        if (responses.size() != 1) {
+          break;
+        }
+        const std::vector<uint8_t>& response = responses.front().data;
+        EXPECT_EQ(response.at(0), 0x11);
+        EXPECT_EQ(response.at(1), 0x01);
+        EXPECT_EQ(Field<uint32_t>(response, 4), content.size());
+        totalSize = Field<uint32_t>(response, 8);
+        const uint32_t chunkSize = Field<uint32_t>(response, 12);
+        EXPECT_EQ(response.size(), readResponseSize + chunkSize);
+        EXPECT_LE(chunkSize, HostStubs::attMtu - 3U - readResponseSize);
+        if (chunkSize == 0) {
+          break;
+        }
+        content.insert(content.end(), response.begin() + readResponseSize, response.end());
+      }
+      return content;
+    }
+
+    size_t CountMessages(Messages message) const {
+      return std::count(systemTask.messages.begin(), systemTask.messages.end(), message);
+    }
+  };
+}
+
+TEST_F(FSServiceTest, UploadThenDownloadTheSameFile) {
+  const std::vector<uint8_t> content = FileContent(10000);
+  Upload("/test.bin", content);
+  EXPECT_EQ(fs.Content("/test.bin"), content);
+  EXPECT_EQ(fs.OpenFiles(), 0);
+
+  EXPECT_EQ(Download("/test.bin"), content);
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(linkPolicy.transferBytes, 2 * content.size());
+}
+
+TEST_F(FSServiceTest, ChunksAreAsLargeAsTheMtuAllows) {
+  const std::vector<uint8_t> content = FileContent(1000);
+  for (const uint16_t mtu : {23, 100, 247}) {
+    HostStubs::attMtu = mtu;
+    const size_t nbPackets = Upload("/test.bin", content);
+    EXPECT_EQ(nbPackets, (content.size() + mtu - 3 - writeDataSize - 1) / (mtu - 3 - writeDataSize));
+    EXPECT_EQ(Download("/test.bin"), content);
+  }
+}
+
+TEST_F(FSServiceTest, TransferWakesTheSystemTaskOnce) {
+  Upload("/test.bin", FileContent(5000));
+  EXPECT_EQ(CountMessages(Messages::StartFileTransfer), 1U);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+  // Opened once to write, closed when the last chunk is received
+  EXPECT_EQ(fs.statistics.opens, 1U);
+  EXPECT_EQ(fs.statistics.closes, 1U);
+
+  systemTask.messages.clear();
+  Download("/test.bin");
+  EXPECT_EQ(CountMessages(Messages::StartFileTransfer), 1U);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+}
+
+TEST_F(FSServiceTest, IdleSessionIsClosedAfterTheTimeout) {
+  const std::vector<uint8_t> content = FileContent(1000);
+  WriteHeader("/test.bin", content.size());
+  WriteData(0, std::vector<uint8_t>(content.begin(), content.begin() + 200));
+  EXPECT_EQ(fs.OpenFiles(), 1);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 0U);
+
+  // Each packet restarts the timer
+  HostStubs::AdvanceTicks(sessionTimeout - 1);
+  WriteData(200, std::vector<uint8_t>(content.begin() + 200, content.begin() + 400));
+  HostStubs::AdvanceTicks(sessionTimeout - 1);
+  EXPECT_EQ(fs.OpenFiles(), 1);
+
+  // The client stopped : the timer task only notifies the system task, which closes the file and may sleep
+  HostStubs::AdvanceTicks(1);
+  EXPECT_EQ(CountMessages(Messages::FileTransferSessionTimeout), 1U);
+  EXPECT_EQ(fs.OpenFiles(), 1);
+  service->OnSessionTimeout();
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+  EXPECT_EQ(fs.Content("/test.bin").size(), 400U);
+
+  // A late packet opens the file again
+  WriteData(400, std::vector<uint8_t>(content.begin() + 400, content.end()));
+  EXPECT_EQ(fs.Content("/test.bin"), content);
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(CountMessages(Messages::StartFileTransfer), CountMessages(Messages::StopFileTransfer));
+}
+
+TEST_F(FSServiceTest, PacketReceivedBeforeTheTimeoutIsHandledKeepsTheSession) {
+  const std::vector<uint8_t> content = FileContent(1000);
+  WriteHeader("/test.bin", content.size());
+  WriteData(0, std::vector<uint8_t>(content.begin(), content.begin() + 200));
+  HostStubs::AdvanceTicks(sessionTimeout);
+  EXPECT_EQ(CountMessages(Messages::FileTransferSessionTimeout), 1U);
+
+  // The packet restarted the timer before the system task handled the message
+  WriteData(200, std::vector<uint8_t>(content.begin() + 200, content.begin() + 400));
+  service->OnSessionTimeout();
+  EXPECT_EQ(fs.OpenFiles(), 1);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 0U);
+}
+
+TEST_F(FSServiceTest, CompleteTransferStopsTheTimer) {
+  Upload("/test.bin", FileContent(1000));
+  systemTask.messages.clear();
+  HostStubs::AdvanceTicks(sessionTimeout);
+  EXPECT_TRUE(systemTask.messages.empty());
+}
+
+TEST_F(FSServiceTest, DisconnectionEndsTheTransfer) {
+  const std::vector<uint8_t> content = FileContent(1000);
+  WriteHeader("/test.bin", content.size());
+  WriteData(0, std::vector<uint8_t>(content.begin(), content.begin() + 200));
+  service->OnDisconnect();
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+
+  HostStubs::AdvanceTicks(sessionTimeout);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+}
+
+TEST_F(FSServiceTest, ReadOfMissingFileReturnsTheError) {
+  const auto responses = Read(0x10, "/missing.bin", 0, 100);
+  ASSERT_EQ(responses.size(), 1U);
+  EXPECT_EQ(static_cast<int8_t>(responses.front().data.at(1)), LFS_ERR_NOENT);
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(CountMessages(Messages::StartFileTransfer), CountMessages(Messages::StopFileTransfer));
+}
+
+TEST_F(FSServiceTest, WriteErrorEndsTheTransfer) {
+  const std::vector<uint8_t> content = FileContent(1000);
+  WriteHeader("/test.bin", content.size());
+  fs.writesBeforeFailure = 0;
+  const auto responses = WriteData(0, std::vector<uint8_t>(content.begin(), content.begin() + 200));
+  ASSERT_EQ(responses.size(), 1U);
+  EXPECT_EQ(static_cast<int8_t>(responses.front().data.at(1)), LFS_ERR_NOSPC);
+  EXPECT_EQ(fs.OpenFiles(), 0);
+  EXPECT_EQ(CountMessages(Messages::StopFileTransfer), 1U);
+}
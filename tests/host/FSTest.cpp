@@ -0,0 +1,123 @@
+#include "components/fs/FS.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "drivers/SpiNorFlash.h"
+
+using Pinetime::Controllers::FS;
+using Pinetime::Drivers::SpiNorFlash;
+
+// The FS of the firmware with littlefs, on the flash memory in RAM of stubs/drivers/SpiNorFlash.h
+namespace {
+  // Start of the file system in the flash memory, after the bootloader assets and the OTA area
+  constexpr size_t fsStartAddress = 0x0B4000;
+
+  std::vector<uint8_t> Data(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+      data[i] = static_cast<uint8_t>(i * 13 + seed);
+    }
+    return data;
+  }
+
+  class FSTest : public ::testing::Test {
+  protected:
+    SpiNorFlash flash;
+    std::unique_ptr<FS> fs;
+
+    void SetUp() override {
+      Mount();
+    }
+
+    // New FS on the same flash memory, as after a reset of the watch
+    void Mount() {
+      fs = std::make_unique<FS>(flash);
+      fs->Init();
+    }
+
+    void WriteFile(const char* path, const std::vector<uint8_t>& data) {
+      lfs_file_t file {};
+      ASSERT_EQ(fs->FileOpen(&file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC), LFS_ERR_OK);
+      ASSERT_EQ(fs->FileWrite(&file, data.data(), data.size()), static_cast<int>(data.size()));
+      ASSERT_EQ(fs->FileClose(&file), LFS_ERR_OK);
+    }
+
+    // Content of the file, read by pieces of pieceSize bytes
+    std::vector<uint8_t> ReadFile(const char* path, size_t pieceSize = 64) {
+      std::vector<uint8_t> data;
+      lfs_file_t file {};
+      if (fs->FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+        return data;
+      }
+      std::vector<uint8_t> piece(pieceSize);
+      int read;
+      while ((read = fs->FileRead(&file, piece.data(), piece.size())) > 0) {
+        data.insert(data.end(), piece.begin(), piece.begin() + read);
+      }
+      fs->FileClose(&file);
+      return data;
+    }
+  };
+
+  std::vector<std::string> listedNames;
+
+  int ListName(FS& /*fs*/, lfs_info& info) {
+    listedNames.emplace_back(info.name);
+    return 0;
+  }
+}
+
+TEST_F(FSTest, FormatsTheBlankMemoryAndKeepsTheFilesAfterAReset) {
+  const std::vector<uint8_t> data = Data(10000, 1);
+  WriteFile("/data.bin", data);
+  Mount();
+  EXPECT_EQ(ReadFile("/data.bin"), data);
+}
+
+TEST_F(FSTest, OnlyWritesInItsPartOfTheMemory) {
+  WriteFile("/data.bin", Data(50000, 2));
+  EXPECT_TRUE(std::all_of(flash.memory.begin(), flash.memory.begin() + fsStartAddress, [](uint8_t byte) {
+    return byte == 0xff;
+  }));
+}
+
+TEST_F(FSTest, RenamesAndDeletesFiles) {
+  const std::vector<uint8_t> data = Data(300, 3);
+  WriteFile("/old.bin", data);
+  ASSERT_EQ(fs->Rename("/old.bin", "/new.bin"), LFS_ERR_OK);
+  lfs_info info;
+  EXPECT_EQ(fs->Stat("/old.bin", &info), LFS_ERR_NOENT);
+  ASSERT_EQ(fs->Stat("/new.bin", &info), LFS_ERR_OK);
+  EXPECT_EQ(info.size, data.size());
+
+  ASSERT_EQ(fs->FileDelete("/new.bin"), LFS_ERR_OK);
+  EXPECT_EQ(fs->Stat("/new.bin", &info), LFS_ERR_NOENT);
+}
+
+TEST_F(FSTest, ListsTheDirectories) {
+  ASSERT_EQ(fs->EnsureDirectory("/dir"), LFS_ERR_OK);
+  ASSERT_EQ(fs->EnsureDirectory("/dir"), LFS_ERR_OK);
+  WriteFile("/dir/a", Data(10, 4));
+  WriteFile("/dir/b", Data(10, 5));
+
+  listedNames.clear();
+  ASSERT_EQ(fs->DirList("/dir", ListName), LFS_ERR_OK);
+  std::sort(listedNames.begin(), listedNames.end());
+  EXPECT_EQ(listedNames, (std::vector<std::string> {".", "..", "a", "b"}));
+}
+
+// The small reads of littlefs are served by the lines of the read cache, which are dropped when their block is written
+TEST_F(FSTest, ReadCacheHoldsTheSmallReads) {
+  WriteFile("/small.bin", Data(200, 6));
+  const FS::ReadCacheStatistics before = fs->GetReadCacheStatistics();
+  EXPECT_EQ(ReadFile("/small.bin", 16), Data(200, 6));
+  EXPECT_EQ(ReadFile("/small.bin", 16), Data(200, 6));
+  const FS::ReadCacheStatistics after = fs->GetReadCacheStatistics();
+  EXPECT_GT(after.hits - before.hits, after.misses - before.misses);
+
+  WriteFile("/small.bin", Data(200, 7));
+  EXPECT_EQ(ReadFile("/small.bin", 16), Data(200, 7));
+}
@@ -0,0 +1,49 @@
+#include "components/heartrate/FixedPointFft.h"
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+#ifdef HOST_ARDUINOFFT
+  #define sqrt_internal sqrtf
+  #define FFT_SPEED_OVER_PRECISION
+  #include "libs/arduinoFFT/src/arduinoFFT.h"
+#endif
+
+using Pinetime::Controllers::FixedPointFft;
+
+// Duration of the FFT of the windows of the synthetic signals, with ArduinoFFT (when its submodule is checked out) and
+// with the Q15 and Q31 FixedPointFft
+TEST(FixedPointFftBenchmark, Magnitude) {
+  std::vector<std::vector<float>> windows;
+  for (int bpm : {45, 72, 120, 180}) {
+    const std::vector<uint16_t> samples = HostTests::SyntheticPpg(bpm, 600);
+    for (size_t start = 0; start + HostTests::ppgWindowLength <= samples.size(); start += 5) {
+      windows.push_back(HostTests::Windowed(samples.data() + start));
+    }
+  }
+  constexpr size_t nbCalls = 100000;
+  std::array<float, FixedPointFft::spectrumLength> spectrum;
+
+#ifdef HOST_ARDUINOFFT
+  std::array<float, FixedPointFft::length> vReal;
+  std::array<float, FixedPointFft::length> vImag;
+  const HostTests::PerCall arduinoFft = HostTests::MeasurePerCall(nbCalls, [&](size_t i) {
+    const std::vector<float>& window = windows[i % windows.size()];
+    std::copy(window.begin(), window.end(), vReal.begin());
+    vImag.fill(0.0f);
+    ArduinoFFT<float> fft(vReal.data(), vImag.data(), FixedPointFft::length, 1000.0f / HostTests::ppgDeltaTms);
+    fft.compute(FFTDirection::Forward);
+    fft.complexToMagnitude();
+  });
+  HostTests::Report("ArduinoFFT", arduinoFft);
+#endif
+  const HostTests::PerCall q15 = HostTests::MeasurePerCall(nbCalls, [&](size_t i) {
+    FixedPointFft::MagnitudeQ15(windows[i % windows.size()].data(), spectrum.data());
+  });
+  const HostTests::PerCall q31 = HostTests::MeasurePerCall(nbCalls, [&](size_t i) {
+    FixedPointFft::MagnitudeQ31(windows[i % windows.size()].data(), spectrum.data());
+  });
+  HostTests::Report("Q15", q15);
+  HostTests::Report("Q31", q31);
+}
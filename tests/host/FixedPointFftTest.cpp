@@ -0,0 +1,119 @@
+#include "components/heartrate/FixedPointFft.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+
+using Pinetime::Controllers::FixedPointFft;
+
+namespace {
+  using Magnitude = void (*)(const float*, float*);
+
+  struct Deviation {
+    // Largest deviation from the DFT, relative to its highest bin (ppm)
+    double ppmOfPeak = 0.0;
+    int peakMismatches = 0;
+    int nbWindows = 0;
+  };
+
+  void Compare(Magnitude magnitude, const std::vector<float>& window, Deviation& deviation) {
+    std::array<float, FixedPointFft::spectrumLength> spectrum;
+    magnitude(window.data(), spectrum.data());
+    const std::vector<double> reference = HostTests::DftMagnitude(window.data(), window.size(), spectrum.size());
+    const double peak = *std::max_element(reference.begin(), reference.end());
+    for (size_t k = 0; k < spectrum.size(); k++) {
+      deviation.ppmOfPeak = std::max(deviation.ppmOfPeak, std::abs(spectrum[k] - reference[k]) * 1e6 / peak);
+    }
+    if (HostTests::PeakBin(spectrum) != HostTests::PeakBin(reference)) {
+      deviation.peakMismatches++;
+    }
+    deviation.nbWindows++;
+  }
+
+  // Windows of 64 samples every 5 samples (update rate of Ppg)
+  void CompareWindows(Magnitude magnitude, const std::vector<uint16_t>& samples, Deviation& deviation) {
+    for (size_t start = 0; start + HostTests::ppgWindowLength <= samples.size(); start += 5) {
+      Compare(magnitude, HostTests::Windowed(samples.data() + start), deviation);
+    }
+  }
+
+  Deviation SyntheticDeviation(Magnitude magnitude) {
+    Deviation deviation;
+    for (int bpm : {45, 72, 120, 180}) {
+      for (float amplitude : {10.0f, 100.0f, 1000.0f}) {
+        CompareWindows(magnitude, HostTests::SyntheticPpg(bpm, 600, amplitude), deviation);
+      }
+    }
+    return deviation;
+  }
+}
+
+TEST(FixedPointFft, SinusoidIsInItsBin) {
+  std::array<float, FixedPointFft::length> signal;
+  for (size_t n = 0; n < signal.size(); n++) {
+    signal[n] = 100.0f * std::cos(2.0f * static_cast<float>(M_PI) * 5.0f * static_cast<float>(n) / signal.size());
+  }
+  for (Magnitude magnitude : {FixedPointFft::MagnitudeQ15, FixedPointFft::MagnitudeQ31}) {
+    std::array<float, FixedPointFft::spectrumLength> spectrum;
+    magnitude(signal.data(), spectrum.data());
+    // Same unit as ArduinoFFT : amplitude * N / 2
+    EXPECT_NEAR(spectrum[5], 100.0f * FixedPointFft::length / 2, 5.0f);
+    for (size_t k = 0; k < spectrum.size(); k++) {
+      if (k != 5) {
+        EXPECT_LT(spectrum[k], 5.0f) << "bin " << k;
+      }
+    }
+  }
+}
+
+TEST(FixedPointFft, NullSignalHasNullSpectrum) {
+  std::array<float, FixedPointFft::length> signal {};
+  std::array<float, FixedPointFft::spectrumLength> spectrum;
+  spectrum.fill(1.0f);
+  FixedPointFft::MagnitudeQ15(signal.data(), spectrum.data());
+  EXPECT_TRUE(std::all_of(spectrum.begin(), spectrum.end(), [](float value) {
+    return value == 0.0f;
+  }));
+}
+
+TEST(FixedPointFft, InPlace) {
+  std::vector<float> window = HostTests::Windowed(HostTests::SyntheticPpg(72, 64).data());
+  std::array<float, FixedPointFft::spectrumLength> expected;
+  FixedPointFft::MagnitudeQ31(window.data(), expected.data());
+  FixedPointFft::MagnitudeQ31(window.data(), window.data());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), window.begin()));
+}
+
+// Accuracy on the synthetic signals of the benchmarks of Ppg, at 3 amplitudes of the pulse
+TEST(FixedPointFft, AccuracyOnSyntheticSignals) {
+  const Deviation q15 = SyntheticDeviation(FixedPointFft::MagnitudeQ15);
+  const Deviation q31 = SyntheticDeviation(FixedPointFft::MagnitudeQ31);
+  HostTests::Report("Q15 deviation", q15.ppmOfPeak, "ppm of the peak");
+  HostTests::Report("Q31 deviation", q31.ppmOfPeak, "ppm of the peak");
+  EXPECT_LT(q15.ppmOfPeak, 3000.0);
+  EXPECT_LT(q31.ppmOfPeak, 300.0);
+  EXPECT_EQ(q15.peakMismatches, 0);
+  EXPECT_EQ(q31.peakMismatches, 0);
+}
+
+// Accuracy on a trace recorded on a watch : PPG_TRACE=<file of raw samples, one per line>
+TEST(FixedPointFft, AccuracyOnRecordedTrace) {
+  const std::vector<uint16_t> samples = HostTests::RecordedPpg();
+  if (samples.size() < HostTests::ppgWindowLength) {
+    GTEST_SKIP() << "PPG_TRACE is not set";
+  }
+  Deviation q15;
+  Deviation q31;
+  CompareWindows(FixedPointFft::MagnitudeQ15, samples, q15);
+  CompareWindows(FixedPointFft::MagnitudeQ31, samples, q31);
+  HostTests::Report("windows", q15.nbWindows, "");
+  HostTests::Report("Q15 deviation", q15.ppmOfPeak, "ppm of the peak");
+  HostTests::Report("Q15 peak mismatches", q15.peakMismatches, "windows");
+  HostTests::Report("Q31 deviation", q31.ppmOfPeak, "ppm of the peak");
+  HostTests::Report("Q31 peak mismatches", q31.peakMismatches, "windows");
+  EXPECT_LT(q15.ppmOfPeak, 3000.0);
+  EXPECT_LT(q31.ppmOfPeak, 300.0);
+}
@@ -0,0 +1,122 @@
+#include "displayapp/GlyphCache.h"
+#include <array>
+#include <string>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "TextScreen.h"
+
+using Pinetime::Components::GlyphCache;
+using HostTests::GlyphHeader;
+using HostTests::GlyphSource;
+using HostTests::TextScreen;
+
+namespace {
+  // Cache of RemoteGlyphFont before GlyphCache : the payloads (metrics and bitmap) of the last 24 glyphs looked up,
+  // allocated in a 2KB ring buffer and evicted in FIFO order. Measuring a line loads the bitmaps of its glyphs.
+  class FifoGlyphCache {
+  public:
+    explicit FifoGlyphCache(GlyphCache::Source& source) : source {source} {
+    }
+
+    const GlyphHeader* Metrics(uint16_t codePoint) {
+      const CachedGlyph* glyph = Find(codePoint);
+      if (glyph == nullptr) {
+        glyph = Load(codePoint);
+      }
+      return glyph == nullptr ? nullptr : reinterpret_cast<const GlyphHeader*>(&bitmapPool[glyph->offset]);
+    }
+
+    const uint8_t* Bitmap(uint16_t codePoint) {
+      const CachedGlyph* glyph = Find(codePoint);
+      return glyph == nullptr ? nullptr : &bitmapPool[glyph->offset + sizeof(GlyphHeader)];
+    }
+
+  private:
+    struct CachedGlyph {
+      uint16_t codePoint;
+      uint16_t offset;
+      uint16_t size;
+      bool valid;
+    };
+
+    const CachedGlyph* Find(uint16_t codePoint) const {
+      for (const auto& glyph : glyphs) {
+        if (glyph.valid && glyph.codePoint == codePoint) {
+          return &glyph;
+        }
+      }
+      return nullptr;
+    }
+
+    const CachedGlyph* Load(uint16_t codePoint) {
+      const int size = source.GlyphSize(codePoint);
+      if (size < static_cast<int>(sizeof(GlyphHeader)) || size > static_cast<int>(bitmapPool.size())) {
+        return nullptr;
+      }
+      if (poolHead + size > static_cast<int>(bitmapPool.size())) {
+        poolHead = 0;
+      }
+      const uint16_t begin = poolHead;
+      const uint16_t end = poolHead + size;
+      for (auto& glyph : glyphs) {
+        if (glyph.valid && glyph.offset < end && begin < glyph.offset + glyph.size) {
+          glyph.valid = false;
+        }
+      }
+      CachedGlyph& slot = glyphs[nextSlot];
+      nextSlot = (nextSlot + 1) % glyphs.size();
+      slot.valid = false;
+      if (source.Read(codePoint, &bitmapPool[begin], size) != size) {
+        return nullptr;
+      }
+      slot = {codePoint, begin, static_cast<uint16_t>(size), true};
+      poolHead = end;
+      return &slot;
+    }
+
+    GlyphCache::Source& source;
+    std::array<uint8_t, 2048> bitmapPool;
+    std::array<CachedGlyph, 24> glyphs = {};
+    uint16_t poolHead = 0;
+    uint8_t nextSlot = 0;
+  };
+
+  // Draws the screen until the cache is warm, then reports the reads of the flash memory per frame and the lookups per second
+  template <class Cache>
+  void Run(const std::string& name, const TextScreen& screen, GlyphSource& source, Cache& cache) {
+    screen.Draw(cache);
+    constexpr size_t nbFrames = 20;
+    source.reads = 0;
+    source.bytesRead = 0;
+    uint32_t lookups = 0;
+    const HostTests::PerCall frame = HostTests::MeasurePerCall(nbFrames, [&](size_t) {
+      lookups += screen.Draw(cache);
+    });
+    HostTests::Report(name + " reads", static_cast<double>(source.reads) / nbFrames, "reads per frame");
+    HostTests::Report(name + " bytes", static_cast<double>(source.bytesRead) / nbFrames, "bytes read per frame");
+    HostTests::Report(name + " hit rate", 100.0 * (1.0 - static_cast<double>(source.reads) / lookups), "% of the lookups");
+    HostTests::Report(name + " lookups", lookups / (frame.nanoseconds * nbFrames / 1e9), "lookups/s");
+    HostTests::Report(name + " frame", frame);
+  }
+
+  // Notification of 8 lines of 12 ideographs, 4-line stripes
+  void Compare(int top) {
+    constexpr uint16_t firstIdeograph = 0x4e00;
+    GlyphSource source;
+    source.AddIdeographs(firstIdeograph, 8 * 12);
+    const TextScreen screen = TextScreen::Ideographs(firstIdeograph, 8, 12, top);
+
+    FifoGlyphCache fifo {source};
+    Run("FIFO", screen, source, fifo);
+    GlyphCache cache {source};
+    Run("GlyphCache", screen, source, cache);
+  }
+}
+
+TEST(GlyphCacheBenchmark, ScreenOfIdeographs) {
+  Compare(0);
+}
+
+TEST(GlyphCacheBenchmark, ScreenOfIdeographsAcrossStripes) {
+  Compare(2);
+}
@@ -0,0 +1,146 @@
+#include "displayapp/GlyphCache.h"
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include "TextScreen.h"
+
+using Pinetime::Components::GlyphCache;
+using HostTests::GlyphHeader;
+using HostTests::GlyphPayload;
+using HostTests::GlyphSource;
+using HostTests::TextScreen;
+
+namespace {
+  constexpr uint16_t firstIdeograph = 0x4e00;
+
+  class GlyphCacheTest : public ::testing::Test {
+  protected:
+    GlyphSource source;
+    GlyphCache cache {source};
+
+    void ExpectBitmap(uint16_t codePoint) {
+      const uint8_t* bitmap = cache.Bitmap(codePoint);
+      ASSERT_NE(bitmap, nullptr) << "code point " << codePoint;
+      const std::vector<uint8_t>& payload = source.glyphs[codePoint];
+      EXPECT_EQ(std::memcmp(bitmap, payload.data() + sizeof(GlyphHeader), payload.size() - sizeof(GlyphHeader)), 0)
+        << "code point " << codePoint;
+    }
+
+    // Draws count glyphs from first and returns the number of glyphs read from the source
+    uint32_t DrawGlyphs(uint16_t first, uint16_t count) {
+      const uint32_t reads = source.reads;
+      for (uint16_t codePoint = first; codePoint < first + count; codePoint++) {
+        ExpectBitmap(codePoint);
+      }
+      return source.reads - reads;
+    }
+  };
+}
+
+TEST_F(GlyphCacheTest, MetricsAreReadWithoutTheBitmap) {
+  source.AddIdeographs(firstIdeograph, 1);
+  const GlyphHeader* header = cache.Metrics(firstIdeograph);
+  ASSERT_NE(header, nullptr);
+  EXPECT_EQ(header->boxWidth, 18);
+  EXPECT_EQ(header->boxHeight, 19);
+  EXPECT_EQ(header->bpp, 4);
+  EXPECT_EQ(source.reads, 1U);
+  EXPECT_EQ(source.bytesRead, sizeof(GlyphHeader));
+
+  ASSERT_NE(cache.Metrics(firstIdeograph), nullptr);
+  EXPECT_EQ(source.reads, 1U);
+}
+
+TEST_F(GlyphCacheTest, MetricsOfACachedBitmapAreNotRead) {
+  source.AddIdeographs(firstIdeograph, 1);
+  ExpectBitmap(firstIdeograph);
+  ASSERT_NE(cache.Metrics(firstIdeograph), nullptr);
+  EXPECT_EQ(source.reads, 1U);
+}
+
+TEST_F(GlyphCacheTest, MetricsOfAScreenOfGlyphsStayCached) {
+  constexpr uint16_t nbGlyphs = GlyphCache::nbMetricsSets * GlyphCache::nbMetricsWays;
+  source.AddIdeographs(firstIdeograph, nbGlyphs);
+  for (uint16_t codePoint = firstIdeograph; codePoint < firstIdeograph + nbGlyphs; codePoint++) {
+    ASSERT_NE(cache.Metrics(codePoint), nullptr);
+  }
+  const uint32_t reads = source.reads;
+  for (uint16_t codePoint = firstIdeograph; codePoint < firstIdeograph + nbGlyphs; codePoint++) {
+    ASSERT_NE(cache.Metrics(codePoint), nullptr);
+  }
+  EXPECT_EQ(source.reads, reads);
+}
+
+TEST_F(GlyphCacheTest, MissingGlyphIsNotFound) {
+  EXPECT_EQ(cache.Metrics(firstIdeograph), nullptr);
+  EXPECT_EQ(cache.Bitmap(firstIdeograph), nullptr);
+  EXPECT_EQ(cache.Metrics(0), nullptr);
+}
+
+TEST_F(GlyphCacheTest, GlyphWhoseHeaderDoesNotMatchThePayloadIsRejected) {
+  source.glyphs[0x4e00] = GlyphPayload(0x4e00, 18, 19, 3);
+  source.glyphs[0x4e01] = GlyphPayload(0x4e01, 18, 19);
+  source.glyphs[0x4e01].resize(100);
+  source.glyphs[0x4e02] = std::vector<uint8_t>(4);
+  for (uint16_t codePoint = 0x4e00; codePoint <= 0x4e02; codePoint++) {
+    EXPECT_EQ(cache.Metrics(codePoint), nullptr) << "code point " << codePoint;
+    EXPECT_EQ(cache.Bitmap(codePoint), nullptr) << "code point " << codePoint;
+  }
+}
+
+TEST_F(GlyphCacheTest, GlyphsLargerThanASlotUseConsecutiveSlots) {
+  // 4 bytes per row : 1 slot for the small glyphs, 3 slots for the large ones
+  for (uint16_t i = 0; i < 40; i++) {
+    source.glyphs[firstIdeograph + i] = GlyphPayload(firstIdeograph + i, 8, i % 5 == 0 ? 60 : 20);
+  }
+  for (int frame = 0; frame < 3; frame++) {
+    for (uint16_t i = 0; i < 40; i++) {
+      ExpectBitmap(firstIdeograph + (i * 7) % 40);
+    }
+  }
+}
+
+TEST_F(GlyphCacheTest, GlyphLargerThanTheCacheIsRejected) {
+  source.glyphs[firstIdeograph] = GlyphPayload(firstIdeograph, 100, 100, 8);
+  EXPECT_NE(cache.Metrics(firstIdeograph), nullptr);
+  EXPECT_EQ(cache.Bitmap(firstIdeograph), nullptr);
+}
+
+TEST_F(GlyphCacheTest, LeastRecentlyUsedBitmapIsEvicted) {
+  source.AddIdeographs(firstIdeograph, 100);
+  constexpr uint16_t nbGlyphs = GlyphCache::maxIdeographsPerLine;
+  EXPECT_EQ(DrawGlyphs(firstIdeograph, nbGlyphs), nbGlyphs);
+
+  EXPECT_EQ(DrawGlyphs(firstIdeograph, 1), 0U);
+  EXPECT_EQ(DrawGlyphs(firstIdeograph + 50, 1), 1U);
+  EXPECT_EQ(DrawGlyphs(firstIdeograph, 1), 0U);
+  EXPECT_EQ(DrawGlyphs(firstIdeograph + 2, nbGlyphs - 2), 0U);
+  EXPECT_EQ(DrawGlyphs(firstIdeograph + 1, 1), 1U);
+}
+
+TEST_F(GlyphCacheTest, LineOfIdeographsFitsInTheCache) {
+  constexpr uint16_t nbGlyphs = GlyphCache::maxIdeographsPerLine;
+  source.AddIdeographs(firstIdeograph, nbGlyphs);
+  EXPECT_EQ(DrawGlyphs(firstIdeograph, nbGlyphs), nbGlyphs);
+  for (int stripe = 0; stripe < 6; stripe++) {
+    EXPECT_EQ(DrawGlyphs(firstIdeograph, nbGlyphs), 0U);
+  }
+}
+
+// 8 lines of 12 ideographs : after the first frame, the metrics are never read again and each bitmap is read once per
+// frame, also when the stripes cross 2 lines
+TEST_F(GlyphCacheTest, EachBitmapIsReadOncePerFrame) {
+  constexpr uint32_t nbGlyphs = 8 * 12;
+  source.AddIdeographs(firstIdeograph, nbGlyphs);
+  for (const int top : {0, 2}) {
+    const TextScreen screen = TextScreen::Ideographs(firstIdeograph, 8, 12, top);
+    screen.Draw(cache);
+    for (int frame = 0; frame < 3; frame++) {
+      source.reads = 0;
+      source.bytesRead = 0;
+      screen.Draw(cache);
+      EXPECT_LE(source.reads, nbGlyphs) << "top " << top;
+      EXPECT_EQ(source.bytesRead, source.reads * source.glyphs[firstIdeograph].size()) << "top " << top;
+    }
+  }
+}
@@ -0,0 +1,34 @@
+#include <cstdlib>
+#include <new>
+#include <FreeRTOS.h>
+
+// Replaces operator new in the host tests to count the allocations in HostStubs::heapAllocations, as pvPortMalloc() does :
+// the firmware allocates its objects from the heap of FreeRTOS. The aligned versions of operator new are not counted.
+
+void* operator new(size_t size) {
+  HostStubs::heapAllocations++;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc {};
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t /*size*/) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,212 @@
+#include "components/heartrate/HeartRateHistory.h"
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "components/datetime/DateTimeController.h"
+#include "components/fs/FS.h"
+#include "systemtask/SystemTask.h"
+
+using Pinetime::Controllers::DateTime;
+using Pinetime::Controllers::FS;
+using Pinetime::Controllers::HeartRateHistory;
+using Pinetime::System::Messages;
+using Pinetime::System::SystemTask;
+
+namespace {
+  constexpr uint32_t startTime = 1700000000;
+  constexpr const char* journalPath = "/.system/hrlog.dat";
+
+  class HeartRateHistoryTest : public ::testing::Test {
+  protected:
+    FS fs;
+    DateTime dateTime;
+    SystemTask systemTask;
+    std::unique_ptr<HeartRateHistory> history;
+
+    void SetUp() override {
+      Reboot();
+    }
+
+    // New history on the same file system, as after a reset of the watch
+    void Reboot() {
+      history.reset();
+      fs.Reset();
+      systemTask.messages.clear();
+      history = std::make_unique<HeartRateHistory>(fs, dateTime);
+      history->Init();
+      history->Register(&systemTask);
+    }
+
+    // Readings over the sample interval that ends at time, then the messages of SystemTask are handled
+    void AddSample(uint32_t time, uint8_t heartRate) {
+      dateTime.utcSeconds = time - HeartRateHistory::sampleInterval;
+      history->AddReading(heartRate);
+      dateTime.utcSeconds = time;
+      history->AddReading(heartRate);
+      for (const Messages message : systemTask.messages) {
+        if (message == Messages::OnHeartRateHistoryBlock) {
+          history->Flush();
+        }
+      }
+      systemTask.messages.clear();
+    }
+
+    // Samples every 10s from time, each one in a new record (the heart rate changes by more than 63 BPM)
+    uint32_t AddRecords(uint32_t time, uint32_t nbRecords) {
+      for (uint32_t i = 0; i < nbRecords; i++, time += HeartRateHistory::sampleInterval) {
+        AddSample(time, (time / HeartRateHistory::sampleInterval) % 2 == 0 ? 50 : 150);
+      }
+      return time;
+    }
+
+    // Samples of all the records returned by ReadRecords() for [begin, end], read 3 records at a time
+    std::vector<HeartRateHistory::Sample> ReadSamples(uint32_t begin, uint32_t end) {
+      std::vector<HeartRateHistory::Sample> samples;
+      uint32_t cursor = 0;
+      while (ReadMore(begin, end, cursor, samples) > 0) {
+      }
+      return samples;
+    }
+
+    size_t ReadMore(uint32_t begin, uint32_t end, uint32_t& cursor, std::vector<HeartRateHistory::Sample>& samples) {
+      std::array<uint8_t, 3 * HeartRateHistory::recordSize> buffer;
+      const size_t nbRecords = history->ReadRecords(begin, end, cursor, buffer.data(), buffer.size());
+      for (size_t i = 0; i < nbRecords; i++) {
+        std::array<HeartRateHistory::Sample, UINT8_MAX> decoded;
+        const size_t nbSamples = HeartRateHistory::Decode(buffer.data() + i * HeartRateHistory::recordSize, decoded.data(), decoded.size());
+        samples.insert(samples.end(), decoded.begin(), decoded.begin() + nbSamples);
+      }
+      return nbRecords;
+    }
+  };
+}
+
+TEST_F(HeartRateHistoryTest, CompleteBlockIsWrittenBySystemTask) {
+  for (uint32_t i = 0; i < HeartRateHistory::recordsPerBlock; i++) {
+    dateTime.utcSeconds = startTime + i * 20;
+    history->AddReading(i % 2 == 0 ? 50 : 150);
+    dateTime.utcSeconds += HeartRateHistory::sampleInterval;
+    history->AddReading(i % 2 == 0 ? 50 : 150);
+  }
+  EXPECT_TRUE(systemTask.messages.empty());
+  fs.statistics = {};
+
+  // The sample that completes the 4th record
+  AddSample(startTime + 100, 50);
+  EXPECT_EQ(fs.Content(journalPath).size(), HeartRateHistory::recordsPerBlock * HeartRateHistory::recordSize);
+  EXPECT_EQ(history->NbRecords(), HeartRateHistory::recordsPerBlock + 1);
+}
+
+TEST_F(HeartRateHistoryTest, AddReadingDoesNotAccessTheFileSystem) {
+  fs.statistics = {};
+  // maxPendingRecords complete records and a record being filled
+  for (uint32_t i = 0; i <= HeartRateHistory::maxPendingRecords; i++) {
+    dateTime.utcSeconds = startTime + i * 20;
+    history->AddReading(i % 2 == 0 ? 50 : 150);
+    dateTime.utcSeconds += HeartRateHistory::sampleInterval;
+    history->AddReading(i % 2 == 0 ? 50 : 150);
+  }
+  EXPECT_EQ(fs.statistics.opens, 0U);
+  EXPECT_EQ(fs.statistics.writes, 0U);
+  // SystemTask did not handle its message : the records are kept until it does
+  EXPECT_EQ(systemTask.messages.size(), 1U);
+  EXPECT_EQ(history->NbRecords(), HeartRateHistory::maxPendingRecords + 1);
+  history->Flush();
+  EXPECT_EQ(fs.Content(journalPath).size(), HeartRateHistory::maxPendingRecords * HeartRateHistory::recordSize);
+}
+
+TEST_F(HeartRateHistoryTest, FlushedSamplesSurviveAReset) {
+  // 2 complete records, pending, and a record being filled
+  uint32_t time = AddRecords(startTime, 2);
+  for (int i = 0; i < 20; i++, time += HeartRateHistory::sampleInterval) {
+    AddSample(time, 70 + i % 3);
+  }
+  const std::vector<HeartRateHistory::Sample> before = ReadSamples(0, UINT32_MAX);
+  ASSERT_EQ(before.size(), 22U);
+
+  history->Flush();
+  Reboot();
+  const std::vector<HeartRateHistory::Sample> after = ReadSamples(0, UINT32_MAX);
+  ASSERT_EQ(after.size(), before.size());
+  for (size_t i = 0; i < before.size(); i++) {
+    EXPECT_EQ(after[i].time, before[i].time);
+    EXPECT_EQ(after[i].heartRate, before[i].heartRate);
+  }
+  EXPECT_EQ(history->NbRecords(), 3U);
+
+  // The record saved before the reset is not filled anymore, and not saved twice
+  AddSample(time, 70);
+  history->Flush();
+  Reboot();
+  EXPECT_EQ(ReadSamples(0, UINT32_MAX).size(), before.size() + 1);
+  EXPECT_EQ(history->NbRecords(), 4U);
+}
+
+TEST_F(HeartRateHistoryTest, FlushWithoutNewSamplesDoesNotWrite) {
+  AddRecords(startTime, 2);
+  history->Flush();
+  fs.statistics = {};
+  history->Flush();
+  EXPECT_EQ(fs.statistics.writes, 0U);
+}
+
+TEST_F(HeartRateHistoryTest, SamplesOlderThanTheLastOneAreDropped) {
+  uint32_t time = startTime;
+  for (int i = 0; i < 100; i++, time += HeartRateHistory::sampleInterval) {
+    AddSample(time, 70);
+  }
+  // The time is set back by 1 hour, then goes forward again
+  for (int i = 0; i < 500; i++) {
+    AddSample(time - 3600 + i * HeartRateHistory::sampleInterval, 75);
+  }
+  const std::vector<HeartRateHistory::Sample> samples = ReadSamples(0, UINT32_MAX);
+  for (size_t i = 1; i < samples.size(); i++) {
+    ASSERT_LE(samples[i - 1].time, samples[i].time) << "sample " << i;
+  }
+  // The sample at the time of the last one is kept
+  EXPECT_EQ(samples.size(), 100U + 500U - 359U);
+
+  // The records are found by time
+  const std::vector<HeartRateHistory::Sample> lastHour = ReadSamples(time, time + 3600);
+  ASSERT_FALSE(lastHour.empty());
+  EXPECT_LE(lastHour.front().time, time);
+
+  // Also after a reset
+  history->Flush();
+  Reboot();
+  AddSample(time - 600, 80);
+  history->Flush();
+  EXPECT_EQ(ReadSamples(0, UINT32_MAX).size(), samples.size());
+}
+
+TEST_F(HeartRateHistoryTest, CursorSurvivesTheRotationOfTheJournal) {
+  constexpr uint32_t recordsPerJournal = HeartRateHistory::maxJournalSize / HeartRateHistory::recordSize;
+  // The old journal is full, the journal half full
+  uint32_t time = AddRecords(startTime, recordsPerJournal + recordsPerJournal / 2);
+
+  // Reading from the journal : the next records are the same after the rotation
+  std::vector<HeartRateHistory::Sample> samples;
+  const uint32_t journalStart = startTime + recordsPerJournal * HeartRateHistory::sampleInterval;
+  uint32_t cursor = 0;
+  ASSERT_GT(ReadMore(journalStart, UINT32_MAX, cursor, samples), 0U);
+  time = AddRecords(time, recordsPerJournal / 2);
+  ASSERT_GT(ReadMore(journalStart, UINT32_MAX, cursor, samples), 0U);
+  for (size_t i = 1; i < samples.size(); i++) {
+    EXPECT_EQ(samples[i].time, samples[i - 1].time + HeartRateHistory::sampleInterval) << "sample " << i;
+  }
+
+  // Reading from the old journal : the deleted records are skipped, the read goes on with the oldest ones left
+  samples.clear();
+  cursor = 0;
+  ASSERT_GT(ReadMore(0, UINT32_MAX, cursor, samples), 0U);
+  const uint32_t lastBeforeRotation = samples.back().time;
+  time = AddRecords(time, recordsPerJournal);
+  ASSERT_GT(ReadMore(0, UINT32_MAX, cursor, samples), 0U);
+  EXPECT_GT(samples.back().time, lastBeforeRotation);
+  while (ReadMore(0, UINT32_MAX, cursor, samples) > 0) {
+  }
+  for (size_t i = 1; i < samples.size(); i++) {
+    ASSERT_LT(samples[i - 1].time, samples[i].time) << "sample " << i;
+  }
+  EXPECT_EQ(samples.back().time, time - HeartRateHistory::sampleInterval);
+}
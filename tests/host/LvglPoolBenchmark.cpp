@@ -0,0 +1,61 @@
+#include "displayapp/LvglPool.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "LvglTrace.h"
+
+using HostTests::LvglOperation;
+using Pinetime::Components::LvglPool;
+
+// Replays the allocations of an event trace recorded on the watch (LVGL_TRACE, see doc/EventTrace.md) with LvglPool :
+// how many of them the size classes serve, and the peak use of each class, to check their sizes against a real workload.
+TEST(LvglPoolBenchmark, RecordedTrace) {
+  const std::vector<LvglOperation> operations = HostTests::RecordedLvglOperations();
+  if (operations.empty()) {
+    GTEST_SKIP() << "LVGL_TRACE is not set, or the trace holds no allocation of LVGL";
+  }
+
+  LvglPool pool;
+  HostTests::ReplayLvglOperations(
+    operations,
+    [&pool](size_t size) {
+      return pool.Allocate(size);
+    },
+    [&pool](void* block) {
+      pool.Free(block);
+    });
+
+  const LvglPool::Statistics& statistics = pool.GetStatistics();
+  uint32_t nbAllocations = 0;
+  for (const LvglOperation& operation : operations) {
+    nbAllocations += (operation.size > 0) ? 1 : 0;
+  }
+  HostTests::Report("allocations", nbAllocations, "");
+  HostTests::Report("heap allocations", statistics.heapAllocations, "");
+  for (const auto& classStatistics : statistics.classes) {
+    const std::string name = std::to_string(classStatistics.blockSize) + " B class";
+    HostTests::Report(name + " allocations", classStatistics.allocations, "");
+    HostTests::Report(name + " peak", classStatistics.peakUsed, "of " + std::to_string(classStatistics.nbBlocks) + " blocks");
+    HostTests::Report(name + " overflows", classStatistics.overflows, "");
+  }
+
+  constexpr size_t nbRuns = 100;
+  const HostTests::PerCall poolPerCall = HostTests::MeasurePerCall(nbRuns, [&](size_t) {
+    HostTests::ReplayLvglOperations(
+      operations,
+      [&pool](size_t size) {
+        return pool.Allocate(size);
+      },
+      [&pool](void* block) {
+        pool.Free(block);
+      });
+  });
+  const HostTests::PerCall mallocPerCall = HostTests::MeasurePerCall(nbRuns, [&](size_t) {
+    HostTests::ReplayLvglOperations(operations, std::malloc, std::free);
+  });
+  // The allocations of malloc are not counted, only the ones of the pool that fall back on pvPortMalloc()
+  HostTests::Report("pool", poolPerCall / operations.size());
+  HostTests::Report("malloc", mallocPerCall / operations.size());
+}
@@ -0,0 +1,176 @@
+#include "displayapp/LvglPool.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include "LvglTrace.h"
+#include "displayapp/LvglPoolTraces.h"
+
+using HostTests::LvglOperation;
+using Pinetime::Components::LvglPool;
+using Pinetime::System::EventTrace;
+
+namespace {
+  // Event trace of the watch (see doc/EventTrace.md) holding the events given as type and argument
+  std::vector<uint8_t> Trace(const std::vector<std::pair<EventTrace::Type, uint32_t>>& events) {
+    std::vector<uint8_t> trace {'I', 'T', 'E', 'V', 1, 1, 8, 0, 0, 0x80, 0, 0};
+    const auto nbEvents = static_cast<uint32_t>(events.size());
+    trace.insert(trace.end(), reinterpret_cast<const uint8_t*>(&nbEvents), reinterpret_cast<const uint8_t*>(&nbEvents + 1));
+    trace.insert(trace.end(), {0, 0, 0, 0});
+    // Task 1, "IDLE"
+    trace.insert(trace.end(), {1, 'I', 'D', 'L', 'E'});
+    uint32_t time = 0;
+    for (const auto& event : events) {
+      const uint32_t words[2] {(static_cast<uint32_t>(event.first) << 24) | time++, event.second};
+      trace.insert(trace.end(), reinterpret_cast<const uint8_t*>(words), reinterpret_cast<const uint8_t*>(words + 2));
+    }
+    return trace;
+  }
+
+  uint32_t Alloc(uint16_t address, uint16_t size) {
+    return (static_cast<uint32_t>(address) << 16) | size;
+  }
+
+  // Replays a screen of LvglPoolTraces.h and returns the peak number of blocks used in each class
+  template <size_t N>
+  std::array<uint16_t, LvglPool::nbClasses> ReplayScreen(const int16_t (&trace)[N]) {
+    LvglPool pool;
+    std::vector<void*> allocations;
+    for (const int16_t entry : trace) {
+      if (entry > 0) {
+        allocations.push_back(pool.Allocate(entry));
+      } else {
+        void*& allocation = allocations[allocations.size() + entry];
+        pool.Free(allocation);
+        allocation = nullptr;
+      }
+    }
+    std::array<uint16_t, LvglPool::nbClasses> peaks;
+    for (size_t i = 0; i < LvglPool::nbClasses; i++) {
+      EXPECT_EQ(pool.GetStatistics().classes[i].overflows, 0U) << i;
+      peaks[i] = pool.GetStatistics().classes[i].peakUsed;
+    }
+    for (void* allocation : allocations) {
+      if (allocation != nullptr) {
+        pool.Free(allocation);
+      }
+    }
+    return peaks;
+  }
+}
+
+TEST(LvglPoolTest, SmallAllocationGoesToItsSizeClass) {
+  LvglPool pool;
+  void* block = pool.Allocate(20);
+  ASSERT_NE(block, nullptr);
+  const auto& statistics = pool.GetStatistics();
+  EXPECT_EQ(statistics.classes[1].allocations, 1U);
+  EXPECT_EQ(statistics.classes[1].used, 1U);
+  EXPECT_EQ(statistics.heapAllocations, 0U);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 8, 0U);
+
+  pool.Free(block);
+  EXPECT_EQ(statistics.classes[1].used, 0U);
+  EXPECT_EQ(statistics.classes[1].peakUsed, 1U);
+  // The released block is the next one allocated
+  EXPECT_EQ(pool.Allocate(32), block);
+}
+
+TEST(LvglPoolTest, FullClassBorrowsFromTheNextOne) {
+  LvglPool pool;
+  const auto& statistics = pool.GetStatistics();
+  std::vector<void*> blocks;
+  for (uint16_t i = 0; i < statistics.classes[0].nbBlocks + 1; i++) {
+    blocks.push_back(pool.Allocate(16));
+  }
+  EXPECT_EQ(statistics.classes[0].used, statistics.classes[0].nbBlocks);
+  EXPECT_EQ(statistics.classes[1].used, 1U);
+  EXPECT_EQ(statistics.classes[0].allocations, statistics.classes[0].nbBlocks + 1U);
+  EXPECT_EQ(statistics.heapAllocations, 0U);
+
+  // The borrowed block goes back to the class it was taken from
+  pool.Free(blocks.back());
+  EXPECT_EQ(statistics.classes[0].used, statistics.classes[0].nbBlocks);
+  EXPECT_EQ(statistics.classes[1].used, 0U);
+  for (size_t i = 0; i + 1 < blocks.size(); i++) {
+    pool.Free(blocks[i]);
+  }
+  EXPECT_EQ(statistics.classes[0].used, 0U);
+}
+
+TEST(LvglPoolTest, LargeAllocationGoesToTheHeap) {
+  LvglPool pool;
+  void* block = pool.Allocate(200);
+  ASSERT_NE(block, nullptr);
+  const auto& statistics = pool.GetStatistics();
+  EXPECT_EQ(statistics.heapAllocations, 1U);
+  for (const auto& classStatistics : statistics.classes) {
+    EXPECT_EQ(classStatistics.allocations, 0U);
+    EXPECT_EQ(classStatistics.used, 0U);
+  }
+  pool.Free(block);
+}
+
+TEST(LvglPoolTest, AllocationsAreReadFromTheEventTrace) {
+  const std::vector<uint8_t> trace = Trace({
+    // Released before being allocated in the trace
+    {EventTrace::Type::LvglFree, 0x1230},
+    {EventTrace::Type::LvglAlloc, Alloc(0x2000, 80)},
+    {EventTrace::Type::TaskSwitchedIn, 1},
+    {EventTrace::Type::LvglAlloc, Alloc(0x2050, 12)},
+    // Failed
+    {EventTrace::Type::LvglAlloc, Alloc(0, 40)},
+    {EventTrace::Type::LvglFree, 0x2000},
+    {EventTrace::Type::LvglRefreshBegin, 0},
+    // The address of the released block is reused
+    {EventTrace::Type::LvglAlloc, Alloc(0x2000, 24)},
+    {EventTrace::Type::LvglFree, 0x2000},
+  });
+  const std::vector<LvglOperation> operations = HostTests::LvglOperations(trace);
+  ASSERT_EQ(operations.size(), 5U);
+  EXPECT_EQ(operations[0].size, 80);
+  EXPECT_EQ(operations[0].block, 0U);
+  EXPECT_EQ(operations[1].size, 12);
+  EXPECT_EQ(operations[1].block, 1U);
+  EXPECT_EQ(operations[2].size, 0);
+  EXPECT_EQ(operations[2].block, 0U);
+  EXPECT_EQ(operations[3].size, 24);
+  EXPECT_EQ(operations[3].block, 2U);
+  EXPECT_EQ(operations[4].size, 0);
+  EXPECT_EQ(operations[4].block, 2U);
+
+  // The blocks still allocated at the end of the trace are released by the replay
+  LvglPool pool;
+  HostTests::ReplayLvglOperations(
+    operations,
+    [&pool](size_t size) {
+      return pool.Allocate(size);
+    },
+    [&pool](void* block) {
+      pool.Free(block);
+    });
+  for (const auto& classStatistics : pool.GetStatistics().classes) {
+    EXPECT_EQ(classStatistics.used, 0U);
+  }
+  EXPECT_EQ(pool.GetStatistics().heapAllocations, 0U);
+}
+
+// The blocks of each class are twice the peak of the modeled screens (see blockCounts in LvglPool.h)
+TEST(LvglPoolTest, ClassesAreSizedFromTheModeledScreens) {
+  const std::array<uint16_t, LvglPool::nbClasses> expectedPeaks {22, 11, 15, 1, 13};
+  std::array<uint16_t, LvglPool::nbClasses> peaks {};
+  for (const auto& screen : {ReplayScreen(Pinetime::Components::LvglPoolTraces::watchFace),
+                             ReplayScreen(Pinetime::Components::LvglPoolTraces::list),
+                             ReplayScreen(Pinetime::Components::LvglPoolTraces::settings)}) {
+    for (size_t i = 0; i < LvglPool::nbClasses; i++) {
+      peaks[i] = std::max(peaks[i], screen[i]);
+    }
+  }
+  EXPECT_EQ(peaks, expectedPeaks);
+
+  const LvglPool pool;
+  for (size_t i = 0; i < LvglPool::nbClasses; i++) {
+    EXPECT_EQ(pool.GetStatistics().classes[i].nbBlocks, 2 * expectedPeaks[i]) << i;
+  }
+}
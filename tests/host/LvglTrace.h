@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <vector>
+#include "systemtask/EventTrace.h"
+
+// Allocations of LVGL recorded in an event trace of the watch (/.system/trace.bin, see doc/EventTrace.md)
+namespace HostTests {
+  struct LvglOperation {
+    // Size of the allocation, 0 for a release
+    uint16_t size;
+    // Index of the block, in the order of the allocations
+    uint32_t block;
+  };
+
+  // Allocations and releases of the trace, in the order they were recorded. The releases of the blocks allocated before
+  // the first event of the trace, and the failed allocations, are left out.
+  inline std::vector<LvglOperation> LvglOperations(const std::vector<uint8_t>& trace) {
+    constexpr size_t headerSize = 20;
+    constexpr size_t taskSize = 5;
+    std::vector<LvglOperation> operations;
+    if (trace.size() < headerSize || std::memcmp(trace.data(), "ITEV", 4) != 0) {
+      return operations;
+    }
+    const uint8_t nbTasks = trace[5];
+    uint16_t eventSize;
+    uint32_t nbEvents;
+    std::memcpy(&eventSize, trace.data() + 6, sizeof(eventSize));
+    std::memcpy(&nbEvents, trace.data() + 12, sizeof(nbEvents));
+
+    // Blocks that are allocated, by address
+    std::map<uint16_t, uint32_t> blocks;
+    uint32_t nbBlocks = 0;
+    for (size_t offset = headerSize + nbTasks * taskSize; nbEvents > 0 && offset + eventSize <= trace.size();
+         offset += eventSize, nbEvents--) {
+      uint32_t header;
+      uint32_t argument;
+      std::memcpy(&header, trace.data() + offset, sizeof(header));
+      std::memcpy(&argument, trace.data() + offset + sizeof(header), sizeof(argument));
+      const auto type = static_cast<Pinetime::System::EventTrace::Type>(header >> 24);
+      if (type == Pinetime::System::EventTrace::Type::LvglAlloc && (argument >> 16) != 0) {
+        blocks[argument >> 16] = nbBlocks;
+        operations.push_back({static_cast<uint16_t>(argument & 0xffff), nbBlocks++});
+      } else if (type == Pinetime::System::EventTrace::Type::LvglFree) {
+        auto it = blocks.find(argument & 0xffff);
+        if (it != blocks.end()) {
+          operations.push_back({0, it->second});
+          blocks.erase(it);
+        }
+      }
+    }
+    return operations;
+  }
+
+  // Allocations of the trace file named by the environment variable LVGL_TRACE, empty if the variable is not set
+  inline std::vector<LvglOperation> RecordedLvglOperations() {
+    const char* path = std::getenv("LVGL_TRACE");
+    if (path == nullptr) {
+      return {};
+    }
+    std::ifstream file(path, std::ios::binary);
+    return LvglOperations(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+  }
+
+  // Replays the operations with allocate and release, the blocks that are still allocated at the end are released
+  template <class Allocate, class Release>
+  void ReplayLvglOperations(const std::vector<LvglOperation>& operations, Allocate allocate, Release release) {
+    std::vector<void*> blocks;
+    for (const LvglOperation& operation : operations) {
+      if (operation.size > 0) {
+        blocks.resize(operation.block + 1);
+        blocks[operation.block] = allocate(operation.size);
+      } else {
+        release(blocks[operation.block]);
+        blocks[operation.block] = nullptr;
+      }
+    }
+    for (void* block : blocks) {
+      if (block != nullptr) {
+        release(block);
+      }
+    }
+  }
+}
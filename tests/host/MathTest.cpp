@@ -0,0 +1,30 @@
+#include "utility/Math.h"
+#include <cstdint>
+#include <lvgl/src/lv_misc/lv_math.h>
+#include <gtest/gtest.h>
+
+using Pinetime::Utility::Asin;
+
+TEST(Math, AsinOfTheBounds) {
+  EXPECT_EQ(Asin(0), 0);
+  EXPECT_EQ(Asin(32767), 90);
+  EXPECT_EQ(Asin(-32767), -90);
+}
+
+// Asin() is the inverse of the sine of LVGL for each angle in degrees
+TEST(Math, AsinOfTheSineOfEachAngle) {
+  for (int16_t angle = -90; angle <= 90; angle++) {
+    EXPECT_EQ(Asin(_lv_trigo_sin(angle)), angle) << "angle " << angle;
+  }
+}
+
+// The angle never decreases when the value increases, and Asin(-value) is -Asin(value)
+TEST(Math, AsinIsMonotonicAndOdd) {
+  int16_t previous = Asin(-32767);
+  for (int32_t value = -32767; value <= 32767; value++) {
+    const int16_t angle = Asin(static_cast<int16_t>(value));
+    ASSERT_GE(angle, previous) << "value " << value;
+    ASSERT_EQ(Asin(static_cast<int16_t>(-value)), -angle) << "value " << value;
+    previous = angle;
+  }
+}
@@ -0,0 +1,141 @@
+#include "components/motion/MotionController.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "components/motion/SyntheticMotion.h"
+
+using Pinetime::Controllers::MotionController;
+using Pinetime::Drivers::Bma421;
+using Sample = Pinetime::Drivers::Bma421::Sample;
+namespace SyntheticMotion = Pinetime::Controllers::SyntheticMotion;
+
+// MotionController in FIFO acquisition (see CMakeLists.txt), fed batch by batch like SystemTask::UpdateMotion()
+namespace {
+  constexpr size_t batchSize = Bma421::fifoWatermark;
+  constexpr uint16_t shakeThreshold = 150;
+
+  // Time (ms) of the end of the batches in which each gesture was first detected, -1 if it was not
+  struct Detections {
+    int32_t raiseMs = -1;
+    int32_t shakeMs = -1;
+    int32_t lowerMs = -1;
+  };
+
+  // Samples of the FIFO frames at the 2G range, as Bma421::ConvertFifoFrames()
+  void ConvertFifoFrames(Sample* samples, size_t count) {
+    auto* frames = reinterpret_cast<const uint8_t*>(samples);
+    for (size_t i = 0; i < count; i++) {
+      const uint8_t* frame = frames + (i * Bma421::fifoFrameSize);
+      const auto x = static_cast<int16_t>(static_cast<int16_t>(frame[0] | (frame[1] << 8)) / 0x10);
+      const auto y = static_cast<int16_t>(static_cast<int16_t>(frame[2] | (frame[3] << 8)) / 0x10);
+      const auto z = static_cast<int16_t>(static_cast<int16_t>(frame[4] | (frame[5] << 8)) / 0x10);
+      samples[i] = {y, x, z};
+    }
+  }
+
+  // Feeds the samples in batches, the detections of the first ignoredMs are not reported
+  Detections Replay(MotionController& controller, const std::vector<Sample>& samples, int32_t ignoredMs) {
+    Detections detections;
+    for (size_t first = 0; first + batchSize <= samples.size(); first += batchSize) {
+      controller.Update(samples.data() + first, batchSize, 0);
+      const bool raise = controller.ShouldRaiseWake();
+      const bool shake = controller.ShouldShakeWake(shakeThreshold);
+      const bool lower = controller.ShouldLowerSleep();
+      const auto endMs = static_cast<int32_t>((first + batchSize) * 1000 / Bma421::fifoRate);
+      if (endMs <= ignoredMs) {
+        continue;
+      }
+      if (raise && detections.raiseMs < 0) {
+        detections.raiseMs = endMs;
+      }
+      if (shake && detections.shakeMs < 0) {
+        detections.shakeMs = endMs;
+      }
+      if (lower && detections.lowerMs < 0) {
+        detections.lowerMs = endMs;
+      }
+    }
+    return detections;
+  }
+
+  Detections ReplayScenario(const char* name) {
+    for (const auto& scenario : SyntheticMotion::scenarios) {
+      if (std::strcmp(scenario.name, name) == 0) {
+        std::vector<Sample> samples(SyntheticMotion::durationMs * Bma421::fifoRate / 1000);
+        SyntheticMotion::EncodeFifoFrames(scenario, 0, samples.data(), samples.size());
+        ConvertFifoFrames(samples.data(), samples.size());
+        MotionController controller;
+        return Replay(controller, samples, SyntheticMotion::warmUpMs);
+      }
+    }
+    ADD_FAILURE() << "No scenario " << name;
+    return {};
+  }
+
+  // Dump recorded by the watch built with MOTION_DUMP (see doc/Benchmarks.md), named by the environment variable MOTION_DUMP.
+  // Empty if the variable is not set, or if the dump was recorded at another rate than the one of the test.
+  std::vector<Sample> RecordedSamples() {
+    const char* path = std::getenv("MOTION_DUMP");
+    if (path == nullptr) {
+      return {};
+    }
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<uint8_t> dump {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    constexpr size_t headerSize = 8;
+    uint16_t rate = 0;
+    if (dump.size() < headerSize || std::memcmp(dump.data(), "IMOT", 4) != 0 || dump[4] != 1) {
+      return {};
+    }
+    std::memcpy(&rate, dump.data() + 6, sizeof(rate));
+    if (rate != Bma421::fifoRate) {
+      return {};
+    }
+    std::vector<Sample> samples((dump.size() - headerSize) / sizeof(Sample));
+    std::memcpy(samples.data(), dump.data() + headerSize, samples.size() * sizeof(Sample));
+    return samples;
+  }
+}
+
+TEST(MotionControllerTest, NoGestureAtRest) {
+  const Detections detections = ReplayScenario("rest");
+  EXPECT_LT(detections.raiseMs, 0);
+  EXPECT_LT(detections.shakeMs, 0);
+  EXPECT_LT(detections.lowerMs, 0);
+}
+
+// A roll of 75 degrees in 400ms is fast enough to be a shake at the default threshold too, as with the polling every 100ms
+TEST(MotionControllerTest, RaiseIsDetected) {
+  const Detections detections = ReplayScenario("raise");
+  EXPECT_GT(detections.raiseMs, SyntheticMotion::warmUpMs);
+  EXPECT_LT(detections.lowerMs, 0);
+}
+
+TEST(MotionControllerTest, LowerIsDetected) {
+  const Detections detections = ReplayScenario("lower");
+  EXPECT_GT(detections.lowerMs, SyntheticMotion::warmUpMs);
+  EXPECT_LT(detections.raiseMs, 0);
+}
+
+TEST(MotionControllerTest, ShakeIsDetected) {
+  const Detections detections = ReplayScenario("shake");
+  EXPECT_GT(detections.shakeMs, SyntheticMotion::warmUpMs);
+}
+
+// Replays a dump recorded on the watch (MOTION_DUMP) and prints when the gestures were first detected
+TEST(MotionControllerTest, RecordedDump) {
+  const std::vector<Sample> samples = RecordedSamples();
+  if (samples.empty()) {
+    GTEST_SKIP() << "MOTION_DUMP is not set, or the dump was not recorded at " << Bma421::fifoRate << "Hz";
+  }
+  MotionController controller;
+  const Detections detections = Replay(controller, samples, 0);
+  HostTests::Report("samples", samples.size(), "");
+  HostTests::Report("first raise", detections.raiseMs, "ms");
+  HostTests::Report("first shake", detections.shakeMs, "ms");
+  HostTests::Report("first lower", detections.lowerMs, "ms");
+}
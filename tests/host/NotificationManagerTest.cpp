@@ -0,0 +1,241 @@
+#include "components/ble/NotificationManager.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "components/ble/RemoteFont.h"
+#include "components/fs/FS.h"
+
+// The tests do not register a RemoteFont
+void Pinetime::Controllers::RemoteFont::Prefetch(const char* /*text*/, size_t /*size*/) {
+}
+
+using Pinetime::Controllers::FS;
+using Pinetime::Controllers::NotificationManager;
+
+namespace {
+  constexpr const char* storePath = "/.system/notifs.dat";
+  constexpr uint32_t totalNbNotifications = NotificationManager::TotalNbNotifications;
+
+  // Message of the n-th notification pushed by a test, padded to length characters
+  std::string Text(uint32_t n, size_t length) {
+    std::string text = "notification " + std::to_string(n) + " ";
+    text.resize(std::max(length, text.size()), '.');
+    return text;
+  }
+
+  class NotificationManagerTest : public ::testing::Test {
+  protected:
+    FS fs;
+    NotificationManager manager {fs};
+    uint32_t nbPushed = 0;
+
+    void SetUp() override {
+      manager.Init();
+    }
+
+    // Pushes count notifications of length characters, the n-th one with the message Text(n, length)
+    void Push(uint32_t count, size_t length) {
+      for (uint32_t i = 0; i < count; i++, nbPushed++) {
+        const std::string text = Text(nbPushed, length);
+        NotificationManager::Notification notification;
+        std::memcpy(notification.message.data(), text.c_str(), text.size() + 1);
+        notification.size = text.size() + 1;
+        notification.category = NotificationManager::Categories::SimpleAlert;
+        manager.Push(std::move(notification));
+      }
+    }
+
+    // Id of the newest notification
+    NotificationManager::Notification::Id NewestId() {
+      return manager.GetLastNotification().id;
+    }
+  };
+}
+
+TEST_F(NotificationManagerTest, NotificationsAreBrowsedFromTheNewest) {
+  Push(3, 20);
+  auto view = manager.GetLastNotification();
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(2, 20));
+  EXPECT_EQ(view.index, 0);
+  EXPECT_EQ(view.count, 3U);
+
+  const auto newestId = view.id;
+  view = manager.GetPrevious(newestId);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(1, 20));
+  EXPECT_EQ(view.index, 1);
+  view = manager.GetNext(view.id);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.id, newestId);
+  EXPECT_FALSE(manager.GetNext(newestId).valid);
+  // Nothing is written to the flash memory while the notifications fit in RAM
+  EXPECT_FALSE(fs.Exists(storePath));
+}
+
+// A record of 200 characters takes 206 bytes of the arena, which holds 4 of them
+TEST_F(NotificationManagerTest, OldNotificationsAreReadFromFlash) {
+  Push(20, 200);
+  EXPECT_TRUE(fs.Exists(storePath));
+  EXPECT_EQ(manager.NbNotifications(), 20U);
+
+  auto id = NewestId();
+  for (uint32_t n = 20; n-- > 0;) {
+    const uint32_t reads = fs.statistics.reads;
+    {
+      auto view = manager.Get(id);
+      ASSERT_TRUE(view.valid) << n;
+      EXPECT_EQ(view.Message(), Text(n, 200)) << n;
+      EXPECT_EQ(view.index, 19 - n);
+      EXPECT_EQ(view.count, 20U);
+    }
+    // The oldest notifications are read back from the ring file, the newest from RAM
+    if (n < 16) {
+      EXPECT_GT(fs.statistics.reads, reads) << n;
+    } else {
+      EXPECT_EQ(fs.statistics.reads, reads) << n;
+    }
+    NotificationManager::Notification::Id previousId;
+    if (n > 0) {
+      ASSERT_TRUE(manager.FindPrevious(id, previousId));
+      id = previousId;
+    } else {
+      EXPECT_FALSE(manager.FindPrevious(id, previousId));
+    }
+  }
+}
+
+// A view is a copy : the notification stays readable while another one is read, and the store is not locked
+TEST_F(NotificationManagerTest, ViewsDoNotLockTheStore) {
+  Push(10, 200);
+  const auto newestId = NewestId();
+  const auto first = manager.Get(newestId - 9);
+  const auto second = manager.Get(newestId - 8);
+  ASSERT_TRUE(first.valid);
+  ASSERT_TRUE(second.valid);
+
+  // Notifications received by the BLE host while the views are displayed
+  std::thread host {[this]() {
+    Push(totalNbNotifications, 200);
+  }};
+  host.join();
+  EXPECT_EQ(first.Message(), Text(0, 200));
+  EXPECT_EQ(second.Message(), Text(1, 200));
+  EXPECT_FALSE(manager.Get(newestId - 9).valid);
+}
+
+TEST_F(NotificationManagerTest, DismissedNotificationInFlashIsSkipped) {
+  Push(10, 200);
+  const auto newestId = NewestId();
+  const auto dismissedId = static_cast<NotificationManager::Notification::Id>(newestId - 8);
+  manager.Dismiss(dismissedId);
+  EXPECT_EQ(manager.NbNotifications(), 9U);
+  EXPECT_FALSE(manager.Get(dismissedId).valid);
+
+  NotificationManager::Notification::Id previousId;
+  ASSERT_TRUE(manager.FindPrevious(dismissedId + 1, previousId));
+  EXPECT_EQ(previousId, dismissedId - 1);
+  auto view = manager.Get(previousId);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(0, 200));
+  EXPECT_EQ(view.index, 8);
+}
+
+// Once TotalNbNotifications are stored, each new notification overwrites the slot of the oldest one
+TEST_F(NotificationManagerTest, OldestNotificationIsOverwrittenWhenTheStoreIsFull) {
+  Push(totalNbNotifications + 10, 30);
+  EXPECT_EQ(manager.NbNotifications(), totalNbNotifications);
+
+  auto view = manager.GetLastNotification();
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(totalNbNotifications + 9, 30));
+  const auto oldestId = static_cast<NotificationManager::Notification::Id>(view.id - (totalNbNotifications - 1));
+  view = manager.Get(oldestId);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(10, 30));
+  EXPECT_EQ(view.index, totalNbNotifications - 1);
+  NotificationManager::Notification::Id previousId;
+  EXPECT_FALSE(manager.FindPrevious(oldestId, previousId));
+  EXPECT_FALSE(manager.Get(oldestId - 1).valid);
+}
+
+// The ids are 16 bits : after 65536 notifications, nextId wraps around to 0 and then oldestId does
+TEST_F(NotificationManagerTest, IdsWrapAround) {
+  constexpr uint32_t nbIds = UINT16_MAX + 1;
+  Push(nbIds - 5, 10);
+  EXPECT_EQ(NewestId(), UINT16_MAX - 5);
+
+  // nextId wraps around, the oldest notifications are still before 0
+  Push(10, 10);
+  EXPECT_EQ(NewestId(), 4);
+  EXPECT_EQ(manager.NbNotifications(), totalNbNotifications);
+  NotificationManager::Notification::Id id = 4;
+  for (uint32_t n = nbPushed; n-- > nbPushed - totalNbNotifications; id--) {
+    auto view = manager.Get(id);
+    ASSERT_TRUE(view.valid) << id;
+    EXPECT_EQ(view.Message(), Text(n, 10)) << id;
+    EXPECT_EQ(view.index, nbPushed - 1 - n) << id;
+  }
+  NotificationManager::Notification::Id nextId;
+  ASSERT_TRUE(manager.FindNext(UINT16_MAX, nextId));
+  EXPECT_EQ(nextId, 0);
+  NotificationManager::Notification::Id previousId;
+  ASSERT_TRUE(manager.FindPrevious(0, previousId));
+  EXPECT_EQ(previousId, UINT16_MAX);
+  EXPECT_FALSE(manager.Get(5).valid);
+
+  // oldestId wraps around too
+  Push(totalNbNotifications, 10);
+  EXPECT_EQ(manager.NbNotifications(), totalNbNotifications);
+  EXPECT_FALSE(manager.Get(UINT16_MAX).valid);
+  auto view = manager.Get(5);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.index, totalNbNotifications - 1);
+  EXPECT_EQ(view.Message(), Text(nbPushed - totalNbNotifications, 10));
+}
+
+// The notifications that cannot be written to the flash memory are dropped : dismissed, and no longer counted
+TEST_F(NotificationManagerTest, NotificationsThatCannotBeStoredAreDropped) {
+  fs.writesBeforeFailure = 0;
+  Push(4, 200);
+  EXPECT_EQ(manager.NbNotifications(), 4U);
+
+  // The 5th notification moves the 2 oldest ones to flash, which fails
+  Push(1, 200);
+  EXPECT_EQ(manager.NbNotifications(), 3U);
+  auto view = manager.GetLastNotification();
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.count, 3U);
+  const auto newestId = view.id;
+  EXPECT_FALSE(manager.Get(newestId - 3).valid);
+  EXPECT_FALSE(manager.Get(newestId - 4).valid);
+  NotificationManager::Notification::Id previousId;
+  ASSERT_TRUE(manager.FindPrevious(newestId - 1, previousId));
+  EXPECT_EQ(previousId, newestId - 2);
+  EXPECT_FALSE(manager.FindPrevious(previousId, previousId));
+  view = manager.Get(newestId - 2);
+  EXPECT_EQ(view.Message(), Text(2, 200));
+  EXPECT_EQ(view.index, 2);
+
+  // Once the flash memory accepts the writes again, the next notifications are stored
+  fs.writesBeforeFailure = -1;
+  Push(2, 200);
+  EXPECT_EQ(manager.NbNotifications(), 5U);
+  view = manager.Get(newestId - 2);
+  ASSERT_TRUE(view.valid);
+  EXPECT_EQ(view.Message(), Text(2, 200));
+  EXPECT_EQ(view.index, 4);
+}
+
+// The store is emptied at boot, the ring file of the previous run is deleted
+TEST_F(NotificationManagerTest, StoreIsEmptiedAtBoot) {
+  Push(10, 200);
+  ASSERT_TRUE(fs.Exists(storePath));
+
+  NotificationManager rebooted {fs};
+  rebooted.Init();
+  EXPECT_TRUE(rebooted.IsEmpty());
+  EXPECT_FALSE(rebooted.GetLastNotification().valid);
+  EXPECT_FALSE(fs.Exists(storePath));
+}
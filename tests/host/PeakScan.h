@@ -0,0 +1,91 @@
+#pragma once
+
+// Previous peak search of Ppg, which scanned the linear interpolation of the spectrum in steps of 0.01 bin. Reference of
+// SpectrumPeak::Find() in SpectrumPeakTest and SpectrumPeakBenchmark.
+
+namespace HostTests {
+  inline float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX) {
+    if (pointX > xValues[length - 1]) {
+      return yValues[length - 1];
+    } else if (pointX <= xValues[0]) {
+      return yValues[0];
+    }
+    int index = 0;
+    while (pointX > xValues[index] && index < length - 1) {
+      index++;
+    }
+    float pointX0 = xValues[index - 1];
+    float pointX1 = xValues[index];
+    float pointY0 = yValues[index - 1];
+    float pointY1 = yValues[index];
+    float mu = (pointX - pointX0) / (pointX1 - pointX0);
+
+    return (pointY0 * (1 - mu) + pointY1 * mu);
+  }
+
+  inline float PeakScan(const float* xVals, const float* yVals, float threshold, float& width, float start, float end, int length) {
+    int peaks = 0;
+    bool enabled = false;
+    float minBin = 0.0f;
+    float maxBin = 0.0f;
+    float peakCenter = 0.0f;
+    float prevValue = LinearInterpolation(xVals, yVals, length, start - 0.01f);
+    float currValue = LinearInterpolation(xVals, yVals, length, start);
+    float idx = start;
+    while (idx < end) {
+      float nextValue = LinearInterpolation(xVals, yVals, length, idx + 0.01f);
+      if (currValue < threshold) {
+        enabled = true;
+      }
+      if (currValue >= threshold and enabled) {
+        if (prevValue < threshold) {
+          minBin = idx;
+        } else if (nextValue <= threshold) {
+          maxBin = idx;
+          peaks++;
+          width = maxBin - minBin;
+          peakCenter = width / 2.0f + minBin;
+        }
+      }
+      prevValue = currValue;
+      currValue = nextValue;
+      idx += 0.01f;
+    }
+    if (peaks != 1) {
+      width = 0.0f;
+      peakCenter = 0.0f;
+    }
+    return peakCenter;
+  }
+
+  // Spectrum of Ppg (32 bins) with one Lorentzian peak, an optional second one, and a noise floor. The spectra are the
+  // same in each run.
+  class SyntheticSpectra {
+  public:
+    static constexpr int length = 32;
+    // Region of interest of Ppg (30 to 240 BPM)
+    static constexpr int roiBegin = 3;
+    static constexpr int roiEnd = 26;
+
+    void Next(float* spectrum, float noise, bool secondPeak) {
+      const float center = Random(roiBegin, roiEnd);
+      const float halfWidth = Random(0.3f, 2.0f);
+      const float secondCenter = Random(roiBegin, roiEnd);
+      const float secondAmplitude = secondPeak ? Random(0.2f, 1.0f) : 0.0f;
+      for (int idx = 0; idx < length; idx++) {
+        const float distance = (static_cast<float>(idx) - center) / halfWidth;
+        const float secondDistance = (static_cast<float>(idx) - secondCenter) / halfWidth;
+        spectrum[idx] = Random(0.0f, noise) + 1.0f / (1.0f + distance * distance) +
+                        secondAmplitude / (1.0f + secondDistance * secondDistance);
+      }
+    }
+
+  private:
+    unsigned seed = 12345;
+
+    float Random(float min, float max) {
+      seed = seed * 1103515245 + 12345;
+      return min + (max - min) * static_cast<float>((seed >> 8) & 0xffff) / 65535.0f;
+    }
+  };
+}
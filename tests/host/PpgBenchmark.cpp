@@ -0,0 +1,22 @@
+#include "components/heartrate/Ppg.h"
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+#include "PpgVariant.h"
+
+using Pinetime::Controllers::Ppg;
+
+// Cost of a sample of the heart rate sensor in HeartRateTask : Preprocess() and HeartRate(), which analyzes the spectrum
+// every 5 samples once the window is full
+TEST(PpgBenchmark, Sample) {
+  const std::vector<uint16_t> samples = HostTests::SyntheticPpg(72, 6000);
+  Ppg ppg;
+  volatile int sink = 0;
+  const HostTests::PerCall sample = HostTests::MeasurePerCall(samples.size(), [&](size_t i) {
+    ppg.Preprocess(samples[i], 0);
+    sink = ppg.HeartRate();
+  });
+  HostTests::Report(std::string(HostTests::ppgVariant) + ", per sample", sample);
+}
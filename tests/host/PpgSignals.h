@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Signals of the heart rate sensor for the tests of the spectrum analysis of Ppg
+namespace HostTests {
+  constexpr int ppgWindowLength = 64;
+  constexpr int ppgSpectrumLength = ppgWindowLength / 2;
+  // Sampling period of Ppg (ms)
+  constexpr float ppgDeltaTms = 100.0f;
+  // Region of interest of Ppg (30 to 240 BPM)
+  constexpr int ppgRoiBegin = 3;
+  constexpr int ppgRoiEnd = 26;
+
+  // Pulse around the DC level of the HRS3300, with a drift and some noise (noise values, centered on 0), as in the
+  // benchmarks of Ppg. seed is the state of a linear congruential generator : the signals are the same in each run.
+  inline uint16_t SyntheticPpgSample(int bpm, int idx, uint32_t& seed, float amplitude = 100.0f, uint32_t noise = 64) {
+    const float omega = 2.0f * 3.14159265f * (static_cast<float>(bpm) / 60.0f) * (ppgDeltaTms / 1000.0f);
+    seed = seed * 1103515245 + 12345;
+    const float noiseSample = static_cast<float>((seed >> 16) % noise) - static_cast<float>(noise / 2);
+    return static_cast<uint16_t>(4000.0f + 2.0f * static_cast<float>(idx) + amplitude * std::sin(omega * static_cast<float>(idx)) +
+                                 noiseSample);
+  }
+
+  inline std::vector<uint16_t> SyntheticPpg(int bpm, int nbSamples, float amplitude = 100.0f, uint32_t noise = 64) {
+    std::vector<uint16_t> samples(nbSamples);
+    uint32_t seed = 12345;
+    for (int idx = 0; idx < nbSamples; idx++) {
+      samples[idx] = SyntheticPpgSample(bpm, idx, seed, amplitude, noise);
+    }
+    return samples;
+  }
+
+  // Raw samples of the heart rate sensor recorded on a watch, one per line, from the file named by the environment
+  // variable PPG_TRACE. Empty if the variable is not set.
+  inline std::vector<uint16_t> RecordedPpg() {
+    std::vector<uint16_t> samples;
+    const char* path = std::getenv("PPG_TRACE");
+    if (path == nullptr) {
+      return samples;
+    }
+    std::ifstream trace(path);
+    unsigned sample;
+    while (trace >> sample) {
+      samples.push_back(static_cast<uint16_t>(sample));
+    }
+    return samples;
+  }
+
+  // Removes the mean and applies a Hanning window
+  inline std::vector<float> Windowed(const uint16_t* samples) {
+    double mean = 0.0;
+    for (int n = 0; n < ppgWindowLength; n++) {
+      mean += samples[n];
+    }
+    mean /= ppgWindowLength;
+    std::vector<float> window(ppgWindowLength);
+    for (int n = 0; n < ppgWindowLength; n++) {
+      const double hanning = 0.5 - 0.5 * std::cos(2.0 * M_PI * n / (ppgWindowLength - 1));
+      window[n] = static_cast<float>((samples[n] - mean) * hanning);
+    }
+    return window;
+  }
+
+  // Magnitude of the bins [0, size[ of the DFT of signal, in double precision (not normalized, like ArduinoFFT)
+  inline std::vector<double> DftMagnitude(const float* signal, int length, int size) {
+    std::vector<double> magnitude(size);
+    for (int k = 0; k < size; k++) {
+      std::complex<double> sum = 0.0;
+      for (int n = 0; n < length; n++) {
+        sum += static_cast<double>(signal[n]) * std::polar(1.0, -2.0 * M_PI * k * n / length);
+      }
+      magnitude[k] = std::abs(sum);
+    }
+    return magnitude;
+  }
+
+  template <class Spectrum>
+  int PeakBin(const Spectrum& spectrum) {
+    int peak = ppgRoiBegin;
+    for (int k = ppgRoiBegin; k < ppgRoiEnd; k++) {
+      if (spectrum[k] > spectrum[peak]) {
+        peak = k;
+      }
+    }
+    return peak;
+  }
+}
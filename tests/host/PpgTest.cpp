@@ -0,0 +1,66 @@
+#include "components/heartrate/Ppg.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+#include "PpgVariant.h"
+
+using Pinetime::Controllers::Ppg;
+
+namespace {
+  // Feeds the samples to Ppg as HeartRateTask does and returns the last heart rate found, 0 if there is none
+  int LastHeartRate(Ppg& ppg, const std::vector<uint16_t>& samples) {
+    int lastBpm = 0;
+    for (uint16_t sample : samples) {
+      ppg.Preprocess(sample, 0);
+      const int bpm = ppg.HeartRate();
+      if (bpm < 0) {
+        ppg.Reset(false);
+        lastBpm = 0;
+      } else if (bpm > 0) {
+        lastBpm = bpm;
+      }
+    }
+    return lastBpm;
+  }
+}
+
+TEST(Ppg, NoHeartRateBeforeAFullWindow) {
+  Ppg ppg;
+  const std::vector<uint16_t> samples = HostTests::SyntheticPpg(72, Ppg::dataLength);
+  for (size_t i = 0; i + 1 < samples.size(); i++) {
+    ppg.Preprocess(samples[i], 0);
+    EXPECT_EQ(ppg.HeartRate(), 0);
+  }
+}
+
+// The resolution of the spectrum is 9.4 BPM per bin, the peak is interpolated between the bins. The pulse is small : the
+// window analysis rejects the spectra whose DC bin is above an absolute threshold (Ppg::dcThreshold), which the leakage
+// of the Hanning window exceeds for the larger pulses of SyntheticPpg().
+TEST(Ppg, FindsTheHeartRateOfASyntheticPulse) {
+  for (int bpm : {50, 72, 100, 140, 180}) {
+    Ppg ppg;
+    const int found = LastHeartRate(ppg, HostTests::SyntheticPpg(bpm, 600, 20.0f, 8));
+    HostTests::Report(std::string(HostTests::ppgVariant) + ", " + std::to_string(bpm) + " BPM", found, "BPM");
+    EXPECT_LE(std::abs(found - bpm), 5) << bpm << " BPM";
+  }
+}
+
+TEST(Ppg, NoHeartRateWithoutPulse) {
+  Ppg ppg;
+  EXPECT_EQ(LastHeartRate(ppg, HostTests::SyntheticPpg(72, 600, 0.0f, 8)), 0);
+}
+
+// After an analysis, an ambient light more than twice as bright as during the analysis is reported
+TEST(Ppg, DetectsTheAmbientLight) {
+  Ppg ppg;
+  const std::vector<uint16_t> samples = HostTests::SyntheticPpg(72, Ppg::dataLength);
+  for (uint16_t sample : samples) {
+    EXPECT_EQ(ppg.Preprocess(sample, 1000), 0);
+  }
+  ppg.HeartRate();
+  EXPECT_EQ(ppg.Preprocess(samples.back(), 2000), 0);
+  EXPECT_EQ(ppg.Preprocess(samples.back(), 2001), 1);
+}
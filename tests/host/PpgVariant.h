@@ -0,0 +1,14 @@
+#pragma once
+
+// Analysis and FFT of Ppg selected by the definitions of the host test target (PPG_ANALYSIS and PPG_FFT in the firmware)
+namespace HostTests {
+#if defined(PPG_ANALYSIS_SLIDING)
+  constexpr const char* ppgVariant = "sliding";
+#elif defined(PPG_FFT_Q15)
+  constexpr const char* ppgVariant = "window, Q15";
+#elif defined(PPG_FFT_Q31)
+  constexpr const char* ppgVariant = "window, Q31";
+#else
+  constexpr const char* ppgVariant = "window, ArduinoFFT";
+#endif
+}
@@ -0,0 +1,204 @@
+#include "components/ble/RemoteFontCache.h"
+#include <memory>
+#include <numeric>
+#include <vector>
+#include <gtest/gtest.h>
+
+using Pinetime::Controllers::FS;
+using Pinetime::Controllers::RemoteFontCache;
+
+namespace {
+  // Glyph of codePoint : size bytes derived from the code point
+  std::vector<uint8_t> Glyph(uint16_t codePoint, uint16_t size = 40) {
+    std::vector<uint8_t> glyph(size);
+    std::iota(glyph.begin(), glyph.end(), static_cast<uint8_t>(codePoint));
+    return glyph;
+  }
+
+  class RemoteFontCacheTest : public ::testing::Test {
+  protected:
+    FS fs;
+    std::unique_ptr<RemoteFontCache> cache;
+
+    void SetUp() override {
+      fs.DirCreate("/remote_fonts");
+      Reboot();
+    }
+
+    // New cache on the same file system, as after a reset of the watch
+    void Reboot() {
+      cache.reset();
+      fs.Reset();
+      cache = std::make_unique<RemoteFontCache>(fs);
+      ASSERT_EQ(cache->Init(), 0);
+    }
+
+    int Insert(uint16_t codePoint, uint16_t size = 40) {
+      const std::vector<uint8_t> glyph = Glyph(codePoint, size);
+      int result = cache->InsertBegin(codePoint, size);
+      if (result < 0) {
+        return result;
+      }
+      // In 2 pieces, as the BLE packets of RemoteFont
+      result = cache->InsertData(glyph.data(), size / 2);
+      if (result < 0) {
+        return result;
+      }
+      result = cache->InsertData(glyph.data() + size / 2, size - size / 2);
+      if (result < 0) {
+        return result;
+      }
+      return cache->InsertCommit();
+    }
+
+    void ExpectGlyph(uint16_t codePoint, uint16_t size = 40) {
+      std::vector<uint8_t> buffer(size);
+      EXPECT_EQ(cache->Read(codePoint, buffer.data(), buffer.size()), size) << "code point " << codePoint;
+      EXPECT_EQ(buffer, Glyph(codePoint, size)) << "code point " << codePoint;
+    }
+  };
+}
+
+TEST_F(RemoteFontCacheTest, HitIsOneSeekAndOneReadOfThePackFile) {
+  for (uint16_t codePoint = 0x4e00; codePoint < 0x4e20; codePoint++) {
+    ASSERT_EQ(Insert(codePoint), 0);
+  }
+  ASSERT_EQ(cache->Checkpoint(), 0);
+
+  constexpr uint32_t nbLookups = 100;
+  fs.statistics = {};
+  for (uint32_t i = 0; i < nbLookups; i++) {
+    const uint16_t codePoint = 0x4e00 + (i * 7) % 0x20;
+    ASSERT_TRUE(cache->Contains(codePoint));
+    ASSERT_EQ(cache->GlyphSize(codePoint), 40);
+    ExpectGlyph(codePoint);
+  }
+  EXPECT_EQ(fs.statistics.opens, 0U);
+  EXPECT_EQ(fs.statistics.writes, 0U);
+  EXPECT_EQ(fs.statistics.stats, 0U);
+  EXPECT_EQ(fs.statistics.seeks, nbLookups);
+  EXPECT_EQ(fs.statistics.reads, nbLookups);
+  EXPECT_EQ(fs.statistics.bytesRead, nbLookups * 40);
+}
+
+TEST_F(RemoteFontCacheTest, MissDoesNotAccessTheFlash) {
+  ASSERT_EQ(Insert('a'), 0);
+  fs.statistics = {};
+  uint8_t buffer[40];
+  EXPECT_FALSE(cache->Contains('b'));
+  EXPECT_LT(cache->GlyphSize('b'), 0);
+  EXPECT_EQ(cache->Read('b', buffer, sizeof(buffer)), LFS_ERR_NOENT);
+  EXPECT_EQ(fs.statistics.opens + fs.statistics.reads + fs.statistics.writes + fs.statistics.seeks + fs.statistics.stats, 0U);
+}
+
+TEST_F(RemoteFontCacheTest, ReadIsLimitedToTheBuffer) {
+  ASSERT_EQ(Insert('a', 40), 0);
+  std::vector<uint8_t> buffer(10);
+  EXPECT_EQ(cache->Read('a', buffer.data(), buffer.size()), 10);
+  EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), Glyph('a').begin()));
+}
+
+TEST_F(RemoteFontCacheTest, IndexIsWrittenOncePerBatch) {
+  fs.statistics = {};
+  cache->BeginBatch();
+  for (uint16_t codePoint = 'a'; codePoint <= 'z'; codePoint++) {
+    ASSERT_EQ(Insert(codePoint), 0);
+  }
+  EXPECT_EQ(fs.statistics.opens, 0U);
+  ASSERT_EQ(cache->EndBatch(), 0);
+  // The index file is opened and the pack file synced once
+  EXPECT_EQ(fs.statistics.opens, 1U);
+  EXPECT_EQ(fs.statistics.syncs, 1U);
+}
+
+TEST_F(RemoteFontCacheTest, IndexIsReloadedAfterAReset) {
+  for (uint16_t codePoint = 'a'; codePoint <= 'z'; codePoint++) {
+    ASSERT_EQ(Insert(codePoint, 10 + codePoint % 7), 0);
+  }
+  ASSERT_EQ(cache->Checkpoint(), 0);
+  Reboot();
+  EXPECT_EQ(cache->Count(), 26U);
+  for (uint16_t codePoint = 'a'; codePoint <= 'z'; codePoint++) {
+    ExpectGlyph(codePoint, 10 + codePoint % 7);
+  }
+}
+
+TEST_F(RemoteFontCacheTest, GlyphsAfterTheLastCheckpointAreRecovered) {
+  ASSERT_EQ(Insert('a'), 0);
+  ASSERT_EQ(cache->Checkpoint(), 0);
+  ASSERT_EQ(Insert('b'), 0);
+  ASSERT_EQ(Insert('c'), 0);
+  Reboot();
+  EXPECT_EQ(cache->Count(), 3U);
+  ExpectGlyph('a');
+  ExpectGlyph('b');
+  ExpectGlyph('c');
+}
+
+TEST_F(RemoteFontCacheTest, InterruptedDownloadIsDropped) {
+  ASSERT_EQ(Insert('a'), 0);
+  ASSERT_EQ(cache->Checkpoint(), 0);
+  const std::vector<uint8_t> glyph = Glyph('b');
+  ASSERT_EQ(cache->InsertBegin('b', glyph.size()), 0);
+  ASSERT_GE(cache->InsertData(glyph.data(), 10), 0);
+  // Reset before InsertCommit()
+  Reboot();
+  EXPECT_EQ(cache->Count(), 1U);
+  EXPECT_FALSE(cache->Contains('b'));
+  // The truncated record is removed by the next checkpoint, the following glyphs are not mistaken for it
+  ASSERT_EQ(cache->Checkpoint(), 0);
+  ASSERT_EQ(Insert('c'), 0);
+  Reboot();
+  EXPECT_EQ(cache->Count(), 2U);
+  ExpectGlyph('a');
+  ExpectGlyph('c');
+}
+
+TEST_F(RemoteFontCacheTest, InsertLargerThanAnnouncedIsRejected) {
+  const std::vector<uint8_t> glyph = Glyph('a', 20);
+  ASSERT_EQ(cache->InsertBegin('a', 10), 0);
+  EXPECT_EQ(cache->InsertData(glyph.data(), glyph.size()), LFS_ERR_INVAL);
+  EXPECT_EQ(cache->InsertCommit(), LFS_ERR_INVAL);
+  EXPECT_FALSE(cache->Contains('a'));
+  ASSERT_EQ(Insert('b'), 0);
+  ExpectGlyph('b');
+}
+
+TEST_F(RemoteFontCacheTest, LeastRecentlyUsedGlyphIsEvicted) {
+  for (uint16_t i = 0; i < RemoteFontCache::maxEntries; i++) {
+    ASSERT_EQ(Insert(0x4e00 + i, 8), 0);
+  }
+  // The first glyph is used again, the second one becomes the oldest
+  uint8_t buffer[8];
+  ASSERT_EQ(cache->Read(0x4e00, buffer, sizeof(buffer)), 8);
+  ASSERT_EQ(Insert(0x5000, 8), 0);
+  EXPECT_EQ(cache->Count(), RemoteFontCache::maxEntries);
+  EXPECT_TRUE(cache->Contains(0x4e00));
+  EXPECT_FALSE(cache->Contains(0x4e01));
+  EXPECT_TRUE(cache->Contains(0x5000));
+}
+
+TEST_F(RemoteFontCacheTest, DeadRecordsAreCompacted) {
+  // Downloading the same glyphs again leaves dead records in the pack file
+  for (int round = 0; round < 20; round++) {
+    for (uint16_t codePoint = 'a'; codePoint <= 'z'; codePoint++) {
+      ASSERT_EQ(Insert(codePoint, 100), 0);
+    }
+    ASSERT_EQ(cache->Checkpoint(), 0);
+  }
+  const size_t liveBytes = 26 * (100 + 4);
+  EXPECT_LT(fs.Content(RemoteFontCache::packPath).size(), 2 * liveBytes + 16 * 1024);
+  Reboot();
+  for (uint16_t codePoint = 'a'; codePoint <= 'z'; codePoint++) {
+    ExpectGlyph(codePoint, 100);
+  }
+}
+
+TEST_F(RemoteFontCacheTest, ClearRemovesAllTheGlyphs) {
+  ASSERT_EQ(Insert('a'), 0);
+  ASSERT_EQ(cache->Checkpoint(), 0);
+  ASSERT_EQ(cache->Clear(), 0);
+  EXPECT_EQ(cache->Count(), 0U);
+  Reboot();
+  EXPECT_EQ(cache->Count(), 0U);
+}
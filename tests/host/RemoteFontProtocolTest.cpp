@@ -0,0 +1,169 @@
+#include "components/ble/RemoteFontProtocol.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace Pinetime::Controllers::RemoteFontProtocol;
+
+namespace {
+  // Payload of size bytes (at least a GlyphHeader) derived from the code point
+  std::vector<uint8_t> Payload(uint16_t codePoint, uint16_t size) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < payload.size(); i++) {
+      payload[i] = static_cast<uint8_t>(codePoint + i);
+    }
+    return payload;
+  }
+
+  void Append(std::vector<uint8_t>& batch, uint16_t codePoint, uint16_t size, const std::vector<uint8_t>& payload) {
+    batch.push_back(codePoint & 0xff);
+    batch.push_back(codePoint >> 8);
+    batch.push_back(size & 0xff);
+    batch.push_back(size >> 8);
+    batch.insert(batch.end(), payload.begin(), payload.end());
+  }
+
+  void Append(std::vector<uint8_t>& batch, uint16_t codePoint, uint16_t size) {
+    Append(batch, codePoint, size, Payload(codePoint, size));
+  }
+
+  struct Parsed {
+    BatchStatus status;
+    std::vector<BatchGlyph> glyphs;
+  };
+
+  // Parses batch, stopping at the glyph of index abortAt
+  Parsed Parse(const std::vector<uint8_t>& batch, size_t abortAt = SIZE_MAX) {
+    Parsed parsed;
+    parsed.status = ParseBatch(
+      static_cast<uint16_t>(batch.size()),
+      [&batch](uint16_t offset, uint16_t size, uint8_t* buffer) {
+        ASSERT_LE(offset + size, batch.size());
+        std::memcpy(buffer, batch.data() + offset, size);
+      },
+      [&parsed, abortAt](const BatchGlyph& glyph) {
+        if (parsed.glyphs.size() == abortAt) {
+          return false;
+        }
+        parsed.glyphs.push_back(glyph);
+        return true;
+      });
+    return parsed;
+  }
+
+  void ExpectGlyph(const std::vector<uint8_t>& batch, const BatchGlyph& glyph, uint16_t codePoint, uint16_t size) {
+    EXPECT_EQ(glyph.codePoint, codePoint);
+    ASSERT_EQ(glyph.size, size);
+    ASSERT_LE(glyph.offset + glyph.size, batch.size());
+    EXPECT_EQ(std::vector<uint8_t>(batch.begin() + glyph.offset, batch.begin() + glyph.offset + glyph.size), Payload(codePoint, size));
+  }
+}
+
+TEST(RemoteFontProtocol, V1CodePointIsBigEndian) {
+  const uint8_t data[] = {0x4e, 0x2d};
+  EXPECT_EQ(V1CodePoint(data), 0x4e2d);
+}
+
+TEST(RemoteFontProtocol, BatchFieldsAreLittleEndian) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e2d, 0x0107);
+  const Parsed parsed = Parse(batch);
+  EXPECT_EQ(parsed.status, BatchStatus::Complete);
+  ASSERT_EQ(parsed.glyphs.size(), 1U);
+  ExpectGlyph(batch, parsed.glyphs[0], 0x4e2d, 0x0107);
+}
+
+TEST(RemoteFontProtocol, EmptyBatchIsComplete) {
+  const Parsed parsed = Parse({});
+  EXPECT_EQ(parsed.status, BatchStatus::Complete);
+  EXPECT_TRUE(parsed.glyphs.empty());
+}
+
+TEST(RemoteFontProtocol, AllTheGlyphsOfABatchAreParsedInOrder) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 177);
+  Append(batch, 0x0416, 60);
+  Append(batch, 0x4e01, sizeof(GlyphHeader));
+  const Parsed parsed = Parse(batch);
+  EXPECT_EQ(parsed.status, BatchStatus::Complete);
+  ASSERT_EQ(parsed.glyphs.size(), 3U);
+  ExpectGlyph(batch, parsed.glyphs[0], 0x4e00, 177);
+  ExpectGlyph(batch, parsed.glyphs[1], 0x0416, 60);
+  ExpectGlyph(batch, parsed.glyphs[2], 0x4e01, sizeof(GlyphHeader));
+}
+
+TEST(RemoteFontProtocol, TruncatedGlyphHeaderStopsTheBatch) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 40);
+  for (size_t extra = 1; extra < batchHeaderSize; extra++) {
+    std::vector<uint8_t> truncated = batch;
+    truncated.insert(truncated.end(), extra, 0x4e);
+    const Parsed parsed = Parse(truncated);
+    EXPECT_EQ(parsed.status, BatchStatus::Truncated) << extra << " bytes";
+    ASSERT_EQ(parsed.glyphs.size(), 1U) << extra << " bytes";
+    ExpectGlyph(truncated, parsed.glyphs[0], 0x4e00, 40);
+  }
+}
+
+TEST(RemoteFontProtocol, TruncatedPayloadStopsTheBatch) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 40);
+  Append(batch, 0x4e01, 40);
+  batch.pop_back();
+  const Parsed parsed = Parse(batch);
+  EXPECT_EQ(parsed.status, BatchStatus::Truncated);
+  ASSERT_EQ(parsed.glyphs.size(), 1U);
+  ExpectGlyph(batch, parsed.glyphs[0], 0x4e00, 40);
+}
+
+TEST(RemoteFontProtocol, SizeLargerThanTheWriteIsRejected) {
+  // The size claims more bytes than the write holds, up to the largest value of the field
+  for (const uint16_t size : {41, 512, 0xffff}) {
+    std::vector<uint8_t> batch;
+    Append(batch, 0x4e00, size, Payload(0x4e00, 40));
+    const Parsed parsed = Parse(batch);
+    EXPECT_EQ(parsed.status, BatchStatus::Truncated) << "size " << size;
+    EXPECT_TRUE(parsed.glyphs.empty()) << "size " << size;
+  }
+}
+
+TEST(RemoteFontProtocol, PayloadSmallerThanAGlyphHeaderIsRejected) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 40);
+  Append(batch, 0x4e01, 0);
+  Append(batch, 0x4e02, 40);
+  const Parsed parsed = Parse(batch);
+  EXPECT_EQ(parsed.status, BatchStatus::InvalidGlyph);
+  ASSERT_EQ(parsed.glyphs.size(), 1U);
+}
+
+TEST(RemoteFontProtocol, RefusedGlyphAbortsTheBatch) {
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 40);
+  Append(batch, 0x4e01, 40);
+  Append(batch, 0x4e02, 40);
+  const Parsed parsed = Parse(batch, 1);
+  EXPECT_EQ(parsed.status, BatchStatus::Aborted);
+  EXPECT_EQ(parsed.glyphs.size(), 1U);
+}
+
+TEST(RemoteFontProtocol, LargestWriteIsParsed) {
+  // 512 bytes, the largest attribute value of ATT
+  std::vector<uint8_t> batch;
+  Append(batch, 0x4e00, 250);
+  Append(batch, 0x4e01, 512 - 2 * batchHeaderSize - 250);
+  ASSERT_EQ(batch.size(), 512U);
+  const Parsed parsed = Parse(batch);
+  EXPECT_EQ(parsed.status, BatchStatus::Complete);
+  EXPECT_EQ(parsed.glyphs.size(), 2U);
+}
+
+TEST(RemoteFontProtocol, HeaderMustMatchThePayload) {
+  const GlyphHeader header {18, 18, 19, 0, -2, 4};
+  EXPECT_EQ(BitmapSize(header), 171U);
+  EXPECT_TRUE(IsValid(header, 177));
+  EXPECT_FALSE(IsValid(header, 176));
+  const GlyphHeader invalidBpp {18, 18, 19, 0, -2, 3};
+  EXPECT_FALSE(IsValid(invalidBpp, 1000));
+}
@@ -0,0 +1,23 @@
+#include "components/rle/RleDecoder.h"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "RleLogo.h"
+
+using Pinetime::Tools::RleDecoder;
+
+// Cost of the decoding of a line of the logo, drawn at boot by the recovery firmware and the bootloader
+TEST(RleDecoderBenchmark, Logo) {
+  constexpr size_t nbLogos = 1000;
+  std::array<uint8_t, HostTests::logoWidth * 2> line;
+  volatile uint8_t sink = 0;
+  const HostTests::PerCall logo = HostTests::MeasurePerCall(nbLogos, [&](size_t) {
+    RleDecoder decoder(infinitime_nb, sizeof(infinitime_nb));
+    for (size_t y = 0; y < HostTests::logoHeight; y++) {
+      decoder.DecodeNext(line.data(), line.size());
+      sink = sink + line[y];
+    }
+  });
+  HostTests::Report("line", logo / HostTests::logoHeight);
+}
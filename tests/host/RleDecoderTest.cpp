@@ -0,0 +1,45 @@
+#include "components/rle/RleDecoder.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RleLogo.h"
+
+using Pinetime::Tools::RleDecoder;
+
+TEST(RleDecoder, DecodesTheLogoLineByLine) {
+  const std::vector<uint8_t> expected = HostTests::ExpandRuns(infinitime_nb, sizeof(infinitime_nb), 0xffff, 0);
+  ASSERT_EQ(expected.size(), HostTests::logoWidth * HostTests::logoHeight * 2);
+
+  RleDecoder decoder(infinitime_nb, sizeof(infinitime_nb));
+  std::array<uint8_t, HostTests::logoWidth * 2> line;
+  for (size_t y = 0; y < HostTests::logoHeight; y++) {
+    decoder.DecodeNext(line.data(), line.size());
+    ASSERT_TRUE(std::equal(line.begin(), line.end(), expected.begin() + y * line.size())) << "line " << y;
+  }
+}
+
+TEST(RleDecoder, UsesTheColorsOfTheConstructor) {
+  const std::vector<uint8_t> expected = HostTests::ExpandRuns(infinitime_nb, sizeof(infinitime_nb), 0x07e0, 0x0000);
+
+  RleDecoder decoder(infinitime_nb, sizeof(infinitime_nb), 0x07e0, 0x0000);
+  std::array<uint8_t, HostTests::logoWidth * 2> line;
+  for (size_t y = 0; y < HostTests::logoHeight; y++) {
+    decoder.DecodeNext(line.data(), line.size());
+    ASSERT_TRUE(std::equal(line.begin(), line.end(), expected.begin() + y * line.size())) << "line " << y;
+  }
+}
+
+// A run is continued in the next call when the output is full, and a run of 0 switches the color
+TEST(RleDecoder, ContinuesARunInTheNextCall) {
+  const std::array<uint8_t, 4> encoded {3, 0, 2, 1};
+  RleDecoder decoder(encoded.data(), encoded.size(), 0x1234, 0xabcd);
+  std::array<uint8_t, 4> output;
+
+  decoder.DecodeNext(output.data(), output.size());
+  EXPECT_EQ(output, (std::array<uint8_t, 4> {0xab, 0xcd, 0xab, 0xcd}));
+  decoder.DecodeNext(output.data(), output.size());
+  EXPECT_EQ(output, (std::array<uint8_t, 4> {0xab, 0xcd, 0xab, 0xcd}));
+  decoder.DecodeNext(output.data(), output.size());
+  EXPECT_EQ(output, (std::array<uint8_t, 4> {0xab, 0xcd, 0x12, 0x34}));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "displayapp/icons/infinitime/infinitime-nb.c"
+
+// The logo of the recovery firmware, decoded by RleDecoder one line of the display at a time
+namespace HostTests {
+  constexpr size_t logoWidth = 240;
+  constexpr size_t logoHeight = 240;
+
+  // RGB565 pixels of the runs of encoded, in the byte order of the display : the runs alternate between background and
+  // foreground, starting with the background
+  inline std::vector<uint8_t> ExpandRuns(const uint8_t* encoded, size_t size, uint16_t foreground, uint16_t background) {
+    std::vector<uint8_t> pixels;
+    uint16_t color = background;
+    for (size_t i = 0; i < size; i++) {
+      for (uint8_t n = 0; n < encoded[i]; n++) {
+        pixels.push_back(color >> 8);
+        pixels.push_back(color & 0xff);
+      }
+      color = (color == background) ? foreground : background;
+    }
+    return pixels;
+  }
+}
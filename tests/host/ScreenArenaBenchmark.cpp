@@ -0,0 +1,30 @@
+#include "displayapp/ScreenArena.h"
+#include <memory>
+#include <gtest/gtest.h>
+#include "ArenaScreens.h"
+#include "Benchmark.h"
+
+using Pinetime::Applications::Screens::Screen;
+
+// Cost of a switch between the screens of ArenaScreens.h, constructed in the screen arena or allocated from the heap.
+// The screens of the tests create no object of LVGL : the switch of the watch also loads the objects of the screen,
+// measured by SCREEN_LOAD_BENCHMARK.
+TEST(ScreenArenaBenchmark, Switch) {
+  constexpr size_t nbSwitches = 300000;
+  volatile uint8_t sink = 0;
+
+  HostTests::Arena arena;
+  const HostTests::PerCall arenaSwitch = HostTests::MeasurePerCall(nbSwitches, [&](size_t i) {
+    sink = sink + static_cast<uint8_t>(HostTests::SwitchScreen(arena, i)->IsRunning());
+  });
+  arena.Clear();
+
+  std::unique_ptr<Screen> screen;
+  const HostTests::PerCall heapSwitch = HostTests::MeasurePerCall(nbSwitches, [&](size_t i) {
+    sink = sink + static_cast<uint8_t>(HostTests::SwitchScreen(screen, i)->IsRunning());
+  });
+  screen.reset();
+
+  HostTests::Report("arena", arenaSwitch);
+  HostTests::Report("heap", heapSwitch);
+}
@@ -0,0 +1,84 @@
+#include "displayapp/ScreenArena.h"
+#include <memory>
+#include <new>
+#include <gtest/gtest.h>
+#include "ArenaScreens.h"
+#include "Benchmark.h"
+
+using HostTests::Arena;
+using HostTests::LargeScreen;
+using HostTests::MediumScreen;
+using HostTests::SmallScreen;
+using Pinetime::Applications::ScreenLayout;
+using Pinetime::Applications::Screens::Screen;
+
+TEST(ScreenArenaTest, SizedForTheLargestScreen) {
+  EXPECT_EQ(HostTests::ArenaScreens::size, sizeof(LargeScreen));
+  EXPECT_EQ(Arena::size, sizeof(LargeScreen));
+  EXPECT_EQ((ScreenLayout<char, double, int>::size), sizeof(double));
+  EXPECT_EQ((ScreenLayout<char, double, int>::alignment), alignof(double));
+}
+
+TEST(ScreenArenaTest, ConstructsTheScreenInPlace) {
+  Arena arena;
+  EXPECT_EQ(arena.Get(), nullptr);
+
+  SmallScreen* small = arena.Emplace<SmallScreen>(1);
+  EXPECT_EQ(arena.Get(), small);
+  EXPECT_EQ(small->Value(), 1);
+  EXPECT_EQ(HostTests::liveScreens, 1);
+
+  // The next screen takes the memory of the previous one, which is destroyed first
+  LargeScreen* large = arena.Emplace<LargeScreen>(2);
+  EXPECT_EQ(static_cast<void*>(large), static_cast<void*>(small));
+  EXPECT_EQ(arena.Get(), large);
+  EXPECT_EQ(large->Value(), 2);
+  EXPECT_EQ(HostTests::liveScreens, 1);
+
+  arena.Clear();
+  EXPECT_EQ(arena.Get(), nullptr);
+  EXPECT_EQ(HostTests::liveScreens, 0);
+}
+
+TEST(ScreenArenaTest, ConstructsWithTheCreateFunctionOfTheApps) {
+  Arena arena;
+  arena.Emplace<SmallScreen>(1);
+  // As AppTraits<>::Create() and WatchFaceTraits<>::Create() do it
+  Screen* screen = arena.EmplaceWith([](void* memory) {
+    return new (memory) MediumScreen(3);
+  });
+  EXPECT_EQ(arena.Get(), screen);
+  EXPECT_EQ(static_cast<MediumScreen*>(screen)->Value(), 3);
+  EXPECT_EQ(HostTests::liveScreens, 1);
+  arena.Clear();
+  EXPECT_EQ(HostTests::liveScreens, 0);
+}
+
+TEST(ScreenArenaTest, DestroysTheScreenWithTheArena) {
+  {
+    Arena arena;
+    arena.Emplace<MediumScreen>(1);
+    EXPECT_EQ(HostTests::liveScreens, 1);
+  }
+  EXPECT_EQ(HostTests::liveScreens, 0);
+}
+
+TEST(ScreenArenaTest, SwitchingScreensDoesNotAllocate) {
+  constexpr size_t nbSwitches = 300;
+  Arena arena;
+  const HostTests::PerCall arenaSwitch = HostTests::MeasurePerCall(nbSwitches, [&](size_t i) {
+    HostTests::SwitchScreen(arena, i);
+  });
+  EXPECT_EQ(arenaSwitch.allocations, 0);
+  EXPECT_EQ(HostTests::liveScreens, 1);
+  arena.Clear();
+
+  // The allocation the arena saves : one per switch when the screen is allocated from the heap
+  std::unique_ptr<Screen> screen;
+  const HostTests::PerCall heapSwitch = HostTests::MeasurePerCall(nbSwitches, [&](size_t i) {
+    HostTests::SwitchScreen(screen, i);
+  });
+  EXPECT_EQ(heapSwitch.allocations, 1);
+  screen.reset();
+  EXPECT_EQ(HostTests::liveScreens, 0);
+}
@@ -0,0 +1,35 @@
+#include "components/heartrate/SlidingSpectrum.h"
+#include "components/heartrate/PpgWindow.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+
+using Pinetime::Controllers::PpgWindow;
+using Pinetime::Controllers::SlidingSpectrum;
+
+// Cost of an update of Ppg (5 samples) with SlidingSpectrum, and of the preprocessing of the whole window it replaces
+TEST(SlidingSpectrumBenchmark, UpdateCost) {
+  const std::vector<uint16_t> samples = HostTests::SyntheticPpg(72, 6000);
+  SlidingSpectrum slidingSpectrum;
+  std::array<float, HostTests::ppgSpectrumLength> spectrum;
+  const HostTests::PerCall push = HostTests::MeasurePerCall(samples.size(), [&](size_t i) {
+    slidingSpectrum.Push(samples[i]);
+  });
+  const HostTests::PerCall magnitude = HostTests::MeasurePerCall(samples.size(), [&](size_t) {
+    slidingSpectrum.Magnitude(spectrum.data(), spectrum.size());
+  });
+  std::array<float, PpgWindow::length> window;
+  const HostTests::PerCall windowUpdate = HostTests::MeasurePerCall(samples.size() - PpgWindow::length, [&](size_t i) {
+    std::copy(samples.begin() + i, samples.begin() + i + window.size(), window.begin());
+    PpgWindow::Detrend(window);
+    PpgWindow::Filter30to240(window);
+    PpgWindow::ApplyHanningWindow(window);
+  });
+  HostTests::Report("sliding, per sample", push);
+  HostTests::Report("sliding, magnitude", magnitude);
+  HostTests::Report("sliding, per update", push.nanoseconds * 5 + magnitude.nanoseconds, "ns");
+  HostTests::Report("window preprocessing (without the FFT), per update", windowUpdate);
+}
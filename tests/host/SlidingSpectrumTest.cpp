@@ -0,0 +1,139 @@
+#include "components/heartrate/SlidingSpectrum.h"
+#include "components/heartrate/PpgWindow.h"
+#include "components/heartrate/SpectrumPeak.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PpgSignals.h"
+
+using Pinetime::Controllers::PpgWindow;
+using Pinetime::Controllers::SlidingSpectrum;
+using Pinetime::Controllers::SpectrumPeak;
+
+namespace {
+  using Spectrum = std::array<float, HostTests::ppgSpectrumLength>;
+  // Resolution of the spectrum of Ppg (BPM per bin)
+  constexpr float bpmPerBin = (1000.0f / HostTests::ppgDeltaTms) / HostTests::ppgWindowLength * 60.0f;
+  // Samples between two updates of Ppg
+  constexpr size_t overlapWindow = 5;
+
+  // Heart rate found by the peak search of Ppg in spectrum (BPM), 0 if the peak is not found
+  float PeakBpm(const Spectrum& spectrum) {
+    const float max = *std::max_element(spectrum.begin() + HostTests::ppgRoiBegin, spectrum.begin() + HostTests::ppgRoiEnd);
+    const SpectrumPeak peak =
+      SpectrumPeak::Find(spectrum.data(), spectrum.size(), 0.6f * max, HostTests::ppgRoiBegin, HostTests::ppgRoiEnd);
+    return peak.location * bpmPerBin;
+  }
+
+  // Analysis of the whole window by Ppg : detrend, filters, Hanning window and FFT (in double precision)
+  Spectrum WindowSpectrum(const uint16_t* samples) {
+    std::array<float, PpgWindow::length> window;
+    std::copy(samples, samples + window.size(), window.begin());
+    PpgWindow::Detrend(window);
+    PpgWindow::Filter30to240(window);
+    PpgWindow::ApplyHanningWindow(window);
+    const std::vector<double> magnitude = HostTests::DftMagnitude(window.data(), window.size(), HostTests::ppgSpectrumLength);
+    Spectrum spectrum;
+    std::copy(magnitude.begin(), magnitude.end(), spectrum.begin());
+    return spectrum;
+  }
+
+  struct Comparison {
+    int nbUpdates = 0;
+    int windowFailures = 0;
+    int slidingFailures = 0;
+    // Largest difference between the heart rates found in both spectra (BPM)
+    float largestDifference = 0.0f;
+    float windowError = 0.0f;
+    float slidingError = 0.0f;
+  };
+
+  // Feeds samples to SlidingSpectrum and computes both spectra at each update of Ppg, once the first window is full
+  Comparison Compare(const std::vector<uint16_t>& samples, float bpm) {
+    Comparison comparison;
+    SlidingSpectrum slidingSpectrum;
+    for (size_t idx = 0; idx < samples.size(); idx++) {
+      slidingSpectrum.Push(samples[idx]);
+      if (idx + 1 < HostTests::ppgWindowLength || (idx + 1 - HostTests::ppgWindowLength) % overlapWindow != 0) {
+        continue;
+      }
+      Spectrum sliding;
+      slidingSpectrum.Magnitude(sliding.data(), sliding.size());
+      const float windowBpm = PeakBpm(WindowSpectrum(samples.data() + idx + 1 - HostTests::ppgWindowLength));
+      const float slidingBpm = PeakBpm(sliding);
+      comparison.nbUpdates++;
+      comparison.windowFailures += (windowBpm == 0.0f);
+      comparison.slidingFailures += (slidingBpm == 0.0f);
+      if (windowBpm != 0.0f && slidingBpm != 0.0f) {
+        comparison.largestDifference = std::max(comparison.largestDifference, std::abs(windowBpm - slidingBpm));
+      }
+      if (bpm != 0.0f) {
+        comparison.windowError = std::max(comparison.windowError, std::abs(windowBpm - bpm));
+        comparison.slidingError = std::max(comparison.slidingError, std::abs(slidingBpm - bpm));
+      }
+    }
+    return comparison;
+  }
+}
+
+TEST(SlidingSpectrum, BinsAfterTheMagnitudesAreCleared) {
+  SlidingSpectrum slidingSpectrum;
+  for (uint16_t sample : HostTests::SyntheticPpg(72, 100)) {
+    slidingSpectrum.Push(sample);
+  }
+  Spectrum spectrum;
+  spectrum.fill(1.0f);
+  slidingSpectrum.Magnitude(spectrum.data(), spectrum.size());
+  for (size_t k = SlidingSpectrum::nbMagnitudes; k < spectrum.size(); k++) {
+    EXPECT_EQ(spectrum[k], 0.0f);
+  }
+}
+
+TEST(SlidingSpectrum, ResetRestartsTheFilters) {
+  const std::vector<uint16_t> samples = HostTests::SyntheticPpg(120, 200);
+  SlidingSpectrum slidingSpectrum;
+  Spectrum first;
+  Spectrum second;
+  for (uint16_t sample : samples) {
+    slidingSpectrum.Push(sample);
+  }
+  slidingSpectrum.Magnitude(first.data(), first.size());
+  slidingSpectrum.Reset();
+  for (uint16_t sample : samples) {
+    slidingSpectrum.Push(sample);
+  }
+  slidingSpectrum.Magnitude(second.data(), second.size());
+  EXPECT_EQ(first, second);
+}
+
+// Side by side with the analysis of the whole window : the filters of the sliding analysis are not restarted at each
+// update, the spectra differ but both must find the heart rate of the synthetic signals
+TEST(SlidingSpectrum, FindsTheSameHeartRateAsTheWindowAnalysis) {
+  for (int bpm : {45, 72, 120, 180}) {
+    const Comparison comparison = Compare(HostTests::SyntheticPpg(bpm, 600), bpm);
+    const std::string name = std::to_string(bpm) + " bpm";
+    HostTests::Report(name + ", largest difference", comparison.largestDifference, "bpm");
+    HostTests::Report(name + ", window error", comparison.windowError, "bpm");
+    HostTests::Report(name + ", sliding error", comparison.slidingError, "bpm");
+    EXPECT_EQ(comparison.windowFailures, 0) << name;
+    EXPECT_EQ(comparison.slidingFailures, 0) << name;
+    EXPECT_LT(comparison.largestDifference, 0.5f) << name;
+    EXPECT_LT(comparison.slidingError, 2.0f) << name;
+  }
+}
+
+// Same comparison on a trace recorded on a watch : PPG_TRACE=<file of raw samples, one per line>
+TEST(SlidingSpectrum, RecordedTrace) {
+  const std::vector<uint16_t> samples = HostTests::RecordedPpg();
+  if (samples.size() < HostTests::ppgWindowLength) {
+    GTEST_SKIP() << "PPG_TRACE is not set";
+  }
+  const Comparison comparison = Compare(samples, 0.0f);
+  HostTests::Report("updates", comparison.nbUpdates, "");
+  HostTests::Report("window failures", comparison.windowFailures, "updates");
+  HostTests::Report("sliding failures", comparison.slidingFailures, "updates");
+  HostTests::Report("largest difference", comparison.largestDifference, "bpm");
+}
@@ -0,0 +1,45 @@
+#include "components/heartrate/SpectrumPeak.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Benchmark.h"
+#include "PeakScan.h"
+
+using Pinetime::Controllers::SpectrumPeak;
+using HostTests::SyntheticSpectra;
+
+// Duration of the previous scan in steps of 0.01 bin and of the closed form search on the same noisy spectra
+TEST(SpectrumPeakBenchmark, ScanAndClosedForm) {
+  constexpr size_t nbSpectra = 1000;
+  std::vector<std::array<float, SyntheticSpectra::length>> spectra(nbSpectra);
+  std::vector<float> thresholds(nbSpectra);
+  SyntheticSpectra generator;
+  for (size_t i = 0; i < nbSpectra; i++) {
+    generator.Next(spectra[i].data(), 0.1f, i % 4 == 0);
+    thresholds[i] = 0.6f * *std::max_element(spectra[i].begin() + SyntheticSpectra::roiBegin, spectra[i].begin() + SyntheticSpectra::roiEnd);
+  }
+  std::array<float, SyntheticSpectra::length> xValues;
+  for (size_t idx = 0; idx < xValues.size(); idx++) {
+    xValues[idx] = static_cast<float>(idx);
+  }
+
+  volatile float sink = 0.0f;
+  const HostTests::PerCall scan = HostTests::MeasurePerCall(nbSpectra, [&](size_t i) {
+    float width;
+    sink = HostTests::PeakScan(xValues.data(),
+                               spectra[i].data(),
+                               thresholds[i],
+                               width,
+                               SyntheticSpectra::roiBegin,
+                               SyntheticSpectra::roiEnd,
+                               SyntheticSpectra::length);
+  });
+  const HostTests::PerCall closedForm = HostTests::MeasurePerCall(nbSpectra, [&](size_t i) {
+    sink = SpectrumPeak::Find(spectra[i].data(), SyntheticSpectra::length, thresholds[i], SyntheticSpectra::roiBegin, SyntheticSpectra::roiEnd)
+             .center;
+  });
+  HostTests::Report("scan", scan);
+  HostTests::Report("closed form", closedForm);
+  HostTests::Report("speedup", scan.nanoseconds / closedForm.nanoseconds, "x");
+}
@@ -0,0 +1,140 @@
+#include "components/heartrate/SpectrumPeak.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include "PeakScan.h"
+
+using Pinetime::Controllers::SpectrumPeak;
+using HostTests::SyntheticSpectra;
+
+namespace {
+  using Spectrum = std::array<float, SyntheticSpectra::length>;
+
+  SpectrumPeak Find(const Spectrum& spectrum, float threshold) {
+    return SpectrumPeak::Find(spectrum.data(), spectrum.size(), threshold, SyntheticSpectra::roiBegin, SyntheticSpectra::roiEnd);
+  }
+
+  // Triangle of height 1 centered on center, of half width halfWidth (bins)
+  Spectrum Triangle(float center, float halfWidth) {
+    Spectrum spectrum;
+    for (size_t idx = 0; idx < spectrum.size(); idx++) {
+      spectrum[idx] = std::max(0.0f, 1.0f - std::abs(static_cast<float>(idx) - center) / halfWidth);
+    }
+    return spectrum;
+  }
+}
+
+TEST(SpectrumPeak, FindsTheCrossingsOfTheThreshold) {
+  const SpectrumPeak peak = Find(Triangle(10.0f, 4.0f), 0.5f);
+  EXPECT_FLOAT_EQ(peak.center, 10.0f);
+  EXPECT_FLOAT_EQ(peak.width, 4.0f);
+  EXPECT_FLOAT_EQ(peak.location, 10.0f);
+}
+
+TEST(SpectrumPeak, RefinesTheLocationBetweenTwoBins) {
+  Spectrum spectrum {};
+  spectrum[11] = 0.8f;
+  spectrum[12] = 1.0f;
+  spectrum[13] = 0.9f;
+  const SpectrumPeak peak = Find(spectrum, 0.5f);
+  // Vertex of the parabola through (11, 0.8), (12, 1), (13, 0.9)
+  EXPECT_NEAR(peak.location, 12.0f + 0.5f * (0.8f - 0.9f) / (0.8f - 2.0f + 0.9f), 1e-5f);
+  EXPECT_GT(peak.location, 12.0f);
+  EXPECT_LT(peak.location, 12.5f);
+}
+
+TEST(SpectrumPeak, PeakOnTheFirstBinOfTheRangeIsIgnored) {
+  // Already above the threshold at the start of the range : it does not rise inside the range
+  const SpectrumPeak peak = Find(Triangle(SyntheticSpectra::roiBegin, 2.0f), 0.5f);
+  EXPECT_EQ(peak.center, 0.0f);
+  EXPECT_EQ(peak.width, 0.0f);
+  EXPECT_EQ(peak.location, 0.0f);
+}
+
+TEST(SpectrumPeak, PeakRisingAfterTheFirstBinIsFound) {
+  const SpectrumPeak peak = Find(Triangle(SyntheticSpectra::roiBegin + 1, 1.0f), 0.5f);
+  EXPECT_FLOAT_EQ(peak.center, SyntheticSpectra::roiBegin + 1);
+  EXPECT_FLOAT_EQ(peak.width, 1.0f);
+}
+
+TEST(SpectrumPeak, PeakFallingOnTheLastBinOfTheRangeIsFound) {
+  // Falls below the threshold between the last bin of the range and the next one
+  const SpectrumPeak peak = Find(Triangle(SyntheticSpectra::roiEnd - 1, 1.5f), 0.5f);
+  EXPECT_FLOAT_EQ(peak.center, SyntheticSpectra::roiEnd - 1);
+  EXPECT_FLOAT_EQ(peak.width, 1.5f);
+}
+
+TEST(SpectrumPeak, PeakFallingAfterTheRangeIsIgnored) {
+  const SpectrumPeak peak = Find(Triangle(SyntheticSpectra::roiEnd + 1, 2.0f), 0.5f);
+  EXPECT_EQ(peak.center, 0.0f);
+}
+
+TEST(SpectrumPeak, FlatSpectrumHasNoPeak) {
+  Spectrum spectrum;
+  spectrum.fill(1.0f);
+  EXPECT_EQ(Find(spectrum, 0.6f).center, 0.0f);
+  EXPECT_EQ(Find(spectrum, 1.0f).center, 0.0f);
+  spectrum.fill(0.0f);
+  EXPECT_EQ(Find(spectrum, 0.0f).center, 0.0f);
+}
+
+TEST(SpectrumPeak, TwoPeaksAreRejected) {
+  Spectrum spectrum = Triangle(8.0f, 2.0f);
+  const Spectrum second = Triangle(18.0f, 2.0f);
+  std::transform(spectrum.begin(), spectrum.end(), second.begin(), spectrum.begin(), [](float a, float b) {
+    return std::max(a, b);
+  });
+  const SpectrumPeak peak = Find(spectrum, 0.5f);
+  EXPECT_EQ(peak.center, 0.0f);
+  EXPECT_EQ(peak.width, 0.0f);
+}
+
+TEST(SpectrumPeak, SecondPeakBelowTheThresholdIsIgnored) {
+  Spectrum spectrum = Triangle(8.0f, 2.0f);
+  spectrum[18] = 0.4f;
+  EXPECT_FLOAT_EQ(Find(spectrum, 0.5f).center, 8.0f);
+}
+
+// The closed form search must agree with the previous scan in steps of 0.01 bin on noisy spectra : same single peak
+// found or not, and centers and widths within the step of the scan (x2)
+TEST(SpectrumPeak, AgreesWithThePreviousScanOnNoisySpectra) {
+  constexpr int nbSpectra = 1000;
+  constexpr float tolerance = 0.02f;
+  constexpr float peakDetectionThreshold = 0.6f;
+  Spectrum xValues;
+  for (size_t idx = 0; idx < xValues.size(); idx++) {
+    xValues[idx] = static_cast<float>(idx);
+  }
+
+  SyntheticSpectra spectra;
+  int nbPeaks = 0;
+  for (int i = 0; i < nbSpectra; i++) {
+    Spectrum spectrum;
+    // One spectrum out of four has a second peak, which may or may not rise above the threshold
+    spectra.Next(spectrum.data(), 0.1f, i % 4 == 0);
+    const float max = *std::max_element(spectrum.begin() + SyntheticSpectra::roiBegin, spectrum.begin() + SyntheticSpectra::roiEnd);
+    const float threshold = peakDetectionThreshold * max;
+
+    float scanWidth = 0.0f;
+    const float scanCenter = HostTests::PeakScan(xValues.data(),
+                                                 spectrum.data(),
+                                                 threshold,
+                                                 scanWidth,
+                                                 SyntheticSpectra::roiBegin,
+                                                 SyntheticSpectra::roiEnd,
+                                                 spectrum.size());
+    const SpectrumPeak peak = Find(spectrum, threshold);
+
+    ASSERT_EQ(peak.center != 0.0f, scanCenter != 0.0f) << "spectrum " << i;
+    EXPECT_NEAR(peak.center, scanCenter, tolerance) << "spectrum " << i;
+    EXPECT_NEAR(peak.width, scanWidth, tolerance) << "spectrum " << i;
+    if (peak.center != 0.0f) {
+      nbPeaks++;
+      // The refined location is the maximum of the peak, between its threshold crossings
+      EXPECT_GT(peak.location, peak.center - peak.width / 2.0f) << "spectrum " << i;
+      EXPECT_LT(peak.location, peak.center + peak.width / 2.0f) << "spectrum " << i;
+    }
+  }
+  EXPECT_GT(nbPeaks, nbSpectra / 2);
+}
@@ -0,0 +1,174 @@
+#include "drivers/SpiNorFlash.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "drivers/Spi.h"
+
+using Pinetime::Drivers::Spi;
+using Pinetime::Drivers::SpiNorFlash;
+
+// The driver of the firmware, on the emulated flash memory of emulated/drivers/Spi.h
+namespace {
+  constexpr size_t pageSize = Spi::pageSize;
+  constexpr size_t sectorSize = Spi::sectorSize;
+
+  std::vector<uint8_t> Data(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+      data[i] = static_cast<uint8_t>(i * 13 + seed);
+    }
+    return data;
+  }
+
+  class SpiNorFlashTest : public ::testing::Test {
+  protected:
+    Spi spi;
+    SpiNorFlash flash {spi};
+
+    void SetUp() override {
+      flash.Init();
+    }
+
+    std::vector<uint8_t> Memory(size_t address, size_t size) {
+      return {spi.memory.begin() + address, spi.memory.begin() + address + size};
+    }
+  };
+}
+
+// Each program and erase is started by the task that saw the memory idle : the WREN and the commands are never sent while
+// another task's operation is running
+TEST_F(SpiNorFlashTest, ConcurrentWritesAreNotLost) {
+  constexpr size_t nbPages = 256;
+  const std::vector<uint8_t> first = Data(nbPages * pageSize, 1);
+  const std::vector<uint8_t> second = Data(nbPages * pageSize, 2);
+  constexpr size_t secondAddress = 0x10000;
+
+  std::atomic<bool> started {false};
+  std::thread firstTask([&]() {
+    while (!started) {
+    }
+    flash.Write(0, first.data(), first.size());
+  });
+  std::thread secondTask([&]() {
+    while (!started) {
+    }
+    for (size_t offset = 0; offset < second.size(); offset += pageSize) {
+      flash.StartPageProgram(secondAddress + offset, second.data() + offset, pageSize);
+    }
+    flash.WaitWhileBusy();
+  });
+  started = true;
+  firstTask.join();
+  secondTask.join();
+
+  EXPECT_EQ(Memory(0, first.size()), first);
+  EXPECT_EQ(Memory(secondAddress, second.size()), second);
+  EXPECT_EQ(spi.statistics.pagePrograms, 2 * nbPages);
+  EXPECT_EQ(spi.statistics.ignoredCommands, 0U);
+}
+
+// The second task tries to start a program while the first one is starting its own : it waits for the end of the first program
+// instead of sending its WREN and program while the memory is busy. The program lasts longer than its typical time.
+TEST_F(SpiNorFlashTest, ProgramWaitsForTheProgramOfAnotherTask) {
+  const std::vector<uint8_t> first = Data(pageSize, 7);
+  const std::vector<uint8_t> second = Data(pageSize, 8);
+  spi.pageProgramTicks = 10;
+  std::thread secondTask;
+  std::atomic<bool> secondTaskStarted {false};
+  spi.transactionDone = [&](uint8_t /*command*/) {
+    if (!secondTaskStarted.exchange(true)) {
+      secondTask = std::thread([&]() {
+        flash.StartPageProgram(pageSize, second.data(), second.size());
+        flash.WaitWhileBusy();
+      });
+      // The second task waits for the mutex of the driver, it takes it as soon as the first task releases it
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  };
+  flash.StartPageProgram(0, first.data(), first.size());
+  flash.WaitWhileBusy();
+  secondTask.join();
+
+  EXPECT_EQ(Memory(0, pageSize), first);
+  EXPECT_EQ(Memory(pageSize, pageSize), second);
+  EXPECT_EQ(spi.statistics.ignoredCommands, 0U);
+}
+
+TEST_F(SpiNorFlashTest, ConcurrentEraseAndReads) {
+  const std::vector<uint8_t> data = Data(sectorSize, 3);
+  flash.Write(sectorSize, data.data(), data.size());
+  flash.SetEraseSuspend(true);
+
+  std::atomic<bool> started {false};
+  std::thread eraseTask([&]() {
+    while (!started) {
+    }
+    for (size_t sector = 4; sector < 12; sector++) {
+      flash.SectorErase(sector * sectorSize);
+    }
+  });
+  std::thread readTask([&]() {
+    while (!started) {
+    }
+    std::vector<uint8_t> read(pageSize);
+    for (size_t i = 0; i < 32; i++) {
+      flash.FastRead(sectorSize + (i % 16) * pageSize, read.data(), read.size());
+      EXPECT_TRUE(std::equal(read.begin(), read.end(), data.begin() + (i % 16) * pageSize)) << i;
+      vTaskDelay(5);
+    }
+  });
+  started = true;
+  eraseTask.join();
+  readTask.join();
+
+  EXPECT_EQ(spi.statistics.sectorErases, 8U);
+  EXPECT_EQ(spi.statistics.ignoredCommands, 0U);
+  EXPECT_EQ(Memory(4 * sectorSize, 8 * sectorSize), std::vector<uint8_t>(8 * sectorSize, 0xff));
+}
+
+// A WREN that is not taken into account is sent again
+TEST_F(SpiNorFlashTest, LostWriteEnableIsSentAgain) {
+  const std::vector<uint8_t> data = Data(pageSize, 4);
+  spi.dropWriteEnables = 2;
+  flash.Write(0, data.data(), data.size());
+  EXPECT_EQ(Memory(0, pageSize), data);
+  EXPECT_EQ(spi.statistics.writeEnables, 1U);
+  EXPECT_EQ(spi.dropWriteEnables, 0U);
+}
+
+// The reads suspend the erase of another sector, which is resumed once they are done
+TEST_F(SpiNorFlashTest, ReadSuspendsTheErase) {
+  const std::vector<uint8_t> data = Data(2 * sectorSize, 5);
+  flash.Write(0, data.data(), data.size());
+  flash.SetEraseSuspend(true);
+
+  const TickType_t start = xTaskGetTickCount();
+  flash.StartSectorErase(0);
+  std::vector<uint8_t> read(sectorSize);
+  flash.Read(sectorSize, read.data(), read.size());
+  EXPECT_EQ(xTaskGetTickCount(), start);
+  EXPECT_TRUE(std::equal(read.begin(), read.end(), data.begin() + sectorSize));
+  EXPECT_EQ(spi.statistics.suspends, 1U);
+
+  flash.WaitWhileBusy();
+  EXPECT_GE(xTaskGetTickCount() - start, spi.sectorEraseTicks);
+  EXPECT_EQ(Memory(0, sectorSize), std::vector<uint8_t>(sectorSize, 0xff));
+  EXPECT_EQ(Memory(sectorSize, sectorSize), read);
+}
+
+// Without erase suspend, the read waits for the end of the erase
+TEST_F(SpiNorFlashTest, ReadWaitsForTheErase) {
+  const std::vector<uint8_t> data = Data(pageSize, 6);
+  flash.Write(sectorSize, data.data(), data.size());
+
+  const TickType_t start = xTaskGetTickCount();
+  flash.StartSectorErase(0);
+  std::vector<uint8_t> read(pageSize);
+  flash.Read(sectorSize, read.data(), read.size());
+  EXPECT_GE(xTaskGetTickCount() - start, spi.sectorEraseTicks);
+  EXPECT_EQ(read, data);
+  EXPECT_EQ(spi.statistics.suspends, 0U);
+  EXPECT_EQ(spi.statistics.ignoredCommands, 0U);
+}
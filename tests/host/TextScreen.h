@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+#include "displayapp/GlyphCache.h"
+
+// Glyphs downloaded from the companion and screens of text drawn by LVGL, for the tests of GlyphCache
+namespace HostTests {
+  using GlyphHeader = Pinetime::Components::GlyphCache::GlyphHeader;
+
+  // Payload of a glyph of the companion (GlyphHeader + bitmap) whose bitmap bytes are derived from the code point
+  inline std::vector<uint8_t> GlyphPayload(uint16_t codePoint, uint8_t boxWidth, uint8_t boxHeight, uint8_t bpp = 4) {
+    const GlyphHeader header {boxWidth, boxWidth, boxHeight, 0, 0, bpp};
+    std::vector<uint8_t> payload(sizeof(header) + Pinetime::Controllers::RemoteFontProtocol::BitmapSize(header));
+    std::memcpy(payload.data(), &header, sizeof(header));
+    for (size_t i = sizeof(header); i < payload.size(); i++) {
+      payload[i] = static_cast<uint8_t>(codePoint + i);
+    }
+    return payload;
+  }
+
+  // Glyphs stored in the flash memory, counts the accesses as RemoteFont would do them
+  class GlyphSource : public Pinetime::Components::GlyphCache::Source {
+  public:
+    std::map<uint16_t, std::vector<uint8_t>> glyphs;
+    uint32_t reads = 0;
+    uint32_t bytesRead = 0;
+
+    // CJK ideograph of the companion at 20px : 18x19 pixels, 4 bits per pixel (177 bytes with the header)
+    void AddIdeographs(uint16_t first, uint16_t count) {
+      for (uint16_t codePoint = first; codePoint < first + count; codePoint++) {
+        glyphs[codePoint] = GlyphPayload(codePoint, 18, 19);
+      }
+    }
+
+    int GlyphSize(uint16_t codePoint) override {
+      const auto glyph = glyphs.find(codePoint);
+      return glyph == glyphs.end() ? -1 : static_cast<int>(glyph->second.size());
+    }
+
+    int Read(uint16_t codePoint, uint8_t* buffer, size_t size) override {
+      const auto glyph = glyphs.find(codePoint);
+      if (glyph == glyphs.end()) {
+        return -1;
+      }
+      const size_t count = std::min(size, glyph->second.size());
+      std::memcpy(buffer, glyph->second.data(), count);
+      reads++;
+      bytesRead += count;
+      return static_cast<int>(count);
+    }
+  };
+
+  // Label drawn by LVGL 7 with a font whose glyphs are looked up by Metrics() and Bitmap(). The screen is rendered in
+  // stripes of LVGL_DRAW_BUFFER_LINES lines : for each stripe, lv_draw_label() measures the lines of the label from
+  // the first one to find the lines that cross the stripe (_lv_txt_get_next_line()), then draws their glyphs
+  // (lv_draw_letter()).
+  struct TextScreen {
+    std::vector<std::vector<uint16_t>> lines;
+    int top = 0;
+    int lineHeight = 24;
+    int height = 240;
+    int stripeHeight = 4;
+
+    // Lines of glyphsPerLine consecutive code points from first
+    static TextScreen Ideographs(uint16_t first, int nbLines, int glyphsPerLine, int top = 0) {
+      TextScreen screen;
+      screen.top = top;
+      for (int line = 0; line < nbLines; line++) {
+        screen.lines.emplace_back();
+        for (int i = 0; i < glyphsPerLine; i++) {
+          screen.lines.back().push_back(first + line * glyphsPerLine + i);
+        }
+      }
+      return screen;
+    }
+
+    // Returns the number of glyph lookups
+    template <class Font>
+    uint32_t Draw(Font& font) const {
+      uint32_t lookups = 0;
+      for (int y = 0; y < height; y += stripeHeight) {
+        for (size_t line = 0; line < lines.size(); line++) {
+          const int lineTop = top + static_cast<int>(line) * lineHeight;
+          if (lineTop >= y + stripeHeight) {
+            break;
+          }
+          for (const uint16_t codePoint : lines[line]) {
+            font.Metrics(codePoint);
+            lookups++;
+          }
+          if (lineTop + lineHeight <= y) {
+            continue;
+          }
+          for (const uint16_t codePoint : lines[line]) {
+            font.Metrics(codePoint);
+            font.Bitmap(codePoint);
+            lookups += 2;
+          }
+        }
+      }
+      return lookups;
+    }
+  };
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <task.h>
+
+// Replaces drivers/Spi.h for the tests of the drivers that run the code of the firmware (see 'emulated' in CMakeLists.txt) :
+// the bus of the SPI flash memory, with the memory behind it. As the chip of the watch, the memory ignores the commands it
+// receives while it is busy, except the status and suspend ones, and needs WREN before each program or erase. The programs and
+// erases last a number of ticks of xTaskGetTickCount(), the transfers take the time they take on the bus of the watch.
+namespace Pinetime {
+  namespace Drivers {
+    class Spi {
+    public:
+      static constexpr size_t size = 1024 * 1024;
+      static constexpr size_t pageSize = 256;
+      static constexpr size_t sectorSize = 4096;
+
+      struct Statistics {
+        uint32_t writeEnables = 0;
+        uint32_t pagePrograms = 0;
+        uint32_t sectorErases = 0;
+        uint32_t suspends = 0;
+        // Commands received while the memory was busy, or a program or erase without WREN
+        uint32_t ignoredCommands = 0;
+      };
+
+      std::array<uint8_t, size> memory;
+      Statistics statistics;
+      TickType_t pageProgramTicks = 1;
+      TickType_t sectorEraseTicks = 40;
+      // Number of the next WREN that are lost, as if they were not received
+      uint32_t dropWriteEnables = 0;
+      // Called with the command of each transaction once it is done, lets the tests run another task at that moment
+      std::function<void(uint8_t command)> transactionDone;
+
+      Spi() {
+        memory.fill(0xff);
+      }
+
+      Spi(const Spi&) = delete;
+      Spi& operator=(const Spi&) = delete;
+      Spi(Spi&&) = delete;
+      Spi& operator=(Spi&&) = delete;
+
+      bool Init() {
+        return true;
+      }
+
+      bool Write(const uint8_t* data, size_t size, const std::function<void()>& /*preTransactionHook*/) {
+        Transaction(data, size, nullptr, 0);
+        return true;
+      }
+
+      bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+        Transaction(cmd, cmdSize, data, dataSize);
+        return true;
+      }
+
+      bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+        std::array<uint8_t, 4 + pageSize> transaction;
+        std::memcpy(transaction.data(), cmd, cmdSize);
+        std::memcpy(transaction.data() + cmdSize, data, dataSize);
+        Transaction(transaction.data(), cmdSize + dataSize, nullptr, 0);
+        return true;
+      }
+
+      void Sleep() {
+      }
+
+      void Wakeup() {
+      }
+
+    private:
+      enum class Operations : uint8_t { None, Program, Erase };
+
+      std::mutex mutex;
+      bool writeEnabled = false;
+      Operations operation = Operations::None;
+      uint32_t operationAddress = 0;
+      TickType_t operationEnd = 0;
+      bool suspended = false;
+      TickType_t remainingTicks = 0;
+
+      bool Busy() {
+        if (operation != Operations::None && !suspended && static_cast<int32_t>(xTaskGetTickCount() - operationEnd) >= 0) {
+          // The sector is erased at the end of the erase, the data of a program is written when it starts
+          if (operation == Operations::Erase) {
+            std::fill_n(memory.begin() + operationAddress, sectorSize, 0xff);
+          }
+          operation = Operations::None;
+          writeEnabled = false;
+        }
+        return operation != Operations::None && !suspended;
+      }
+
+      static uint32_t Address(const uint8_t* cmd) {
+        return ((cmd[1] << 16U) | (cmd[2] << 8U) | cmd[3]) % size;
+      }
+
+      void Start(Operations newOperation, uint32_t address, TickType_t ticks) {
+        operation = newOperation;
+        operationAddress = address;
+        operationEnd = xTaskGetTickCount() + ticks;
+      }
+
+      void Transaction(const uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+        {
+          std::lock_guard<std::mutex> lock {mutex};
+          // 8MHz
+          std::this_thread::sleep_for(std::chrono::microseconds(cmdSize + dataSize));
+          Execute(cmd, cmdSize, data, dataSize);
+        }
+        if (transactionDone) {
+          transactionDone(cmd[0]);
+        }
+      }
+
+      void Execute(const uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+        const bool busy = Busy();
+        const uint8_t command = cmd[0];
+        if (command == 0x05) {
+          // Read Status Register : WIP and WEL
+          std::fill_n(data, dataSize, (busy ? 0x01 : 0x00) | (writeEnabled ? 0x02 : 0x00));
+          return;
+        }
+        if (command == 0x75) {
+          // Program/Erase Suspend
+          if (operation == Operations::Erase && !suspended) {
+            suspended = true;
+            remainingTicks = operationEnd - xTaskGetTickCount();
+            statistics.suspends++;
+          }
+          return;
+        }
+        if (busy) {
+          statistics.ignoredCommands++;
+          std::fill_n(data, dataSize, 0xff);
+          return;
+        }
+
+        switch (command) {
+          case 0x06:
+            if (dropWriteEnables > 0) {
+              dropWriteEnables--;
+            } else {
+              writeEnabled = true;
+              statistics.writeEnables++;
+            }
+            break;
+          case 0x7A:
+            if (suspended) {
+              suspended = false;
+              operationEnd = xTaskGetTickCount() + remainingTicks;
+            }
+            break;
+          case 0x02:
+            if (!writeEnabled || suspended) {
+              statistics.ignoredCommands++;
+              break;
+            }
+            // The data wraps around within the page
+            for (size_t i = 0; i + 4 < cmdSize; i++) {
+              const uint32_t address = Address(cmd);
+              memory[(address & ~(pageSize - 1)) + ((address + i) % pageSize)] &= cmd[4 + i];
+            }
+            statistics.pagePrograms++;
+            Start(Operations::Program, Address(cmd), pageProgramTicks);
+            break;
+          case 0x20:
+            if (!writeEnabled || suspended) {
+              statistics.ignoredCommands++;
+              break;
+            }
+            statistics.sectorErases++;
+            Start(Operations::Erase, Address(cmd) & ~(sectorSize - 1), sectorEraseTicks);
+            break;
+          case 0x03:
+          case 0x0B: {
+            // Fast Read is followed by a dummy byte
+            const uint32_t address = Address(cmd);
+            for (size_t i = 0; i < dataSize; i++) {
+              data[i] = memory[(address + i) % size];
+            }
+            break;
+          }
+          case 0x9F: {
+            static constexpr uint8_t identification[] {0x0b, 0x40, 0x16};
+            for (size_t i = 0; i < dataSize; i++) {
+              data[i] = (i < sizeof(identification)) ? identification[i] : 0;
+            }
+            break;
+          }
+          default:
+            // Security and configuration registers, deep power down
+            std::fill_n(data, dataSize, 0x00);
+            break;
+        }
+      }
+    };
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// FreeRTOS of the host tests: the tests run in the main thread, the tasks they create in threads of their own
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+
+using TickType_t = uint32_t;
+using BaseType_t = long;
+using UBaseType_t = unsigned long;
+
+#define pdFALSE             ((BaseType_t) 0)
+#define pdTRUE              ((BaseType_t) 1)
+#define pdPASS              (pdTRUE)
+#define pdFAIL              (pdFALSE)
+#define portMAX_DELAY       ((TickType_t) 0xffffffffUL)
+#define configTICK_RATE_HZ  1024
+#define pdMS_TO_TICKS(ms)   ((TickType_t) (((TickType_t) (ms) * (TickType_t) configTICK_RATE_HZ) / (TickType_t) 1000U))
+#define configMAX_TASK_NAME_LEN 4
+#define portYIELD_FROM_ISR(x) (void) (x)
+
+// Checked in the release builds too, as on the watch
+#define ASSERT(expression)                                                                                                           \
+  do {                                                                                                                               \
+    if (!(expression)) {                                                                                                             \
+      std::abort();                                                                                                                  \
+    }                                                                                                                                \
+  } while (0)
+
+namespace HostStubs {
+  // Allocations from the heap, by pvPortMalloc() and by operator new (see HeapAllocations.cpp), read by the benchmarks
+  inline std::atomic<uint64_t> heapAllocations {0};
+}
+
+inline void* pvPortMalloc(size_t size) {
+  HostStubs::heapAllocations++;
+  return std::malloc(size);
+}
+
+inline void vPortFree(void* ptr) {
+  std::free(ptr);
+}
+
+// The heap of the computer has no statistics
+inline size_t xPortGetFreeHeapSize() {
+  return 0;
+}
+
+inline size_t xPortGetMinimumEverFreeHeapSize() {
+  return 0;
+}
+
+extern "C" inline void vPortGetFreeBlockStats(size_t* pxLargestFreeBlock, size_t* pxNumberOfFreeBlocks) {
+  *pxLargestFreeBlock = 0;
+  *pxNumberOfFreeBlocks = 0;
+}
+
+namespace HostStubs {
+  // Set at the end of the test program : the tasks that wait forever leave their loop by throwing TaskExit
+  inline std::atomic<bool> tasksStopping {false};
+
+  struct TaskExit {};
+
+  // Waits until predicate is true or for ticks milliseconds, returns the value of predicate. condition_variable::wait()
+  // is not used : it needs a libstdc++ more recent than the one some distributions of gtest are linked with.
+  template <class Predicate>
+  bool Wait(std::condition_variable& condition, std::unique_lock<std::mutex>& lock, TickType_t ticks, Predicate predicate) {
+    if (ticks == portMAX_DELAY) {
+      while (!condition.wait_for(lock, std::chrono::milliseconds(10), predicate)) {
+        if (tasksStopping) {
+          throw TaskExit {};
+        }
+      }
+      return true;
+    }
+    return condition.wait_for(lock, std::chrono::milliseconds(ticks), predicate);
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    // LinkPolicy of the host tests : there is no link to tune, the activity of the transfers is counted
+    class LinkPolicy {
+    public:
+      enum class Transfers : uint8_t { Dfu, FileSystem, RemoteFont };
+
+      size_t transferBytes = 0;
+      uint32_t transferPackets = 0;
+
+      void OnTransferActivity(Transfers /*transfer*/, size_t bytes) {
+        transferBytes += bytes;
+        transferPackets++;
+      }
+    };
+  }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include "drivers/Bma421.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    // MotionService of the host tests : the values of MotionController are not sent, the samples are counted
+    class MotionService {
+    public:
+      size_t nbSamples = 0;
+
+      void OnNewStepCountValue(uint32_t /*stepCount*/) {
+      }
+
+      void OnNewMotionValues(int16_t /*x*/, int16_t /*y*/, int16_t /*z*/) {
+      }
+
+      void OnNewMotionSamples(const Pinetime::Drivers::Bma421::Sample* /*samples*/, size_t count, TickType_t /*lastSampleTime*/) {
+        nbSamples += count;
+      }
+
+      bool IsMotionNotificationSubscribed() const {
+        return false;
+      }
+    };
+  }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    // Clock of the host tests, set by the tests
+    class DateTime {
+    public:
+      // UTC time (s)
+      uint32_t utcSeconds = 0;
+
+      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> UTCDateTime() const {
+        return std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>(std::chrono::seconds(utcSeconds));
+      }
+    };
+  }
+}
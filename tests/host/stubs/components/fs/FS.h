@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * File system of the host tests, replacing components/fs/FS.h : the files are kept in RAM, and each operation is
+     * counted so that the tests can check how often a component accesses the flash memory. Writes can be made to fail
+     * to test the error paths.
+     *
+     * Unlike littlefs, the data written to a file is visible to the other handles at once, synced or not.
+     */
+    class FS {
+    public:
+      struct Statistics {
+        uint32_t opens = 0;
+        uint32_t closes = 0;
+        uint32_t reads = 0;
+        uint32_t writes = 0;
+        uint32_t seeks = 0;
+        uint32_t syncs = 0;
+        uint32_t deletes = 0;
+        uint32_t renames = 0;
+        uint32_t stats = 0;
+        uint32_t bytesRead = 0;
+        uint32_t bytesWritten = 0;
+      };
+
+      Statistics statistics;
+      // Number of writes that succeed before the following ones fail with LFS_ERR_NOSPC, -1 for no failure
+      int writesBeforeFailure = -1;
+
+      void Init() {
+      }
+
+      int FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
+        statistics.opens++;
+        const std::string path = Normalize(fileName);
+        auto it = files.find(path);
+        if (it == files.end()) {
+          if ((flags & LFS_O_CREAT) == 0) {
+            return LFS_ERR_NOENT;
+          }
+          if (!DirectoryExists(Parent(path))) {
+            return LFS_ERR_NOENT;
+          }
+          it = files.emplace(path, std::vector<uint8_t> {}).first;
+        } else if ((flags & LFS_O_CREAT) != 0 && (flags & LFS_O_EXCL) != 0) {
+          return LFS_ERR_EXIST;
+        }
+        if ((flags & LFS_O_TRUNC) != 0) {
+          it->second.clear();
+        }
+        file_p->path = path;
+        file_p->pos = 0;
+        file_p->flags = flags;
+        file_p->opened = true;
+        openFiles++;
+        return LFS_ERR_OK;
+      }
+
+      int FileClose(lfs_file_t* file_p) {
+        statistics.closes++;
+        if (!file_p->opened) {
+          return LFS_ERR_BADF;
+        }
+        file_p->opened = false;
+        openFiles--;
+        return LFS_ERR_OK;
+      }
+
+      int FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
+        statistics.reads++;
+        std::vector<uint8_t>* data = Data(file_p);
+        if (data == nullptr || (file_p->flags & LFS_O_RDONLY) == 0) {
+          return LFS_ERR_BADF;
+        }
+        const uint32_t available = (file_p->pos < data->size()) ? data->size() - file_p->pos : 0;
+        const uint32_t count = std::min(size, available);
+        std::copy_n(data->begin() + file_p->pos, count, buff);
+        file_p->pos += count;
+        statistics.bytesRead += count;
+        return count;
+      }
+
+      int FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size) {
+        statistics.writes++;
+        std::vector<uint8_t>* data = Data(file_p);
+        if (data == nullptr || (file_p->flags & LFS_O_WRONLY) == 0) {
+          return LFS_ERR_BADF;
+        }
+        if (writesBeforeFailure == 0) {
+          return LFS_ERR_NOSPC;
+        }
+        if (writesBeforeFailure > 0) {
+          writesBeforeFailure--;
+        }
+        if ((file_p->flags & LFS_O_APPEND) != 0) {
+          file_p->pos = data->size();
+        }
+        if (data->size() < file_p->pos + size) {
+          data->resize(file_p->pos + size);
+        }
+        std::copy_n(buff, size, data->begin() + file_p->pos);
+        file_p->pos += size;
+        statistics.bytesWritten += size;
+        return size;
+      }
+
+      int FileSeek(lfs_file_t* file_p, uint32_t pos) {
+        statistics.seeks++;
+        if (Data(file_p) == nullptr) {
+          return LFS_ERR_BADF;
+        }
+        file_p->pos = pos;
+        return pos;
+      }
+
+      int FileSync(lfs_file_t* file_p) {
+        statistics.syncs++;
+        return (Data(file_p) == nullptr) ? LFS_ERR_BADF : LFS_ERR_OK;
+      }
+
+      int FileDelete(const char* fileName) {
+        statistics.deletes++;
+        const std::string path = Normalize(fileName);
+        if (files.erase(path) == 1) {
+          return LFS_ERR_OK;
+        }
+        if (directories.count(path) == 0) {
+          return LFS_ERR_NOENT;
+        }
+        for (const auto& file : files) {
+          if (Parent(file.first) == path) {
+            return LFS_ERR_NOTEMPTY;
+          }
+        }
+        directories.erase(path);
+        return LFS_ERR_OK;
+      }
+
+      int32_t FileSize(lfs_t* /*lfs*/, lfs_file_t* file) {
+        std::vector<uint8_t>* data = Data(file);
+        return (data == nullptr) ? LFS_ERR_BADF : static_cast<int32_t>(data->size());
+      }
+
+      int DirOpen(const char* path, lfs_dir_t* lfs_dir) {
+        const std::string directory = Normalize(path);
+        if (!DirectoryExists(directory)) {
+          return LFS_ERR_NOENT;
+        }
+        lfs_dir->path = directory;
+        lfs_dir->next = 0;
+        lfs_dir->opened = true;
+        return LFS_ERR_OK;
+      }
+
+      int DirClose(lfs_dir_t* lfs_dir) {
+        lfs_dir->opened = false;
+        return LFS_ERR_OK;
+      }
+
+      // Returns 1 for each entry, then 0
+      int DirRead(lfs_dir_t* dir, lfs_info* info) {
+        std::vector<std::pair<std::string, lfs_info>> entries;
+        for (const auto& file : files) {
+          if (Parent(file.first) == dir->path) {
+            entries.push_back({Name(file.first), Info(LFS_TYPE_REG, file.second.size())});
+          }
+        }
+        for (const std::string& directory : directories) {
+          if (directory != "/" && Parent(directory) == dir->path) {
+            entries.push_back({Name(directory), Info(LFS_TYPE_DIR, 0)});
+          }
+        }
+        if (dir->next >= entries.size()) {
+          return 0;
+        }
+        *info = entries[dir->next].second;
+        std::strncpy(info->name, entries[dir->next].first.c_str(), sizeof(info->name) - 1);
+        dir->next++;
+        return 1;
+      }
+
+      int DirRewind(lfs_dir_t* dir) {
+        dir->next = 0;
+        return LFS_ERR_OK;
+      }
+
+      int DirCreate(const char* path) {
+        const std::string directory = Normalize(path);
+        if (DirectoryExists(directory) || files.count(directory) != 0) {
+          return LFS_ERR_EXIST;
+        }
+        if (!DirectoryExists(Parent(directory))) {
+          return LFS_ERR_NOENT;
+        }
+        directories.insert(directory);
+        return LFS_ERR_OK;
+      }
+
+      int EnsureDirectory(const char* path) {
+        return DirectoryExists(Normalize(path)) ? LFS_ERR_OK : DirCreate(path);
+      }
+
+      int Rename(const char* oldPath, const char* newPath) {
+        statistics.renames++;
+        auto it = files.find(Normalize(oldPath));
+        if (it == files.end()) {
+          return LFS_ERR_NOENT;
+        }
+        std::vector<uint8_t> data = std::move(it->second);
+        files.erase(it);
+        files[Normalize(newPath)] = std::move(data);
+        return LFS_ERR_OK;
+      }
+
+      int Stat(const char* path, lfs_info* info) {
+        statistics.stats++;
+        const std::string name = Normalize(path);
+        auto it = files.find(name);
+        if (it != files.end()) {
+          *info = Info(LFS_TYPE_REG, it->second.size());
+        } else if (DirectoryExists(name)) {
+          *info = Info(LFS_TYPE_DIR, 0);
+        } else {
+          return LFS_ERR_NOENT;
+        }
+        std::strncpy(info->name, Name(name).c_str(), sizeof(info->name) - 1);
+        return LFS_ERR_OK;
+      }
+
+      lfs_ssize_t GetFSSize() {
+        lfs_ssize_t size = 0;
+        for (const auto& file : files) {
+          size += (file.second.size() + blockSize - 1) / blockSize;
+        }
+        return size;
+      }
+
+      static size_t getSize() {
+        return size;
+      }
+
+      static size_t getBlockSize() {
+        return blockSize;
+      }
+
+      // Test helpers
+
+      // Content of a file, empty if it does not exist
+      std::vector<uint8_t> Content(const char* path) const {
+        auto it = files.find(Normalize(path));
+        return (it == files.end()) ? std::vector<uint8_t> {} : it->second;
+      }
+
+      bool Exists(const char* path) const {
+        const std::string name = Normalize(path);
+        return files.count(name) != 0 || directories.count(name) != 0;
+      }
+
+      void Truncate(const char* path, size_t newSize) {
+        files.at(Normalize(path)).resize(newSize);
+      }
+
+      int OpenFiles() const {
+        return openFiles;
+      }
+
+      // Forgets the open files, as a reset of the watch would
+      void Reset() {
+        openFiles = 0;
+        statistics = {};
+      }
+
+    private:
+      static constexpr size_t size = 0x34C000;
+      static constexpr size_t blockSize = 4096;
+
+      std::map<std::string, std::vector<uint8_t>> files;
+      std::set<std::string> directories {"/"};
+      int openFiles = 0;
+
+      static std::string Normalize(const char* path) {
+        std::string name = (path[0] == '/') ? path : std::string("/") + path;
+        while (name.size() > 1 && name.back() == '/') {
+          name.pop_back();
+        }
+        return name;
+      }
+
+      static std::string Parent(const std::string& path) {
+        const size_t slash = path.rfind('/');
+        return (slash == 0) ? "/" : path.substr(0, slash);
+      }
+
+      static std::string Name(const std::string& path) {
+        return path.substr(path.rfind('/') + 1);
+      }
+
+      static lfs_info Info(uint8_t type, size_t fileSize) {
+        lfs_info info {};
+        info.type = type;
+        info.size = fileSize;
+        return info;
+      }
+
+      bool DirectoryExists(const std::string& path) const {
+        return directories.count(path) != 0;
+      }
+
+      std::vector<uint8_t>* Data(lfs_file_t* file) {
+        if (!file->opened) {
+          return nullptr;
+        }
+        auto it = files.find(file->path);
+        return (it == files.end()) ? nullptr : &it->second;
+      }
+    };
+  }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Pinetime {
+  namespace Drivers {
+    /**
+     * SPI NOR flash memory of the host tests, replacing drivers/SpiNorFlash.h : the content is kept in RAM, programming
+     * clears bits and erasing sets them as on the flash memory. By default the operations are instantaneous ; with
+     * watchTimings, the calls take as long as they do on the watch (SPI bus at 8MHz, page program and sector erase for
+     * the durations the driver waits for). The data is programmed when the program starts.
+     */
+    class SpiNorFlash {
+    public:
+      struct Timings {
+        std::chrono::microseconds perByte;
+        std::chrono::microseconds pageProgram;
+        std::chrono::microseconds sectorErase;
+      };
+
+      static constexpr Timings instantTimings {};
+      static constexpr Timings watchTimings {std::chrono::microseconds(1),
+                                             std::chrono::microseconds(1000),
+                                             std::chrono::microseconds(40000)};
+
+      struct Statistics {
+        uint32_t pagePrograms = 0;
+        uint32_t sectorErases = 0;
+        uint32_t bytesRead = 0;
+      };
+
+      static constexpr size_t size = 4 * 1024 * 1024;
+      static constexpr size_t pageSize = 256;
+      static constexpr size_t sectorSize = 4096;
+
+      Timings timings = instantTimings;
+      Statistics statistics;
+      std::vector<uint8_t> memory = std::vector<uint8_t>(size, 0xff);
+
+      void Read(uint32_t address, uint8_t* buffer, size_t count) {
+        Transfer(4 + count);
+        std::lock_guard<std::mutex> lock {mutex};
+        std::copy_n(memory.begin() + address, count, buffer);
+        statistics.bytesRead += count;
+      }
+
+      void FastRead(uint32_t address, uint8_t* buffer, size_t count) {
+        Read(address, buffer, count);
+      }
+
+      void Write(uint32_t address, const uint8_t* buffer, size_t count) {
+        while (count > 0) {
+          const size_t length = std::min(count, pageSize - address % pageSize);
+          StartPageProgram(address, buffer, length);
+          WaitWhileBusy();
+          address += length;
+          buffer += length;
+          count -= length;
+        }
+      }
+
+      void SectorErase(uint32_t sectorAddress) {
+        StartSectorErase(sectorAddress);
+        WaitWhileBusy();
+      }
+
+      void StartSectorErase(uint32_t sectorAddress) {
+        WaitWhileBusy();
+        Transfer(4);
+        std::lock_guard<std::mutex> lock {mutex};
+        const size_t first = sectorAddress & ~(sectorSize - 1);
+        std::fill_n(memory.begin() + first, sectorSize, 0xff);
+        statistics.sectorErases++;
+        busyUntil = std::chrono::steady_clock::now() + timings.sectorErase;
+      }
+
+      void StartPageProgram(uint32_t address, const uint8_t* buffer, size_t count) {
+        WaitWhileBusy();
+        Transfer(4 + count);
+        std::lock_guard<std::mutex> lock {mutex};
+        for (size_t i = 0; i < count; i++) {
+          memory[address + i] &= buffer[i];
+        }
+        statistics.pagePrograms++;
+        busyUntil = std::chrono::steady_clock::now() + timings.pageProgram;
+      }
+
+      void WaitWhileBusy() {
+        std::chrono::steady_clock::time_point end;
+        {
+          std::lock_guard<std::mutex> lock {mutex};
+          end = busyUntil;
+        }
+        std::this_thread::sleep_until(end);
+      }
+
+      bool ProgramFailed() {
+        return false;
+      }
+
+      bool EraseFailed() {
+        return false;
+      }
+
+    private:
+      void Transfer(size_t nbBytes) const {
+        if (timings.perByte.count() > 0) {
+          std::this_thread::sleep_for(timings.perByte * nbBytes);
+        }
+      }
+
+      std::mutex mutex;
+      std::chrono::steady_clock::time_point busyUntil {};
+    };
+  }
+}
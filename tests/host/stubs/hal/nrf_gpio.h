@@ -0,0 +1,3 @@
+#pragma once
+
+// Included by the drivers, the emulated devices have no pins
@@ -0,0 +1,313 @@
+#pragma once
+
+// The firmware includes this header with min and max defined as empty macros (see FSService.h)
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+// Included by the NimBLE port for FreeRTOS
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+#include "task.h"
+#include "timers.h"
+
+// Subset of the NimBLE host used by the services, for the host tests : the packets are chains of mbufs allocated on the
+// heap, the notifications are kept so that the tests can check them, and the services get consecutive attribute
+// handles when they are registered.
+
+#define MYNEWT_VAL(name)                 MYNEWT_VAL_##name
+#define MYNEWT_VAL_BLE_ATT_PREFERRED_MTU (256)
+
+#define BLE_HS_CONN_HANDLE_NONE 0xffff
+#define BLE_ATT_MTU_DFLT        23
+
+#define BLE_ATT_ERR_INVALID_HANDLE         0x01
+#define BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN 0x0d
+#define BLE_ATT_ERR_UNLIKELY               0x0e
+#define BLE_ATT_ERR_INSUFFICIENT_RES       0x11
+
+#define BLE_GATT_ACCESS_OP_READ_CHR  0
+#define BLE_GATT_ACCESS_OP_WRITE_CHR 1
+
+#define BLE_GATT_CHR_F_READ         0x0002
+#define BLE_GATT_CHR_F_WRITE_NO_RSP 0x0004
+#define BLE_GATT_CHR_F_WRITE        0x0008
+#define BLE_GATT_CHR_F_NOTIFY       0x0010
+
+#define BLE_GATT_SVC_TYPE_PRIMARY 1
+
+#define BLE_GAP_LE_PHY_1M 1
+#define BLE_GAP_LE_PHY_2M 2
+
+#define BLE_UUID_TYPE_16  16
+#define BLE_UUID_TYPE_128 128
+
+struct os_mbuf {
+  uint8_t* om_data;
+  uint16_t om_len;
+
+  struct {
+    os_mbuf* sle_next;
+  } om_next;
+
+  uint8_t om_databuf[256];
+};
+
+#define SLIST_NEXT(element, field) ((element)->field.sle_next)
+
+struct ble_uuid_t {
+  uint8_t type;
+};
+
+struct ble_uuid16_t {
+  ble_uuid_t u;
+  uint16_t value;
+};
+
+struct ble_uuid128_t {
+  ble_uuid_t u;
+  uint8_t value[16];
+};
+
+struct ble_gatt_access_ctxt {
+  uint8_t op;
+  os_mbuf* om;
+};
+
+using ble_gatt_access_fn = int(uint16_t conn_handle, uint16_t attr_handle, ble_gatt_access_ctxt* ctxt, void* arg);
+
+struct ble_gatt_chr_def {
+  const ble_uuid_t* uuid;
+  ble_gatt_access_fn* access_cb;
+  void* arg;
+  void* descriptors;
+  uint16_t flags;
+  uint8_t min_key_size;
+  uint16_t* val_handle;
+};
+
+struct ble_gatt_svc_def {
+  uint8_t type;
+  const ble_uuid_t* uuid;
+  const ble_gatt_svc_def** includes;
+  const ble_gatt_chr_def* characteristics;
+};
+
+struct ble_gap_upd_params {
+  uint16_t itvl_min;
+  uint16_t itvl_max;
+  uint16_t latency;
+  uint16_t supervision_timeout;
+  uint16_t min_ce_len;
+  uint16_t max_ce_len;
+};
+
+namespace HostStubs {
+  struct Notification {
+    uint16_t connectionHandle;
+    uint16_t attributeHandle;
+    std::vector<uint8_t> data;
+  };
+
+  inline std::vector<Notification> notifications;
+  // MTU of every connection
+  inline uint16_t attMtu = BLE_ATT_MTU_DFLT;
+  inline int mbufsInUse = 0;
+  inline uint16_t nextAttributeHandle = 1;
+
+  struct Characteristic {
+    const ble_uuid_t* service;
+    const ble_uuid_t* characteristic;
+    uint16_t handle;
+  };
+
+  // Characteristics registered by ble_gatts_add_svcs(), found by the address of their UUID
+  inline std::vector<Characteristic> characteristics;
+}
+
+inline uint16_t OS_MBUF_PKTLEN(const os_mbuf* om) {
+  uint16_t length = 0;
+  for (; om != nullptr; om = om->om_next.sle_next) {
+    length += om->om_len;
+  }
+  return length;
+}
+
+namespace HostStubs {
+  inline os_mbuf* AllocateMbuf() {
+    auto* om = new os_mbuf {};
+    om->om_data = om->om_databuf;
+    mbufsInUse++;
+    return om;
+  }
+
+  inline os_mbuf* LastMbuf(os_mbuf* om) {
+    while (om->om_next.sle_next != nullptr) {
+      om = om->om_next.sle_next;
+    }
+    return om;
+  }
+
+  inline uint16_t Tailroom(const os_mbuf* om) {
+    return sizeof(om->om_databuf) - (om->om_data - om->om_databuf) - om->om_len;
+  }
+
+  // Chain of mbufs of at most segmentSize bytes each, as the controller delivers the long packets
+  inline os_mbuf* MbufFromFlat(const void* data, uint16_t size, uint16_t segmentSize = sizeof(os_mbuf::om_databuf)) {
+    os_mbuf* head = AllocateMbuf();
+    os_mbuf* last = head;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (uint16_t offset = 0; offset < size;) {
+      if (last->om_len == segmentSize) {
+        last->om_next.sle_next = AllocateMbuf();
+        last = last->om_next.sle_next;
+      }
+      const uint16_t length = std::min<uint16_t>(segmentSize - last->om_len, size - offset);
+      std::memcpy(last->om_data + last->om_len, bytes + offset, length);
+      last->om_len += length;
+      offset += length;
+    }
+    return head;
+  }
+
+  inline std::vector<uint8_t> MbufData(const os_mbuf* om) {
+    std::vector<uint8_t> data;
+    for (; om != nullptr; om = om->om_next.sle_next) {
+      data.insert(data.end(), om->om_data, om->om_data + om->om_len);
+    }
+    return data;
+  }
+}
+
+inline int os_mbuf_free_chain(os_mbuf* om) {
+  while (om != nullptr) {
+    os_mbuf* next = om->om_next.sle_next;
+    delete om;
+    HostStubs::mbufsInUse--;
+    om = next;
+  }
+  return 0;
+}
+
+inline void* os_mbuf_extend(os_mbuf* om, uint16_t length) {
+  os_mbuf* last = HostStubs::LastMbuf(om);
+  if (HostStubs::Tailroom(last) < length) {
+    if (length > sizeof(os_mbuf::om_databuf)) {
+      return nullptr;
+    }
+    last->om_next.sle_next = HostStubs::AllocateMbuf();
+    last = last->om_next.sle_next;
+  }
+  uint8_t* data = last->om_data + last->om_len;
+  last->om_len += length;
+  return data;
+}
+
+inline int os_mbuf_append(os_mbuf* om, const void* data, uint16_t length) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (length > 0) {
+    os_mbuf* last = HostStubs::LastMbuf(om);
+    if (HostStubs::Tailroom(last) == 0) {
+      last->om_next.sle_next = HostStubs::AllocateMbuf();
+      last = last->om_next.sle_next;
+    }
+    const uint16_t count = std::min(length, HostStubs::Tailroom(last));
+    std::memcpy(last->om_data + last->om_len, bytes, count);
+    last->om_len += count;
+    bytes += count;
+    length -= count;
+  }
+  return 0;
+}
+
+// Trims length bytes from the head of the packet, or -length bytes from its tail
+inline void os_mbuf_adj(os_mbuf* om, int length) {
+  if (length >= 0) {
+    for (; om != nullptr && length > 0; om = om->om_next.sle_next) {
+      const int count = std::min<int>(length, om->om_len);
+      om->om_data += count;
+      om->om_len -= count;
+      length -= count;
+    }
+    return;
+  }
+  int remaining = OS_MBUF_PKTLEN(om) + length;
+  for (; om != nullptr; om = om->om_next.sle_next) {
+    om->om_len = std::clamp<int>(remaining, 0, om->om_len);
+    remaining -= om->om_len;
+  }
+}
+
+inline int os_mbuf_copyinto(os_mbuf* om, int offset, const void* data, int length) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (; om != nullptr && length > 0; om = om->om_next.sle_next) {
+    if (offset >= om->om_len) {
+      offset -= om->om_len;
+      continue;
+    }
+    const int count = std::min<int>(length, om->om_len - offset);
+    std::memcpy(om->om_data + offset, bytes, count);
+    bytes += count;
+    length -= count;
+    offset = 0;
+  }
+  return (length == 0) ? 0 : -1;
+}
+
+inline os_mbuf* ble_hs_mbuf_from_flat(const void* data, uint16_t length) {
+  return HostStubs::MbufFromFlat(data, length);
+}
+
+// The notification is sent at once : the mbuf is freed
+inline int ble_gattc_notify_custom(uint16_t connectionHandle, uint16_t attributeHandle, os_mbuf* om) {
+  HostStubs::notifications.push_back({connectionHandle, attributeHandle, HostStubs::MbufData(om)});
+  os_mbuf_free_chain(om);
+  return 0;
+}
+
+inline uint16_t ble_att_mtu(uint16_t /*connectionHandle*/) {
+  return HostStubs::attMtu;
+}
+
+inline int ble_gatts_count_cfg(const ble_gatt_svc_def* /*services*/) {
+  return 0;
+}
+
+inline int ble_gatts_add_svcs(const ble_gatt_svc_def* services) {
+  for (; services->type != 0; services++) {
+    for (const ble_gatt_chr_def* characteristic = services->characteristics; characteristic->uuid != nullptr; characteristic++) {
+      if (characteristic->val_handle != nullptr) {
+        *characteristic->val_handle = HostStubs::nextAttributeHandle;
+      }
+      HostStubs::characteristics.push_back({services->uuid, characteristic->uuid, HostStubs::nextAttributeHandle});
+      HostStubs::nextAttributeHandle += 2;
+    }
+  }
+  return 0;
+}
+
+inline int
+ble_gatts_find_chr(const ble_uuid_t* service, const ble_uuid_t* characteristic, uint16_t* definitionHandle, uint16_t* valueHandle) {
+  for (const auto& registered : HostStubs::characteristics) {
+    if (registered.service == service && registered.characteristic == characteristic) {
+      if (definitionHandle != nullptr) {
+        *definitionHandle = registered.handle - 1;
+      }
+      if (valueHandle != nullptr) {
+        *valueHandle = registered.handle;
+      }
+      return 0;
+    }
+  }
+  return -1;
+}
+
+#pragma pop_macro("max")
+#pragma pop_macro("min")
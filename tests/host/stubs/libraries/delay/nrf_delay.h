@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// The delays of the drivers are not needed by the emulated devices
+inline void nrf_delay_ms(uint32_t /*ms*/) {
+}
+
+inline void nrf_delay_us(uint32_t /*us*/) {
+}
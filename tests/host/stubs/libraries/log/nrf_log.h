@@ -0,0 +1,4 @@
+#pragma once
+
+// The log of the nRF SDK, included by the drivers with its path in the SDK
+#include "../../nrf_log.h"
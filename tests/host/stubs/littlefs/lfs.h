@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Types and constants of littlefs used by the firmware, for the in-memory FS of the host tests (components/fs/FS.h)
+
+using lfs_size_t = uint32_t;
+using lfs_off_t = uint32_t;
+using lfs_ssize_t = int32_t;
+using lfs_soff_t = int32_t;
+using lfs_block_t = uint32_t;
+
+enum lfs_error {
+  LFS_ERR_OK = 0,
+  LFS_ERR_IO = -5,
+  LFS_ERR_CORRUPT = -84,
+  LFS_ERR_NOENT = -2,
+  LFS_ERR_EXIST = -17,
+  LFS_ERR_NOTDIR = -20,
+  LFS_ERR_ISDIR = -21,
+  LFS_ERR_NOTEMPTY = -39,
+  LFS_ERR_BADF = -9,
+  LFS_ERR_FBIG = -27,
+  LFS_ERR_INVAL = -22,
+  LFS_ERR_NOSPC = -28,
+  LFS_ERR_NOMEM = -12,
+};
+
+enum lfs_type {
+  LFS_TYPE_REG = 0x001,
+  LFS_TYPE_DIR = 0x002,
+};
+
+enum lfs_open_flags {
+  LFS_O_RDONLY = 1,
+  LFS_O_WRONLY = 2,
+  LFS_O_RDWR = 3,
+  LFS_O_CREAT = 0x0100,
+  LFS_O_EXCL = 0x0200,
+  LFS_O_TRUNC = 0x0400,
+  LFS_O_APPEND = 0x0800,
+};
+
+enum lfs_whence_flags {
+  LFS_SEEK_SET = 0,
+  LFS_SEEK_CUR = 1,
+  LFS_SEEK_END = 2,
+};
+
+struct lfs_info {
+  uint8_t type;
+  lfs_size_t size;
+  char name[256];
+};
+
+struct lfs_t {
+};
+
+struct lfs_config {
+};
+
+// The firmware zero-initializes them with {0}
+struct lfs_file_t {
+  bool opened = false;
+  std::string path;
+  lfs_off_t pos = 0;
+  int flags = 0;
+};
+
+struct lfs_dir_t {
+  bool opened = false;
+  std::string path;
+  size_t next = 0;
+};
+
+using lfs_file = lfs_file_t;
+using lfs_dir = lfs_dir_t;
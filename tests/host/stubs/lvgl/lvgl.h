@@ -0,0 +1,5 @@
+#pragma once
+
+// The declarations of LVGL used by the interface of the screens (displayapp/screens/Screen.h), for the tests of
+// ScreenArena : LVGL is not built for the computer, the screens of the tests create no object of LVGL
+typedef struct _lv_task_t lv_task_t;
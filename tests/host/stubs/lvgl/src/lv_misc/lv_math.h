@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// The sine of LVGL, used by utility/Math.cpp : computed instead of read from the table of LVGL, the values are the same
+// (the sine of the angle in degrees, scaled to 32767)
+inline int16_t _lv_trigo_sin(int16_t angle) {
+  return static_cast<int16_t>(std::lround(std::sin(angle * 3.14159265358979323846 / 180.0) * 32767.0));
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Registers of the nRF52 read by the hardware independent components. The cycle counter does not count on the host:
+// the benchmarks of tests/host measure the time with std::chrono.
+
+namespace HostStubs {
+  struct CoreDebugRegisters {
+    uint32_t DEMCR;
+  };
+
+  struct DwtRegisters {
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+  };
+
+  struct RtcRegisters {
+    uint32_t COUNTER;
+  };
+
+  inline CoreDebugRegisters coreDebug;
+  inline DwtRegisters dwt;
+  inline RtcRegisters rtc0;
+}
+
+#define CoreDebug                    (&HostStubs::coreDebug)
+#define DWT                          (&HostStubs::dwt)
+#define NRF_RTC0                     (&HostStubs::rtc0)
+#define CoreDebug_DEMCR_TRCENA_Msk   (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk       (1UL << 0)
+
+inline uint32_t SystemCoreClock = 64000000;
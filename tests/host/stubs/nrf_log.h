@@ -0,0 +1,15 @@
+#pragma once
+
+// The logs of the firmware are discarded, the tests report their results with gtest
+
+namespace HostStubs {
+  template <class... Arguments>
+  void Log(const char* /*format*/, Arguments&&... /*arguments*/) {
+  }
+}
+
+// Blocks, as the macros of the nRF SDK : some calls of the firmware are not followed by a semicolon
+#define NRF_LOG_INFO(...)    { HostStubs::Log(__VA_ARGS__); }
+#define NRF_LOG_WARNING(...) { HostStubs::Log(__VA_ARGS__); }
+#define NRF_LOG_ERROR(...)   { HostStubs::Log(__VA_ARGS__); }
+#define NRF_LOG_DEBUG(...)   { HostStubs::Log(__VA_ARGS__); }
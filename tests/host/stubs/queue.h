@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "FreeRTOS.h"
+
+// Queues of the host tests, they block the thread of the task that waits (see xTaskCreate() in task.h). The ticks of
+// the timeouts are milliseconds.
+
+namespace HostStubs {
+  struct Queue {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+  };
+}
+
+using QueueHandle_t = HostStubs::Queue*;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  auto* queue = new HostStubs::Queue {};
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock {queue->mutex};
+  if (!HostStubs::Wait(queue->changed, lock, ticks, [queue]() {
+        return queue->items.size() < queue->length;
+      })) {
+    return pdFALSE;
+  }
+  const auto* bytes = static_cast<const uint8_t*>(item);
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  lock.unlock();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock {queue->mutex};
+  if (!HostStubs::Wait(queue->changed, lock, ticks, [queue]() {
+        return !queue->items.empty();
+      })) {
+    return pdFALSE;
+  }
+  std::memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  lock.unlock();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock {queue->mutex};
+  return queue->items.size();
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "FreeRTOS.h"
+
+// Semaphores of the host tests, they block the thread of the task that takes them (see xTaskCreate() in task.h). The
+// ticks of the timeouts are milliseconds. As a task of higher priority on the watch, a task that waits for a semaphore
+// takes it as soon as it is given : the task that gave it waits (up to a millisecond) until it is taken.
+
+namespace HostStubs {
+  struct Semaphore {
+    std::mutex mutex;
+    std::condition_variable available;
+    std::condition_variable taken;
+    UBaseType_t count;
+    UBaseType_t nbWaiting = 0;
+    UBaseType_t maxCount;
+    // Recursive mutexes only
+    bool recursive = false;
+    std::thread::id owner;
+    UBaseType_t depth = 0;
+  };
+
+  inline BaseType_t Take(Semaphore* semaphore, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock {semaphore->mutex};
+    const auto isAvailable = [semaphore]() {
+      return semaphore->count > 0;
+    };
+    semaphore->nbWaiting++;
+    const bool available = Wait(semaphore->available, lock, ticks, isAvailable);
+    semaphore->nbWaiting--;
+    if (!available) {
+      return pdFALSE;
+    }
+    semaphore->count--;
+    semaphore->taken.notify_all();
+    return pdTRUE;
+  }
+
+  inline BaseType_t Give(Semaphore* semaphore) {
+    std::unique_lock<std::mutex> lock {semaphore->mutex};
+    if (semaphore->count == semaphore->maxCount) {
+      return pdFALSE;
+    }
+    semaphore->count++;
+    semaphore->available.notify_one();
+    if (semaphore->nbWaiting > 0) {
+      const UBaseType_t count = semaphore->count;
+      Wait(semaphore->taken, lock, 1, [semaphore, count]() {
+        return semaphore->count < count;
+      });
+    }
+    return pdTRUE;
+  }
+}
+
+using SemaphoreHandle_t = HostStubs::Semaphore*;
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+  auto* semaphore = new HostStubs::Semaphore {};
+  semaphore->count = initialCount;
+  semaphore->maxCount = maxCount;
+  return semaphore;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  SemaphoreHandle_t semaphore = xSemaphoreCreateMutex();
+  semaphore->recursive = true;
+  return semaphore;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  return HostStubs::Take(semaphore, ticks);
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  return HostStubs::Give(semaphore);
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  if (semaphore->depth > 0 && semaphore->owner == std::this_thread::get_id()) {
+    semaphore->depth++;
+    return pdTRUE;
+  }
+  if (HostStubs::Take(semaphore, ticks) == pdFALSE) {
+    return pdFALSE;
+  }
+  semaphore->owner = std::this_thread::get_id();
+  semaphore->depth = 1;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+  if (semaphore->depth == 0 || semaphore->owner != std::this_thread::get_id()) {
+    return pdFALSE;
+  }
+  if (--semaphore->depth > 0) {
+    return pdTRUE;
+  }
+  semaphore->owner = {};
+  return HostStubs::Give(semaphore);
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete semaphore;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include "systemtask/Messages.h"
+
+namespace Pinetime {
+  namespace System {
+    // SystemTask of the host tests : the messages pushed to it are kept, the tests handle them
+    class SystemTask {
+    public:
+      std::vector<Messages> messages;
+      bool sleeping = false;
+      bool sleepDisabled = true;
+
+      void PushMessage(Messages message) {
+        messages.push_back(message);
+      }
+
+      bool IsSleeping() const {
+        return sleeping;
+      }
+
+      bool IsSleepDisabled() const {
+        return sleepDisabled;
+      }
+    };
+  }
+}
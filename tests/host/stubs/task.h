@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "FreeRTOS.h"
+
+namespace HostStubs {
+  // Tick count returned by xTaskGetTickCount(), the tests advance it. vTaskDelay() advances it too, from any task.
+  inline std::atomic<TickType_t> tickCount = 0;
+
+  // Threads of the tasks, stopped and joined when the test program exits : a thread still running while the program
+  // exits would use the objects that are destroyed
+  class Tasks {
+  public:
+    ~Tasks() {
+      tasksStopping = true;
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+
+    void Start(void (*function)(void*), void* parameters) {
+      threads.emplace_back([function, parameters]() {
+        try {
+          function(parameters);
+        } catch (const TaskExit&) {
+        }
+      });
+    }
+
+  private:
+    std::vector<std::thread> threads;
+  };
+
+  inline Tasks tasks;
+}
+
+using TaskHandle_t = void*;
+using TaskFunction_t = void (*)(void*);
+
+// The task runs in a thread of its own, until it returns or the test program exits
+inline BaseType_t xTaskCreate(TaskFunction_t function,
+                              const char* /*name*/,
+                              uint16_t /*stackDepth*/,
+                              void* parameters,
+                              UBaseType_t /*priority*/,
+                              TaskHandle_t* handle) {
+  HostStubs::tasks.Start(function, parameters);
+  // The firmware only compares the handles with nullptr
+  if (handle != nullptr) {
+    static int task;
+    *handle = &task;
+  }
+  return pdPASS;
+}
+
+inline TickType_t xTaskGetTickCount() {
+  return HostStubs::tickCount;
+}
+
+// The other tasks run while the task is delayed
+inline void vTaskDelay(TickType_t ticks) {
+  HostStubs::tickCount += ticks;
+  std::this_thread::yield();
+}
+
+inline void vTaskSuspendAll() {
+}
+
+inline BaseType_t xTaskResumeAll() {
+  return pdFALSE;
+}
+
+#define taskENTER_CRITICAL() \
+  do {                       \
+  } while (0)
+#define taskEXIT_CRITICAL() \
+  do {                      \
+  } while (0)
+#define taskYIELD() \
+  do {              \
+  } while (0)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Software timers of the host tests : they expire when the tests advance the tick count with HostStubs::AdvanceTicks()
+
+namespace HostStubs {
+  struct Timer {
+    TickType_t period;
+    void* id;
+    void (*callback)(Timer*);
+    bool active;
+    TickType_t expiry;
+  };
+
+  inline std::vector<Timer*> timers;
+}
+
+using TimerHandle_t = HostStubs::Timer*;
+using TimerCallbackFunction_t = void (*)(TimerHandle_t);
+
+inline TimerHandle_t
+xTimerCreate(const char* /*name*/, TickType_t period, UBaseType_t /*autoReload*/, void* id, TimerCallbackFunction_t callback) {
+  auto* timer = new HostStubs::Timer {period, id, callback, false, 0};
+  HostStubs::timers.push_back(timer);
+  return timer;
+}
+
+inline void* pvTimerGetTimerID(TimerHandle_t timer) {
+  return timer->id;
+}
+
+inline BaseType_t xTimerStart(TimerHandle_t timer, TickType_t /*ticksToWait*/) {
+  timer->active = true;
+  timer->expiry = HostStubs::tickCount + timer->period;
+  return pdPASS;
+}
+
+inline BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticksToWait) {
+  return xTimerStart(timer, ticksToWait);
+}
+
+inline BaseType_t xTimerStop(TimerHandle_t timer, TickType_t /*ticksToWait*/) {
+  timer->active = false;
+  return pdPASS;
+}
+
+inline BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+  return timer->active ? pdTRUE : pdFALSE;
+}
+
+namespace HostStubs {
+  // Advances the tick count and calls the one-shot timers that expire, in the order they were created
+  inline void AdvanceTicks(TickType_t ticks) {
+    tickCount += ticks;
+    for (Timer* timer : timers) {
+      if (timer->active && static_cast<int32_t>(tickCount - timer->expiry) >= 0) {
+        timer->active = false;
+        timer->callback(timer);
+      }
+    }
+  }
+
+  // Deletes the timers, for the tests whose objects own timers that outlive them
+  inline void DeleteTimers() {
+    for (Timer* timer : timers) {
+      delete timer;
+    }
+    timers.clear();
+  }
+}
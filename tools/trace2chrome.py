@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+    trace2chrome
+    ~~~~~~~~~~~~
+
+    Converts the event trace of the watch (/.system/trace.bin, firmware built with EVENT_TRACE) to the JSON trace format
+    of Chrome, which can be opened with https://ui.perfetto.dev or chrome://tracing. See doc/EventTrace.md.
+
+    The names of the messages, of the SPI chip select pins and of the I2C devices are read from the sources of the
+    firmware.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, 'src')
+
+HEADER = struct.Struct('<4sBBHIII')
+MAGIC = b'ITEV'
+VERSION = 1
+TASK_NAME_LENGTH = 4  # configMAX_TASK_NAME_LEN
+
+# EventTrace::Type
+TASK_SWITCHED_IN = 1
+SYSTEM_MESSAGE = 2
+DISPLAY_MESSAGE = 3
+SPI_BEGIN = 4
+SPI_END = 5
+TWI_BEGIN = 6
+TWI_END = 7
+LVGL_REFRESH_BEGIN = 8
+LVGL_REFRESH_END = 9
+LVGL_ALLOC = 10
+LVGL_FREE = 11
+
+COUNTER_BITS = 24
+
+PID = 1
+TID_CPU = 1
+TID_SYSTEM_QUEUE = 2
+TID_DISPLAY_QUEUE = 3
+TID_SPI = 4
+TID_TWI = 5
+TID_LVGL = 6
+THREAD_NAMES = {
+    TID_CPU: 'CPU',
+    TID_SYSTEM_QUEUE: 'SystemTask messages',
+    TID_DISPLAY_QUEUE: 'DisplayApp messages',
+    TID_SPI: 'SPI',
+    TID_TWI: 'I2C',
+    TID_LVGL: 'LVGL refresh',
+}
+
+
+def read_source(path):
+    with open(os.path.join(SOURCE_DIR, path), 'r') as source:
+        return source.read()
+
+
+def enum_names(path):
+    """ Names of the values of the enum class Messages of a header """
+    body = re.search(r'enum class Messages[^{]*{([^}]*)}', read_source(path)).group(1)
+    body = re.sub(r'//[^\n]*', '', body)
+    return [name.strip() for name in body.split(',') if name.strip()]
+
+
+def source_names():
+    system_messages = enum_names('systemtask/Messages.h')
+    display_messages = enum_names('displayapp/Messages.h')
+    pins = {int(pin): name for name, pin in re.findall(r'Spi(\w+)Csn = (\d+);', read_source('drivers/PinMap.h'))}
+    devices = {int(address, 16): name for name, address in
+               re.findall(r'(\w+)TwiAddress = (0x[0-9a-fA-F]+);', read_source('main.cpp'))}
+    return system_messages, display_messages, pins, devices
+
+
+def name_of(names, value, default):
+    if isinstance(names, list):
+        return names[value] if value < len(names) else '%s %d' % (default, value)
+    return names.get(value, '%s %d' % (default, value))
+
+
+def read_trace(data):
+    magic, version, nb_tasks, event_size, frequency, nb_events, lost_events = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('not an event trace of version %d' % VERSION)
+    offset = HEADER.size
+    tasks = {}
+    for _ in range(nb_tasks):
+        number = data[offset]
+        tasks[number] = data[offset + 1:offset + 1 + TASK_NAME_LENGTH].split(b'\0')[0].decode('ascii', 'replace')
+        offset += 1 + TASK_NAME_LENGTH
+
+    # The counter of RTC0 wraps every 512s, and an event that preempted another one may be stored before it : the time
+    # goes back by less than half the range of the counter in that case
+    events = []
+    mask = (1 << COUNTER_BITS) - 1
+    previous = None
+    time = 0
+    for i in range(nb_events):
+        header, argument = struct.unpack_from('<II', data, offset + i * event_size)
+        counter = header & mask
+        if previous is not None:
+            delta = (counter - previous) & mask
+            if delta >= 1 << (COUNTER_BITS - 1):
+                delta -= 1 << COUNTER_BITS
+            time += delta
+        previous = counter
+        events.append((time, i, header >> COUNTER_BITS, argument))
+    events.sort()
+    return tasks, frequency, lost_events, events
+
+
+def convert(data):
+    tasks, frequency, lost_events, events = read_trace(data)
+    if not events:
+        raise ValueError('no events')
+    system_messages, display_messages, pins, devices = source_names()
+
+    def us(time):
+        return (time - events[0][0]) * 1000000.0 / frequency
+
+    trace = [{'name': 'process_name', 'ph': 'M', 'pid': PID, 'args': {'name': 'PineTime'}}]
+    for tid, name in THREAD_NAMES.items():
+        trace.append({'name': 'thread_name', 'ph': 'M', 'pid': PID, 'tid': tid, 'args': {'name': name}})
+
+    def add_slice(tid, name, begin, end, args=None):
+        trace.append({'name': name, 'ph': 'X', 'pid': PID, 'tid': tid, 'ts': us(begin), 'dur': us(end) - us(begin),
+                      'args': args or {}})
+
+    current_task = None
+    spi = None
+    twi = {}
+    lvgl = None
+    # Size of the LVGL blocks allocated during the trace, by address : the blocks allocated before are not counted
+    lvgl_blocks = {}
+    lvgl_bytes = 0
+    for time, _, event_type, argument in events:
+        if event_type == TASK_SWITCHED_IN:
+            if current_task is not None:
+                add_slice(TID_CPU, name_of(tasks, current_task[1], 'task'), current_task[0], time)
+            current_task = (time, argument)
+        elif event_type in (SYSTEM_MESSAGE, DISPLAY_MESSAGE):
+            names = system_messages if event_type == SYSTEM_MESSAGE else display_messages
+            trace.append({'name': name_of(names, argument & 0xff, 'message'), 'ph': 'i', 's': 't', 'pid': PID,
+                          'tid': TID_SYSTEM_QUEUE if event_type == SYSTEM_MESSAGE else TID_DISPLAY_QUEUE,
+                          'ts': us(time), 'args': {'from interrupt': bool(argument & 0x100)}})
+        elif event_type == SPI_BEGIN:
+            spi = (time, argument >> 24, argument & 0xffffff)
+        elif event_type == SPI_END and spi is not None:
+            add_slice(TID_SPI, name_of(pins, spi[1], 'CS'), spi[0], time, {'bytes': spi[2]})
+            spi = None
+        elif event_type == TWI_BEGIN:
+            # The batches of several tasks may be queued at the same time
+            twi[current_task[1] if current_task else None] = (time, argument >> 8, argument & 0xff)
+        elif event_type == TWI_END:
+            begin = twi.pop(current_task[1] if current_task else None, None)
+            if begin is not None:
+                add_slice(TID_TWI, name_of(devices, begin[1], 'device'), begin[0], time,
+                          {'transactions': begin[2], 'failed': argument != 0})
+        elif event_type == LVGL_REFRESH_BEGIN:
+            lvgl = time
+        elif event_type == LVGL_REFRESH_END and lvgl is not None:
+            add_slice(TID_LVGL, 'refresh', lvgl, time, {'flushes': argument})
+            lvgl = None
+        elif event_type in (LVGL_ALLOC, LVGL_FREE):
+            if event_type == LVGL_ALLOC:
+                lvgl_blocks[argument >> 16] = argument & 0xffff
+                lvgl_bytes += argument & 0xffff
+            else:
+                lvgl_bytes -= lvgl_blocks.pop(argument, 0)
+            trace.append({'name': 'LVGL memory', 'ph': 'C', 'pid': PID, 'ts': us(time), 'args': {'bytes': lvgl_bytes}})
+    if current_task is not None:
+        add_slice(TID_CPU, name_of(tasks, current_task[1], 'task'), current_task[0], events[-1][0])
+
+    duration = (events[-1][0] - events[0][0]) / float(frequency)
+    metadata = {'events': len(events), 'lost events': lost_events, 'duration (s)': duration}
+    return {'traceEvents': trace, 'displayTimeUnit': 'ms', 'metadata': metadata}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an event trace of the watch to the Chrome JSON trace format')
+    parser.add_argument('trace', help='trace file read from the watch (/.system/trace.bin)')
+    parser.add_argument('-o', '--output', help='JSON file to write (default : standard output)')
+    args = parser.parse_args()
+
+    with open(args.trace, 'rb') as trace_file:
+        data = trace_file.read()
+    try:
+        chrome_trace = convert(data)
+    except (ValueError, struct.error) as error:
+        sys.exit('%s: %s' % (args.trace, error))
+    if args.output:
+        with open(args.output, 'w') as output:
+            json.dump(chrome_trace, output)
+    else:
+        json.dump(chrome_trace, sys.stdout)
+    metadata = chrome_trace['metadata']
+    print('%d events over %.1fs, %d lost' % (metadata['events'], metadata['duration (s)'], metadata['lost events']),
+          file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()